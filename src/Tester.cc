@@ -2,51 +2,129 @@
 #include "codegen-llvm-instance/WebAssemblyInstance.h"
 
 #include <filesystem>
+#include <memory>
+#include <string_view>
 
-void run(char const *Path) {
+void run(
+    char const *Path, runtime::MemoryPagePolicy PagePolicy,
+    std::shared_ptr<runtime::wasi::WASIContext> Context) {
   using namespace runtime;
 
-#define WASI_IMPORT(name, func)                                                \
-  InstanceBuilder.tryImport("wasi_snapshot_preview1", name, func)
-
-  auto InstanceBuilder = WebAssemblyInstanceBuilder(Path);
-  WASI_IMPORT("proc_exit", wasi::proc_exit);
-  WASI_IMPORT("clock_time_get", wasi::clock_time_get);
-  WASI_IMPORT("args_sizes_get", wasi::args_sizes_get);
-  WASI_IMPORT("args_get", wasi::args_get);
-  WASI_IMPORT("fd_prestat_get", wasi::fd_prestart_get);
-  WASI_IMPORT("fd_prestat_dir_name", wasi::fd_prestat_dir_name);
-  WASI_IMPORT("path_open", wasi::path_open);
-  WASI_IMPORT("fd_read", wasi::fd_read);
-  WASI_IMPORT("fd_seek", wasi::fd_seek);
-  WASI_IMPORT("fd_close", wasi::fd_close);
-  WASI_IMPORT("fd_fdstat_get", wasi::fd_fdstat_get);
-  WASI_IMPORT("fd_fdstat_set_flags", wasi::fd_fdstat_set_flags);
-  WASI_IMPORT("fd_write", wasi::fd_write);
-  WASI_IMPORT("random_get", wasi::random_get);
-  WASI_IMPORT("poll_oneoff", wasi::poll_oneoff);
+#define WASI_FUNCTION(name, func)                                              \
+  WebAssemblyImportResolver::define(name, func)
+
+  using HostFunction = WebAssemblyImportResolver::HostFunction;
+  static HostFunction const WASIFunctions[] = {
+      WASI_FUNCTION("proc_exit", wasi::proc_exit),
+      WASI_FUNCTION("clock_time_get", wasi::clock_time_get),
+      WASI_FUNCTION("args_sizes_get", wasi::args_sizes_get),
+      WASI_FUNCTION("args_get", wasi::args_get),
+      WASI_FUNCTION("environ_sizes_get", wasi::environ_sizes_get),
+      WASI_FUNCTION("environ_get", wasi::environ_get),
+      WASI_FUNCTION("fd_prestat_get", wasi::fd_prestat_get),
+      WASI_FUNCTION("fd_prestat_dir_name", wasi::fd_prestat_dir_name),
+      WASI_FUNCTION("path_open", wasi::path_open),
+      WASI_FUNCTION("path_filestat_get", wasi::path_filestat_get),
+      WASI_FUNCTION("path_create_directory", wasi::path_create_directory),
+      WASI_FUNCTION("path_remove_directory", wasi::path_remove_directory),
+      WASI_FUNCTION("path_unlink_file", wasi::path_unlink_file),
+      WASI_FUNCTION("path_rename", wasi::path_rename),
+      WASI_FUNCTION("path_filestat_set_times", wasi::path_filestat_set_times),
+      WASI_FUNCTION("path_readlink", wasi::path_readlink),
+      WASI_FUNCTION("path_symlink", wasi::path_symlink),
+      WASI_FUNCTION("path_link", wasi::path_link),
+      WASI_FUNCTION("fd_read", wasi::fd_read),
+      WASI_FUNCTION("fd_pread", wasi::fd_pread),
+      WASI_FUNCTION("fd_seek", wasi::fd_seek),
+      WASI_FUNCTION("fd_tell", wasi::fd_tell),
+      WASI_FUNCTION("fd_close", wasi::fd_close),
+      WASI_FUNCTION("fd_renumber", wasi::fd_renumber),
+      WASI_FUNCTION("fd_advise", wasi::fd_advise),
+      WASI_FUNCTION("fd_allocate", wasi::fd_allocate),
+      WASI_FUNCTION("fd_sync", wasi::fd_sync),
+      WASI_FUNCTION("fd_datasync", wasi::fd_datasync),
+      WASI_FUNCTION("fd_fdstat_get", wasi::fd_fdstat_get),
+      WASI_FUNCTION("fd_fdstat_set_flags", wasi::fd_fdstat_set_flags),
+      WASI_FUNCTION("fd_fdstat_set_rights", wasi::fd_fdstat_set_rights),
+      WASI_FUNCTION("fd_filestat_get", wasi::fd_filestat_get),
+      WASI_FUNCTION("fd_filestat_set_size", wasi::fd_filestat_set_size),
+      WASI_FUNCTION("fd_filestat_set_times", wasi::fd_filestat_set_times),
+      WASI_FUNCTION("fd_readdir", wasi::fd_readdir),
+      WASI_FUNCTION("fd_write", wasi::fd_write),
+      WASI_FUNCTION("fd_pwrite", wasi::fd_pwrite),
+      WASI_FUNCTION("random_get", wasi::random_get),
+      WASI_FUNCTION("sched_yield", wasi::sched_yield),
+      WASI_FUNCTION("poll_oneoff", wasi::poll_oneoff)};
+#undef WASI_FUNCTION
+
+  auto Module = WebAssemblyModule::load(Path);
+  auto Resolver = WebAssemblyImportResolver(Module);
+  Resolver.resolve("wasi_snapshot_preview1", WASIFunctions);
+  auto InstanceBuilder = WebAssemblyInstanceBuilder(Module);
+  InstanceBuilder.setMemoryPagePolicy(PagePolicy);
+  InstanceBuilder.import(Resolver);
+  // threaded modules import their shared memory, it outlives the instance
+  // which joins the threads it spawned
+  auto Memory = Module->createImportMemory("env", "memory", PagePolicy);
+  if (Memory != nullptr) InstanceBuilder.import("env", "memory", *Memory);
+  InstanceBuilder.tryImport("wasi", "thread-spawn", wasi::thread_spawn);
   auto Instance = InstanceBuilder.Build();
+  wasi::bind(*Instance, std::move(Context));
 
-  Instance->getFunction("_start").invoke<void>();
+  // exit ends the whole process as it does from a spawned thread, the other
+  // threads are not waited for
+  try {
+    Instance->getFunction("_start").invoke<void>();
+  } catch (wasi::exceptions::WASIExit const &Exception) {
+    std::exit(Exception.getExitCode());
+  }
+}
+
+[[noreturn]] void usage(char const *Name) {
+  fmt::print(
+      "usage: {} [--huge-pages=thp|hugetlb] [--dir=HOST[:GUEST]]... "
+      "[sable shared libraries]\n",
+      Name);
+  std::exit(EXIT_FAILURE);
 }
 
 int main(int argc, char const *argv[]) {
 
-  if (argc != 2) {
-    fmt::print("usage: {} [sable shared libraries]\n", argv[0]);
-    std::exit(EXIT_FAILURE);
+  if (argc < 2) usage(argv[0]);
+
+  auto PagePolicy = runtime::MemoryPagePolicy::Native;
+  auto Context = std::make_shared<runtime::wasi::WASIContext>();
+  for (int I = 1; I < argc - 1; ++I) {
+    std::string_view Option(argv[I]);
+    if (Option == "--huge-pages=thp") {
+      PagePolicy = runtime::MemoryPagePolicy::TransparentHugePage;
+    } else if (Option == "--huge-pages=hugetlb") {
+      PagePolicy = runtime::MemoryPagePolicy::HugeTLB;
+    } else if (Option.starts_with("--dir=")) {
+      // the guest sees the directory under its host path unless renamed
+      auto Directory = Option.substr(std::string_view("--dir=").size());
+      auto Separator = Directory.find(':');
+      auto HostPath = Directory.substr(0, Separator);
+      auto GuestPath = (Separator == std::string_view::npos)
+                           ? HostPath
+                           : Directory.substr(Separator + 1);
+      if (!Context->preopen(HostPath, GuestPath)) {
+        fmt::print("cannot open directory {}.\n", HostPath);
+        return EXIT_FAILURE;
+      }
+    } else {
+      usage(argv[0]);
+    }
   }
 
-  std::filesystem::path Path(argv[1]);
+  std::filesystem::path Path(argv[argc - 1]);
   if (!std::filesystem::exists(Path)) {
     fmt::print("cannot locate {}.\n", Path.c_str());
     return EXIT_FAILURE;
   }
 
   try {
-    run(argv[1]);
-  } catch (runtime::wasi::exceptions::WASIExit const &Exception) {
-    return Exception.getExitCode();
+    run(argv[argc - 1], PagePolicy, std::move(Context));
   } catch (std::exception const &Exception) {
     fmt::print("exit with exception:\n  {}\n", Exception.what());
     return EXIT_FAILURE;
@@ -30,7 +30,11 @@ enum class InstCategory {
   /* nontrapping float-to-int conversions (merged WG-03-11) */
   NontrappingFloatToIntConvs,
   /* SIMD v128 */
-  SIMD128
+  SIMD128,
+  /* threads and atomics */
+  Atomic,
+  /* bulk memory operations */
+  BulkMemory
 };
 
 class TaggedInstPtr;
@@ -58,6 +62,7 @@ enum class TableIDX  : std::uint32_t {};
 enum class MemIDX    : std::uint32_t {};
 enum class FuncIDX   : std::uint32_t {};
 enum class TypeIDX   : std::uint32_t {};
+enum class DataIDX   : std::uint32_t {};
 // clang-format on
 
 struct BlockResultUnit {};
@@ -47,7 +47,10 @@ struct Element {
   std::vector<bytecode::FuncIDX> Initializer;
 };
 
+// passive segments are only copied by memory.init, Memory and Offset are unused
+enum class DataMode { Active, Passive };
 struct Data {
+  DataMode Mode;
   bytecode::MemIDX Memory;
   bytecode::Expression Offset;
   std::vector<std::byte> Initializer;
@@ -75,6 +78,7 @@ struct Module {
   std::vector  <entities::Element     > Elements;
   std::vector  <entities::Data        > Data;
   std::optional<bytecode::FuncIDX     > Start;
+  std::optional<std::uint32_t         > DataCount;
   std::vector  <entities::Import      > Imports;
   std::vector  <entities::Export      > Exports;
   // clang-format on
@@ -73,27 +73,47 @@ public:
 
 // clang-format off
 template <typename T> concept limit_like_type = requires(T Type) {
-  { Type.getMin() } -> std::convertible_to<std::uint32_t>;
+  { Type.getMin() } -> std::convertible_to<std::uint64_t>;
   { Type.hasMax() } -> std::convertible_to<bool>;
-  { Type.getMax() } -> std::convertible_to<std::uint32_t>;
+  { Type.getMax() } -> std::convertible_to<std::uint64_t>;
 };
 // clang-format on
 
+// Limits are counted in pages. 64-bit memories (memory64 proposal) may exceed
+// 2^32 pages and are addressed by i64 indices.
 class MemoryType {
-  std::uint32_t Min;
-  std::optional<std::uint32_t> Max;
+  std::uint64_t Min;
+  std::optional<std::uint64_t> Max;
+  bool Shared = false;
+  bool Memory64 = false;
 
 public:
-  explicit MemoryType(std::uint32_t Min_) : Min(Min_), Max(std::nullopt) {}
-  MemoryType(std::uint32_t Min_, std::uint32_t Max_) : Min(Min_), Max(Max_) {
+  explicit MemoryType(std::uint64_t Min_) : Min(Min_), Max(std::nullopt) {}
+  MemoryType(std::uint64_t Min_, std::uint64_t Max_) : Min(Min_), Max(Max_) {
     assert(Min <= Max && "memory type constraint");
   }
-  std::uint32_t getMin() const { return Min; }
+  // shared memories always come with a maximum (threads proposal)
+  MemoryType(std::uint64_t Min_, std::uint64_t Max_, bool Shared_)
+      : Min(Min_), Max(Max_), Shared(Shared_) {
+    assert(Min <= Max && "memory type constraint");
+  }
+  MemoryType(
+      std::uint64_t Min_, std::optional<std::uint64_t> Max_, bool Shared_,
+      bool Memory64_)
+      : Min(Min_), Max(Max_), Shared(Shared_), Memory64(Memory64_) {
+    assert((!Max.has_value() || (Min <= *Max)) && "memory type constraint");
+  }
+  std::uint64_t getMin() const { return Min; }
   bool hasMax() const { return Max.has_value(); }
-  std::uint32_t getMax() const {
+  std::uint64_t getMax() const {
     assert(hasMax() && "memory type maximum is not set");
     return *Max;
   }
+  bool isShared() const { return Shared; }
+  bool isMemory64() const { return Memory64; }
+  ValueType getIndexType() const {
+    return Memory64 ? valuetypes::I64 : valuetypes::I32;
+  }
   bool operator==(MemoryType const &Other) const = default;
 };
 
@@ -188,7 +208,10 @@ struct fmt::formatter<bytecode::MemoryType, char> :
   template <typename T> constexpr auto parse(T &&CTX) { return CTX.begin(); }
   template <typename Context>
   auto format(bytecode::MemoryType const &Type, Context &&CTX) const {
-    return formatLimit(CTX.out(), Type);
+    auto Out = formatLimit(CTX.out(), Type);
+    if (Type.isShared()) Out = fmt::format_to(Out, " shared");
+    if (Type.isMemory64()) Out = fmt::format_to(Out, " i64");
+    return Out;
   }
 };
 
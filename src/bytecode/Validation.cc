@@ -11,6 +11,7 @@
 
 #include <array>
 #include <bit>
+#include <limits>
 #include <optional>
 #include <span>
 #include <type_traits>
@@ -64,12 +65,22 @@ bool validateLimitLikeType(T const &Type, std::uint64_t K) {
 } // namespace
 
 bool validate(MemoryType const &Type) {
+  if (Type.isMemory64())
+    return validateLimitLikeType(Type, std::uint64_t(1) << 48);
   return validateLimitLikeType(Type, std::uint64_t(1) << 32);
 }
 bool validate(TableType const &Type) {
   return validateLimitLikeType(Type, std::uint64_t(1) << 16);
 }
 
+namespace {
+// memarg offsets are encoded as u64, 32-bit memories only take u32 offsets
+bool isValidOffset(MemoryType const &Type, std::uint64_t Offset) {
+  if (Type.isMemory64()) return true;
+  return Offset <= std::numeric_limits<std::uint32_t>::max();
+}
+} // namespace
+
 ///////////////////////////////// OperandStack /////////////////////////////////
 namespace {
 class OperandStack {
@@ -225,6 +236,19 @@ public:
     }
   };
 
+  // data segments are only visible to code through the data count section
+  struct DataWrapper {
+    ExprValidationContext const &Context;
+    std::optional<entities::Data const *> operator[](DataIDX const &Index) {
+      auto const &M = Context.Module.module();
+      if (!M.DataCount.has_value()) return std::nullopt;
+      auto CastedIndex = static_cast<std::size_t>(Index);
+      if (!(CastedIndex < *M.DataCount)) return std::nullopt;
+      if (!(CastedIndex < M.Data.size())) return std::nullopt;
+      return std::addressof(M.Data[CastedIndex]);
+    }
+  };
+
   LabelStack &labels() { return Labels; }
   bool hasReturn() const { return Returns.has_value(); }
   auto return_() const { return ranges::views::all(*Returns); }
@@ -235,6 +259,7 @@ public:
   auto memories() const { return Wrapper<MemIDX>{*this}; }
   auto globals() const { return Wrapper<GlobalIDX>{*this}; }
   auto locals() const { return LocalWrapper{*this}; }
+  auto data() const { return DataWrapper{*this}; }
 
   explicit ExprValidationContext(ModuleView MView)
       : Module(std::move(MView)), Locals(std::nullopt), Returns(std::nullopt) {}
@@ -265,6 +290,8 @@ concept validation_context = requires(T &CTX, T const &CCTX) {
   -> std::convertible_to<std::optional<views::Global>>;
   { CCTX.locals()[std::declval<LocalIDX>()] }
   -> std::convertible_to<std::optional<ValueType>>;
+  { CCTX.data()[std::declval<DataIDX>()] }
+  -> std::convertible_to<std::optional<entities::Data const *>>;
 };
 // clang-format on
 
@@ -479,9 +506,8 @@ public:
   ON(F64Const         , (0, ()   ), (1, (F64))) // [] -> [f64]
   /* Control Instructions */
   ON(Nop              , (0, ()   ), (0, ()   )) // []    -> []
-  /* Memory Instruction */
-  ON(MemorySize       , (0, ()   ), (1, (I32))) // []    -> [i32]
-  ON(MemoryGrow       , (1, (I32)), (1, (I32))) // [i32] -> [i32]
+  /* Atomic Instructions */
+  ON(AtomicFence      , (0, ()   ), (0, ()   )) // []    -> []
   /* Saturated Conversion Instructions */
   ON(I32TruncSatF32S  , (1, (F32)), (1, (I32))) // [f32] -> [i32]
   ON(I32TruncSatF32U  , (1, (F32)), (1, (I32))) // [f32] -> [i32]
@@ -731,9 +757,12 @@ public:
 #undef ON
 #define ON(Name, Width, ParamTypes, ResultTypes)                               \
   ErrorPtr operator()(Name const *Inst) {                                      \
-    auto Memory = Context.memories()[static_cast<MemIDX>(0)];                  \
+    auto Memory = Context.memories()[Inst->Memory];                            \
     if (!Memory.has_value())                                                   \
       return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);     \
+    if (!isValidOffset(*Memory->getType(), Inst->Offset))                      \
+      return Trace.BuildError(MalformedErrorKind::INVALID_OFFSET);             \
+    auto IDX = Memory->getType()->getIndexType();                              \
     if (!(Inst->Align <= std::countr_zero(static_cast<unsigned>(Width)) + 1))  \
       return Trace.BuildError(MalformedErrorKind::INVALID_ALIGN);              \
     auto Parameters = BuildTypesArray(                                         \
@@ -748,43 +777,134 @@ public:
     return nullptr;                                                            \
   }
   // clang-format off
-  ON(I32Load        ,  32, (1, (I32       )), (1, (I32 )))
-  ON(I64Load        ,  64, (1, (I32       )), (1, (I64 )))
-  ON(F32Load        ,  32, (1, (I32       )), (1, (F32 )))
-  ON(F64Load        ,  64, (1, (I32       )), (1, (F64 )))
-  ON(I32Load8S      ,   8, (1, (I32       )), (1, (I32 )))
-  ON(I32Load8U      ,   8, (1, (I32       )), (1, (I32 )))
-  ON(I32Load16S     ,  16, (1, (I32       )), (1, (I32 )))
-  ON(I32Load16U     ,  16, (1, (I32       )), (1, (I32 )))
-  ON(I64Load8S      ,   8, (1, (I32       )), (1, (I64 )))
-  ON(I64Load8U      ,   8, (1, (I32       )), (1, (I64 )))
-  ON(I64Load16S     ,  16, (1, (I32       )), (1, (I64 )))
-  ON(I64Load16U     ,  16, (1, (I32       )), (1, (I64 )))
-  ON(I64Load32S     ,  32, (1, (I32       )), (1, (I64 )))
-  ON(I64Load32U     ,  32, (1, (I32       )), (1, (I64 )))
-  ON(I32Store       ,  32, (2, (I32 , I32 )), (0, (    )))
-  ON(I64Store       ,  64, (2, (I32 , I64 )), (0, (    )))
-  ON(F32Store       ,  32, (2, (I32 , F32 )), (0, (    )))
-  ON(F64Store       ,  64, (2, (I32 , F64 )), (0, (    )))
-  ON(I32Store8      ,   8, (2, (I32 , I32 )), (0, (    )))
-  ON(I32Store16     ,  16, (2, (I32 , I32 )), (0, (    )))
-  ON(I64Store8      ,   8, (2, (I32 , I64 )), (0, (    )))
-  ON(I64Store16     ,  16, (2, (I32 , I64 )), (0, (    )))
-  ON(I64Store32     ,  32, (2, (I32 , I64 )), (0, (    )))
-  ON(V128Load       , 128, (1, (I32       )), (1, (V128)))
-  ON(V128Load32Zero ,  32, (1, (I32       )), (1, (V128)))
-  ON(V128Load64Zero ,  64, (1, (I32       )), (1, (V128)))
-  ON(V128Load8Splat ,   8, (1, (I32       )), (1, (V128)))
-  ON(V128Load16Splat,  16, (1, (I32       )), (1, (V128)))
-  ON(V128Load32Splat,  32, (1, (I32       )), (1, (V128)))
-  ON(V128Load64Splat,  64, (1, (I32       )), (1, (V128)))
-  ON(V128Load8x8S   ,   8, (1, (I32       )), (1, (V128)))
-  ON(V128Load8x8U   ,   8, (1, (I32       )), (1, (V128)))
-  ON(V128Load16x4S  ,  16, (1, (I32       )), (1, (V128)))
-  ON(V128Load16x4U  ,  16, (1, (I32       )), (1, (V128)))
-  ON(V128Load32x2S  ,  32, (1, (I32       )), (1, (V128)))
-  ON(V128Load32x2U  ,  32, (1, (I32       )), (1, (V128)))
-  ON(V128Store      , 128, (1, (I32 , V128)), (0, (    )))
+  ON(I32Load        ,  32, (1, (IDX       )), (1, (I32 )))
+  ON(I64Load        ,  64, (1, (IDX       )), (1, (I64 )))
+  ON(F32Load        ,  32, (1, (IDX       )), (1, (F32 )))
+  ON(F64Load        ,  64, (1, (IDX       )), (1, (F64 )))
+  ON(I32Load8S      ,   8, (1, (IDX       )), (1, (I32 )))
+  ON(I32Load8U      ,   8, (1, (IDX       )), (1, (I32 )))
+  ON(I32Load16S     ,  16, (1, (IDX       )), (1, (I32 )))
+  ON(I32Load16U     ,  16, (1, (IDX       )), (1, (I32 )))
+  ON(I64Load8S      ,   8, (1, (IDX       )), (1, (I64 )))
+  ON(I64Load8U      ,   8, (1, (IDX       )), (1, (I64 )))
+  ON(I64Load16S     ,  16, (1, (IDX       )), (1, (I64 )))
+  ON(I64Load16U     ,  16, (1, (IDX       )), (1, (I64 )))
+  ON(I64Load32S     ,  32, (1, (IDX       )), (1, (I64 )))
+  ON(I64Load32U     ,  32, (1, (IDX       )), (1, (I64 )))
+  ON(I32Store       ,  32, (2, (IDX , I32 )), (0, (    )))
+  ON(I64Store       ,  64, (2, (IDX , I64 )), (0, (    )))
+  ON(F32Store       ,  32, (2, (IDX , F32 )), (0, (    )))
+  ON(F64Store       ,  64, (2, (IDX , F64 )), (0, (    )))
+  ON(I32Store8      ,   8, (2, (IDX , I32 )), (0, (    )))
+  ON(I32Store16     ,  16, (2, (IDX , I32 )), (0, (    )))
+  ON(I64Store8      ,   8, (2, (IDX , I64 )), (0, (    )))
+  ON(I64Store16     ,  16, (2, (IDX , I64 )), (0, (    )))
+  ON(I64Store32     ,  32, (2, (IDX , I64 )), (0, (    )))
+  ON(V128Load       , 128, (1, (IDX       )), (1, (V128)))
+  ON(V128Load32Zero ,  32, (1, (IDX       )), (1, (V128)))
+  ON(V128Load64Zero ,  64, (1, (IDX       )), (1, (V128)))
+  ON(V128Load8Splat ,   8, (1, (IDX       )), (1, (V128)))
+  ON(V128Load16Splat,  16, (1, (IDX       )), (1, (V128)))
+  ON(V128Load32Splat,  32, (1, (IDX       )), (1, (V128)))
+  ON(V128Load64Splat,  64, (1, (IDX       )), (1, (V128)))
+  ON(V128Load8x8S   ,   8, (1, (IDX       )), (1, (V128)))
+  ON(V128Load8x8U   ,   8, (1, (IDX       )), (1, (V128)))
+  ON(V128Load16x4S  ,  16, (1, (IDX       )), (1, (V128)))
+  ON(V128Load16x4U  ,  16, (1, (IDX       )), (1, (V128)))
+  ON(V128Load32x2S  ,  32, (1, (IDX       )), (1, (V128)))
+  ON(V128Load32x2U  ,  32, (1, (IDX       )), (1, (V128)))
+  ON(V128Store      , 128, (1, (IDX , V128)), (0, (    )))
+  // clang-format on
+#undef ON
+// atomic accesses must be naturally aligned, hence the exact alignment
+#define ON(Name, Width, ParamTypes, ResultTypes)                               \
+  ErrorPtr operator()(Name const *Inst) {                                      \
+    auto Memory = Context.memories()[Inst->Memory];                            \
+    if (!Memory.has_value())                                                   \
+      return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);     \
+    if (!isValidOffset(*Memory->getType(), Inst->Offset))                      \
+      return Trace.BuildError(MalformedErrorKind::INVALID_OFFSET);             \
+    auto IDX = Memory->getType()->getIndexType();                              \
+    if (Inst->Align != std::countr_zero(static_cast<unsigned>(Width / 8)))     \
+      return Trace.BuildError(MalformedErrorKind::INVALID_ALIGN);              \
+    auto Parameters = BuildTypesArray(                                         \
+        BOOST_PP_LIST_ENUM(BOOST_PP_ARRAY_TO_LIST(ParamTypes)));               \
+    auto Results = BuildTypesArray(                                            \
+        BOOST_PP_LIST_ENUM(BOOST_PP_ARRAY_TO_LIST(ResultTypes)));              \
+    if (!TypeStack(Parameters, Results)) {                                     \
+      auto Epsilon = TypeStack.getEpsilon();                                   \
+      auto Actuals = TypeStack.recover(Parameters.size());                     \
+      return Trace.BuildError(Epsilon, Parameters, Actuals);                   \
+    }                                                                          \
+    return nullptr;                                                            \
+  }
+  // clang-format off
+  ON(MemoryAtomicNotify  ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(MemoryAtomicWait32  ,  32, (3, (IDX , I32 , I64 )), (1, (I32)))
+  ON(MemoryAtomicWait64  ,  64, (3, (IDX , I64 , I64 )), (1, (I32)))
+  ON(I32AtomicLoad       ,  32, (1, (IDX             )), (1, (I32)))
+  ON(I64AtomicLoad       ,  64, (1, (IDX             )), (1, (I64)))
+  ON(I32AtomicLoad8U     ,   8, (1, (IDX             )), (1, (I32)))
+  ON(I32AtomicLoad16U    ,  16, (1, (IDX             )), (1, (I32)))
+  ON(I64AtomicLoad8U     ,   8, (1, (IDX             )), (1, (I64)))
+  ON(I64AtomicLoad16U    ,  16, (1, (IDX             )), (1, (I64)))
+  ON(I64AtomicLoad32U    ,  32, (1, (IDX             )), (1, (I64)))
+  ON(I32AtomicStore      ,  32, (2, (IDX , I32       )), (0, (   )))
+  ON(I64AtomicStore      ,  64, (2, (IDX , I64       )), (0, (   )))
+  ON(I32AtomicStore8     ,   8, (2, (IDX , I32       )), (0, (   )))
+  ON(I32AtomicStore16    ,  16, (2, (IDX , I32       )), (0, (   )))
+  ON(I64AtomicStore8     ,   8, (2, (IDX , I64       )), (0, (   )))
+  ON(I64AtomicStore16    ,  16, (2, (IDX , I64       )), (0, (   )))
+  ON(I64AtomicStore32    ,  32, (2, (IDX , I64       )), (0, (   )))
+  ON(I32AtomicRmwAdd     ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmwAdd     ,  64, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmw8AddU   ,   8, (2, (IDX , I32       )), (1, (I32)))
+  ON(I32AtomicRmw16AddU  ,  16, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmw8AddU   ,   8, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw16AddU  ,  16, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw32AddU  ,  32, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmwSub     ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmwSub     ,  64, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmw8SubU   ,   8, (2, (IDX , I32       )), (1, (I32)))
+  ON(I32AtomicRmw16SubU  ,  16, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmw8SubU   ,   8, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw16SubU  ,  16, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw32SubU  ,  32, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmwAnd     ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmwAnd     ,  64, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmw8AndU   ,   8, (2, (IDX , I32       )), (1, (I32)))
+  ON(I32AtomicRmw16AndU  ,  16, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmw8AndU   ,   8, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw16AndU  ,  16, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw32AndU  ,  32, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmwOr      ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmwOr      ,  64, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmw8OrU    ,   8, (2, (IDX , I32       )), (1, (I32)))
+  ON(I32AtomicRmw16OrU   ,  16, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmw8OrU    ,   8, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw16OrU   ,  16, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw32OrU   ,  32, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmwXor     ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmwXor     ,  64, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmw8XorU   ,   8, (2, (IDX , I32       )), (1, (I32)))
+  ON(I32AtomicRmw16XorU  ,  16, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmw8XorU   ,   8, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw16XorU  ,  16, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw32XorU  ,  32, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmwXchg    ,  32, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmwXchg    ,  64, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmw8XchgU  ,   8, (2, (IDX , I32       )), (1, (I32)))
+  ON(I32AtomicRmw16XchgU ,  16, (2, (IDX , I32       )), (1, (I32)))
+  ON(I64AtomicRmw8XchgU  ,   8, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw16XchgU ,  16, (2, (IDX , I64       )), (1, (I64)))
+  ON(I64AtomicRmw32XchgU ,  32, (2, (IDX , I64       )), (1, (I64)))
+  ON(I32AtomicRmwCmpxchg ,  32, (3, (IDX , I32 , I32 )), (1, (I32)))
+  ON(I64AtomicRmwCmpxchg ,  64, (3, (IDX , I64 , I64 )), (1, (I64)))
+  ON(I32AtomicRmw8CmpxchgU,   8, (3, (IDX , I32 , I32 )), (1, (I32)))
+  ON(I32AtomicRmw16CmpxchgU,  16, (3, (IDX , I32 , I32 )), (1, (I32)))
+  ON(I64AtomicRmw8CmpxchgU,   8, (3, (IDX , I64 , I64 )), (1, (I64)))
+  ON(I64AtomicRmw16CmpxchgU,  16, (3, (IDX , I64 , I64 )), (1, (I64)))
+  ON(I64AtomicRmw32CmpxchgU,  32, (3, (IDX , I64 , I64 )), (1, (I64)))
   // clang-format on
 #undef ON
 #define ON(Name, Width, ParamTypes, ResultTypes)                               \
@@ -825,9 +945,12 @@ public:
     unsigned MaxLaneIndex = 128 / Width;                                       \
     if (!(static_cast<unsigned>(Inst->Index) < MaxLaneIndex))                  \
       return Trace.BuildError(MalformedErrorKind::SIMD_INVALID_LANE_ID);       \
-    auto Memory = Context.memories()[static_cast<MemIDX>(0)];                  \
+    auto Memory = Context.memories()[Inst->Memory];                            \
     if (!Memory.has_value())                                                   \
       return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);     \
+    if (!isValidOffset(*Memory->getType(), Inst->Offset))                      \
+      return Trace.BuildError(MalformedErrorKind::INVALID_OFFSET);             \
+    auto IDX = Memory->getType()->getIndexType();                              \
     if (!(Inst->Align <= std::countr_zero(static_cast<unsigned>(Width)) + 1))  \
       return Trace.BuildError(MalformedErrorKind::INVALID_ALIGN);              \
     auto Parameters = BuildTypesArray(                                         \
@@ -842,14 +965,14 @@ public:
     return nullptr;                                                            \
   }
   // clang-format off
-  ON(V128Load8Lane  ,  8, (1, (I32, V128)), (1, (V128)))
-  ON(V128Load16Lane , 16, (1, (I32, V128)), (1, (V128)))
-  ON(V128Load32Lane , 32, (1, (I32, V128)), (1, (V128)))
-  ON(V128Load64Lane , 64, (1, (I32, V128)), (1, (V128)))
-  ON(V128Store8Lane ,  8, (1, (I32, V128)), (0, (    )))
-  ON(V128Store16Lane, 16, (1, (I32, V128)), (0, (    )))
-  ON(V128Store32Lane, 32, (1, (I32, V128)), (0, (    )))
-  ON(V128Store64Lane, 64, (1, (I32, V128)), (0, (    )))
+  ON(V128Load8Lane  ,  8, (1, (IDX, V128)), (1, (V128)))
+  ON(V128Load16Lane , 16, (1, (IDX, V128)), (1, (V128)))
+  ON(V128Load32Lane , 32, (1, (IDX, V128)), (1, (V128)))
+  ON(V128Load64Lane , 64, (1, (IDX, V128)), (1, (V128)))
+  ON(V128Store8Lane ,  8, (1, (IDX, V128)), (0, (    )))
+  ON(V128Store16Lane, 16, (1, (IDX, V128)), (0, (    )))
+  ON(V128Store32Lane, 32, (1, (IDX, V128)), (0, (    )))
+  ON(V128Store64Lane, 64, (1, (IDX, V128)), (0, (    )))
   // clang-format on
 #undef ON
 
@@ -865,11 +988,19 @@ public:
   ErrorPtr operator()(BrTable const *);
   ErrorPtr operator()(Call const *);
   ErrorPtr operator()(CallIndirect const *);
+  ErrorPtr operator()(ReturnCall const *);
+  ErrorPtr operator()(ReturnCallIndirect const *);
   ErrorPtr operator()(LocalGet const *);
   ErrorPtr operator()(LocalSet const *);
   ErrorPtr operator()(LocalTee const *);
   ErrorPtr operator()(GlobalGet const *);
   ErrorPtr operator()(GlobalSet const *);
+  ErrorPtr operator()(MemorySize const *);
+  ErrorPtr operator()(MemoryGrow const *);
+  ErrorPtr operator()(MemoryInit const *);
+  ErrorPtr operator()(DataDrop const *);
+  ErrorPtr operator()(MemoryCopy const *);
+  ErrorPtr operator()(MemoryFill const *);
 
 private:
   ErrorPtr validateBlockResult(BlockResultType const &Type);
@@ -1148,10 +1279,10 @@ ErrorPtr ExprValidationVisitor<T>::operator()(Call const *Inst) {
 
 template <validation_context T>
 ErrorPtr ExprValidationVisitor<T>::operator()(CallIndirect const *Inst) {
-  //  C.tables[0] = limits funcref    C.types[x] = [t1*] -> [t2*]
+  //  C.tables[y] = limits funcref    C.types[x] = [t1*] -> [t2*]
   // -------------------------------------------------------------
-  //         C |- call_indirect x: [t1* i32] -> [t2*]
-  auto Table = Context.tables()[static_cast<TableIDX>(0)];
+  //        C |- call_indirect x y: [t1* i32] -> [t2*]
+  auto Table = Context.tables()[Inst->Table];
   if (!Table.has_value())
     return Trace.BuildError(MalformedErrorKind::TABLE_INDEX_OUT_OF_BOUND);
   auto Type = Context.types()[Inst->Type];
@@ -1169,6 +1300,60 @@ ErrorPtr ExprValidationVisitor<T>::operator()(CallIndirect const *Inst) {
   return nullptr;
 }
 
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(ReturnCall const *Inst) {
+  //  C.funcs[x] = [t1*] -> [t2*]    C.return = [t2*]
+  // --------------------------------------------------
+  //     C |- return_call x: [t3* t1*] -> [t4*]
+  auto Function = Context.functions()[Inst->Target];
+  if (!Function.has_value())
+    return Trace.BuildError(MalformedErrorKind::FUNC_INDEX_OUT_OF_BOUND);
+  if (!Context.hasReturn())
+    return Trace.BuildError(MalformedErrorKind::MISSING_CONTEXT_RETURN);
+  auto Parameters = (*Function).getType() /* FunctionType * */->getParamTypes();
+  auto Results = (*Function).getType() /* FunctionType * */->getResultTypes();
+  if (!rangeEqual(Results, Context.return_()))
+    return Trace.BuildError(MalformedErrorKind::INVALID_TAIL_CALL_RESULT);
+  if (!TypeStack(Parameters, BuildTypesArray())) {
+    auto Epsilon = TypeStack.getEpsilon();
+    auto Actual = TypeStack.recover(ranges::size(Parameters));
+    return Trace.BuildError(Epsilon, Parameters, Actual);
+  }
+  TypeStack.clear();
+  TypeStack.setEpsilon();
+  return nullptr;
+}
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(ReturnCallIndirect const *Inst) {
+  //  C.tables[y] = limits funcref
+  //  C.types[x] = [t1*] -> [t2*]    C.return = [t2*]
+  // -------------------------------------------------------
+  //  C |- return_call_indirect x y: [t3* t1* i32] -> [t4*]
+  auto Table = Context.tables()[Inst->Table];
+  if (!Table.has_value())
+    return Trace.BuildError(MalformedErrorKind::TABLE_INDEX_OUT_OF_BOUND);
+  auto Type = Context.types()[Inst->Type];
+  if (!Type.has_value())
+    return Trace.BuildError(MalformedErrorKind::TYPE_INDEX_OUT_OF_BOUND);
+  if (!Context.hasReturn())
+    return Trace.BuildError(MalformedErrorKind::MISSING_CONTEXT_RETURN);
+  auto Parameters = (*Type) /* FunctionType * */->getParamTypes();
+  auto Results = (*Type) /* FunctionType * */->getResultTypes();
+  if (!rangeEqual(Results, Context.return_()))
+    return Trace.BuildError(MalformedErrorKind::INVALID_TAIL_CALL_RESULT);
+  auto CallIndirectParameters =
+      ranges::views::concat(Parameters, ranges::views::single(I32));
+  if (!TypeStack(CallIndirectParameters, BuildTypesArray())) {
+    auto Epsilon = TypeStack.getEpsilon();
+    auto Actual = TypeStack.recover(ranges::size(CallIndirectParameters));
+    return Trace.BuildError(Epsilon, CallIndirectParameters, Actual);
+  }
+  TypeStack.clear();
+  TypeStack.setEpsilon();
+  return nullptr;
+}
+
 template <validation_context T>
 ErrorPtr ExprValidationVisitor<T>::operator()(LocalGet const *Inst) {
   //       C.locals[x] = t
@@ -1253,6 +1438,108 @@ ErrorPtr ExprValidationVisitor<T>::operator()(GlobalSet const *Inst) {
   }
   return nullptr;
 }
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(MemorySize const *Inst) {
+  //      C.mems[x] = limits idx
+  // -----------------------------------
+  //  C |- memory.size x: [] -> [idx]
+  auto Memory = Context.memories()[Inst->Memory];
+  if (!Memory.has_value())
+    return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);
+  auto AlwaysSuccessful = TypeStack(
+      BuildTypesArray(), BuildTypesArray(Memory->getType()->getIndexType()));
+  assert(AlwaysSuccessful);
+  utility::ignore(AlwaysSuccessful);
+  return nullptr;
+}
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(MemoryGrow const *Inst) {
+  //        C.mems[x] = limits idx
+  // -------------------------------------
+  //  C |- memory.grow x: [idx] -> [idx]
+  auto Memory = Context.memories()[Inst->Memory];
+  if (!Memory.has_value())
+    return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);
+  auto IDX = Memory->getType()->getIndexType();
+  auto Parameters = BuildTypesArray(IDX);
+  if (!TypeStack(Parameters, BuildTypesArray(IDX))) {
+    auto Epsilon = TypeStack.getEpsilon();
+    auto Actual = TypeStack.recover(Parameters.size());
+    return Trace.BuildError(Epsilon, Parameters, Actual);
+  }
+  return nullptr;
+}
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(MemoryInit const *Inst) {
+  //   C.mems[y] = limits    C.datas[x] = ok
+  // ---------------------------------------------
+  //  C |- memory.init x y: [idx i32 i32] -> []
+  auto Memory = Context.memories()[Inst->Memory];
+  if (!Memory.has_value())
+    return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);
+  if (!Context.data()[Inst->Segment].has_value())
+    return Trace.BuildError(MalformedErrorKind::DATA_INDEX_OUT_OF_BOUND);
+  auto IDX = Memory->getType()->getIndexType();
+  auto Parameters = BuildTypesArray(IDX, I32, I32);
+  if (!TypeStack(Parameters, BuildTypesArray())) {
+    auto Epsilon = TypeStack.getEpsilon();
+    auto Actual = TypeStack.recover(Parameters.size());
+    return Trace.BuildError(Epsilon, Parameters, Actual);
+  }
+  return nullptr;
+}
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(DataDrop const *Inst) {
+  //        C.datas[x] = ok
+  // ------------------------------
+  //  C |- data.drop x: [] -> []
+  if (!Context.data()[Inst->Segment].has_value())
+    return Trace.BuildError(MalformedErrorKind::DATA_INDEX_OUT_OF_BOUND);
+  return nullptr;
+}
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(MemoryCopy const *Inst) {
+  //   C.mems[x] = limits idx_x    C.mems[y] = limits idx_y
+  // -----------------------------------------------------------
+  //  C |- memory.copy x y: [idx_x idx_y min(idx_x, idx_y)] -> []
+  auto Destination = Context.memories()[Inst->Destination];
+  auto Source = Context.memories()[Inst->Source];
+  if (!Destination.has_value() || !Source.has_value())
+    return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);
+  auto DestinationIDX = Destination->getType()->getIndexType();
+  auto SourceIDX = Source->getType()->getIndexType();
+  auto SizeIDX = (DestinationIDX == I64) && (SourceIDX == I64) ? I64 : I32;
+  auto Parameters = BuildTypesArray(DestinationIDX, SourceIDX, SizeIDX);
+  if (!TypeStack(Parameters, BuildTypesArray())) {
+    auto Epsilon = TypeStack.getEpsilon();
+    auto Actual = TypeStack.recover(Parameters.size());
+    return Trace.BuildError(Epsilon, Parameters, Actual);
+  }
+  return nullptr;
+}
+
+template <validation_context T>
+ErrorPtr ExprValidationVisitor<T>::operator()(MemoryFill const *Inst) {
+  //         C.mems[x] = limits idx
+  // -----------------------------------------
+  //  C |- memory.fill x: [idx i32 idx] -> []
+  auto Memory = Context.memories()[Inst->Memory];
+  if (!Memory.has_value())
+    return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);
+  auto IDX = Memory->getType()->getIndexType();
+  auto Parameters = BuildTypesArray(IDX, I32, IDX);
+  if (!TypeStack(Parameters, BuildTypesArray())) {
+    auto Epsilon = TypeStack.getEpsilon();
+    auto Actual = TypeStack.recover(Parameters.size());
+    return Trace.BuildError(Epsilon, Parameters, Actual);
+  }
+  return nullptr;
+}
 } // namespace
 
 //////////////////////////////// TraceCollector ////////////////////////////////
@@ -1544,17 +1831,21 @@ validateData(TraceCollector &Trace, ModuleView const &MView, Module const &M) {
   auto EnumerateView = ranges::views::enumerate(M.Data);
   for (auto const &[Index, Data] : EnumerateView) {
     Trace.enterData(Index);
+    if (Data.Mode == entities::DataMode::Passive) continue;
     if (!MView.get(Data.Memory).has_value())
       return Trace.BuildError(MalformedErrorKind::MEM_INDEX_OUT_OF_BOUND);
     ExprValidationContext Context(MView);
     ExprValidationVisitor<decltype(Context)> ETypeVisitor(Context, Trace);
     std::array<ValueType, 0> Parameters{};
-    std::array<ValueType, 1> Results{I32};
+    std::array<ValueType, 1> Results{
+        MView.get(Data.Memory)->getType()->getIndexType()};
     if (auto Error = ETypeVisitor(Data.Offset, Parameters, Results))
       return Error;
     if (!isConstExpr(MView, Data.Offset))
       return Trace.BuildError(MalformedErrorKind::NON_CONST_EXPRESSION);
   }
+  if (M.DataCount.has_value() && (*M.DataCount != M.Data.size()))
+    return Trace.BuildError(MalformedErrorKind::DATA_COUNT_MISMATCH);
   return nullptr;
 }
 
@@ -1597,15 +1888,6 @@ ErrorPtr validate(Module const &M) {
   if (auto Error = validateData(Trace, MView, M)) return Error;
   if (auto Error = validateStart(Trace, MView, M)) return Error;
 
-  if (ranges::size(MView.tables()) > 1) {
-    Trace.enterTable(1);
-    return Trace.BuildError(MalformedErrorKind::MORE_THAN_ONE_TABLE);
-  }
-  if (ranges::size(MView.memories()) > 1) {
-    Trace.enterMemory(1);
-    return Trace.BuildError(MalformedErrorKind::MORE_THAN_ONE_MEMORY);
-  }
-
   std::unordered_set<std::string_view> ExportNames;
   for (auto const &[Index, Export] : ranges::views::enumerate(M.Exports)) {
     Trace.enterExport(Index);
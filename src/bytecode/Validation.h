@@ -113,13 +113,15 @@ public:
   X(MEM_INDEX_OUT_OF_BOUND    , "memory index out-of-bound"                 )  \
   X(LOCAL_INDEX_OUT_OF_BOUND  , "local index out-of-bound"                  )  \
   X(GLOBAL_INDEX_OUT_OF_BOUND , "global index out-of-bound"                 )  \
+  X(DATA_INDEX_OUT_OF_BOUND   , "data segment index out-of-bound"           )  \
+  X(DATA_COUNT_MISMATCH       , "data count does not match data section"    )  \
   X(INVALID_BRANCH_TABLE      , "label types in branch table do not agree"  )  \
+  X(INVALID_TAIL_CALL_RESULT  , "tail callee results do not match return"   )  \
   X(INVALID_ALIGN             , "malformed alignment hint"                  )  \
+  X(INVALID_OFFSET            , "offset exceeds the memory index type"      )  \
   X(GLOBAL_MUST_BE_MUT        , "global is not mutable"                     )  \
   X(NON_CONST_EXPRESSION      , "expression is not constant"                )  \
   X(INVALID_START_FUNC_TYPE   , "start function has mismatched type"        )  \
-  X(MORE_THAN_ONE_TABLE       , "at most one table is allowed"              )  \
-  X(MORE_THAN_ONE_MEMORY      , "at most one memory is allowed"             )  \
   X(NON_UNIQUE_EXPORT_NAME    , "export name is not unique"                 )  \
   X(ILLEGAL_IF_BLOCK_TYPE_TAG , "if without else cannot have type signature")  \
   X(SIMD_INVALID_LANE_ID      , "simd instruction refers to invalid lane"   )
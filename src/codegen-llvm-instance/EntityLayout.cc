@@ -8,6 +8,7 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Type.h>
 
 #include <range/v3/range/conversion.hpp>
@@ -16,9 +17,11 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <limits>
 
 #define INSTANCE_ENTITY_START_OFFSET 4
+#define WEBASSEMBLY_PAGE_SIZE (64 * 1024)
 
 namespace codegen::llvm_instance {
 
@@ -64,38 +67,57 @@ void EntityLayout::setupInstanceType() {
   InstanceFields.push_back(llvm::PointerType::getUnqual(FunctionMetadataTy));
   assert(InstanceFields.size() == INSTANCE_ENTITY_START_OFFSET);
 
+  auto getNextOffset = [&]() {
+    return InstanceFields.size() - INSTANCE_ENTITY_START_OFFSET;
+  };
+
+  // Each memory instance pointer is followed by the memory size in bytes,
+  // kept up-to-date by the runtime, for inline boundary checks.
   auto *MemoryOpaqueTy = declareOpaqueTy("__sable_memory_t");
   auto *MemoryOpaquePtrTy = llvm::PointerType::getUnqual(MemoryOpaqueTy);
   for (auto const &Memory : Source.getMemories().asView()) {
-    OffsetMap.insert(std::make_pair(std::addressof(Memory), OffsetMap.size()));
+    OffsetMap.insert(std::make_pair(std::addressof(Memory), getNextOffset()));
     InstanceFields.push_back(MemoryOpaquePtrTy);
+    InstanceFields.push_back(ModuleIRBuilder.getIntPtrTy());
   }
 
   auto *TableOpaqueTy = declareOpaqueTy("__sable_table_t");
   auto *TableOpaquePtrTy = llvm::PointerType::getUnqual(TableOpaqueTy);
+  auto *TableEntryTy = createNamedStructTy("__sable_table_entry_t");
   for (auto const &Table : Source.getTables().asView()) {
-    OffsetMap.insert(std::make_pair(std::addressof(Table), OffsetMap.size()));
+    OffsetMap.insert(std::make_pair(std::addressof(Table), getNextOffset()));
     InstanceFields.push_back(TableOpaquePtrTy);
   }
 
   auto *GlobalOpaqueTy = declareOpaqueTy("__sable_global_t");
   auto *GlobalOpaquePtrTy = llvm::PointerType::getUnqual(GlobalOpaqueTy);
   for (auto const &Global : Source.getGlobals().asView()) {
-    OffsetMap.insert(std::make_pair(std::addressof(Global), OffsetMap.size()));
+    OffsetMap.insert(std::make_pair(std::addressof(Global), getNextOffset()));
     InstanceFields.push_back(GlobalOpaquePtrTy);
   }
 
-  auto FunctionIndex = OffsetMap.size();
   auto *FunctionOpaqueTy = declareOpaqueTy("__sable_function_t");
   auto *FunctionOpaquePtrTy = llvm::PointerType::getUnqual(FunctionOpaqueTy);
   for (auto const &Function : Source.getFunctions().asView()) {
     auto *FunctionAddress = std::addressof(Function);
-    OffsetMap.insert(std::make_pair(FunctionAddress, FunctionIndex));
+    OffsetMap.insert(std::make_pair(FunctionAddress, getNextOffset()));
     InstanceFields.push_back(llvm::PointerType::getUnqual(InstanceTy));
     InstanceFields.push_back(FunctionOpaquePtrTy);
-    FunctionIndex = FunctionIndex + 2;
   }
 
+  // Remaining length in bytes of each data segment, zero once dropped.
+  // memory.init reads it for the segment boundary check.
+  for (auto const &DataSegment : Source.getData().asView()) {
+    auto *DataAddress = std::addressof(DataSegment);
+    OffsetMap.insert(std::make_pair(DataAddress, getNextOffset()));
+    InstanceFields.push_back(ModuleIRBuilder.getIntPtrTy());
+  }
+
+  TableEntryTy->setBody(
+      {/* ContextPtr  */ llvm::PointerType::getUnqual(InstanceTy),
+       /* FunctionPtr */ FunctionOpaquePtrTy,
+       /* SignatureID */ ModuleIRBuilder.getInt32Ty()});
+
   InstanceTy->setBody(InstanceFields);
 }
 
@@ -127,6 +149,13 @@ struct InitExprTranslationVisitor :
     return GlobalValue;
   }
 };
+
+// constant data segment offsets are i32 or i64 following the memory index type
+std::uint64_t getConstantOffset(mir::initializer::Constant const &Offset) {
+  if (Offset.getValueType().isI64())
+    return static_cast<std::uint64_t>(Offset.asI64());
+  return static_cast<std::uint32_t>(Offset.asI32());
+}
 } // namespace
 
 llvm::Value *EntityLayout::translateInitExpr(
@@ -136,9 +165,109 @@ llvm::Value *EntityLayout::translateInitExpr(
   return Visitor.visit(std::addressof(Expr));
 }
 
+// Lays out the data segments of each defined memory as a single image if
+// all of them have constant in-bound offsets. The runtime maps the image
+// copy-on-write into the linear memory instead of copying the segments on
+// every instantiation.
+// Images are only emitted for in place reservations, exact reservations grow
+// with mremap which cannot move a memory made of several mappings.
+void EntityLayout::setupMemoryImages() {
+  auto &Context = Target.getContext();
+
+  auto *ImageTy = llvm::StructType::get(
+      Context, {/* Index   */ ModuleIRBuilder.getInt32Ty(),
+                /* Offset  */ ModuleIRBuilder.getInt64Ty(),
+                /* Size    */ ModuleIRBuilder.getInt64Ty(),
+                /* Content */ ModuleIRBuilder.getInt8PtrTy()});
+
+  std::vector<llvm::Constant *> Images;
+  for (auto const &[Index, Memory] :
+       ranges::views::enumerate(Source.getMemories().asView())) {
+    auto IsInPlace = Options.UseMemGuardPage || Options.ReserveMemory;
+    if (!IsInPlace || Memory.isImported()) continue;
+    auto MemorySize = std::uint64_t(Memory.getType().getMin());
+    MemorySize = MemorySize * WEBASSEMBLY_PAGE_SIZE;
+    auto ImageStart = std::numeric_limits<std::uint64_t>::max();
+    auto ImageEnd = std::uint64_t(0);
+    auto IsStatic = true;
+    for (auto const *DataSegment : Memory.getInitializers()) {
+      auto const *Offset = DataSegment->getOffset();
+      if (!mir::is_a<mir::initializer::Constant>(Offset)) {
+        IsStatic = false;
+        break;
+      }
+      auto Start = getConstantOffset(
+          *mir::dyn_cast<mir::initializer::Constant>(Offset));
+      // out of bound segments trap at instantiation, keep them dynamic
+      if ((Start > MemorySize) ||
+          (DataSegment->getSize() > MemorySize - Start)) {
+        IsStatic = false;
+        break;
+      }
+      if (DataSegment->getSize() == 0) continue;
+      ImageStart = std::min(ImageStart, Start);
+      ImageEnd = std::max(ImageEnd, Start + DataSegment->getSize());
+    }
+    if (!IsStatic || (ImageEnd == 0)) continue;
+    ImageStart = ImageStart - ImageStart % WEBASSEMBLY_PAGE_SIZE;
+
+    // later segments overwrite earlier ones, as the initializer would do
+    std::vector<char> Content(ImageEnd - ImageStart, 0);
+    for (auto const *DataSegment : Memory.getInitializers()) {
+      auto const *Offset = DataSegment->getOffset();
+      auto Start = getConstantOffset(
+          *mir::dyn_cast<mir::initializer::Constant>(Offset));
+      auto ByteView = DataSegment->getContent();
+      std::transform(
+          ByteView.begin(), ByteView.end(),
+          std::next(Content.begin(), Start - ImageStart),
+          [](std::byte Byte) { return static_cast<char>(Byte); });
+      ImagedDataSegments.insert(DataSegment);
+    }
+
+    auto *ContentConstant = llvm::ConstantDataArray::getString(
+        Context, llvm::StringRef(Content.data(), Content.size()), false);
+    auto *ContentGlobal = new llvm::GlobalVariable(
+        /* Parent      */ Target,
+        /* Type        */ ContentConstant->getType(),
+        /* IsConstant  */ true,
+        /* Linkage     */ llvm::GlobalVariable::LinkageTypes::PrivateLinkage,
+        /* Initializer */ ContentConstant,
+        /* Name        */ "memory.image");
+    ContentGlobal->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    auto *ContentPtr = llvm::ConstantExpr::getPointerCast(
+        ContentGlobal, ModuleIRBuilder.getInt8PtrTy());
+    auto *ImageConstant = llvm::ConstantStruct::get(
+        ImageTy, {ModuleIRBuilder.getInt32(Index),
+                  ModuleIRBuilder.getInt64(ImageStart),
+                  ModuleIRBuilder.getInt64(ImageEnd - ImageStart), ContentPtr});
+    Images.push_back(ImageConstant);
+  }
+
+  auto *ImageArray = createArrayGlobal(ImageTy, Images);
+  ImageArray->setName("__sable_memory_image_metadata.images");
+  ImageArray->setUnnamedAddr(llvm::GlobalVariable::UnnamedAddr::Global);
+
+  auto *MetadataTy = createNamedStructTy("__sable_memory_image_metadata_t");
+  MetadataTy->setBody(
+      {/* Size   */ ModuleIRBuilder.getInt32Ty(),
+       /* Images */ ImageArray->getType()});
+  auto *MetadataConstant = llvm::ConstantStruct::get(
+      MetadataTy, {/* Size   */ ModuleIRBuilder.getInt32(Images.size()),
+                   /* Images */ ImageArray});
+  new llvm::GlobalVariable(
+      /* Parent      */ Target,
+      /* Type        */ MetadataTy,
+      /* IsConstant  */ true,
+      /* Linkage     */ llvm::GlobalVariable::ExternalLinkage,
+      /* Initializer */ MetadataConstant,
+      /* Name        */ "__sable_memory_image_metadata");
+}
+
 void EntityLayout::setupDataSegments() {
   auto &Context = Target.getContext();
   for (auto const &DataSegment : Source.getData().asView()) {
+    if (ImagedDataSegments.count(std::addressof(DataSegment))) continue;
     auto ByteView = DataSegment.getContent();
     llvm::StringRef CharView(
         reinterpret_cast<char const *>(ByteView.data()), // NOLINT
@@ -206,6 +335,52 @@ llvm::GlobalVariable *EntityLayout::createArrayGlobal(
   return ElementsGlobal;
 }
 
+template <typename EntityView>
+std::vector<llvm::Constant *> EntityLayout::createImports(
+    llvm::StructType *ImportTy, EntityView const &Entities) {
+  using ImportEntry =
+      std::tuple<std::string_view, std::string_view, std::uint32_t>;
+  std::vector<ImportEntry> Entries;
+  for (auto const &[Index, Entity] : ranges::views::enumerate(Entities)) {
+    if (!Entity.isImported()) continue;
+    Entries.emplace_back(
+        Entity.getImportModuleName(), Entity.getImportEntityName(), Index);
+  }
+  // the runtime locates imports by binary search
+  std::stable_sort(Entries.begin(), Entries.end());
+  std::vector<llvm::Constant *> Imports;
+  Imports.reserve(Entries.size());
+  for (auto const &[ModuleName, EntityName, Index] : Entries) {
+    auto *ImportConstant = llvm::ConstantStruct::get(
+        ImportTy, {ModuleIRBuilder.getInt32(Index),
+                   ModuleIRBuilder.getCStr(ModuleName),
+                   ModuleIRBuilder.getCStr(EntityName)});
+    Imports.push_back(ImportConstant);
+  }
+  return Imports;
+}
+
+template <typename EntityView>
+std::vector<llvm::Constant *> EntityLayout::createExports(
+    llvm::StructType *ExportTy, EntityView const &Entities) {
+  std::vector<std::pair<std::string_view, std::uint32_t>> Entries;
+  for (auto const &[Index, Entity] : ranges::views::enumerate(Entities)) {
+    if (!Entity.isExported()) continue;
+    Entries.emplace_back(Entity.getExportName(), Index);
+  }
+  // export names are unique, the runtime looks them up by binary search
+  std::sort(Entries.begin(), Entries.end());
+  std::vector<llvm::Constant *> Exports;
+  Exports.reserve(Entries.size());
+  for (auto const &[Name, Index] : Entries) {
+    auto *ExportConstant = llvm::ConstantStruct::get(
+        ExportTy,
+        {ModuleIRBuilder.getInt32(Index), ModuleIRBuilder.getCStr(Name)});
+    Exports.push_back(ExportConstant);
+  }
+  return Exports;
+}
+
 llvm::GlobalVariable *EntityLayout::createMetadata(
     std::string_view Prefix, std::uint32_t Size, std::uint32_t ImportSize,
     std::uint32_t ExportSize, llvm::GlobalVariable *Signatures,
@@ -248,8 +423,9 @@ void EntityLayout::setupMemoryMetadata() {
   auto &Context = Target.getContext();
 
   auto *SignatureTy = llvm::StructType::get(
-      Context, {/* Min        */ ModuleIRBuilder.getInt32Ty(),
-                /* Max        */ ModuleIRBuilder.getInt32Ty()});
+      Context, {/* Min        */ ModuleIRBuilder.getInt64Ty(),
+                /* Max        */ ModuleIRBuilder.getInt64Ty(),
+                /* Flags      */ ModuleIRBuilder.getInt32Ty()});
   auto *ImportTy = llvm::StructType::get(
       Context, {/* Index      */ ModuleIRBuilder.getInt32Ty(),
                 /* ModuleName */ ModuleIRBuilder.getCStrTy(),
@@ -259,38 +435,31 @@ void EntityLayout::setupMemoryMetadata() {
                 /* Name       */ ModuleIRBuilder.getCStrTy()});
 
   std::vector<llvm::Constant *> Signatures;
-  std::vector<llvm::Constant *> Imports;
-  std::vector<llvm::Constant *> Exports;
+
+  // Flags must stay in sync with runtime::MemoryReservationKind, 0x4 marks
+  // shared memories and 0x8 memory64 ones
+  std::uint32_t ReservationFlags = 0;
+  if (Options.UseMemGuardPage) ReservationFlags = 0x1;
+  else if (Options.ReserveMemory) ReservationFlags = 0x2;
 
   for (auto const &Memory : Source.getMemories().asView()) {
     auto Min = Memory.getType().getMin();
     auto Max = Memory.getType().hasMax()
                    ? Memory.getType().getMax()
-                   : std::numeric_limits<std::uint32_t>::max();
+                   : std::numeric_limits<std::uint64_t>::max();
+    auto Flags = ReservationFlags;
+    if (Memory.getType().isShared()) Flags = Flags | 0x4;
+    if (Memory.getType().isMemory64()) Flags = Flags | 0x8;
     auto *SignatureConstant = llvm::ConstantStruct::get(
         SignatureTy,
-        {ModuleIRBuilder.getInt32(Min), ModuleIRBuilder.getInt32(Max)});
+        {ModuleIRBuilder.getInt64(Min), ModuleIRBuilder.getInt64(Max),
+         ModuleIRBuilder.getInt32(Flags)});
     Signatures.push_back(SignatureConstant);
   }
 
-  for (auto const &[Index, Memory] :
-       ranges::views::enumerate(Source.getMemories().asView())) {
-    if (!Memory.isImported()) continue;
-    auto *ModuleName = ModuleIRBuilder.getCStr(Memory.getImportModuleName());
-    auto *EntityName = ModuleIRBuilder.getCStr(Memory.getImportEntityName());
-    auto *ImportConstant = llvm::ConstantStruct::get(
-        ImportTy, {ModuleIRBuilder.getInt32(Index), ModuleName, EntityName});
-    Imports.push_back(ImportConstant);
-  }
+  auto Imports = createImports(ImportTy, Source.getMemories().asView());
 
-  for (auto const &[Index, Memory] :
-       ranges::views::enumerate(Source.getMemories().asView())) {
-    if (!Memory.isExported()) continue;
-    auto *EntityName = ModuleIRBuilder.getCStr(Memory.getExportName());
-    auto *ExportConstant = llvm::ConstantStruct::get(
-        ExportTy, {ModuleIRBuilder.getInt32(Index), EntityName});
-    Exports.push_back(ExportConstant);
-  }
+  auto Exports = createExports(ExportTy, Source.getMemories().asView());
 
   createMetadata(
       "__sable_memory_metadata",
@@ -315,8 +484,6 @@ void EntityLayout::setupTableMetadata() {
                 /* Name       */ ModuleIRBuilder.getCStrTy()});
 
   std::vector<llvm::Constant *> Signatures;
-  std::vector<llvm::Constant *> Imports;
-  std::vector<llvm::Constant *> Exports;
 
   for (auto const &Table : Source.getTables().asView()) {
     auto Min = Table.getType().getMin();
@@ -329,24 +496,9 @@ void EntityLayout::setupTableMetadata() {
     Signatures.push_back(SignatureConstant);
   }
 
-  for (auto const &[Index, Table] :
-       ranges::views::enumerate(Source.getTables().asView())) {
-    if (!Table.isImported()) continue;
-    auto *ModuleName = ModuleIRBuilder.getCStr(Table.getImportModuleName());
-    auto *EntityName = ModuleIRBuilder.getCStr(Table.getImportEntityName());
-    auto *ImportConstant = llvm::ConstantStruct::get(
-        ImportTy, {ModuleIRBuilder.getInt32(Index), ModuleName, EntityName});
-    Imports.push_back(ImportConstant);
-  }
+  auto Imports = createImports(ImportTy, Source.getTables().asView());
 
-  for (auto const &[Index, Table] :
-       ranges::views::enumerate(Source.getTables().asView())) {
-    if (!Table.isExported()) continue;
-    auto *EntityName = ModuleIRBuilder.getCStr(Table.getExportName());
-    auto *ExportConstant = llvm::ConstantStruct::get(
-        ExportTy, {ModuleIRBuilder.getInt32(Index), EntityName});
-    Exports.push_back(ExportConstant);
-  }
+  auto Exports = createExports(ExportTy, Source.getTables().asView());
 
   createMetadata(
       "__sable_table_metadata",
@@ -368,32 +520,15 @@ void EntityLayout::setupGlobalMetadata() {
                 /* Name       */ ModuleIRBuilder.getCStrTy()});
 
   std::string Signatures;
-  std::vector<llvm::Constant *> Imports;
-  std::vector<llvm::Constant *> Exports;
 
   for (auto const &Global : Source.getGlobals().asView()) {
     auto Signature = getSignature(Global.getType());
     Signatures.push_back(Signature);
   }
 
-  for (auto const &[Index, Global] :
-       ranges::views::enumerate(Source.getGlobals().asView())) {
-    if (!Global.isImported()) continue;
-    auto *ModuleName = ModuleIRBuilder.getCStr(Global.getImportModuleName());
-    auto *EntityName = ModuleIRBuilder.getCStr(Global.getImportEntityName());
-    auto *ImportConstant = llvm::ConstantStruct::get(
-        ImportTy, {ModuleIRBuilder.getInt32(Index), ModuleName, EntityName});
-    Imports.push_back(ImportConstant);
-  }
+  auto Imports = createImports(ImportTy, Source.getGlobals().asView());
 
-  for (auto const &[Index, Global] :
-       ranges::views::enumerate(Source.getGlobals().asView())) {
-    if (!Global.isExported()) continue;
-    auto *EntityName = ModuleIRBuilder.getCStr(Global.getExportName());
-    auto *ExportConstant = llvm::ConstantStruct::get(
-        ExportTy, {ModuleIRBuilder.getInt32(Index), EntityName});
-    Exports.push_back(ExportConstant);
-  }
+  auto Exports = createExports(ExportTy, Source.getGlobals().asView());
 
   llvm::Constant *SignaturesConstant =
       llvm::ConstantDataArray::getString(Context, Signatures, false);
@@ -426,30 +561,13 @@ void EntityLayout::setupFunctionMetadata() {
                 /* Name       */ ModuleIRBuilder.getCStrTy()});
 
   std::vector<llvm::Constant *> Signatures;
-  std::vector<llvm::Constant *> Imports;
-  std::vector<llvm::Constant *> Exports;
 
   for (auto const &Function : Source.getFunctions().asView())
     Signatures.push_back(this->operator[](Function).signature());
 
-  for (auto const &[Index, Function] :
-       ranges::views::enumerate(Source.getFunctions().asView())) {
-    if (!Function.isImported()) continue;
-    auto *ModuleName = ModuleIRBuilder.getCStr(Function.getImportModuleName());
-    auto *EntityName = ModuleIRBuilder.getCStr(Function.getImportEntityName());
-    auto *ImportConstant = llvm::ConstantStruct::get(
-        ImportTy, {ModuleIRBuilder.getInt32(Index), ModuleName, EntityName});
-    Imports.push_back(ImportConstant);
-  }
+  auto Imports = createImports(ImportTy, Source.getFunctions().asView());
 
-  for (auto const &[Index, Function] :
-       ranges::views::enumerate(Source.getFunctions().asView())) {
-    if (!Function.isExported()) continue;
-    auto *EntityName = ModuleIRBuilder.getCStr(Function.getExportName());
-    auto *ExportConstant = llvm::ConstantStruct::get(
-        ExportTy, {ModuleIRBuilder.getInt32(Index), EntityName});
-    Exports.push_back(ExportConstant);
-  }
+  auto Exports = createExports(ExportTy, Source.getFunctions().asView());
 
   createMetadata(
       "__sable_function_metadata",
@@ -459,6 +577,79 @@ void EntityLayout::setupFunctionMetadata() {
       /* Exports  */ createArrayGlobal(ExportTy, Exports));
 }
 
+void EntityLayout::setupSignatureMetadata() {
+  std::vector<llvm::Constant *> Signatures;
+  for (auto const &Function : Source.getFunctions().asView())
+    for (auto const &BasicBlock : Function.getBasicBlocks().asView())
+      for (auto const &Instruction : BasicBlock) {
+        if (!mir::is_a<mir::instructions::CallIndirect>(Instruction)) continue;
+        auto const &CallIndirect =
+            mir::dyn_cast<mir::instructions::CallIndirect>(Instruction);
+        auto Signature = getSignature(CallIndirect.getExpectType());
+        auto NextSlot = static_cast<std::uint32_t>(Signatures.size());
+        if (!SignatureSlots.try_emplace(Signature, NextSlot).second) continue;
+        Signatures.push_back(ModuleIRBuilder.getCStr(Signature, "signature"));
+      }
+
+  auto *SignatureIDArrayTy =
+      llvm::ArrayType::get(ModuleIRBuilder.getInt32Ty(), Signatures.size());
+  SignatureIDs = new llvm::GlobalVariable(
+      /* Parent      */ Target,
+      /* Type        */ SignatureIDArrayTy,
+      /* IsConstant  */ false,
+      /* Linkage     */ llvm::GlobalVariable::LinkageTypes::PrivateLinkage,
+      /* Initializer */ llvm::ConstantAggregateZero::get(SignatureIDArrayTy),
+      /* Name        */ "__sable_signature_metadata.ids");
+  auto *SignatureArray =
+      createArrayGlobal(ModuleIRBuilder.getCStrTy(), Signatures);
+  SignatureArray->setName("__sable_signature_metadata.signatures");
+  SignatureArray->setUnnamedAddr(llvm::GlobalVariable::UnnamedAddr::Global);
+
+  auto *MetadataTy = createNamedStructTy("__sable_signature_metadata_t");
+  MetadataTy->setBody(
+      {/* Size         */ ModuleIRBuilder.getInt32Ty(),
+       /* Signatures   */ SignatureArray->getType(),
+       /* SignatureIDs */ SignatureIDs->getType()});
+  auto *MetadataConstant = llvm::ConstantStruct::get(
+      MetadataTy,
+      {/* Size         */ ModuleIRBuilder.getInt32(Signatures.size()),
+       /* Signatures   */ SignatureArray,
+       /* SignatureIDs */ SignatureIDs});
+  new llvm::GlobalVariable(
+      /* Parent      */ Target,
+      /* Type        */ MetadataTy,
+      /* IsConstant  */ true,
+      /* Linkage     */ llvm::GlobalVariable::ExternalLinkage,
+      /* Initializer */ MetadataConstant,
+      /* Name        */ "__sable_signature_metadata");
+}
+
+// Initial length of each data segment, the runtime checks restored lengths
+// against it
+void EntityLayout::setupDataMetadata() {
+  std::vector<llvm::Constant *> Sizes;
+  for (auto const &DataSegment : Source.getData().asView())
+    Sizes.push_back(ModuleIRBuilder.getInt64(DataSegment.getSize()));
+  auto *SizeArray = createArrayGlobal(ModuleIRBuilder.getInt64Ty(), Sizes);
+  SizeArray->setName("__sable_data_metadata.sizes");
+  SizeArray->setUnnamedAddr(llvm::GlobalVariable::UnnamedAddr::Global);
+
+  auto *MetadataTy = createNamedStructTy("__sable_data_metadata_t");
+  MetadataTy->setBody(
+      {/* Size  */ ModuleIRBuilder.getInt32Ty(),
+       /* Sizes */ SizeArray->getType()});
+  auto *MetadataConstant = llvm::ConstantStruct::get(
+      MetadataTy, {/* Size  */ ModuleIRBuilder.getInt32(Sizes.size()),
+                   /* Sizes */ SizeArray});
+  new llvm::GlobalVariable(
+      /* Parent      */ Target,
+      /* Type        */ MetadataTy,
+      /* IsConstant  */ true,
+      /* Linkage     */ llvm::GlobalVariable::ExternalLinkage,
+      /* Initializer */ MetadataConstant,
+      /* Name        */ "__sable_data_metadata");
+}
+
 void EntityLayout::setupFunctions() {
   for (auto const &[Index, Function] :
        ranges::views::enumerate(Source.getFunctions().asView())) {
@@ -471,6 +662,10 @@ void EntityLayout::setupFunctions() {
         /* Linkage */ llvm::GlobalVariable::PrivateLinkage,
         /* Name    */ llvm::StringRef(Function.getName()),
         /* Parent  */ Target);
+    // Guard page traps are raised from arbitrary load/store instructions,
+    // asynchronous unwind tables are required to unwind through them.
+    if (Options.UseMemGuardPage)
+      Definition->addFnAttr(llvm::Attribute::AttrKind::UWTable);
     FunctionMap.insert(std::make_pair(
         std::addressof(Function),
         FunctionEntry(Index, Definition, SignatureStr)));
@@ -498,7 +693,9 @@ void EntityLayout::setupFunctions() {
       auto *CalleeTy = convertType(Function.getType());
       llvm::FunctionCallee Callee(CalleeTy, FunctionPtr);
       auto *ForwardResult = Builder.CreateCall(Callee, Arguments);
-      if (Function.getType().isVoidResult()) {
+      // same prototype, tail calls to imports do not grow the stack either
+      ForwardResult->setTailCallKind(llvm::CallInst::TCK_MustTail);
+      if (CalleeTy->getReturnType()->isVoidTy()) {
         Builder.CreateRetVoid();
       } else {
         Builder.CreateRet(ForwardResult);
@@ -507,39 +704,47 @@ void EntityLayout::setupFunctions() {
   }
 }
 
+// Data segments are copied by __sable_initialize_memory, which runs before
+// __sable_initialize. Instances restored from a snapshot skip the former.
 void EntityLayout::setupInitializer() {
   auto &Context = Target.getContext();
 
   auto *InitializerTy = llvm::FunctionType::get(
       ModuleIRBuilder.getVoidTy(), {getInstancePtrTy()}, false);
+  auto *MemoryInitializerFn = llvm::Function::Create(
+      /* Type    */ InitializerTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_initialize_memory",
+      /* Parent  */ Target);
   auto *InitializerFn = llvm::Function::Create(
       /* Type    */ InitializerTy,
       /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
       /* Name    */ "__sable_initialize",
       /* Parent  */ Target);
 
-  auto *EntryBasicBlock =
-      llvm::BasicBlock::Create(Context, "entry", InitializerFn);
-
-  IRBuilder Builder(*EntryBasicBlock);
-
-  auto *InstancePtr = InitializerFn->getArg(0);
+  IRBuilder Builder(
+      *llvm::BasicBlock::Create(Context, "entry", MemoryInitializerFn));
+  auto *InstancePtr = MemoryInitializerFn->getArg(0);
 
   for (auto const &Memory : Source.getMemories().asView()) {
     for (auto const *DataSegment : Memory.getInitializers()) {
+      if (ImagedDataSegments.count(DataSegment)) continue;
       auto *Data = this->operator[](*DataSegment);
       auto *MemoryInstance = get(Builder, InstancePtr, Memory);
       llvm::Value *Offset =
           translateInitExpr(Builder, InstancePtr, *DataSegment->getOffset());
 
+      // the end of the segment saturates instead of wrapping around
+      Offset = Builder.CreateZExtOrTrunc(Offset, Builder.getIntPtrTy());
       if (!Options.SkipMemBoundaryCheck) {
+        auto *SegmentSize = llvm::ConstantInt::get(
+            Builder.getIntPtrTy(), DataSegment->getSize());
         auto *GuardAddress =
-            Builder.CreateAdd(Offset, Builder.getInt32(DataSegment->getSize()));
+            Builder.CreateIntrinsicAddSatU(Offset, SegmentSize);
         Builder.CreateCall(
             getBuiltin("__sable_memory_guard"), {MemoryInstance, GuardAddress});
       }
 
-      Offset = Builder.CreateZExtOrTrunc(Offset, Builder.getIntPtrTy());
       llvm::Value *Dest =
           Builder.CreatePtrToInt(MemoryInstance, Builder.getIntPtrTy());
       Dest = Builder.CreateAdd(Dest, Offset);
@@ -554,6 +759,11 @@ void EntityLayout::setupInitializer() {
       Builder.CreateCall(Intrinsic, {Dest, Data, Length, IsVolatile});
     }
   }
+  Builder.CreateRetVoid();
+
+  Builder.SetInsertPoint(
+      llvm::BasicBlock::Create(Context, "entry", InitializerFn));
+  InstancePtr = InitializerFn->getArg(0);
 
   for (auto const &Global : Source.getGlobals().asView()) {
     if (Global.isImported()) continue;
@@ -575,6 +785,15 @@ void EntityLayout::setupInitializer() {
     Builder.CreateStore(FunctionPtrInitializer, FunctionPtrAddr);
   }
 
+  // active segments are dropped once instantiated
+  for (auto const &DataSegment : Source.getData().asView()) {
+    auto *DataSizeAddr = getDataSizePtr(Builder, InstancePtr, DataSegment);
+    auto DataSize = DataSegment.isPassive() ? DataSegment.getSize() : 0;
+    auto *DataSizeStore = Builder.CreateStore(
+        llvm::ConstantInt::get(Builder.getIntPtrTy(), DataSize), DataSizeAddr);
+    setTBAATag(DataSizeStore, AccessKind::Instance);
+  }
+
   for (auto const &Table : Source.getTables().asView()) {
     for (auto const *ElementSegment : Table.getInitializers()) {
       auto *Indices = this->operator[](*ElementSegment);
@@ -604,7 +823,7 @@ void EntityLayout::setupBuiltins() {
     auto *MemoryGuardFnTy = llvm::FunctionType::get(
         ModuleIRBuilder.getVoidTy(),
         {/* __sable_memory_t *memory */ getMemoryPtrTy(),
-         /* std::uint32_t    offset  */ ModuleIRBuilder.getInt32Ty()},
+         /* std::size_t      offset  */ ModuleIRBuilder.getIntPtrTy()},
         false);
     llvm::Function::Create(
         /* Type    */ MemoryGuardFnTy,
@@ -613,6 +832,34 @@ void EntityLayout::setupBuiltins() {
         /* Parent  */ Target);
   }
 
+  if (!Options.SkipMemBoundaryCheck) {
+    auto *MemoryTrapFnTy = llvm::FunctionType::get(
+        ModuleIRBuilder.getVoidTy(),
+        {/* __sable_memory_t *memory */ getMemoryPtrTy(),
+         /* std::size_t      offset  */ ModuleIRBuilder.getIntPtrTy()},
+        false);
+    auto *MemoryTrapFn = llvm::Function::Create(
+        /* Type    */ MemoryTrapFnTy,
+        /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+        /* Name    */ "__sable_memory_trap",
+        /* Parent  */ Target);
+    MemoryTrapFn->setDoesNotReturn();
+    MemoryTrapFn->addFnAttr(llvm::Attribute::AttrKind::Cold);
+
+    auto *DataTrapFnTy = llvm::FunctionType::get(
+        ModuleIRBuilder.getVoidTy(),
+        {/* std::size_t offset */ ModuleIRBuilder.getIntPtrTy(),
+         /* std::size_t size   */ ModuleIRBuilder.getIntPtrTy()},
+        false);
+    auto *DataTrapFn = llvm::Function::Create(
+        /* Type    */ DataTrapFnTy,
+        /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+        /* Name    */ "__sable_data_trap",
+        /* Parent  */ Target);
+    DataTrapFn->setDoesNotReturn();
+    DataTrapFn->addFnAttr(llvm::Attribute::AttrKind::Cold);
+  }
+
   auto *MemoryGrowFnTy = llvm::FunctionType::get(
       /* std::uint32_t     num_page_after_grow */ ModuleIRBuilder.getInt32Ty(),
       {/* __sable_memory_t *memory             */ getMemoryPtrTy(),
@@ -633,6 +880,78 @@ void EntityLayout::setupBuiltins() {
       /* Name    */ "__sable_memory_size",
       /* Parent  */ Target);
 
+  // memory64 variants, page counts take the whole 64 bits
+  auto *MemoryGrow64FnTy = llvm::FunctionType::get(
+      /* std::uint64_t     num_page_after_grow */ ModuleIRBuilder.getInt64Ty(),
+      {/* __sable_memory_t *memory             */ getMemoryPtrTy(),
+       /* std::uint64_t    num_page_delta      */ ModuleIRBuilder.getInt64Ty()},
+      false);
+  llvm::Function::Create(
+      /* Type    */ MemoryGrow64FnTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_memory_grow64",
+      /* Parent  */ Target);
+
+  auto *MemorySize64FnTy = llvm::FunctionType::get(
+      /* std::uint64_t     num_page */ ModuleIRBuilder.getInt64Ty(),
+      {/* __sable_memory_t *memory  */ getMemoryPtrTy()}, false);
+  llvm::Function::Create(
+      /* Type    */ MemorySize64FnTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_memory_size64",
+      /* Parent  */ Target);
+
+  auto *MemoryUnalignedTrapFnTy = llvm::FunctionType::get(
+      ModuleIRBuilder.getVoidTy(),
+      {/* __sable_memory_t *memory */ getMemoryPtrTy(),
+       /* std::size_t      offset  */ ModuleIRBuilder.getIntPtrTy()},
+      false);
+  auto *MemoryUnalignedTrapFn = llvm::Function::Create(
+      /* Type    */ MemoryUnalignedTrapFnTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_memory_unaligned_trap",
+      /* Parent  */ Target);
+  MemoryUnalignedTrapFn->setDoesNotReturn();
+  MemoryUnalignedTrapFn->addFnAttr(llvm::Attribute::AttrKind::Cold);
+
+  auto *MemoryWait32FnTy = llvm::FunctionType::get(
+      /* std::uint32_t     result  */ ModuleIRBuilder.getInt32Ty(),
+      {/* __sable_memory_t *memory  */ getMemoryPtrTy(),
+       /* std::size_t      offset  */ ModuleIRBuilder.getIntPtrTy(),
+       /* std::uint32_t    expect  */ ModuleIRBuilder.getInt32Ty(),
+       /* std::int64_t     timeout */ ModuleIRBuilder.getInt64Ty()},
+      false);
+  llvm::Function::Create(
+      /* Type    */ MemoryWait32FnTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_memory_wait32",
+      /* Parent  */ Target);
+
+  auto *MemoryWait64FnTy = llvm::FunctionType::get(
+      /* std::uint32_t     result  */ ModuleIRBuilder.getInt32Ty(),
+      {/* __sable_memory_t *memory  */ getMemoryPtrTy(),
+       /* std::size_t      offset  */ ModuleIRBuilder.getIntPtrTy(),
+       /* std::uint64_t    expect  */ ModuleIRBuilder.getInt64Ty(),
+       /* std::int64_t     timeout */ ModuleIRBuilder.getInt64Ty()},
+      false);
+  llvm::Function::Create(
+      /* Type    */ MemoryWait64FnTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_memory_wait64",
+      /* Parent  */ Target);
+
+  auto *MemoryNotifyFnTy = llvm::FunctionType::get(
+      /* std::uint32_t     num_woken */ ModuleIRBuilder.getInt32Ty(),
+      {/* __sable_memory_t *memory    */ getMemoryPtrTy(),
+       /* std::size_t      offset    */ ModuleIRBuilder.getIntPtrTy(),
+       /* std::uint32_t    count     */ ModuleIRBuilder.getInt32Ty()},
+      false);
+  llvm::Function::Create(
+      /* Type    */ MemoryNotifyFnTy,
+      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+      /* Name    */ "__sable_memory_notify",
+      /* Parent  */ Target);
+
   if (!Options.SkipTblBoundaryCheck) {
     auto *TableGuardFnTy = llvm::FunctionType::get(
         ModuleIRBuilder.getVoidTy(),
@@ -664,35 +983,14 @@ void EntityLayout::setupBuiltins() {
       ModuleIRBuilder.getVoidTy(),
       {/* __sable_table_t *table            */ getTablePtrTy(),
        /* std::uint32_t   index             */ ModuleIRBuilder.getInt32Ty(),
-       /* char const      *expect_signature */ ModuleIRBuilder.getCStrTy()},
+       /* std::uint32_t   expect_signature  */ ModuleIRBuilder.getInt32Ty()},
       false);
-  llvm::Function::Create(
+  auto *TableCheckFn = llvm::Function::Create(
       /* Type    */ TableCheckFnTy,
       /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
       /* Name    */ "__sable_table_check",
       /* Parent  */ Target);
-
-  auto *TableFunctionFnTy = llvm::FunctionType::get(
-      /* __sable_function_t *function_ptr */ getFunctionPtrTy(),
-      {/* __sable_table_t   *table        */ getTablePtrTy(),
-       /* std::uint32_t     index         */ ModuleIRBuilder.getInt32Ty()},
-      false);
-  llvm::Function::Create(
-      /* Type    */ TableFunctionFnTy,
-      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
-      /* Name    */ "__sable_table_function",
-      /* Parent  */ Target);
-
-  auto *TableContextFnTy = llvm::FunctionType::get(
-      /* __sable_instance_t *instance */ getInstancePtrTy(),
-      {/* __sable_table_t   *table    */ getTablePtrTy(),
-       /* std::uint32_t     index     */ ModuleIRBuilder.getInt32Ty()},
-      false);
-  llvm::Function::Create(
-      /* Type    */ TableContextFnTy,
-      /* Linkage */ llvm::GlobalValue::LinkageTypes::ExternalLinkage,
-      /* Name    */ "__sable_table_context",
-      /* Parent  */ Target);
+  TableCheckFn->addFnAttr(llvm::Attribute::AttrKind::Cold);
 
   auto *UnreachableFnTy =
       llvm::FunctionType::get(ModuleIRBuilder.getVoidTy(), {}, false);
@@ -703,20 +1001,37 @@ void EntityLayout::setupBuiltins() {
       /* Parent  */ Target);
 }
 
+void EntityLayout::setupTBAA() {
+  llvm::MDBuilder MDBuilder(Target.getContext());
+  auto *Root = MDBuilder.createTBAARoot("sable-wasm TBAA");
+  auto createTag = [&](std::string_view Name) {
+    auto *TypeNode = MDBuilder.createTBAAScalarTypeNode(Name, Root);
+    return MDBuilder.createTBAAStructTagNode(TypeNode, TypeNode, 0);
+  };
+  InstanceTBAATag = createTag("instance");
+  LinearMemoryTBAATag = createTag("linear memory");
+  GlobalTBAATag = createTag("global");
+  TableTBAATag = createTag("table");
+}
+
 EntityLayout::EntityLayout(
     mir::Module const &Source_, llvm::Module &Target_,
     TranslationOptions Options_)
     : Source(Source_), Target(Target_), Options(Options_),
       ModuleIRBuilder(Target_) {
   setupInstanceType();
+  setupTBAA();
   setupBuiltins();
   setupFunctions();
+  setupMemoryImages();
   setupDataSegments();
   setupElementSegments();
   setupMemoryMetadata();
   setupTableMetadata();
   setupGlobalMetadata();
   setupFunctionMetadata();
+  setupSignatureMetadata();
+  setupDataMetadata();
   setupInitializer();
 }
 
@@ -735,31 +1050,109 @@ llvm::FunctionType *
 EntityLayout::convertType(bytecode::FunctionType const &Type) const {
   auto &Context = Target.getContext();
   std::vector<llvm::Type *> ParamTypes;
-  ParamTypes.reserve(Type.getNumParameter() + 1);
+  ParamTypes.reserve(Type.getNumParameter() + 2);
   ParamTypes.push_back(getInstancePtrTy());
   for (auto const &ValueType : Type.getParamTypes())
     ParamTypes.push_back(convertType(ValueType));
-  switch (Type.getNumResult()) {
-  case 0: /* Void Return         */ {
-    auto *VoidTy = ModuleIRBuilder.getVoidTy();
-    return llvm::FunctionType::get(VoidTy, ParamTypes, false);
-  }
-  case 1: /* Single Value Return */ {
-    auto *ResultType = convertType(Type.getResultTypes()[0]);
+  switch (getResultABI(Type)) {
+  case ResultABI::Direct: /* Void or Single Value Return */ {
+    auto *ResultType = Type.isVoidResult()
+                           ? ModuleIRBuilder.getVoidTy()
+                           : convertType(Type.getResultTypes()[0]);
     return llvm::FunctionType::get(ResultType, ParamTypes, false);
   }
-  default: /* Multi Value Return */ {
-    // clang-format off
-    auto ResultTypes = Type.getResultTypes()
-      | ranges::views::transform([&](bytecode::ValueType const &ValueType) {
-          return convertType(ValueType);
-        })
-      | ranges::to<std::vector<llvm::Type *>>();
-    // clang-format on
+  case ResultABI::Register: /* Multi Value Return in Registers */ {
+    std::vector<llvm::Type *> ResultTypes(
+        Type.getNumResult(), ModuleIRBuilder.getInt64Ty());
     auto *ResultType = llvm::StructType::get(Context, ResultTypes);
     return llvm::FunctionType::get(ResultType, ParamTypes, false);
   }
+  case ResultABI::OutParameter: /* Multi Value Return in Memory */ {
+    ParamTypes.push_back(llvm::PointerType::getUnqual(getResultsTy(Type)));
+    auto *VoidTy = ModuleIRBuilder.getVoidTy();
+    return llvm::FunctionType::get(VoidTy, ParamTypes, false);
+  }
+  default: utility::unreachable();
+  }
+}
+
+EntityLayout::ResultABI
+EntityLayout::getResultABI(bytecode::FunctionType const &Type) const {
+  if (!Type.isMultiValueResult()) return ResultABI::Direct;
+  if (Type.getNumResult() > MaxNumRegisterResults)
+    return ResultABI::OutParameter;
+  for (auto const &ValueType : Type.getResultTypes())
+    if (ValueType.isV128()) return ResultABI::OutParameter;
+  return ResultABI::Register;
+}
+
+llvm::StructType *
+EntityLayout::getResultsTy(bytecode::FunctionType const &Type) const {
+  // clang-format off
+  auto ResultTypes = Type.getResultTypes()
+    | ranges::views::transform([&](bytecode::ValueType const &ValueType) {
+        return convertType(ValueType);
+      })
+    | ranges::to<std::vector<llvm::Type *>>();
+  // clang-format on
+  return llvm::StructType::get(Target.getContext(), ResultTypes);
+}
+
+llvm::Value *EntityLayout::encodeResults(
+    IRBuilder &Builder, bytecode::FunctionType const &Type,
+    llvm::Value *Results) const {
+  assert(getResultABI(Type) == ResultABI::Register);
+  auto *EncodedTy = convertType(Type)->getReturnType();
+  llvm::Value *Encoded = llvm::UndefValue::get(EncodedTy);
+  for (auto const &[Index, ValueType] :
+       ranges::views::enumerate(Type.getResultTypes())) {
+    auto StructIndex = static_cast<unsigned>(Index);
+    auto *Member = Builder.CreateExtractValue(Results, StructIndex);
+    switch (ValueType.getKind()) {
+    case bytecode::ValueTypeKind::I32:
+      Member = Builder.CreateZExt(Member, Builder.getInt64Ty());
+      break;
+    case bytecode::ValueTypeKind::I64: break;
+    case bytecode::ValueTypeKind::F32:
+      Member = Builder.CreateBitCast(Member, Builder.getInt32Ty());
+      Member = Builder.CreateZExt(Member, Builder.getInt64Ty());
+      break;
+    case bytecode::ValueTypeKind::F64:
+      Member = Builder.CreateBitCast(Member, Builder.getInt64Ty());
+      break;
+    default: utility::unreachable();
+    }
+    Encoded = Builder.CreateInsertValue(Encoded, Member, StructIndex);
+  }
+  return Encoded;
+}
+
+llvm::Value *EntityLayout::decodeResults(
+    IRBuilder &Builder, bytecode::FunctionType const &Type,
+    llvm::Value *Encoded) const {
+  assert(getResultABI(Type) == ResultABI::Register);
+  llvm::Value *Results = llvm::UndefValue::get(getResultsTy(Type));
+  for (auto const &[Index, ValueType] :
+       ranges::views::enumerate(Type.getResultTypes())) {
+    auto StructIndex = static_cast<unsigned>(Index);
+    auto *Member = Builder.CreateExtractValue(Encoded, StructIndex);
+    switch (ValueType.getKind()) {
+    case bytecode::ValueTypeKind::I32:
+      Member = Builder.CreateTrunc(Member, Builder.getInt32Ty());
+      break;
+    case bytecode::ValueTypeKind::I64: break;
+    case bytecode::ValueTypeKind::F32:
+      Member = Builder.CreateTrunc(Member, Builder.getInt32Ty());
+      Member = Builder.CreateBitCast(Member, Builder.getFloatTy());
+      break;
+    case bytecode::ValueTypeKind::F64:
+      Member = Builder.CreateBitCast(Member, Builder.getDoubleTy());
+      break;
+    default: utility::unreachable();
+    }
+    Results = Builder.CreateInsertValue(Results, Member, StructIndex);
   }
+  return Results;
 }
 
 TranslationOptions const &EntityLayout::getTranslationOptions() const {
@@ -798,15 +1191,31 @@ llvm::Function *EntityLayout::getBuiltin(std::string_view Name) const {
   return Builtin;
 }
 
+llvm::MDNode *EntityLayout::getTBAATag(AccessKind Kind) const {
+  switch (Kind) {
+  case AccessKind::Instance: return InstanceTBAATag;
+  case AccessKind::LinearMemory: return LinearMemoryTBAATag;
+  case AccessKind::Global: return GlobalTBAATag;
+  case AccessKind::Table: return TableTBAATag;
+  default: utility::unreachable();
+  }
+}
+
+void EntityLayout::setTBAATag(llvm::Instruction *Inst, AccessKind Kind) const {
+  Inst->setMetadata(llvm::LLVMContext::MD_tbaa, getTBAATag(Kind));
+}
+
 llvm::Value *EntityLayout::get(
     IRBuilder &Builder, llvm::Value *InstancePtr,
     mir::Global const &Global) const {
   auto Offset = getOffset(Global);
   auto GlobalValueType = Global.getType().getType();
   auto *CastedToTy = llvm::PointerType::getUnqual(convertType(GlobalValueType));
-  llvm::Value *GlobalInstance = Builder.CreateStructGEP(InstancePtr, Offset);
-  GlobalInstance = Builder.CreateLoad(GlobalInstance);
-  GlobalInstance = Builder.CreatePointerCast(GlobalInstance, CastedToTy);
+  auto *GlobalInstanceAddr = Builder.CreateStructGEP(InstancePtr, Offset);
+  auto *GlobalInstanceLoad = Builder.CreateLoad(GlobalInstanceAddr);
+  setTBAATag(GlobalInstanceLoad, AccessKind::Instance);
+  auto *GlobalInstance =
+      Builder.CreatePointerCast(GlobalInstanceLoad, CastedToTy);
   if (Global.hasName())
     GlobalInstance->setName(llvm::StringRef(Global.getName()));
   return GlobalInstance;
@@ -817,7 +1226,9 @@ llvm::Value *EntityLayout::getContextPtr(
     mir::Function const &Function) const {
   auto Offset = getOffset(Function);
   auto *ContextPtrAddr = Builder.CreateStructGEP(InstancePtr, Offset);
-  return Builder.CreateLoad(ContextPtrAddr);
+  auto *ContextPtr = Builder.CreateLoad(ContextPtrAddr);
+  setTBAATag(ContextPtr, AccessKind::Instance);
+  return ContextPtr;
 }
 
 llvm::Value *EntityLayout::getFunctionPtr(
@@ -826,9 +1237,11 @@ llvm::Value *EntityLayout::getFunctionPtr(
   auto Offset = getOffset(Function) + 1;
   auto *FunctionTy = convertType(Function.getType());
   auto *FunctionPtrTy = llvm::PointerType::getUnqual(FunctionTy);
-  llvm::Value *FunctionPtr = Builder.CreateStructGEP(InstancePtr, Offset);
-  FunctionPtr = Builder.CreateLoad(FunctionPtr);
-  FunctionPtr = Builder.CreatePointerCast(FunctionPtr, FunctionPtrTy);
+  auto *FunctionPtrAddr = Builder.CreateStructGEP(InstancePtr, Offset);
+  auto *FunctionPtrLoad = Builder.CreateLoad(FunctionPtrAddr);
+  setTBAATag(FunctionPtrLoad, AccessKind::Instance);
+  auto *FunctionPtr =
+      Builder.CreatePointerCast(FunctionPtrLoad, FunctionPtrTy);
   if (Function.hasName())
     FunctionPtr->setName(llvm::StringRef(Function.getName()));
   return FunctionPtr;
@@ -838,18 +1251,88 @@ llvm::Value *EntityLayout::get(
     IRBuilder &Builder, llvm::Value *InstancePtr,
     mir::Memory const &Memory) const {
   auto Offset = getOffset(Memory);
-  llvm::Value *MemoryPtr = Builder.CreateStructGEP(InstancePtr, Offset);
-  MemoryPtr = Builder.CreateLoad(MemoryPtr);
+  auto *MemoryPtrAddr = Builder.CreateStructGEP(InstancePtr, Offset);
+  auto *MemoryPtr = Builder.CreateLoad(MemoryPtrAddr);
+  setTBAATag(MemoryPtr, AccessKind::Instance);
   if (Memory.hasName()) MemoryPtr->setName(llvm::StringRef(Memory.getName()));
   return MemoryPtr;
 }
 
+llvm::Value *EntityLayout::getMemorySize(
+    IRBuilder &Builder, llvm::Value *InstancePtr,
+    mir::Memory const &Memory) const {
+  auto Offset = getOffset(Memory) + 1;
+  auto *MemorySizeAddr = Builder.CreateStructGEP(InstancePtr, Offset);
+  auto *MemorySize = Builder.CreateLoad(MemorySizeAddr);
+  setTBAATag(MemorySize, AccessKind::Instance);
+  // other threads grow a shared memory concurrently, the runtime publishes
+  // the new size only after the pages are accessible
+  if (Memory.getType().isShared())
+    MemorySize->setAtomic(llvm::AtomicOrdering::Acquire);
+  if (Memory.hasName())
+    MemorySize->setName(fmt::format("{}.size", Memory.getName()));
+  return MemorySize;
+}
+
+llvm::Value *EntityLayout::getDataSizePtr(
+    IRBuilder &Builder, llvm::Value *InstancePtr,
+    mir::Data const &DataSegment) const {
+  auto Offset = getOffset(DataSegment);
+  return Builder.CreateStructGEP(InstancePtr, Offset);
+}
+
+llvm::Value *EntityLayout::getTableHeaderPtr(
+    IRBuilder &Builder, llvm::Value *TablePtr) const {
+  auto *TableEntryPtrTy =
+      llvm::PointerType::getUnqual(getNamedStructTy("__sable_table_entry_t"));
+  auto *TableHeaderTy = llvm::StructType::get(
+      Target.getContext(), {/* Entries */ TableEntryPtrTy,
+                            /* Size    */ Builder.getInt32Ty()});
+  auto *TableHeaderPtrTy = llvm::PointerType::getUnqual(TableHeaderTy);
+  return Builder.CreatePointerCast(TablePtr, TableHeaderPtrTy);
+}
+
+llvm::Value *EntityLayout::getTableEntryPtr(
+    IRBuilder &Builder, llvm::Value *TablePtr, llvm::Value *Index) const {
+  auto *TableHeader = getTableHeaderPtr(Builder, TablePtr);
+  auto *EntriesAddr = Builder.CreateStructGEP(TableHeader, 0);
+  auto *Entries = Builder.CreateLoad(EntriesAddr);
+  setTBAATag(Entries, AccessKind::Table);
+  if (Index->getType() != Builder.getIntPtrTy())
+    Index = Builder.CreateZExt(Index, Builder.getIntPtrTy());
+  return Builder.CreateInBoundsGEP(Entries, Index);
+}
+
+llvm::Value *
+EntityLayout::getTableSize(IRBuilder &Builder, llvm::Value *TablePtr) const {
+  auto *TableHeader = getTableHeaderPtr(Builder, TablePtr);
+  auto *SizeAddr = Builder.CreateStructGEP(TableHeader, 1);
+  auto *Size = Builder.CreateLoad(SizeAddr);
+  setTBAATag(Size, AccessKind::Table);
+  return Size;
+}
+
+llvm::Value *EntityLayout::getSignatureID(
+    IRBuilder &Builder, bytecode::FunctionType const &Type) const {
+  auto SearchIter = SignatureSlots.find(getSignature(Type));
+  assert(SearchIter != SignatureSlots.end());
+  auto *SignatureIDAddr = Builder.CreateConstInBoundsGEP2_32(
+      SignatureIDs->getValueType(), SignatureIDs, 0, SearchIter->second);
+  auto *SignatureID = Builder.CreateLoad(SignatureIDAddr);
+  // written once by the runtime before any generated code runs
+  SignatureID->setMetadata(
+      llvm::LLVMContext::MD_invariant_load,
+      llvm::MDNode::get(Target.getContext(), {}));
+  return SignatureID;
+}
+
 llvm::Value *EntityLayout::get(
     IRBuilder &Builder, llvm::Value *InstancePtr,
     const mir::Table &Table) const {
   auto Offset = getOffset(Table);
-  llvm::Value *TablePtr = Builder.CreateStructGEP(InstancePtr, Offset);
-  TablePtr = Builder.CreateLoad(TablePtr);
+  auto *TablePtrAddr = Builder.CreateStructGEP(InstancePtr, Offset);
+  auto *TablePtr = Builder.CreateLoad(TablePtrAddr);
+  setTBAATag(TablePtr, AccessKind::Instance);
   if (Table.hasName()) TablePtr->setName(llvm::StringRef(Table.getName()));
   return TablePtr;
 }
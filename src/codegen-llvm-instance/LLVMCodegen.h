@@ -6,6 +6,7 @@
 #include "TranslationContext.h"
 
 #include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/StringSet.h>
 #include <llvm/IR/IRBuilder.h>
@@ -20,6 +21,12 @@ struct TranslationOptions {
   bool SkipMemBoundaryCheck = false;
   bool SkipTblBoundaryCheck = false;
   bool AssumeMemRWAligned = false;
+  // Rely on runtime guard pages to trap out-of-bound linear memory accesses
+  // instead of emitting explicit boundary checks.
+  bool UseMemGuardPage = false;
+  // Reserve the maximum size of defined linear memories up front so that
+  // memory.grow never moves them. Boundary checks are still emitted.
+  bool ReserveMemory = false;
 };
 
 class IRBuilder : public llvm::IRBuilder<> {
@@ -104,6 +111,20 @@ public:
 
 class EntityLayout {
 public:
+  // Disjoint classes of memory accessed by generated code, used to attach TBAA
+  // so that LLVM never assumes a linear memory store clobbers the instance.
+  enum class AccessKind { Instance, LinearMemory, Global, Table };
+
+  // How the results of a function cross a call boundary:
+  // Direct       : at most one result, returned as is
+  // Register     : up to MaxNumRegisterResults scalars, each encoded as an i64
+  //                member of a literal struct, which both SysV x86-64 and
+  //                AArch64 return in integer registers
+  // OutParameter : stored by the callee through a trailing pointer to a
+  //                naturally aligned struct provided by the caller
+  enum class ResultABI { Direct, Register, OutParameter };
+  static constexpr std::size_t MaxNumRegisterResults = 2;
+
   class FunctionEntry {
     std::size_t Index;
     llvm::Function *Definition;
@@ -132,6 +153,17 @@ private:
   llvm::DenseMap<mir::Data const *, llvm::Constant *> DataMap;
   llvm::DenseMap<mir::Element const *, llvm::Constant *> ElementMap;
   llvm::DenseMap<mir::Function const *, FunctionEntry> FunctionMap;
+  // data segments laid out in a memory image, not copied by the initializer
+  llvm::DenseSet<mir::Data const *> ImagedDataSegments;
+
+  llvm::MDNode *InstanceTBAATag = nullptr;
+  llvm::MDNode *LinearMemoryTBAATag = nullptr;
+  llvm::MDNode *GlobalTBAATag = nullptr;
+  llvm::MDNode *TableTBAATag = nullptr;
+
+  // slot of each call_indirect signature in __sable_signature_metadata
+  llvm::StringMap<std::uint32_t> SignatureSlots;
+  llvm::GlobalVariable *SignatureIDs = nullptr;
 
   llvm::StructType *declareOpaqueTy(std::string_view Name);
   llvm::StructType *getOpaqueTy(std::string_view Name) const;
@@ -144,23 +176,34 @@ private:
    * __sable_table_metadata_t *
    * __sable_global_metadata_t *
    * __sable_function_metadata_t *
-   * ... Memory Instance Pointers (__sable_memory_t *)
+   * ... Memory Instance Pointers (__sable_memory_t *, std::size_t)
    * ... Table Instance Pointers  (__sable_table_t *)
    * ... Global Instance Pointers (__sable_global_t *)
    * ... Function Pointers        (__sable_instance_t *, __sable_function_t *)
+   * ... Data Segment Sizes       (std::size_t)
    */
 
   void setupInstanceType();
+  void setupTBAA();
 
   llvm::Value *translateInitExpr(
       IRBuilder &Builder, llvm::Value *InstancePtr,
       mir::InitializerExpr const &Expr);
 
+  void setupMemoryImages();
   void setupDataSegments();
   void setupElementSegments();
 
   llvm::GlobalVariable *createArrayGlobal(
       llvm::Type *ElementType, std::span<llvm::Constant *const> Elements);
+  // import descriptors of Entities ordered by module name then entity name
+  template <typename EntityView>
+  std::vector<llvm::Constant *>
+  createImports(llvm::StructType *ImportTy, EntityView const &Entities);
+  // export descriptors of Entities ordered by name
+  template <typename EntityView>
+  std::vector<llvm::Constant *>
+  createExports(llvm::StructType *ExportTy, EntityView const &Entities);
   llvm::GlobalVariable *createMetadata(
       std::string_view Prefix, std::uint32_t Size, std::uint32_t ImportSize,
       std::uint32_t ExportSize, llvm::GlobalVariable *Entities,
@@ -170,6 +213,10 @@ private:
   void setupTableMetadata();
   void setupGlobalMetadata();
   void setupFunctionMetadata();
+  void setupSignatureMetadata();
+  void setupDataMetadata();
+
+  llvm::Value *getTableHeaderPtr(IRBuilder &Builder, llvm::Value *Table) const;
   void setupFunctions();
   void setupInitializer();
   void setupBuiltins();
@@ -186,25 +233,52 @@ public:
   llvm::Type *convertType(bytecode::ValueType const &Type) const;
   llvm::FunctionType *convertType(bytecode::FunctionType const &Type) const;
 
+  ResultABI getResultABI(bytecode::FunctionType const &Type) const;
+  // results as a first-class struct, the form Pack and Unpack work on
+  llvm::StructType *getResultsTy(bytecode::FunctionType const &Type) const;
+  // convert between the results struct and the Register ABI return value
+  llvm::Value *encodeResults(
+      IRBuilder &Builder, bytecode::FunctionType const &Type,
+      llvm::Value *Results) const;
+  llvm::Value *decodeResults(
+      IRBuilder &Builder, bytecode::FunctionType const &Type,
+      llvm::Value *Results) const;
+
   llvm::Constant *operator[](mir::Data const &DataSegment) const;
   FunctionEntry const &operator[](mir::Function const &Function) const;
   llvm::Constant *operator[](mir::Element const &ElementSegment) const;
 
   /* List of Builtins (implement by the runtime library
    * __sable_memory_guard
-   * __sable_table_guard
+   * __sable_memory_trap       (* cold path of inline boundary check *)
+   * __sable_data_trap         (* cold path of memory.init segment check *)
+   * __sable_table_guard       (* element segment initialization *)
    * __sable_table_set
-   * __sable_table_check
-   * __sable_table_function    (* no boundary check is required *)
-   * __sable_table_context     (* no boundary check is required *)
+   * __sable_table_check       (* cold path of inline call_indirect check *)
    * error handling:
    * __sable_unreachable
    */
   llvm::Function *getBuiltin(std::string_view Name) const;
 
+  llvm::MDNode *getTBAATag(AccessKind Kind) const;
+  void setTBAATag(llvm::Instruction *Inst, AccessKind Kind) const;
+
   llvm::Value *get(IRBuilder &, llvm::Value *, mir::Global const &) const;
   llvm::Value *get(IRBuilder &, llvm::Value *, mir::Memory const &) const;
   llvm::Value *get(IRBuilder &, llvm::Value *, mir::Table const &) const;
+  llvm::Value *
+  getMemorySize(IRBuilder &, llvm::Value *, mir::Memory const &) const;
+  // remaining length of a data segment, stored to by data.drop
+  llvm::Value *
+  getDataSizePtr(IRBuilder &, llvm::Value *, mir::Data const &) const;
+
+  // address of the __sable_table_entry_t at Index, no boundary check
+  llvm::Value *getTableEntryPtr(
+      IRBuilder &Builder, llvm::Value *TablePtr, llvm::Value *Index) const;
+  llvm::Value *getTableSize(IRBuilder &Builder, llvm::Value *TablePtr) const;
+  // runtime assigned ID of a call_indirect signature
+  llvm::Value *
+  getSignatureID(IRBuilder &Builder, bytecode::FunctionType const &Type) const;
 
   llvm::Value *
   getContextPtr(IRBuilder &, llvm::Value *, mir::Function const &) const;
@@ -1,5 +1,6 @@
 #include "TranslationContext.h"
 
+#include "../mir/Atomic.h"
 #include "LLVMCodegen.h"
 
 #include <range/v3/view/transform.hpp>
@@ -24,6 +25,51 @@ llvm::Value *TranslationContext::getLocalInitializer(mir::Local const &Local) {
   }
 }
 
+void TranslationContext::setupMemoryCache(IRBuilder &Builder) {
+  namespace minsts = mir::instructions;
+  auto AddCacheSlots = [&](mir::Memory const *Memory) {
+    if ((Memory == nullptr) || MemoryCacheMap.contains(Memory)) return;
+    auto *Base = Builder.CreateAlloca(Layout.getMemoryPtrTy());
+    auto *Size = Builder.CreateAlloca(Builder.getIntPtrTy());
+    Base->setName("memory.base");
+    Size->setName("memory.size");
+    MemoryCacheMap.emplace(Memory, std::make_pair(Base, Size));
+  };
+  for (auto const &BasicBlock : Source.getBasicBlocks().asView())
+    for (auto const &Instruction : BasicBlock) {
+      mir::Memory const *Memory = nullptr;
+      if (mir::is_a<minsts::Load>(Instruction))
+        Memory = mir::dyn_cast<minsts::Load>(Instruction).getLinearMemory();
+      if (mir::is_a<minsts::Store>(Instruction))
+        Memory = mir::dyn_cast<minsts::Store>(Instruction).getLinearMemory();
+      if (mir::is_a<minsts::MemoryGuard>(Instruction))
+        Memory =
+            mir::dyn_cast<minsts::MemoryGuard>(Instruction).getLinearMemory();
+      if (mir::is_a<minsts::Atomic>(Instruction))
+        Memory = mir::dyn_cast<minsts::Atomic>(Instruction).getLinearMemory();
+      if (mir::is_a<minsts::MemoryInit>(Instruction))
+        Memory =
+            mir::dyn_cast<minsts::MemoryInit>(Instruction).getLinearMemory();
+      if (mir::is_a<minsts::MemoryCopy>(Instruction)) {
+        auto const &Copy = mir::dyn_cast<minsts::MemoryCopy>(Instruction);
+        Memory = Copy.getLinearMemory();
+        AddCacheSlots(Copy.getSourceMemory());
+      }
+      if (mir::is_a<minsts::MemoryFill>(Instruction))
+        Memory =
+            mir::dyn_cast<minsts::MemoryFill>(Instruction).getLinearMemory();
+      AddCacheSlots(Memory);
+    }
+  auto *InstancePtr = getInstancePtr();
+  for (auto const &[Memory, CacheSlots] : MemoryCacheMap) {
+    auto [BaseSlot, SizeSlot] = CacheSlots;
+    auto *Base = Layout.get(Builder, InstancePtr, *Memory);
+    auto *Size = Layout.getMemorySize(Builder, InstancePtr, *Memory);
+    Builder.CreateStore(Base, BaseSlot);
+    Builder.CreateStore(Size, SizeSlot);
+  }
+}
+
 TranslationContext::TranslationContext(
     EntityLayout &Laytout_, mir::Function const &Source_,
     llvm::Function &Target_)
@@ -48,6 +94,7 @@ TranslationContext::TranslationContext(
     LocalMap.emplace(std::addressof(Local), LLVMLocal);
     Builder.CreateStore(getLocalInitializer(Local), LLVMLocal);
   }
+  setupMemoryCache(Builder);
 
   for (auto const &BasicBlock : Source.getBasicBlocks().asView()) {
     auto *BB = llvm::BasicBlock::Create(
@@ -114,8 +161,7 @@ TranslationContext::operator[](mir::Instruction const &Instruction) const {
       | ranges::to<std::vector<llvm::Type *>>();
     // clang-format on
     auto *StructTy = llvm::StructType::get(Target.getContext(), Members);
-    auto *StructPtrTy = llvm::PointerType::getUnqual(StructTy);
-    utility::expect(StructPtrTy == Value->getType());
+    utility::expect(StructTy == Value->getType());
     break;
   }
   default: utility::unreachable();
@@ -153,7 +199,7 @@ TranslationContext::createBasicBlock(mir::BasicBlock const &BasicBlock) {
       /* Parent        */ std::addressof(Target),
       /* Insert Before */ InsertPos);
   auto NewEntry = std::make_pair(FirstBB, LastBB);
-  BasicBlockMap.emplace(std::addressof(BasicBlock), NewEntry);
+  BasicBlockMap.insert_or_assign(std::addressof(BasicBlock), NewEntry);
   return LastBB;
 }
 
@@ -162,6 +208,67 @@ void TranslationContext::setValueMapping(
   ValueMap.emplace(std::addressof(Inst), Value);
 }
 
+llvm::Value *TranslationContext::getMemoryBase(
+    IRBuilder &Builder, mir::Memory const &Memory) {
+  auto SearchIter = MemoryCacheMap.find(std::addressof(Memory));
+  assert(SearchIter != MemoryCacheMap.end());
+  auto *CacheSlot = std::get<0>(std::get<1>(*SearchIter));
+  return Builder.CreateLoad(CacheSlot);
+}
+
+llvm::Value *TranslationContext::getMemorySize(
+    IRBuilder &Builder, mir::Memory const &Memory) {
+  auto SearchIter = MemoryCacheMap.find(std::addressof(Memory));
+  assert(SearchIter != MemoryCacheMap.end());
+  auto *CacheSlot = std::get<1>(std::get<1>(*SearchIter));
+  return Builder.CreateLoad(CacheSlot);
+}
+
+llvm::Value *TranslationContext::reloadMemorySize(
+    IRBuilder &Builder, mir::Memory const &Memory) {
+  auto SearchIter = MemoryCacheMap.find(std::addressof(Memory));
+  assert(SearchIter != MemoryCacheMap.end());
+  auto *CacheSlot = std::get<1>(std::get<1>(*SearchIter));
+  auto *Size = Layout.getMemorySize(Builder, getInstancePtr(), Memory);
+  Builder.CreateStore(Size, CacheSlot);
+  return Size;
+}
+
+void TranslationContext::reloadMemoryCache(IRBuilder &Builder) {
+  reloadMemoryCache(Builder, nullptr);
+}
+
+void TranslationContext::reloadMemoryCache(
+    IRBuilder &Builder, mir::Memory const *Grown) {
+  auto const &Options = Layout.getTranslationOptions();
+  // defined memories grow in place within their reservation, shared memories
+  // never move whether imported or not
+  auto IsBaseStable = Options.UseMemGuardPage || Options.ReserveMemory;
+  auto *InstancePtr = getInstancePtr();
+  for (auto const &[Memory, CacheSlots] : MemoryCacheMap) {
+    // the same instance may be imported under several indices, hence growing
+    // an imported memory may affect any other imported one
+    if ((Grown != nullptr) && (Memory != Grown) &&
+        !(Grown->isImported() && Memory->isImported()))
+      continue;
+    auto [BaseSlot, SizeSlot] = CacheSlots;
+    auto IsShared = Memory->getType().isShared();
+    if (!IsShared && (!IsBaseStable || Memory->isImported())) {
+      auto *Base = Layout.get(Builder, InstancePtr, *Memory);
+      Builder.CreateStore(Base, BaseSlot);
+    }
+    auto *Size = Layout.getMemorySize(Builder, InstancePtr, *Memory);
+    Builder.CreateStore(Size, SizeSlot);
+  }
+}
+
+llvm::AllocaInst *TranslationContext::createEntryAlloca(llvm::Type *Type) {
+  auto &EntryBB = Target.getEntryBlock();
+  IRBuilder Builder(EntryBB);
+  Builder.SetInsertPoint(std::addressof(EntryBB), EntryBB.begin());
+  return Builder.CreateAlloca(Type);
+}
+
 EntityLayout const &TranslationContext::getLayout() const { return Layout; }
 
 std::shared_ptr<mir::passes::DominatorTreeNode>
@@ -181,4 +288,11 @@ llvm::Function &TranslationContext::getTarget() { return Target; }
 llvm::Argument *TranslationContext::getInstancePtr() const {
   return Target.arg_begin();
 }
+
+llvm::Argument *TranslationContext::getResultsPtr() const {
+  assert(
+      Layout.getResultABI(Source.getType()) ==
+      EntityLayout::ResultABI::OutParameter);
+  return std::prev(Target.arg_end());
+}
 } // namespace codegen::llvm_instance
\ No newline at end of file
@@ -6,11 +6,13 @@
 #include "../mir/passes/TypeInfer.h"
 
 #include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
 
 #include <unordered_map>
 
 namespace codegen::llvm_instance {
 class EntityLayout;
+class IRBuilder;
 class TranslationContext {
   EntityLayout &Layout;
   mir::Function const &Source;
@@ -26,7 +28,17 @@ class TranslationContext {
       std::pair<llvm::BasicBlock *, llvm::BasicBlock *>>
       BasicBlockMap;
 
+  // Linear memory base pointer and size are cached in stack slots for the
+  // whole function, promoted to registers by mem2reg. Each memory has its own
+  // slots, refreshed after anything that may move it: calls reload all of
+  // them and memory.grow only the grown one. The base of defined memories
+  // with an in place reservation never moves.
+  std::unordered_map<
+      mir::Memory const *, std::pair<llvm::AllocaInst *, llvm::AllocaInst *>>
+      MemoryCacheMap;
+
   llvm::Value *getLocalInitializer(mir::Local const &Local);
+  void setupMemoryCache(IRBuilder &Builder);
 
 public:
   TranslationContext(
@@ -47,12 +59,25 @@ public:
 
   void setValueMapping(mir::Instruction const &Inst, llvm::Value *Value);
 
+  llvm::Value *getMemoryBase(IRBuilder &Builder, mir::Memory const &Memory);
+  llvm::Value *getMemorySize(IRBuilder &Builder, mir::Memory const &Memory);
+  // refreshes the cached size of Memory from the instance and returns it
+  llvm::Value *reloadMemorySize(IRBuilder &Builder, mir::Memory const &Memory);
+  void reloadMemoryCache(IRBuilder &Builder);
+  // after memory.grow, other memories are unaffected
+  void reloadMemoryCache(IRBuilder &Builder, mir::Memory const *Grown);
+
+  // stack slot in the entry block, hence outside of any loop
+  llvm::AllocaInst *createEntryAlloca(llvm::Type *Type);
+
   EntityLayout const &getLayout() const;
   std::shared_ptr<mir::passes::DominatorTreeNode> getDominatorTree() const;
   mir::passes::TypeInferPassResult const &getInferredType() const;
   mir::Function const &getSource() const;
   llvm::Function &getTarget();
   llvm::Argument *getInstancePtr() const;
+  // trailing out parameter of functions using the OutParameter result ABI
+  llvm::Argument *getResultsPtr() const;
 };
 } // namespace codegen::llvm_instance
 
@@ -5,6 +5,7 @@
 #include "llvm/IR/Value.h"
 
 #include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/MDBuilder.h>
 
 #include <range/v3/view/enumerate.hpp>
 #include <range/v3/view/transform.hpp>
@@ -69,65 +70,161 @@ llvm::Value *TranslationVisitor::operator()(minsts::Branch const *Inst) {
 
 llvm::Value *TranslationVisitor::operator()(minsts::Return const *Inst) {
   if (!Inst->hasReturnValue()) return Builder.CreateRetVoid();
+  // results of a tail call are already in their ABI form
+  if (PendingTailCall != nullptr) {
+    if (PendingTailCall->getType()->isVoidTy())
+      return Builder.CreateRetVoid();
+    return Builder.CreateRet(PendingTailCall);
+  }
+  auto const &Layout = Context.getLayout();
+  auto const &FunctionType = Context.getSource().getType();
   auto *ReturnValue = Context[*Inst->getOperand()];
-  auto ReturnTy = Context.getInferredType()[*Inst->getOperand()];
-  if (ReturnTy.isPrimitiveV128() &&
-      (ReturnValue->getType() != Builder.getInt128Ty()))
-    ReturnValue = Builder.CreateBitCast(ReturnValue, Builder.getInt128Ty());
-  return Builder.CreateRet(ReturnValue);
+  switch (Layout.getResultABI(FunctionType)) {
+  case EntityLayout::ResultABI::Direct: {
+    auto ReturnTy = Context.getInferredType()[*Inst->getOperand()];
+    if (ReturnTy.isPrimitiveV128() &&
+        (ReturnValue->getType() != Builder.getInt128Ty()))
+      ReturnValue = Builder.CreateBitCast(ReturnValue, Builder.getInt128Ty());
+    return Builder.CreateRet(ReturnValue);
+  }
+  case EntityLayout::ResultABI::Register: {
+    auto *Encoded = Layout.encodeResults(Builder, FunctionType, ReturnValue);
+    return Builder.CreateRet(Encoded);
+  }
+  case EntityLayout::ResultABI::OutParameter: {
+    Builder.CreateStore(ReturnValue, Context.getResultsPtr());
+    return Builder.CreateRetVoid();
+  }
+  default: utility::unreachable();
+  }
+}
+
+// All functions use the C calling convention since the runtime and host
+// functions call them through the instance and table slots. LLVM guarantees a
+// musttail call under this convention only if the caller and the callee share
+// the same prototype, which covers the dispatch loops of threaded interpreters
+// whose handlers all have the same signature. Other tail calls are left to
+// the sibling call optimization.
+void TranslationVisitor::setTailCallKind(llvm::CallInst *Call) {
+  auto *CallerTy = Context.getTarget().getFunctionType();
+  if (Call->getFunctionType() == CallerTy) {
+    Call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+  } else {
+    Call->setTailCallKind(llvm::CallInst::TCK_Tail);
+  }
+}
+
+// Multi-value results come back either encoded in registers or through a
+// stack slot of the caller, see EntityLayout::ResultABI. Tail calls reuse the
+// results slot of the caller since both functions have the same results.
+llvm::Value *TranslationVisitor::createCall(
+    llvm::FunctionCallee Callee, std::vector<llvm::Value *> Arguments,
+    bytecode::FunctionType const &Type, bool IsTailCall) {
+  auto const &Layout = Context.getLayout();
+  auto ResultABI = Layout.getResultABI(Type);
+  llvm::AllocaInst *ResultsSlot = nullptr;
+  if (ResultABI == EntityLayout::ResultABI::OutParameter) {
+    if (IsTailCall) {
+      Arguments.push_back(Context.getResultsPtr());
+    } else {
+      ResultsSlot = Context.createEntryAlloca(Layout.getResultsTy(Type));
+      Arguments.push_back(ResultsSlot);
+    }
+  }
+  auto *Result = Builder.CreateCall(Callee, Arguments);
+  // the return right after a tail call needs no memory cache
+  if (IsTailCall) {
+    setTailCallKind(Result);
+    PendingTailCall = Result;
+    return Result;
+  }
+  Context.reloadMemoryCache(Builder);
+  switch (ResultABI) {
+  case EntityLayout::ResultABI::Direct: return Result;
+  case EntityLayout::ResultABI::Register:
+    return Layout.decodeResults(Builder, Type, Result);
+  case EntityLayout::ResultABI::OutParameter:
+    return Builder.CreateLoad(ResultsSlot);
+  default: utility::unreachable();
+  }
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::Call const *Inst) {
   auto *InstancePtr = Context.getInstancePtr();
   auto *Callee = Context.getLayout()[*Inst->getTarget()].definition();
   std::vector<llvm::Value *> Arguments;
-  Arguments.reserve(Inst->getTarget()->getType().getNumParameter() + 1);
+  Arguments.reserve(Inst->getTarget()->getType().getNumParameter() + 2);
   Arguments.push_back(InstancePtr);
   for (auto const *Argument : Inst->getArguments())
     Arguments.push_back(Context[*Argument]);
-  return Builder.CreateCall(Callee, Arguments);
+  return createCall(
+      Callee, std::move(Arguments), Inst->getTarget()->getType(),
+      Inst->isTailCall());
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::CallIndirect const *Inst) {
+  auto const &Layout = Context.getLayout();
   auto *InstancePtr = Context.getInstancePtr();
   auto *Index = Context[*Inst->getOperand()];
-  auto *Table =
-      Context.getLayout().get(Builder, InstancePtr, *Inst->getIndirectTable());
-  if (!Context.getLayout().getTranslationOptions().SkipTblBoundaryCheck) {
-    auto *BuiltinTableGuard =
-        Context.getLayout().getBuiltin("__sable_table_guard");
-    Builder.CreateCall(BuiltinTableGuard, {Table, Index});
-  }
-  auto *ExpectSignature = Builder.getCStr(
-      Context.getLayout().getSignature(Inst->getExpectType()),
-      "indirect.call.signature");
-  auto *BuiltinTableCheck =
-      Context.getLayout().getBuiltin("__sable_table_check");
-  Builder.CreateCall(BuiltinTableCheck, {Table, Index, ExpectSignature});
-  auto *BuiltinTableFunction =
-      Context.getLayout().getBuiltin("__sable_table_function");
-  auto *BuiltinTableContext =
-      Context.getLayout().getBuiltin("__sable_table_context");
-
-  llvm::Value *CalleeContext =
-      Builder.CreateCall(BuiltinTableContext, {Table, Index});
-  auto *CalleeFunction =
-      Builder.CreateCall(BuiltinTableFunction, {Table, Index});
+  auto *Table = Layout.get(Builder, InstancePtr, *Inst->getIndirectTable());
+
+  // Out of bound indices, null entries (signature ID 0 is never expected) and
+  // signature mismatches all end up in the cold path, where the runtime
+  // reports the precise error.
+  auto &LLVMContext = Context.getTarget().getContext();
+  auto *TrapBB = llvm::BasicBlock::Create(
+      LLVMContext, "table.trap", std::addressof(Context.getTarget()));
+  llvm::MDBuilder MDBuilder(LLVMContext);
+  auto *BranchWeights = MDBuilder.createBranchWeights(1, (1U << 20) - 1);
+
+  if (!Layout.getTranslationOptions().SkipTblBoundaryCheck) {
+    auto *TableSize = Layout.getTableSize(Builder, Table);
+    auto *IsOutOfBound = Builder.CreateICmpUGE(Index, TableSize);
+    auto *InBoundBB = Context.createBasicBlock(*Inst->getParent());
+    Builder.CreateCondBr(IsOutOfBound, TrapBB, InBoundBB, BranchWeights);
+    Builder.SetInsertPoint(InBoundBB);
+  }
 
+  auto *TableEntry = Layout.getTableEntryPtr(Builder, Table, Index);
+  auto *SignatureIDAddr = Builder.CreateStructGEP(TableEntry, 2);
+  auto *SignatureID = Builder.CreateLoad(SignatureIDAddr);
+  Layout.setTBAATag(SignatureID, EntityLayout::AccessKind::Table);
+  auto *ExpectSignatureID =
+      Layout.getSignatureID(Builder, Inst->getExpectType());
+  auto *IsMismatch = Builder.CreateICmpNE(SignatureID, ExpectSignatureID);
+  auto *ContinueBB = Context.createBasicBlock(*Inst->getParent());
+  Builder.CreateCondBr(IsMismatch, TrapBB, ContinueBB, BranchWeights);
+
+  auto *BuiltinTableCheck = Layout.getBuiltin("__sable_table_check");
+  IRBuilder TrapBuilder(*TrapBB);
+  TrapBuilder.CreateCall(BuiltinTableCheck, {Table, Index, ExpectSignatureID});
+  TrapBuilder.CreateUnreachable();
+
+  Builder.SetInsertPoint(ContinueBB);
+  auto *CalleeContextAddr = Builder.CreateStructGEP(TableEntry, 0);
+  auto *CalleeFunctionAddr = Builder.CreateStructGEP(TableEntry, 1);
+  auto *CalleeContextLoad = Builder.CreateLoad(CalleeContextAddr);
+  auto *CalleeFunction = Builder.CreateLoad(CalleeFunctionAddr);
+  Layout.setTBAATag(CalleeContextLoad, EntityLayout::AccessKind::Table);
+  Layout.setTBAATag(CalleeFunction, EntityLayout::AccessKind::Table);
+
+  // host functions placed into tables have no context
+  llvm::Value *CalleeContext = CalleeContextLoad;
   auto *IsNullTest = Builder.CreateIsNull(CalleeContext);
   CalleeContext = Builder.CreateSelect(IsNullTest, InstancePtr, CalleeContext);
 
   std::vector<llvm::Value *> Arguments;
-  Arguments.reserve(Inst->getNumArguments() + 1);
+  Arguments.reserve(Inst->getNumArguments() + 2);
   Arguments.push_back(CalleeContext);
   for (auto const *Argument : Inst->getArguments())
     Arguments.push_back(Context[*Argument]);
 
-  auto *CalleeTy = Context.getLayout().convertType(Inst->getExpectType());
+  auto *CalleeTy = Layout.convertType(Inst->getExpectType());
   auto *CalleePtrTy = llvm::PointerType::getUnqual(CalleeTy);
   auto *CalleePtr = Builder.CreatePointerCast(CalleeFunction, CalleePtrTy);
   llvm::FunctionCallee Callee(CalleeTy, CalleePtr);
-  return Builder.CreateCall(Callee, Arguments);
+  return createCall(
+      Callee, std::move(Arguments), Inst->getExpectType(), Inst->isTailCall());
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::Select const *Inst) {
@@ -157,7 +254,9 @@ llvm::Value *TranslationVisitor::operator()(minsts::GlobalGet const *Inst) {
   auto *GlobalType = Context.getLayout().convertType(GlobalValueType);
   auto *GlobalPtrType = llvm::PointerType::getUnqual(GlobalType);
   Global = Builder.CreatePointerCast(Global, GlobalPtrType);
-  return Builder.CreateLoad(Global);
+  auto *Result = Builder.CreateLoad(Global);
+  Context.getLayout().setTBAATag(Result, EntityLayout::AccessKind::Global);
+  return Result;
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::GlobalSet const *Inst) {
@@ -169,7 +268,9 @@ llvm::Value *TranslationVisitor::operator()(minsts::GlobalSet const *Inst) {
   auto *GlobalType = Context.getLayout().convertType(GlobalValueType);
   auto *GlobalPtrType = llvm::PointerType::getUnqual(GlobalType);
   Global = Builder.CreatePointerCast(Global, GlobalPtrType);
-  return Builder.CreateStore(Value, Global);
+  auto *Result = Builder.CreateStore(Value, Global);
+  Context.getLayout().setTBAATag(Result, EntityLayout::AccessKind::Global);
+  return Result;
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::Constant const *Inst) {
@@ -619,8 +720,7 @@ llvm::Value *TranslationVisitor::operator()(minsts::Binary const *Inst) {
 
 llvm::Value *TranslationVisitor::getMemoryRWPtr(
     mir::Memory const &Memory, llvm::Value *Offset) {
-  auto *InstancePtr = Context.getInstancePtr();
-  auto *Address = Context.getLayout().get(Builder, InstancePtr, Memory);
+  auto *Address = Context.getMemoryBase(Builder, Memory);
   Address = Builder.CreatePtrToInt(Address, Builder.getIntPtrTy());
   if (Offset->getType() != Builder.getIntPtrTy())
     Offset = Builder.CreateZExtOrTrunc(Offset, Builder.getIntPtrTy());
@@ -628,6 +728,11 @@ llvm::Value *TranslationVisitor::getMemoryRWPtr(
   return Address;
 }
 
+void TranslationVisitor::setLinearMemoryTBAATag(llvm::Instruction *Inst) {
+  auto AccessKind = EntityLayout::AccessKind::LinearMemory;
+  Context.getLayout().setTBAATag(Inst, AccessKind);
+}
+
 llvm::Value *TranslationVisitor::operator()(minsts::Load const *Inst) {
   auto *MIRMemory = Inst->getLinearMemory();
   auto *Offset = Context[*Inst->getAddress()];
@@ -639,6 +744,7 @@ llvm::Value *TranslationVisitor::operator()(minsts::Load const *Inst) {
     auto *LoadPtrTy = llvm::PointerType::getUnqual(LoadTy);
     Address = Builder.CreateIntToPtr(Address, LoadPtrTy);
     auto *LoadInst = Builder.CreateLoad(Address);
+    setLinearMemoryTBAATag(LoadInst);
     if (!Context.getLayout().getTranslationOptions().AssumeMemRWAligned)
       LoadInst->setAlignment(llvm::Align(1));
     return LoadInst;
@@ -653,6 +759,7 @@ llvm::Value *TranslationVisitor::operator()(minsts::Load const *Inst) {
     auto *LoadPtrTy = llvm::PointerType::getUnqual(LoadTy);
     Address = Builder.CreateIntToPtr(Address, LoadPtrTy);
     auto *LoadInst = Builder.CreateLoad(Address);
+    setLinearMemoryTBAATag(LoadInst);
     if (!Context.getLayout().getTranslationOptions().AssumeMemRWAligned)
       LoadInst->setAlignment(llvm::Align(1));
     llvm::Value *Result = LoadInst;
@@ -665,6 +772,7 @@ llvm::Value *TranslationVisitor::operator()(minsts::Load const *Inst) {
     auto *LoadPtrTy = llvm::PointerType::getUnqual(LoadTy);
     Address = Builder.CreateIntToPtr(Address, LoadPtrTy);
     auto *LoadInst = Builder.CreateLoad(Address);
+    setLinearMemoryTBAATag(LoadInst);
     if (!Context.getLayout().getTranslationOptions().AssumeMemRWAligned)
       LoadInst->setAlignment(llvm::Align(1));
     llvm::Value *Result = LoadInst;
@@ -701,44 +809,388 @@ llvm::Value *TranslationVisitor::operator()(minsts::Store const *Inst) {
   auto *StorePtrTy = llvm::PointerType::getUnqual(StoreTy);
   Address = Builder.CreateIntToPtr(Address, StorePtrTy);
   auto *Result = Builder.CreateStore(Value, Address);
+  setLinearMemoryTBAATag(Result);
   if (!Context.getLayout().getTranslationOptions().AssumeMemRWAligned)
     Result->setAlignment(llvm::Align(1));
   return Result;
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::MemoryGuard const *Inst) {
-  if (Context.getLayout().getTranslationOptions().SkipMemBoundaryCheck)
-    return nullptr;
-  auto *InstancePtr = Context.getInstancePtr();
-  auto *BuiltinMemoryGuard =
-      Context.getLayout().getBuiltin("__sable_memory_guard");
-  auto *Memory =
-      Context.getLayout().get(Builder, InstancePtr, *Inst->getLinearMemory());
+  auto const &Options = Context.getLayout().getTranslationOptions();
+  auto const &MIRMemory = *Inst->getLinearMemory();
+  auto IsMemory64 = MIRMemory.getType().isMemory64();
+  if (Options.SkipMemBoundaryCheck) return nullptr;
+  // the reservation of 32-bit memories covers any index plus offset
+  if (Options.UseMemGuardPage && !IsMemory64) return nullptr;
+  // guard size is in bits, the boundary check is computed in bytes with the
+  // native pointer width so that it never wraps around
   llvm::Value *Offset = Context[*Inst->getAddress()];
-  auto *GuardSize = Builder.getInt32(Inst->getGuardSize());
-  Offset = Builder.CreateNUWAdd(Offset, GuardSize);
-  return Builder.CreateCall(BuiltinMemoryGuard, {Memory, Offset});
+  Offset = Builder.CreateZExt(Offset, Builder.getIntPtrTy());
+  auto *GuardSize = llvm::ConstantInt::get(
+      Builder.getIntPtrTy(), (Inst->getGuardSize() + 7) / 8);
+  if (Options.UseMemGuardPage) {
+    // guard sizes never exceed the guard region trailing 64-bit memories,
+    // an access starting within the memory faults there if it overruns
+    guardMemoryLimit(
+        *Inst->getParent(), MIRMemory, llvm::CmpInst::ICMP_UGE, Offset,
+        Offset);
+  } else if (IsMemory64) {
+    // a 64-bit index may already take the whole pointer width
+    auto *GuardAddress = Builder.CreateIntrinsicAddSatU(Offset, GuardSize);
+    guardMemoryLimit(
+        *Inst->getParent(), MIRMemory, llvm::CmpInst::ICMP_UGT, GuardAddress,
+        Offset);
+  } else {
+    auto *GuardAddress = Builder.CreateNUWAdd(Offset, GuardSize);
+    guardMemoryLimit(
+        *Inst->getParent(), MIRMemory, llvm::CmpInst::ICMP_UGT, GuardAddress,
+        Offset);
+  }
+  return nullptr;
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::MemoryGrow const *Inst) {
   auto *InstancePtr = Context.getInstancePtr();
-  auto *BuiltinMemoryGrow =
-      Context.getLayout().getBuiltin("__sable_memory_grow");
+  auto IsMemory64 = Inst->getLinearMemory()->getType().isMemory64();
+  auto *BuiltinMemoryGrow = Context.getLayout().getBuiltin(
+      IsMemory64 ? "__sable_memory_grow64" : "__sable_memory_grow");
   auto *Memory =
       Context.getLayout().get(Builder, InstancePtr, *Inst->getLinearMemory());
   auto *DeltaSize = Context[*Inst->getSize()];
-  return Builder.CreateCall(BuiltinMemoryGrow, {Memory, DeltaSize});
+  auto *Result = Builder.CreateCall(BuiltinMemoryGrow, {Memory, DeltaSize});
+  Context.reloadMemoryCache(Builder, Inst->getLinearMemory());
+  return Result;
 }
 
 llvm::Value *TranslationVisitor::operator()(minsts::MemorySize const *Inst) {
   auto *InstancePtr = Context.getInstancePtr();
-  auto *BuiltinMemorySize =
-      Context.getLayout().getBuiltin("__sable_memory_size");
+  auto IsMemory64 = Inst->getLinearMemory()->getType().isMemory64();
+  auto *BuiltinMemorySize = Context.getLayout().getBuiltin(
+      IsMemory64 ? "__sable_memory_size64" : "__sable_memory_size");
   auto *Memory =
       Context.getLayout().get(Builder, InstancePtr, *Inst->getLinearMemory());
   return Builder.CreateCall(BuiltinMemorySize, {Memory});
 }
 
+// Branches to __sable_memory_trap if End Predicate the cached size of Memory
+// holds, Offset is the offset reported. Another thread may grow a shared
+// memory at any time and its cached size then lags behind. Memories never
+// shrink, hence only the trap path reloads the size from the instance and
+// checks End again before trapping.
+void TranslationVisitor::guardMemoryLimit(
+    mir::BasicBlock const &BasicBlock, mir::Memory const &Memory,
+    llvm::CmpInst::Predicate Predicate, llvm::Value *End,
+    llvm::Value *Offset) {
+  auto *MemorySize = Context.getMemorySize(Builder, Memory);
+  auto *IsOutOfBound = Builder.CreateICmp(Predicate, End, MemorySize);
+
+  auto &LLVMContext = Context.getTarget().getContext();
+  auto *TrapBB = llvm::BasicBlock::Create(
+      LLVMContext, "memory.trap", std::addressof(Context.getTarget()));
+  auto *ContinueBB = Context.createBasicBlock(BasicBlock);
+  llvm::MDBuilder MDBuilder(LLVMContext);
+  auto *BranchWeights = MDBuilder.createBranchWeights(1, (1U << 20) - 1);
+  Builder.CreateCondBr(IsOutOfBound, TrapBB, ContinueBB, BranchWeights);
+
+  IRBuilder TrapBuilder(*TrapBB);
+  if (Memory.getType().isShared()) {
+    auto *GrownMemorySize = Context.reloadMemorySize(TrapBuilder, Memory);
+    auto *IsGrownOutOfBound =
+        TrapBuilder.CreateICmp(Predicate, End, GrownMemorySize);
+    auto *GrownTrapBB = llvm::BasicBlock::Create(
+        LLVMContext, "memory.trap", std::addressof(Context.getTarget()));
+    TrapBuilder.CreateCondBr(IsGrownOutOfBound, GrownTrapBB, ContinueBB);
+    TrapBuilder.SetInsertPoint(GrownTrapBB);
+  }
+  auto *BuiltinMemoryTrap =
+      Context.getLayout().getBuiltin("__sable_memory_trap");
+  auto *MemoryBase = Context.getMemoryBase(TrapBuilder, Memory);
+  TrapBuilder.CreateCall(BuiltinMemoryTrap, {MemoryBase, Offset});
+  TrapBuilder.CreateUnreachable();
+
+  Builder.SetInsertPoint(ContinueBB);
+}
+
+// Bulk operations check their whole range up front, hence an out-of-bound
+// operation traps before any byte is written. Offset and Size are zero
+// extended so that the end of the range never wraps around, 64-bit operands
+// saturate instead.
+void TranslationVisitor::guardMemoryRange(
+    mir::BasicBlock const &BasicBlock, mir::Memory const &Memory,
+    llvm::Value *Offset, llvm::Value *Size) {
+  auto const &Options = Context.getLayout().getTranslationOptions();
+  if (Options.SkipMemBoundaryCheck) return;
+  auto IsWide = Offset->getType()->getIntegerBitWidth() >= 64 ||
+                Size->getType()->getIntegerBitWidth() >= 64;
+  Offset = Builder.CreateZExt(Offset, Builder.getIntPtrTy());
+  Size = Builder.CreateZExt(Size, Builder.getIntPtrTy());
+  auto *End = IsWide ? Builder.CreateIntrinsicAddSatU(Offset, Size)
+                     : Builder.CreateNUWAdd(Offset, Size);
+  guardMemoryLimit(BasicBlock, Memory, llvm::CmpInst::ICMP_UGT, End, Offset);
+}
+
+// memory.init reads its source range from the remaining size of Segment, zero
+// once dropped. Offset and Size are 32-bit, their sum never wraps around in
+// the pointer width. Past the end it branches to __sable_data_trap.
+void TranslationVisitor::guardDataRange(
+    mir::BasicBlock const &BasicBlock, mir::Data const &Segment,
+    llvm::Value *Offset, llvm::Value *Size) {
+  auto &Layout = Context.getLayout();
+  if (Layout.getTranslationOptions().SkipMemBoundaryCheck) return;
+  auto *DataSizePtr =
+      Layout.getDataSizePtr(Builder, Context.getInstancePtr(), Segment);
+  auto *DataSize = Builder.CreateLoad(DataSizePtr);
+  Layout.setTBAATag(DataSize, EntityLayout::AccessKind::Instance);
+  Offset = Builder.CreateZExt(Offset, Builder.getIntPtrTy());
+  Size = Builder.CreateZExt(Size, Builder.getIntPtrTy());
+  auto *End = Builder.CreateNUWAdd(Offset, Size);
+  auto *IsOutOfBound = Builder.CreateICmpUGT(End, DataSize);
+
+  auto &LLVMContext = Context.getTarget().getContext();
+  auto *TrapBB = llvm::BasicBlock::Create(
+      LLVMContext, "data.trap", std::addressof(Context.getTarget()));
+  auto *ContinueBB = Context.createBasicBlock(BasicBlock);
+  llvm::MDBuilder MDBuilder(LLVMContext);
+  auto *BranchWeights = MDBuilder.createBranchWeights(1, (1U << 20) - 1);
+  Builder.CreateCondBr(IsOutOfBound, TrapBB, ContinueBB, BranchWeights);
+
+  IRBuilder TrapBuilder(*TrapBB);
+  auto *BuiltinDataTrap = Layout.getBuiltin("__sable_data_trap");
+  TrapBuilder.CreateCall(BuiltinDataTrap, {Offset, Size});
+  TrapBuilder.CreateUnreachable();
+
+  Builder.SetInsertPoint(ContinueBB);
+}
+
+llvm::Value *TranslationVisitor::operator()(minsts::MemoryInit const *Inst) {
+  auto &Layout = Context.getLayout();
+  auto const &MIRMemory = *Inst->getLinearMemory();
+  auto const &Segment = *Inst->getSegment();
+  auto *Destination = Context[*Inst->getDestination()];
+  auto *Offset = Context[*Inst->getOffset()];
+  auto *Size = Context[*Inst->getSize()];
+  guardMemoryRange(*Inst->getParent(), MIRMemory, Destination, Size);
+  guardDataRange(*Inst->getParent(), Segment, Offset, Size);
+
+  // active segments are always dropped, only a zero sized copy gets here
+  llvm::Value *Source = llvm::ConstantPointerNull::get(Builder.getInt8PtrTy());
+  if (Segment.isPassive()) {
+    Source = Builder.CreatePointerCast(Layout[Segment], Builder.getInt8PtrTy());
+    Offset = Builder.CreateZExt(Offset, Builder.getIntPtrTy());
+    Source = Builder.CreateInBoundsGEP(Builder.getInt8Ty(), Source, Offset);
+  }
+  auto *Address = getMemoryRWPtr(MIRMemory, Destination);
+  Address = Builder.CreateIntToPtr(Address, Builder.getInt8PtrTy());
+  auto *Result = Builder.CreateMemCpy(
+      Address, llvm::MaybeAlign(1), Source, llvm::MaybeAlign(1), Size);
+  setLinearMemoryTBAATag(Result);
+  return Result;
+}
+
+llvm::Value *TranslationVisitor::operator()(minsts::DataDrop const *Inst) {
+  auto &Layout = Context.getLayout();
+  auto *DataSizePtr = Layout.getDataSizePtr(
+      Builder, Context.getInstancePtr(), *Inst->getSegment());
+  auto *Result = Builder.CreateStore(
+      llvm::ConstantInt::get(Builder.getIntPtrTy(), 0), DataSizePtr);
+  Layout.setTBAATag(Result, EntityLayout::AccessKind::Instance);
+  return Result;
+}
+
+llvm::Value *TranslationVisitor::operator()(minsts::MemoryCopy const *Inst) {
+  auto const &MIRMemory = *Inst->getLinearMemory();
+  auto const &MIRSourceMemory = *Inst->getSourceMemory();
+  auto *Destination = Context[*Inst->getDestination()];
+  auto *Source = Context[*Inst->getSource()];
+  auto *Size = Context[*Inst->getSize()];
+  guardMemoryRange(*Inst->getParent(), MIRMemory, Destination, Size);
+  guardMemoryRange(*Inst->getParent(), MIRSourceMemory, Source, Size);
+  auto *DestinationAddress = getMemoryRWPtr(MIRMemory, Destination);
+  DestinationAddress =
+      Builder.CreateIntToPtr(DestinationAddress, Builder.getInt8PtrTy());
+  auto *SourceAddress = getMemoryRWPtr(MIRSourceMemory, Source);
+  SourceAddress = Builder.CreateIntToPtr(SourceAddress, Builder.getInt8PtrTy());
+  auto *Result = Builder.CreateMemMove(
+      DestinationAddress, llvm::MaybeAlign(1), SourceAddress,
+      llvm::MaybeAlign(1), Size);
+  setLinearMemoryTBAATag(Result);
+  return Result;
+}
+
+llvm::Value *TranslationVisitor::operator()(minsts::MemoryFill const *Inst) {
+  auto const &MIRMemory = *Inst->getLinearMemory();
+  auto *Destination = Context[*Inst->getDestination()];
+  auto *Value = Context[*Inst->getValue()];
+  auto *Size = Context[*Inst->getSize()];
+  guardMemoryRange(*Inst->getParent(), MIRMemory, Destination, Size);
+  auto *Address = getMemoryRWPtr(MIRMemory, Destination);
+  Address = Builder.CreateIntToPtr(Address, Builder.getInt8PtrTy());
+  Value = Builder.CreateTrunc(Value, Builder.getInt8Ty());
+  auto *Result =
+      Builder.CreateMemSet(Address, Value, Size, llvm::MaybeAlign(1));
+  setLinearMemoryTBAATag(Result);
+  return Result;
+}
+
+// atomic accesses are never split, a misaligned effective address traps
+void TranslationVisitor::guardAtomicAlignment(minsts::Atomic const &Inst) {
+  auto NumBytes = Inst.getWidth() / 8;
+  if (NumBytes <= 1) return;
+  auto *BuiltinUnalignedTrap =
+      Context.getLayout().getBuiltin("__sable_memory_unaligned_trap");
+  auto const &MIRMemory = *Inst.getLinearMemory();
+  auto *Offset = Context[*Inst.getAddress()];
+  auto *Mask = llvm::ConstantInt::get(Offset->getType(), NumBytes - 1);
+  auto *Misalignment = Builder.CreateAnd(Offset, Mask);
+  auto *IsUnaligned = Builder.CreateICmpNE(
+      Misalignment, llvm::ConstantInt::get(Offset->getType(), 0));
+
+  auto &LLVMContext = Context.getTarget().getContext();
+  auto *TrapBB = llvm::BasicBlock::Create(
+      LLVMContext, "atomic.unaligned", std::addressof(Context.getTarget()));
+  auto *ContinueBB = Context.createBasicBlock(*Inst.getParent());
+  llvm::MDBuilder MDBuilder(LLVMContext);
+  auto *BranchWeights = MDBuilder.createBranchWeights(1, (1U << 20) - 1);
+  Builder.CreateCondBr(IsUnaligned, TrapBB, ContinueBB, BranchWeights);
+
+  IRBuilder TrapBuilder(*TrapBB);
+  auto *Memory = Context.getMemoryBase(TrapBuilder, MIRMemory);
+  auto *TrapOffset = TrapBuilder.CreateZExt(Offset, TrapBuilder.getIntPtrTy());
+  TrapBuilder.CreateCall(BuiltinUnalignedTrap, {Memory, TrapOffset});
+  TrapBuilder.CreateUnreachable();
+
+  Builder.SetInsertPoint(ContinueBB);
+}
+
+llvm::Value *
+TranslationVisitor::getAtomicRWPtr(minsts::Atomic const &Inst) {
+  guardAtomicAlignment(Inst);
+  auto *Offset = Context[*Inst.getAddress()];
+  auto *Address = getMemoryRWPtr(*Inst.getLinearMemory(), Offset);
+  auto *AccessPtrTy =
+      llvm::PointerType::getUnqual(Builder.getIntNTy(Inst.getWidth()));
+  return Builder.CreateIntToPtr(Address, AccessPtrTy);
+}
+
+llvm::Value *
+TranslationVisitor::operator()(minsts::atomic::AtomicLoad const *Inst) {
+  auto *Address = getAtomicRWPtr(*Inst);
+  auto *LoadInst = Builder.CreateLoad(Address);
+  setLinearMemoryTBAATag(LoadInst);
+  LoadInst->setAlignment(llvm::Align(Inst->getWidth() / 8));
+  LoadInst->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+  auto *ExpectLoadTy = Context.getLayout().convertType(Inst->getType());
+  llvm::Value *Result = LoadInst;
+  if (ExpectLoadTy != LoadInst->getType())
+    Result = Builder.CreateZExt(Result, ExpectLoadTy);
+  return Result;
+}
+
+llvm::Value *
+TranslationVisitor::operator()(minsts::atomic::AtomicStore const *Inst) {
+  auto *Address = getAtomicRWPtr(*Inst);
+  llvm::Value *Value = Context[*Inst->getOperand()];
+  auto *StoreTy = Builder.getIntNTy(Inst->getWidth());
+  if (Value->getType() != StoreTy) Value = Builder.CreateTrunc(Value, StoreTy);
+  auto *StoreInst = Builder.CreateStore(Value, Address);
+  setLinearMemoryTBAATag(StoreInst);
+  StoreInst->setAlignment(llvm::Align(Inst->getWidth() / 8));
+  StoreInst->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+  return StoreInst;
+}
+
+namespace {
+llvm::AtomicRMWInst::BinOp
+convertRMWOperator(minsts::atomic::AtomicRMWOperator Operator) {
+  using RMWOperator = minsts::atomic::AtomicRMWOperator;
+  // clang-format off
+  switch (Operator) {
+  case RMWOperator::Add : return llvm::AtomicRMWInst::BinOp::Add ;
+  case RMWOperator::Sub : return llvm::AtomicRMWInst::BinOp::Sub ;
+  case RMWOperator::And : return llvm::AtomicRMWInst::BinOp::And ;
+  case RMWOperator::Or  : return llvm::AtomicRMWInst::BinOp::Or  ;
+  case RMWOperator::Xor : return llvm::AtomicRMWInst::BinOp::Xor ;
+  case RMWOperator::Xchg: return llvm::AtomicRMWInst::BinOp::Xchg;
+  default: utility::unreachable();
+  }
+  // clang-format on
+}
+} // namespace
+
+llvm::Value *
+TranslationVisitor::operator()(minsts::atomic::AtomicRMW const *Inst) {
+  auto *Address = getAtomicRWPtr(*Inst);
+  llvm::Value *Value = Context[*Inst->getOperand()];
+  auto *ResultTy = Value->getType();
+  auto *AccessTy = Builder.getIntNTy(Inst->getWidth());
+  if (ResultTy != AccessTy) Value = Builder.CreateTrunc(Value, AccessTy);
+  llvm::Value *Result = Builder.CreateAtomicRMW(
+      convertRMWOperator(Inst->getOperator()), Address, Value,
+      llvm::MaybeAlign(Inst->getWidth() / 8),
+      llvm::AtomicOrdering::SequentiallyConsistent);
+  if (ResultTy != AccessTy) Result = Builder.CreateZExt(Result, ResultTy);
+  return Result;
+}
+
+llvm::Value *
+TranslationVisitor::operator()(minsts::atomic::AtomicCmpxchg const *Inst) {
+  auto *Address = getAtomicRWPtr(*Inst);
+  llvm::Value *Expected = Context[*Inst->getExpected()];
+  llvm::Value *Replacement = Context[*Inst->getReplacement()];
+  auto *ResultTy = Expected->getType();
+  auto *AccessTy = Builder.getIntNTy(Inst->getWidth());
+  if (ResultTy != AccessTy) {
+    Expected = Builder.CreateTrunc(Expected, AccessTy);
+    Replacement = Builder.CreateTrunc(Replacement, AccessTy);
+  }
+  auto *CmpxchgInst = Builder.CreateAtomicCmpXchg(
+      Address, Expected, Replacement, llvm::MaybeAlign(Inst->getWidth() / 8),
+      llvm::AtomicOrdering::SequentiallyConsistent,
+      llvm::AtomicOrdering::SequentiallyConsistent);
+  llvm::Value *Result = Builder.CreateExtractValue(CmpxchgInst, {0});
+  if (ResultTy != AccessTy) Result = Builder.CreateZExt(Result, ResultTy);
+  return Result;
+}
+
+llvm::Value *
+TranslationVisitor::operator()(minsts::atomic::AtomicWait const *Inst) {
+  guardAtomicAlignment(*Inst);
+  auto *BuiltinMemoryWait = Context.getLayout().getBuiltin(
+      Inst->getWidth() == 32 ? "__sable_memory_wait32"
+                             : "__sable_memory_wait64");
+  auto *InstancePtr = Context.getInstancePtr();
+  auto *Memory =
+      Context.getLayout().get(Builder, InstancePtr, *Inst->getLinearMemory());
+  auto *Offset = Context[*Inst->getAddress()];
+  Offset = Builder.CreateZExt(Offset, Builder.getIntPtrTy());
+  auto *Expected = Context[*Inst->getExpected()];
+  auto *Timeout = Context[*Inst->getTimeout()];
+  return Builder.CreateCall(
+      BuiltinMemoryWait, {Memory, Offset, Expected, Timeout});
+}
+
+llvm::Value *
+TranslationVisitor::operator()(minsts::atomic::AtomicNotify const *Inst) {
+  guardAtomicAlignment(*Inst);
+  auto *BuiltinMemoryNotify =
+      Context.getLayout().getBuiltin("__sable_memory_notify");
+  auto *InstancePtr = Context.getInstancePtr();
+  auto *Memory =
+      Context.getLayout().get(Builder, InstancePtr, *Inst->getLinearMemory());
+  auto *Offset = Context[*Inst->getAddress()];
+  Offset = Builder.CreateZExt(Offset, Builder.getIntPtrTy());
+  auto *Count = Context[*Inst->getCount()];
+  return Builder.CreateCall(BuiltinMemoryNotify, {Memory, Offset, Count});
+}
+
+llvm::Value *TranslationVisitor::operator()(minsts::Atomic const *Inst) {
+  return AtomicVisitorBase::visit(Inst);
+}
+
+llvm::Value *TranslationVisitor::operator()(minsts::AtomicFence const *) {
+  return Builder.CreateFence(llvm::AtomicOrdering::SequentiallyConsistent);
+}
+
 llvm::Value *TranslationVisitor::operator()(minsts::Pack const *Inst) {
   // clang-format off
   auto Members = Inst->getArguments()
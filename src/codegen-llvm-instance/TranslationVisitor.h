@@ -1,6 +1,7 @@
 #ifndef SABLE_INCLUDE_GUARD_CODEGEN_LLVM_CTX_TRANSLATION_VISITOR
 #define SABLE_INCLUDE_GUARD_CODEGEN_LLVM_CTX_TRANSLATION_VISITOR
 
+#include "../mir/Atomic.h"
 #include "../mir/Binary.h"
 #include "../mir/Branch.h"
 #include "../mir/Cast.h"
@@ -10,6 +11,8 @@
 #include "../mir/Unary.h"
 #include "../mir/Vector.h"
 
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Value.h>
 
 namespace codegen::llvm_instance {
@@ -20,6 +23,7 @@ class TranslationVisitor :
     public mir::InstVisitorBase<TranslationVisitor, llvm::Value *>,
     public mir::instructions::BranchVisitorBase<TranslationVisitor, llvm::Value *>,
     public mir::instructions::CompareVisitorBase<TranslationVisitor, llvm::Value *>,
+    public mir::instructions::AtomicVisitorBase<TranslationVisitor, llvm::Value *>,
     public mir::instructions::UnaryVisitorBase<TranslationVisitor, llvm::Value *>,
     public mir::instructions::BinaryVisitorBase<TranslationVisitor, llvm::Value *>, 
     public mir::instructions::VectorSplatVisitorBase<TranslationVisitor, llvm::Value *>,
@@ -29,8 +33,27 @@ class TranslationVisitor :
 {
   TranslationContext &Context;
   IRBuilder &Builder;
+  // raw result of the tail call the next return forwards
+  llvm::CallInst *PendingTailCall = nullptr;
 
   llvm::Value *getMemoryRWPtr(mir::Memory const &Memory, llvm::Value *Address);
+  void setLinearMemoryTBAATag(llvm::Instruction *Inst);
+  void guardAtomicAlignment(mir::instructions::Atomic const &Inst);
+  void setTailCallKind(llvm::CallInst *Call);
+  llvm::Value *createCall(
+      llvm::FunctionCallee Callee, std::vector<llvm::Value *> Arguments,
+      bytecode::FunctionType const &Type, bool IsTailCall);
+  void guardMemoryLimit(
+      mir::BasicBlock const &BasicBlock, mir::Memory const &Memory,
+      llvm::CmpInst::Predicate Predicate, llvm::Value *End,
+      llvm::Value *Offset);
+  void guardMemoryRange(
+      mir::BasicBlock const &BasicBlock, mir::Memory const &Memory,
+      llvm::Value *Offset, llvm::Value *Size);
+  void guardDataRange(
+      mir::BasicBlock const &BasicBlock, mir::Data const &Segment,
+      llvm::Value *Offset, llvm::Value *Size);
+  llvm::Value *getAtomicRWPtr(mir::instructions::Atomic const &Inst);
 
   template <mir::instructions::CastOpcode Opcode>
   llvm::Value *codegenCast(llvm::Value *); // See TranslationCasts.cc
@@ -88,6 +111,20 @@ public:
   SABLE_ON(MemoryGuard)
   SABLE_ON(MemoryGrow)
   SABLE_ON(MemorySize)
+  SABLE_ON(MemoryInit)
+  SABLE_ON(DataDrop)
+  SABLE_ON(MemoryCopy)
+  SABLE_ON(MemoryFill)
+
+  SABLE_ON(atomic::AtomicLoad)
+  SABLE_ON(atomic::AtomicStore)
+  SABLE_ON(atomic::AtomicRMW)
+  SABLE_ON(atomic::AtomicCmpxchg)
+  SABLE_ON(atomic::AtomicWait)
+  SABLE_ON(atomic::AtomicNotify)
+  SABLE_ON(Atomic)
+  SABLE_ON(AtomicFence)
+
   SABLE_ON(Cast)
   SABLE_ON(Pack)
   SABLE_ON(Unpack)
@@ -2,29 +2,39 @@
 #include "WASITypes.h"
 #include "WebAssemblyInstance.h"
 
+#include <dirent.h>
 #include <fcntl.h>
+#include <linux/openat2.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <array>
+#include <atomic>
+#include <climits>
 #include <cstdlib>
 #include <ctime>
+#include <optional>
 #include <random>
+#include <shared_mutex>
 #include <span>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace runtime::wasi {
 namespace {
-constexpr wasi_fd_t WASI_STDIN = 0;
-constexpr wasi_fd_t WASI_STDOUT = 1;
-constexpr wasi_fd_t WASI_STDERR = 2;
-
 __sable_memory_t *getImplicitLinearMemory(__sable_instance_t *InstancePtr) {
   auto &Instance = *WebAssemblyInstance::fromInstancePtr(InstancePtr);
   return Instance.getMemory("memory").asInstancePtr();
 }
 
+// Address may lie past the 32-bit space when computed from a guest address
+// plus an offset, it is bounds checked whole rather than wrapped around.
 template <typename T>
-T read(__sable_memory_t *MemoryPtr, std::uint32_t Address) {
+T read(__sable_memory_t *MemoryPtr, std::size_t Address) {
   __sable_memory_guard(MemoryPtr, Address + sizeof(T));
   auto &Memory = *WebAssemblyMemory::fromInstancePtr(MemoryPtr);
   T Result{};
@@ -36,71 +46,1067 @@ T read(__sable_memory_t *MemoryPtr, std::uint32_t Address) {
 
 template <typename T>
 void write(__sable_memory_t *MemoryPtr, std::uint32_t Address, T const &Value) {
-  __sable_memory_guard(MemoryPtr, Address + sizeof(T));
+  __sable_memory_guard(MemoryPtr, std::size_t(Address) + sizeof(T));
   auto &Memory = *WebAssemblyMemory::fromInstancePtr(MemoryPtr);
   auto *Source = std::addressof(Value);
   auto *Dest = std::addressof(Memory[Address]);
   std::memcpy(Dest, Source, sizeof(T));
 }
+
+wasi_errno_t fromHostErrno(int Errno) {
+  // clang-format off
+  switch (Errno) {
+  case E2BIG       : return ERRNO_2BIG;
+  case EACCES      : return ERRNO_ACCES;
+  case EAGAIN      : return ERRNO_AGAIN;
+  case EBADF       : return ERRNO_BADF;
+  case EBUSY       : return ERRNO_BUSY;
+  case EDESTADDRREQ: return ERRNO_DESTADDRRERQ;
+  case EDQUOT      : return ERRNO_DQUOT;
+  case EEXIST      : return ERRNO_EXIST;
+  case EFAULT      : return ERRNO_FAULT;
+  case EFBIG       : return ERRNO_FBIG;
+  case EINTR       : return ERRNO_INTR;
+  case EINVAL      : return ERRNO_INVAL;
+  case EIO         : return ERRNO_IO;
+  case EISDIR      : return ERRNO_ISDIR;
+  case ELOOP       : return ERRNO_LOOP;
+  case EMFILE      : return ERRNO_MFILE;
+  case EMLINK      : return ERRNO_MLINK;
+  case ENAMETOOLONG: return ERRNO_NAMETOOLONG;
+  case ENFILE      : return ERRNO_NFILE;
+  case ENOENT      : return ERRNO_NOENT;
+  case ENOMEM      : return ERRNO_NOMEM;
+  case ENOSPC      : return ERRNO_NOSPC;
+  case ENOSYS      : return ERRNO_NOSYS;
+  case ENOTDIR     : return ERRNO_NOTDIR;
+  case ENOTEMPTY   : return ERRNO_NOTEMPTY;
+  case ENOTSUP     : return ERRNO_NOTSUP;
+  case ENXIO       : return ERRNO_NXIO;
+  case EOVERFLOW   : return ERRNO_OVERFLOW;
+  case EPERM       : return ERRNO_PERM;
+  case EPIPE       : return ERRNO_PIPE;
+  case EROFS       : return ERRNO_ROFS;
+  case ESPIPE      : return ERRNO_SPIPE;
+  case ETXTBSY     : return ERRNO_TXTBSY;
+  case EXDEV       : return ERRNO_XDEV;
+  default: return ERRNO_IO;
+  }
+  // clang-format on
+}
+
+wasi_filetype_t fromHostFileMode(mode_t Mode) {
+  if (S_ISREG(Mode)) return FILETYPE_REGULAR_FILE;
+  if (S_ISDIR(Mode)) return FILETYPE_DIRECTORY;
+  if (S_ISCHR(Mode)) return FILETYPE_CHARACTER_DEVICE;
+  if (S_ISBLK(Mode)) return FILETYPE_BLOCK_DEVICE;
+  if (S_ISLNK(Mode)) return FILETYPE_SYMBOLIC_LINK;
+  if (S_ISSOCK(Mode)) return FILETYPE_SOCKET_STREAM;
+  return FILETYPE_UNKNOWN;
+}
+
+wasi_filestat_t fromHostStat(struct stat const &Stat) {
+  auto ToTimestamp = [](timespec const &Time) -> wasi_timestamp_t {
+    return Time.tv_sec * 1'000'000'000ULL + Time.tv_nsec;
+  };
+  return wasi_filestat_t{
+      .dev = Stat.st_dev,
+      .ino = Stat.st_ino,
+      .filetype = fromHostFileMode(Stat.st_mode),
+      .nlink = Stat.st_nlink,
+      .size = static_cast<wasi_filesize_t>(Stat.st_size),
+      .atim = ToTimestamp(Stat.st_atim),
+      .mtim = ToTimestamp(Stat.st_mtim),
+      .ctim = ToTimestamp(Stat.st_ctim)};
+}
 } // namespace
 
+// Guest file descriptors of a WASIContext, shared by the instances bound to
+// it and their threads.
+struct FileEntry {
+  int HostFD = -1;
+  bool IsOwned = true;     // stdio is borrowed from the host, never closed
+  std::string PreopenName; // empty unless a preopened directory
+  wasi_rights_t RightsBase = RIGHTS_ALL;
+  wasi_rights_t RightsInheriting = RIGHTS_ALL;
+};
+
+class FileTable {
+  mutable std::shared_mutex Mutex;
+  std::vector<std::optional<FileEntry>> Entries;
+
+public:
+  FileTable() {
+    for (int HostFD : {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO}) {
+      FileEntry Entry;
+      Entry.HostFD = HostFD;
+      Entry.IsOwned = false;
+      Entries.push_back(std::move(Entry));
+    }
+  }
+  FileTable(FileTable const &) = delete;
+  FileTable(FileTable &&) noexcept = delete;
+  FileTable &operator=(FileTable const &) = delete;
+  FileTable &operator=(FileTable &&) noexcept = delete;
+  // the descriptors the program left open go with its context
+  ~FileTable() noexcept {
+    for (auto const &Entry : Entries)
+      if (Entry.has_value() && Entry->IsOwned) close(Entry->HostFD);
+  }
+
+  std::optional<FileEntry> get(wasi_fd_t FD) const {
+    std::shared_lock Lock(Mutex);
+    if (FD >= Entries.size()) return std::nullopt;
+    return Entries[FD];
+  }
+
+  // the lowest descriptor not in use, as POSIX open does
+  wasi_fd_t insert(FileEntry Entry) {
+    std::unique_lock Lock(Mutex);
+    for (std::size_t I = 0; I < Entries.size(); ++I) {
+      if (Entries[I].has_value()) continue;
+      Entries[I] = std::move(Entry);
+      return I;
+    }
+    Entries.push_back(std::move(Entry));
+    return Entries.size() - 1;
+  }
+
+  std::optional<FileEntry> erase(wasi_fd_t FD) {
+    std::unique_lock Lock(Mutex);
+    if (FD >= Entries.size()) return std::nullopt;
+    return std::exchange(Entries[FD], std::nullopt);
+  }
+
+  // moves the entry of From to To, both in use, and returns the entry To
+  // held for the caller to close
+  std::optional<FileEntry> renumber(wasi_fd_t From, wasi_fd_t To) {
+    std::unique_lock Lock(Mutex);
+    auto IsInUse = [&](wasi_fd_t FD) {
+      return (FD < Entries.size()) && Entries[FD].has_value();
+    };
+    if (!IsInUse(From) || !IsInUse(To) || (From == To)) return std::nullopt;
+    auto Replaced = std::exchange(Entries[To], std::move(Entries[From]));
+    Entries[From] = std::nullopt;
+    return Replaced;
+  }
+
+  // rights only ever shrink, ERRNO_NOTCAPABLE for any right FD lacks
+  wasi_errno_t setRights(
+      wasi_fd_t FD, wasi_rights_t RightsBase, wasi_rights_t RightsInheriting) {
+    std::unique_lock Lock(Mutex);
+    if ((FD >= Entries.size()) || !Entries[FD].has_value()) return ERRNO_BADF;
+    auto &Entry = *Entries[FD];
+    if (((Entry.RightsBase & RightsBase) != RightsBase) ||
+        ((Entry.RightsInheriting & RightsInheriting) != RightsInheriting))
+      return ERRNO_NOTCAPABLE;
+    Entry.RightsBase = RightsBase;
+    Entry.RightsInheriting = RightsInheriting;
+    return ERRNO_SUCCESS;
+  }
+};
+
+namespace {
+// the WASI context the calling instance is bound to
+FileTable &getFileTable(__sable_instance_t *InstancePtr) {
+  auto &Instance = *WebAssemblyInstance::fromInstancePtr(InstancePtr);
+  auto *Context = static_cast<WASIContext *>(Instance.getHostData().get());
+  if (Context == nullptr)
+    throw std::logic_error("instance is not bound to a WASI context");
+  return Context->getFileTable();
+}
+
+// ERRNO_BADF if the descriptor is not in use, ERRNO_NOTCAPABLE if its base
+// rights lack any of Rights
+wasi_errno_t
+checkRights(std::optional<FileEntry> const &Entry, wasi_rights_t Rights) {
+  if (!Entry.has_value()) return ERRNO_BADF;
+  if ((Entry->RightsBase & Rights) != Rights) return ERRNO_NOTCAPABLE;
+  return ERRNO_SUCCESS;
+}
+
+// A cheap lexical check rejecting absolute paths and parent components
+// climbing above the directory, the confinement itself is left to
+// openBeneath as symbolic links may still point anywhere.
+bool isBeneath(std::string_view Path) {
+  if (Path.empty() || (Path.front() == '/')) return false;
+  std::ptrdiff_t Depth = 0;
+  while (!Path.empty()) {
+    auto Length = std::min(Path.find('/'), Path.size());
+    auto Component = Path.substr(0, Length);
+    if (Component == "..") {
+      Depth = Depth - 1;
+      if (Depth < 0) return false;
+    } else if (!Component.empty() && (Component != ".")) {
+      Depth = Depth + 1;
+    }
+    Path.remove_prefix(std::min(Length + 1, Path.size()));
+  }
+  return true;
+}
+
+std::optional<std::string> readPath(
+    __sable_memory_t *MemoryPtr, std::uint32_t Address, std::uint32_t Length) {
+  __sable_memory_guard(MemoryPtr, std::size_t(Address) + Length);
+  auto &Memory = *WebAssemblyMemory::fromInstancePtr(MemoryPtr);
+  auto *Content = reinterpret_cast<char const *>(Memory.data() + Address);
+  std::string Path(Content, Length);
+  // embedded nulls would silently truncate the host path
+  if (Path.find('\0') != std::string::npos) return std::nullopt;
+  if (!isBeneath(Path)) return std::nullopt;
+  return Path;
+}
+
+/* Opens Path beneath the directory DirFD without following symbolic links at
+ * all, one component at a time. ".." goes back to the directory the walk came
+ * from, hence the walk never climbs above DirFD.
+ */
+int openByWalk(int DirFD, std::string_view Path, int Flags, mode_t Mode) {
+  std::vector<int> Directories; // opened beneath DirFD, innermost last
+  auto Current = [&] {
+    return Directories.empty() ? DirFD : Directories.back();
+  };
+  auto CloseAll = [&] {
+    auto Error = errno;
+    for (auto FD : Directories) close(FD);
+    errno = Error;
+  };
+  std::string Last = ".";
+  while (!Path.empty()) {
+    auto Length = std::min(Path.find('/'), Path.size());
+    auto Component = std::string(Path.substr(0, Length));
+    Path.remove_prefix(std::min(Length + 1, Path.size()));
+    auto IsLast = Path.find_first_not_of('/') == std::string_view::npos;
+    if (Component == "..") {
+      if (Directories.empty()) {
+        CloseAll();
+        errno = EXDEV;
+        return -1;
+      }
+      close(Directories.back());
+      Directories.pop_back();
+    } else if (!Component.empty() && (Component != ".")) {
+      if (IsLast) {
+        Last = std::move(Component);
+        break;
+      }
+      auto Flag = O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+      auto FD = openat(Current(), Component.c_str(), Flag);
+      if (FD == -1) {
+        CloseAll();
+        return -1;
+      }
+      Directories.push_back(FD);
+    }
+    if (IsLast) break;
+  }
+  auto FD = openat(Current(), Last.c_str(), Flags | O_NOFOLLOW, Mode);
+  CloseAll();
+  return FD;
+}
+
+/* Opens Path beneath the directory DirFD. openat2 keeps ".." and symbolic
+ * links, the last component included, from leaving the directory and fails
+ * with EXDEV otherwise. Kernels without openat2 walk the path instead, which
+ * never follows symbolic links.
+ */
+int openBeneath(int DirFD, std::string_view Path, int Flags, mode_t Mode) {
+  auto HostPath = std::string(Path);
+  open_how How{};
+  How.flags = static_cast<std::uint64_t>(Flags);
+  How.mode = Mode;
+  How.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+  auto FD = static_cast<int>(
+      syscall(SYS_openat2, DirFD, HostPath.c_str(), &How, sizeof(How)));
+  if ((FD != -1) || (errno != ENOSYS)) return FD;
+  return openByWalk(DirFD, Path, Flags, Mode);
+}
+
+// The directory holding the last component of a guest path, opened beneath
+// the directory the path is relative to. The *at calls on the pair act on the
+// last component only and never leave the directory.
+class PathParent {
+  int HostFD = -1;
+  std::string Name;
+
+public:
+  PathParent(int DirFD, std::string_view Path) {
+    auto Length = Path.find_last_not_of('/') + 1;
+    Path = Path.substr(0, Length);
+    auto Separator = Path.rfind('/');
+    auto Directory = std::string_view(".");
+    Name = std::string(Path);
+    if (Separator != std::string_view::npos) {
+      Directory = Path.substr(0, Separator);
+      Name = std::string(Path.substr(Separator + 1));
+    }
+    // the parent of a trailing ".." may well be the directory itself
+    if ((Name == ".") || (Name == "..")) {
+      Directory = Path;
+      Name = ".";
+    }
+    auto Flags = O_PATH | O_DIRECTORY | O_CLOEXEC;
+    HostFD = openBeneath(DirFD, Directory, Flags, 0);
+  }
+  PathParent(PathParent const &) = delete;
+  PathParent(PathParent &&) noexcept = delete;
+  PathParent &operator=(PathParent const &) = delete;
+  PathParent &operator=(PathParent &&) noexcept = delete;
+  ~PathParent() noexcept {
+    if (HostFD != -1) close(HostFD);
+  }
+
+  // -1 with errno set if the directory cannot be opened
+  int getHostFD() const { return HostFD; }
+  char const *getName() const { return Name.c_str(); }
+};
+
+wasi_errno_t fromResolveErrno(int Errno) {
+  if (Errno == EXDEV) return ERRNO_NOTCAPABLE;
+  return fromHostErrno(Errno);
+}
+
+// utimensat times of a set_times call, nullopt for conflicting flags
+std::optional<std::array<timespec, 2>> toHostTimes(
+    wasi_timestamp_t ATime, wasi_timestamp_t MTime, wasi_fstflags_t Flags) {
+  auto ToTimespec = [](wasi_timestamp_t Time, bool IsSet, bool IsNow) {
+    if (IsNow) return timespec{.tv_sec = 0, .tv_nsec = UTIME_NOW};
+    if (!IsSet) return timespec{.tv_sec = 0, .tv_nsec = UTIME_OMIT};
+    return timespec{
+        .tv_sec = static_cast<time_t>(Time / 1'000'000'000),
+        .tv_nsec = static_cast<long>(Time % 1'000'000'000)};
+  };
+  auto IsATimeSet = (Flags & FSTFLAGS_ATIM) != 0;
+  auto IsATimeNow = (Flags & FSTFLAGS_ATIM_NOW) != 0;
+  auto IsMTimeSet = (Flags & FSTFLAGS_MTIM) != 0;
+  auto IsMTimeNow = (Flags & FSTFLAGS_MTIM_NOW) != 0;
+  if ((IsATimeSet && IsATimeNow) || (IsMTimeSet && IsMTimeNow))
+    return std::nullopt;
+  return std::array<timespec, 2>{
+      ToTimespec(ATime, IsATimeSet, IsATimeNow),
+      ToTimespec(MTime, IsMTimeSet, IsMTimeNow)};
+}
+
+// The path of the file behind a descriptor opened beneath a directory. The
+// *at calls following symbolic links on it act on that very file, hence the
+// link cannot lead them outside the directory.
+std::string getProcPath(int HostFD) {
+  return fmt::format("/proc/self/fd/{}", HostFD);
+}
+
+// WASI iovecs as native iovecs pointing into the linear memory, readv and
+// writev then move data between the file and the guest without any copy
+class NativeIOVectors {
+  static constexpr std::size_t NumInlineIOVectors = 16;
+  std::array<iovec, NumInlineIOVectors> InlineIOVectors;
+  std::vector<iovec> OutlineIOVectors;
+  std::span<iovec> IOVectors;
+
+public:
+  NativeIOVectors(
+      __sable_memory_t *MemoryPtr, std::uint32_t Address, std::uint32_t Count) {
+    if (Count <= NumInlineIOVectors) {
+      IOVectors = std::span(InlineIOVectors.data(), Count);
+    } else {
+      OutlineIOVectors.resize(Count);
+      IOVectors = std::span(OutlineIOVectors);
+    }
+    auto &Memory = *WebAssemblyMemory::fromInstancePtr(MemoryPtr);
+    for (std::uint32_t I = 0; I < Count; ++I) {
+      auto WASIAddress = std::size_t(Address) + I * sizeof(wasi_ciovec_t);
+      auto WASIIOVector = read<wasi_ciovec_t>(MemoryPtr, WASIAddress);
+      auto Last = std::size_t(WASIIOVector.buf) + WASIIOVector.buf_len;
+      __sable_memory_guard(MemoryPtr, Last);
+      IOVectors[I] = iovec{
+          .iov_base = Memory.data() + WASIIOVector.buf,
+          .iov_len = WASIIOVector.buf_len};
+    }
+  }
+
+  iovec const *data() const { return IOVectors.data(); }
+  int size() const { return static_cast<int>(IOVectors.size()); }
+};
+} // namespace
+
+WASIContext::WASIContext() : Files(std::make_unique<FileTable>()) {}
+
+WASIContext::~WASIContext() noexcept = default;
+
+bool WASIContext::preopen(
+    std::filesystem::path const &HostPath, std::string_view GuestPath) {
+  auto HostFD = open(HostPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (HostFD == -1) return false;
+  FileEntry Entry;
+  Entry.HostFD = HostFD;
+  Entry.PreopenName = std::string(GuestPath);
+  Files->insert(std::move(Entry));
+  return true;
+}
+
+FileTable &WASIContext::getFileTable() { return *Files; }
+
+void bind(WebAssemblyInstance &Instance, std::shared_ptr<WASIContext> Context) {
+  Instance.setHostData(std::move(Context));
+}
+
 void proc_exit(__sable_instance_t *, std::int32_t ExitCode) {
   throw exceptions::WASIExit(ExitCode);
 }
 
+namespace {
+// thread IDs are positive, the main thread does not have one
+std::atomic<std::int32_t> NextThreadID = 1;
+
+void runThread(
+    std::unique_ptr<WebAssemblyInstance> Instance, std::int32_t ThreadID,
+    std::int32_t StartArg) {
+  // a thread cannot report back to its spawner, exit and traps end the
+  // whole process as in the main thread
+  try {
+    Instance->getFunction("wasi_thread_start")
+        .invoke<void>(ThreadID, StartArg);
+  } catch (exceptions::WASIExit const &Exception) {
+    std::exit(Exception.getExitCode());
+  } catch (std::exception const &Exception) {
+    fmt::print(stderr, "thread {} exit with exception:\n  {}\n", ThreadID,
+               Exception.what());
+    std::abort();
+  }
+}
+} // namespace
+
+std::int32_t
+thread_spawn(__sable_instance_t *InstancePtr, std::int32_t StartArg) {
+  auto &Parent = *WebAssemblyInstance::fromInstancePtr(InstancePtr);
+  try {
+    auto Instance = WebAssemblyInstanceBuilder(Parent).Build();
+    auto ThreadID = NextThreadID.fetch_add(1);
+    Parent.addThread(
+        std::thread(runThread, std::move(Instance), ThreadID, StartArg));
+    return ThreadID;
+  } catch (std::exception const &) {
+    return -ERRNO_AGAIN;
+  }
+}
+
+std::int32_t fd_prestat_get(
+    __sable_instance_t *InstancePtr, std::int32_t FD,
+    std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  if (!Entry.has_value() || Entry->PreopenName.empty()) return ERRNO_BADF;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  wasi_prestat_t Result{
+      .tag = PREOPENTYPE_DIR,
+      .pr_name_len = static_cast<wasi_size_t>(Entry->PreopenName.size())};
+  write<wasi_prestat_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_prestat_dir_name(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t Buffer,
+    std::int32_t BufferLength) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  if (!Entry.has_value() || Entry->PreopenName.empty()) return ERRNO_BADF;
+  auto const &Name = Entry->PreopenName;
+  auto Length = static_cast<std::uint32_t>(BufferLength);
+  if (Length < Name.size()) return ERRNO_NAMETOOLONG;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Address = static_cast<std::uint32_t>(Buffer);
+  __sable_memory_guard(LinearMemory, std::size_t(Address) + Name.size());
+  auto &Memory = *WebAssemblyMemory::fromInstancePtr(LinearMemory);
+  std::memcpy(Memory.data() + Address, Name.data(), Name.size());
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_open(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t LookupFlags, std::int32_t PathAddress,
+    std::int32_t PathLength, std::int32_t OpenFlags, std::int64_t RightsBase,
+    std::int64_t RightsInheriting, std::int32_t FDFlags,
+    std::int32_t ResultAddress) {
+  auto DirectoryRights = RIGHTS_PATH_OPEN;
+  if ((OpenFlags & OFLAGS_CREAT) != 0)
+    DirectoryRights = DirectoryRights | RIGHTS_PATH_CREATE_FILE;
+  if ((OpenFlags & OFLAGS_TRUNC) != 0)
+    DirectoryRights = DirectoryRights | RIGHTS_PATH_FILESTAT_SET_SIZE;
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, DirectoryRights);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+
+  auto Rights = static_cast<wasi_rights_t>(RightsBase);
+  auto IsRead = (Rights & RIGHTS_FD_READ) != 0;
+  auto IsWrite = (Rights & RIGHTS_FD_WRITE) != 0;
+  int Flags = O_CLOEXEC;
+  if (IsRead && IsWrite) Flags = Flags | O_RDWR;
+  else if (IsWrite) Flags = Flags | O_WRONLY;
+  else Flags = Flags | O_RDONLY;
+  if ((OpenFlags & OFLAGS_CREAT) != 0) Flags = Flags | O_CREAT;
+  if ((OpenFlags & OFLAGS_DIRECTORY) != 0) Flags = Flags | O_DIRECTORY;
+  if ((OpenFlags & OFLAGS_EXCL) != 0) Flags = Flags | O_EXCL;
+  if ((OpenFlags & OFLAGS_TRUNC) != 0) Flags = Flags | O_TRUNC;
+  if ((FDFlags & FDFLAGS_APPEND) != 0) Flags = Flags | O_APPEND;
+  if ((FDFlags & FDFLAGS_DSYNC) != 0) Flags = Flags | O_DSYNC;
+  if ((FDFlags & FDFLAGS_NONBLOCK) != 0) Flags = Flags | O_NONBLOCK;
+  if ((FDFlags & (FDFLAGS_RSYNC | FDFLAGS_SYNC)) != 0) Flags = Flags | O_SYNC;
+  if ((LookupFlags & LOOKUPFLAGS_SYMLINK_FOLLOW) == 0)
+    Flags = Flags | O_NOFOLLOW;
+
+  auto Mode = static_cast<mode_t>(((Flags & O_CREAT) != 0) ? 0666 : 0);
+  auto HostFD = openBeneath(Directory->HostFD, *Path, Flags, Mode);
+  if (HostFD == -1) return fromResolveErrno(errno);
+
+  FileEntry Entry;
+  Entry.HostFD = HostFD;
+  Entry.RightsBase = Rights & Directory->RightsInheriting;
+  Entry.RightsInheriting = static_cast<wasi_rights_t>(RightsInheriting) &
+                           Directory->RightsInheriting;
+  auto FD = getFileTable(InstancePtr).insert(std::move(Entry));
+  write<wasi_fd_t>(LinearMemory, ResultAddress, FD);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_filestat_get(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t LookupFlags, std::int32_t PathAddress,
+    std::int32_t PathLength, std::int32_t ResultAddress) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_FILESTAT_GET);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostDirFD = Directory->HostFD;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+  // an O_PATH descriptor of a symbolic link stats the link itself
+  int Flags = O_PATH | O_CLOEXEC;
+  if ((LookupFlags & LOOKUPFLAGS_SYMLINK_FOLLOW) == 0)
+    Flags = Flags | O_NOFOLLOW;
+  auto HostFD = openBeneath(HostDirFD, *Path, Flags, 0);
+  if (HostFD == -1) return fromResolveErrno(errno);
+  struct stat Stat {};
+  auto Result = fstat(HostFD, &Stat);
+  auto Error = errno;
+  close(HostFD);
+  if (Result == -1) return fromHostErrno(Error);
+  write<wasi_filestat_t>(LinearMemory, ResultAddress, fromHostStat(Stat));
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_create_directory(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t PathAddress, std::int32_t PathLength) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_CREATE_DIRECTORY);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostDirFD = Directory->HostFD;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+  PathParent Parent(HostDirFD, *Path);
+  if (Parent.getHostFD() == -1) return fromResolveErrno(errno);
+  if (mkdirat(Parent.getHostFD(), Parent.getName(), 0777) == -1)
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_remove_directory(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t PathAddress, std::int32_t PathLength) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_REMOVE_DIRECTORY);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostDirFD = Directory->HostFD;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+  PathParent Parent(HostDirFD, *Path);
+  if (Parent.getHostFD() == -1) return fromResolveErrno(errno);
+  if (unlinkat(Parent.getHostFD(), Parent.getName(), AT_REMOVEDIR) == -1)
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_unlink_file(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t PathAddress, std::int32_t PathLength) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_UNLINK_FILE);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostDirFD = Directory->HostFD;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+  PathParent Parent(HostDirFD, *Path);
+  if (Parent.getHostFD() == -1) return fromResolveErrno(errno);
+  if (unlinkat(Parent.getHostFD(), Parent.getName(), 0) == -1)
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_rename(
+    __sable_instance_t *InstancePtr, std::int32_t OldDirFD,
+    std::int32_t OldPathAddress, std::int32_t OldPathLength,
+    std::int32_t NewDirFD, std::int32_t NewPathAddress,
+    std::int32_t NewPathLength) {
+  auto OldDirectory = getFileTable(InstancePtr).get(OldDirFD);
+  auto NewDirectory = getFileTable(InstancePtr).get(NewDirFD);
+  auto Errno = checkRights(OldDirectory, RIGHTS_PATH_RENAME_SOURCE);
+  if (Errno == ERRNO_SUCCESS)
+    Errno = checkRights(NewDirectory, RIGHTS_PATH_RENAME_TARGET);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto OldHostDirFD = OldDirectory->HostFD;
+  auto NewHostDirFD = NewDirectory->HostFD;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto OldPath = readPath(LinearMemory, OldPathAddress, OldPathLength);
+  auto NewPath = readPath(LinearMemory, NewPathAddress, NewPathLength);
+  if (!OldPath.has_value() || !NewPath.has_value()) return ERRNO_NOTCAPABLE;
+  PathParent OldParent(OldHostDirFD, *OldPath);
+  if (OldParent.getHostFD() == -1) return fromResolveErrno(errno);
+  PathParent NewParent(NewHostDirFD, *NewPath);
+  if (NewParent.getHostFD() == -1) return fromResolveErrno(errno);
+  if (renameat(
+          OldParent.getHostFD(), OldParent.getName(), NewParent.getHostFD(),
+          NewParent.getName()) == -1)
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
 std::int32_t fd_seek(
-    __sable_instance_t *, std::int32_t, std::int64_t, std::int32_t,
-    std::int32_t) {
-  return ERRNO_BADF;
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int64_t Offset,
+    std::int32_t Whence, std::int32_t ResultAddress) {
+  // a seek going nowhere only tells the offset, as fd_tell does
+  auto IsTell = (Offset == 0) && (Whence == WHENCE_CUR);
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, IsTell ? RIGHTS_FD_TELL : RIGHTS_FD_SEEK);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  int HostWhence{};
+  // clang-format off
+  switch (Whence) {
+  case WHENCE_SET: HostWhence = SEEK_SET; break;
+  case WHENCE_CUR: HostWhence = SEEK_CUR; break;
+  case WHENCE_END: HostWhence = SEEK_END; break;
+  default: return ERRNO_INVAL;
+  }
+  // clang-format on
+  auto Result = lseek(HostFD, Offset, HostWhence);
+  if (Result == -1) return fromHostErrno(errno);
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  write<wasi_filesize_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_tell(
+    __sable_instance_t *InstancePtr, std::int32_t FD,
+    std::int32_t ResultAddress) {
+  return fd_seek(InstancePtr, FD, 0, WHENCE_CUR, ResultAddress);
 }
 
-std::int32_t fd_close(__sable_instance_t *, std::int32_t) { return ERRNO_BADF; }
+std::int32_t fd_close(__sable_instance_t *InstancePtr, std::int32_t FD) {
+  auto Entry = getFileTable(InstancePtr).erase(FD);
+  if (!Entry.has_value()) return ERRNO_BADF;
+  if (Entry->IsOwned && (close(Entry->HostFD) == -1))
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
 
-std::int32_t fd_fdstat_get(__sable_instance_t *, std::int32_t, std::int32_t) {
-  return ERRNO_BADF;
+std::int32_t fd_sync(__sable_instance_t *InstancePtr, std::int32_t FD) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_SYNC);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (fsync(HostFD) == -1) return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
 }
 
-std::int32_t fd_write(
-    __sable_instance_t *InstancePtr, std::int32_t FileDescriptor,
-    std::int32_t IOVectors, std::int32_t IOVectorCount,
+std::int32_t fd_datasync(__sable_instance_t *InstancePtr, std::int32_t FD) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_DATASYNC);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (fdatasync(HostFD) == -1) return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_fdstat_get(
+    __sable_instance_t *InstancePtr, std::int32_t FD,
     std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  if (!Entry.has_value()) return ERRNO_BADF;
+  struct stat Stat {};
+  if (fstat(Entry->HostFD, &Stat) == -1) return fromHostErrno(errno);
+  auto HostFlags = fcntl(Entry->HostFD, F_GETFL);
+  if (HostFlags == -1) return fromHostErrno(errno);
+  wasi_fdflags_t Flags = 0;
+  if ((HostFlags & O_APPEND) != 0) Flags = Flags | FDFLAGS_APPEND;
+  if ((HostFlags & O_NONBLOCK) != 0) Flags = Flags | FDFLAGS_NONBLOCK;
+  if ((HostFlags & O_SYNC) == O_SYNC) Flags = Flags | FDFLAGS_SYNC;
+  else if ((HostFlags & O_DSYNC) != 0) Flags = Flags | FDFLAGS_DSYNC;
+  wasi_fdstat_t Result{
+      .fs_filetype = fromHostFileMode(Stat.st_mode),
+      .fs_flags = Flags,
+      .fs_rights_base = Entry->RightsBase,
+      .fs_rights_inheriting = Entry->RightsInheriting};
   auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  write<wasi_fdstat_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_fdstat_set_flags(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t Flags) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_FDSTAT_SET_FLAGS);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  // only the status flags may change on an open file
+  int HostFlags = 0;
+  if ((Flags & FDFLAGS_APPEND) != 0) HostFlags = HostFlags | O_APPEND;
+  if ((Flags & FDFLAGS_NONBLOCK) != 0) HostFlags = HostFlags | O_NONBLOCK;
+  if (fcntl(HostFD, F_SETFL, HostFlags) == -1) return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_filestat_get(
+    __sable_instance_t *InstancePtr, std::int32_t FD,
+    std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_FILESTAT_GET);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  struct stat Stat {};
+  if (fstat(HostFD, &Stat) == -1) return fromHostErrno(errno);
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  write<wasi_filestat_t>(LinearMemory, ResultAddress, fromHostStat(Stat));
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_filestat_set_size(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int64_t Size) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_FILESTAT_SET_SIZE);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (ftruncate(HostFD, Size) == -1) return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_readdir(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t Buffer,
+    std::int32_t BufferLength, std::int64_t Cookie,
+    std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_READDIR);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Address = static_cast<std::uint32_t>(Buffer);
+  auto Length = static_cast<std::uint32_t>(BufferLength);
+  __sable_memory_guard(LinearMemory, std::size_t(Address) + Length);
   auto &Memory = *WebAssemblyMemory::fromInstancePtr(LinearMemory);
-  std::vector<iovec> NativeIOVectors;
-  NativeIOVectors.reserve(IOVectorCount);
-  for (std::int32_t I = 0; I < IOVectorCount; ++I) {
-    auto Address = IOVectors + I * sizeof(wasi_ciovec_t);
-    auto WASIIOVector = read<wasi_ciovec_t>(LinearMemory, Address);
-    iovec NativeIOVector{
-        .iov_base = Memory.data() + WASIIOVector.buf,
-        .iov_len = WASIIOVector.buf_len};
-    NativeIOVectors.push_back(NativeIOVector);
-  }
-  auto fd = static_cast<int>(FileDescriptor);
-  if ((fd == WASI_STDOUT) || (fd == WASI_STDERR)) {
-    auto result = writev(fd, NativeIOVectors.data(), NativeIOVectors.size());
-    if (result == -1) {
-      // clang-format off
-      switch (errno) {
-      case EAGAIN      : return ERRNO_AGAIN;
-      case EBADF       : return ERRNO_BADF;
-      case EDESTADDRREQ: return ERRNO_DESTADDRRERQ;
-      case EDQUOT      : return ERRNO_DQUOT;
-      case EFAULT      : return ERRNO_FAULT;
-      case EFBIG       : return ERRNO_FBIG;
-      case EINTR       : return ERRNO_INTR;
-      case EINVAL      : return ERRNO_INVAL;
-      case EIO         : return ERRNO_IO;
-      case ENOSPC      : return ERRNO_NOSPC;
-      case EPIPE       : return ERRNO_PIPE;
-      default: utility::unreachable();
-      }
-      // clang-format on
+
+  // the stream works on a duplicate, cookies are telldir positions
+  auto StreamFD = dup(HostFD);
+  if (StreamFD == -1) return fromHostErrno(errno);
+  auto *Stream = fdopendir(StreamFD);
+  if (Stream == nullptr) {
+    auto Errno = errno;
+    close(StreamFD);
+    return fromHostErrno(Errno);
+  }
+  rewinddir(Stream);
+  if (Cookie != 0) seekdir(Stream, Cookie);
+
+  // the last entry is truncated if it does not fit, a full buffer tells the
+  // guest to call again
+  std::uint32_t NumWritten = 0;
+  auto Append = [&](void const *Data, std::size_t Size) {
+    auto NumCopied = std::min<std::size_t>(Size, Length - NumWritten);
+    std::memcpy(Memory.data() + Address + NumWritten, Data, NumCopied);
+    NumWritten = NumWritten + NumCopied;
+  };
+  while (NumWritten < Length) {
+    auto const *HostEntry = readdir(Stream);
+    if (HostEntry == nullptr) break;
+    std::string_view Name(HostEntry->d_name);
+    wasi_filetype_t Type = FILETYPE_UNKNOWN;
+    // clang-format off
+    switch (HostEntry->d_type) {
+    case DT_REG : Type = FILETYPE_REGULAR_FILE    ; break;
+    case DT_DIR : Type = FILETYPE_DIRECTORY       ; break;
+    case DT_CHR : Type = FILETYPE_CHARACTER_DEVICE; break;
+    case DT_BLK : Type = FILETYPE_BLOCK_DEVICE    ; break;
+    case DT_LNK : Type = FILETYPE_SYMBOLIC_LINK   ; break;
+    case DT_SOCK: Type = FILETYPE_SOCKET_STREAM   ; break;
+    default: break;
     }
-    write<std::uint32_t>(LinearMemory, ResultAddress, result);
+    // clang-format on
+    wasi_dirent_t Entry{
+        .d_next = static_cast<wasi_dircookie_t>(telldir(Stream)),
+        .d_ino = HostEntry->d_ino,
+        .d_namlen = static_cast<std::uint32_t>(Name.size()),
+        .d_type = Type};
+    Append(std::addressof(Entry), sizeof(wasi_dirent_t));
+    Append(Name.data(), Name.size());
+  }
+  closedir(Stream);
+  write<wasi_size_t>(LinearMemory, ResultAddress, NumWritten);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_read(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t IOVectors,
+    std::int32_t IOVectorCount, std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_READ);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (static_cast<std::uint32_t>(IOVectorCount) > IOV_MAX) return ERRNO_INVAL;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  NativeIOVectors NativeIOVectors(LinearMemory, IOVectors, IOVectorCount);
+  auto Result = readv(HostFD, NativeIOVectors.data(), NativeIOVectors.size());
+  if (Result == -1) return fromHostErrno(errno);
+  write<wasi_size_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_pread(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t IOVectors,
+    std::int32_t IOVectorCount, std::int64_t Offset,
+    std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_READ | RIGHTS_FD_SEEK);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (static_cast<std::uint32_t>(IOVectorCount) > IOV_MAX) return ERRNO_INVAL;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  NativeIOVectors NativeIOVectors(LinearMemory, IOVectors, IOVectorCount);
+  auto Result = preadv(
+      HostFD, NativeIOVectors.data(), NativeIOVectors.size(), Offset);
+  if (Result == -1) return fromHostErrno(errno);
+  write<wasi_size_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_write(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t IOVectors,
+    std::int32_t IOVectorCount, std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_WRITE);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (static_cast<std::uint32_t>(IOVectorCount) > IOV_MAX) return ERRNO_INVAL;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  NativeIOVectors NativeIOVectors(LinearMemory, IOVectors, IOVectorCount);
+  auto Result = writev(HostFD, NativeIOVectors.data(), NativeIOVectors.size());
+  if (Result == -1) return fromHostErrno(errno);
+  write<wasi_size_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_pwrite(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t IOVectors,
+    std::int32_t IOVectorCount, std::int64_t Offset,
+    std::int32_t ResultAddress) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_WRITE | RIGHTS_FD_SEEK);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto HostFD = Entry->HostFD;
+  if (static_cast<std::uint32_t>(IOVectorCount) > IOV_MAX) return ERRNO_INVAL;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  NativeIOVectors NativeIOVectors(LinearMemory, IOVectors, IOVectorCount);
+  auto Result = pwritev(
+      HostFD, NativeIOVectors.data(), NativeIOVectors.size(), Offset);
+  if (Result == -1) return fromHostErrno(errno);
+  write<wasi_size_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_renumber(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int32_t To) {
+  auto Replaced = getFileTable(InstancePtr).renumber(FD, To);
+  if (!Replaced.has_value()) {
+    // renumbering onto itself keeps the descriptor as is
+    auto Entry = getFileTable(InstancePtr).get(FD);
+    return (Entry.has_value() && (FD == To)) ? ERRNO_SUCCESS : ERRNO_BADF;
+  }
+  if (Replaced->IsOwned && (close(Replaced->HostFD) == -1))
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_advise(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int64_t Offset,
+    std::int64_t Length, std::int32_t Advice) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_ADVISE);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  int HostAdvice{};
+  // clang-format off
+  switch (Advice) {
+  case ADVICE_NORMAL    : HostAdvice = POSIX_FADV_NORMAL    ; break;
+  case ADVICE_SEQUENTIAL: HostAdvice = POSIX_FADV_SEQUENTIAL; break;
+  case ADVICE_RANDOM    : HostAdvice = POSIX_FADV_RANDOM    ; break;
+  case ADVICE_WILLNEED  : HostAdvice = POSIX_FADV_WILLNEED  ; break;
+  case ADVICE_DONTNEED  : HostAdvice = POSIX_FADV_DONTNEED  ; break;
+  case ADVICE_NOREUSE   : HostAdvice = POSIX_FADV_NOREUSE   ; break;
+  default: return ERRNO_INVAL;
+  }
+  // clang-format on
+  // posix_fadvise returns the error instead of setting errno
+  auto Result = posix_fadvise(Entry->HostFD, Offset, Length, HostAdvice);
+  if (Result != 0) return fromHostErrno(Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_allocate(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int64_t Offset,
+    std::int64_t Length) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_ALLOCATE);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto Result = posix_fallocate(Entry->HostFD, Offset, Length);
+  if (Result != 0) return fromHostErrno(Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t fd_fdstat_set_rights(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int64_t RightsBase,
+    std::int64_t RightsInheriting) {
+  return getFileTable(InstancePtr)
+      .setRights(
+          FD, static_cast<wasi_rights_t>(RightsBase),
+          static_cast<wasi_rights_t>(RightsInheriting));
+}
+
+std::int32_t fd_filestat_set_times(
+    __sable_instance_t *InstancePtr, std::int32_t FD, std::int64_t ATime,
+    std::int64_t MTime, std::int32_t Flags) {
+  auto Entry = getFileTable(InstancePtr).get(FD);
+  auto Errno = checkRights(Entry, RIGHTS_FD_FILESTAT_SET_TIMES);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto Times = toHostTimes(ATime, MTime, Flags);
+  if (!Times.has_value()) return ERRNO_INVAL;
+  if (futimens(Entry->HostFD, Times->data()) == -1)
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_filestat_set_times(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t LookupFlags, std::int32_t PathAddress,
+    std::int32_t PathLength, std::int64_t ATime, std::int64_t MTime,
+    std::int32_t Flags) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_FILESTAT_SET_TIMES);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+  auto Times = toHostTimes(ATime, MTime, Flags);
+  if (!Times.has_value()) return ERRNO_INVAL;
+  if ((LookupFlags & LOOKUPFLAGS_SYMLINK_FOLLOW) == 0) {
+    PathParent Parent(Directory->HostFD, *Path);
+    if (Parent.getHostFD() == -1) return fromResolveErrno(errno);
+    if (utimensat(
+            Parent.getHostFD(), Parent.getName(), Times->data(),
+            AT_SYMLINK_NOFOLLOW) == -1)
+      return fromHostErrno(errno);
     return ERRNO_SUCCESS;
   }
-  return ERRNO_BADF;
+  auto HostFD =
+      openBeneath(Directory->HostFD, *Path, O_PATH | O_CLOEXEC, 0);
+  if (HostFD == -1) return fromResolveErrno(errno);
+  auto Result =
+      utimensat(AT_FDCWD, getProcPath(HostFD).c_str(), Times->data(), 0);
+  auto Error = errno;
+  close(HostFD);
+  if (Result == -1) return fromHostErrno(Error);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_readlink(
+    __sable_instance_t *InstancePtr, std::int32_t DirFD,
+    std::int32_t PathAddress, std::int32_t PathLength, std::int32_t Buffer,
+    std::int32_t BufferLength, std::int32_t ResultAddress) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_READLINK);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Path.has_value()) return ERRNO_NOTCAPABLE;
+  auto Address = static_cast<std::uint32_t>(Buffer);
+  auto Length = static_cast<std::uint32_t>(BufferLength);
+  __sable_memory_guard(LinearMemory, std::size_t(Address) + Length);
+  auto &Memory = *WebAssemblyMemory::fromInstancePtr(LinearMemory);
+  PathParent Parent(Directory->HostFD, *Path);
+  if (Parent.getHostFD() == -1) return fromResolveErrno(errno);
+  // the content is truncated to the buffer, as readlink does
+  auto *Content = reinterpret_cast<char *>(Memory.data() + Address);
+  auto Result =
+      readlinkat(Parent.getHostFD(), Parent.getName(), Content, Length);
+  if (Result == -1) return fromHostErrno(errno);
+  write<wasi_size_t>(LinearMemory, ResultAddress, Result);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_symlink(
+    __sable_instance_t *InstancePtr, std::int32_t TargetAddress,
+    std::int32_t TargetLength, std::int32_t DirFD, std::int32_t PathAddress,
+    std::int32_t PathLength) {
+  auto Directory = getFileTable(InstancePtr).get(DirFD);
+  auto Errno = checkRights(Directory, RIGHTS_PATH_SYMLINK);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  // targets are checked as any guest path, relative and never climbing
+  // above the directory
+  auto Target = readPath(LinearMemory, TargetAddress, TargetLength);
+  auto Path = readPath(LinearMemory, PathAddress, PathLength);
+  if (!Target.has_value() || !Path.has_value()) return ERRNO_NOTCAPABLE;
+  PathParent Parent(Directory->HostFD, *Path);
+  if (Parent.getHostFD() == -1) return fromResolveErrno(errno);
+  if (symlinkat(Target->c_str(), Parent.getHostFD(), Parent.getName()) == -1)
+    return fromHostErrno(errno);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t path_link(
+    __sable_instance_t *InstancePtr, std::int32_t OldDirFD,
+    std::int32_t LookupFlags, std::int32_t OldPathAddress,
+    std::int32_t OldPathLength, std::int32_t NewDirFD,
+    std::int32_t NewPathAddress, std::int32_t NewPathLength) {
+  auto OldDirectory = getFileTable(InstancePtr).get(OldDirFD);
+  auto NewDirectory = getFileTable(InstancePtr).get(NewDirFD);
+  auto Errno = checkRights(OldDirectory, RIGHTS_PATH_LINK_SOURCE);
+  if (Errno == ERRNO_SUCCESS)
+    Errno = checkRights(NewDirectory, RIGHTS_PATH_LINK_TARGET);
+  if (Errno != ERRNO_SUCCESS) return Errno;
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  auto OldPath = readPath(LinearMemory, OldPathAddress, OldPathLength);
+  auto NewPath = readPath(LinearMemory, NewPathAddress, NewPathLength);
+  if (!OldPath.has_value() || !NewPath.has_value()) return ERRNO_NOTCAPABLE;
+  PathParent NewParent(NewDirectory->HostFD, *NewPath);
+  if (NewParent.getHostFD() == -1) return fromResolveErrno(errno);
+  if ((LookupFlags & LOOKUPFLAGS_SYMLINK_FOLLOW) == 0) {
+    PathParent OldParent(OldDirectory->HostFD, *OldPath);
+    if (OldParent.getHostFD() == -1) return fromResolveErrno(errno);
+    if (linkat(
+            OldParent.getHostFD(), OldParent.getName(), NewParent.getHostFD(),
+            NewParent.getName(), 0) == -1)
+      return fromHostErrno(errno);
+    return ERRNO_SUCCESS;
+  }
+  auto HostFD =
+      openBeneath(OldDirectory->HostFD, *OldPath, O_PATH | O_CLOEXEC, 0);
+  if (HostFD == -1) return fromResolveErrno(errno);
+  auto Result = linkat(
+      AT_FDCWD, getProcPath(HostFD).c_str(), NewParent.getHostFD(),
+      NewParent.getName(), AT_SYMLINK_FOLLOW);
+  auto Error = errno;
+  close(HostFD);
+  if (Result == -1) return fromHostErrno(Error);
+  return ERRNO_SUCCESS;
 }
 
 std::int32_t args_sizes_get(
@@ -116,6 +1122,25 @@ std::int32_t args_get(__sable_instance_t *, std::int32_t, std::int32_t) {
   return ERRNO_SUCCESS;
 }
 
+// the guest sees no environment variable, as it sees no argument
+std::int32_t environ_sizes_get(
+    __sable_instance_t *InstancePtr, std::int32_t NumVariableAddress,
+    std::int32_t BufSizeAddress) {
+  auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
+  write<wasi_size_t>(LinearMemory, NumVariableAddress, 0);
+  write<wasi_size_t>(LinearMemory, BufSizeAddress, 0);
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t environ_get(__sable_instance_t *, std::int32_t, std::int32_t) {
+  return ERRNO_SUCCESS;
+}
+
+std::int32_t sched_yield(__sable_instance_t *) {
+  std::this_thread::yield();
+  return ERRNO_SUCCESS;
+}
+
 std::int32_t clock_time_get(
     __sable_instance_t *InstancePtr, std::int32_t ClockID,
     std::int64_t /* precision */, std::int32_t ResultAddress) {
@@ -148,13 +1173,16 @@ std::int32_t random_get(
     std::int32_t BufferLength) {
   auto *LinearMemory = getImplicitLinearMemory(InstancePtr);
   auto buf_len = static_cast<wasi_size_t>(BufferLength);
+  // the whole buffer is checked first, no address below then wraps around
+  auto Address = static_cast<std::uint32_t>(Buffer);
+  __sable_memory_guard(LinearMemory, std::size_t(Address) + buf_len);
   std::random_device RandomSource;
   std::array<unsigned, 1> Bytes{};
   auto BytesView = std::as_bytes(std::span{Bytes});
   for (std::size_t I = 0; I < buf_len; ++I) {
     if (I % sizeof(unsigned) == 0) { Bytes[0] = RandomSource(); }
     auto RandomByte = BytesView[I % sizeof(unsigned)];
-    write<std::byte>(LinearMemory, I + Buffer, RandomByte);
+    write<std::byte>(LinearMemory, Address + I, RandomByte);
   }
   return ERRNO_SUCCESS;
 }
@@ -6,12 +6,19 @@
 #include <fmt/format.h>
 
 #include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <stdexcept>
+#include <string_view>
 
 extern "C" {
 struct __sable_instance_t;
 }
 
+namespace runtime {
+class WebAssemblyInstance;
+}
+
 namespace runtime::wasi {
 namespace exceptions {
 class WASIExit : public std::runtime_error {
@@ -25,25 +32,88 @@ public:
 };
 } // namespace exceptions
 
+class FileTable; // see WASI.cc
+
+// The file descriptors of a WASI program, stdio followed by its preopened
+// directories and the files it opens. Every instance calling WASI functions
+// is bound to a context, instances spawned through wasi-threads share the
+// one of their parent while separate programs keep separate descriptors.
+class WASIContext {
+  std::unique_ptr<FileTable> Files;
+
+public:
+  WASIContext();
+  WASIContext(WASIContext const &) = delete;
+  WASIContext(WASIContext &&) noexcept = delete;
+  WASIContext &operator=(WASIContext const &) = delete;
+  WASIContext &operator=(WASIContext &&) noexcept = delete;
+  ~WASIContext() noexcept;
+
+  // Exposes the host directory HostPath to the guest as GuestPath. Preopened
+  // directories take the file descriptors following stdio in the order of
+  // the calls, every path the guest names is resolved beneath one of them,
+  // symbolic links pointing outside included. Returns false if HostPath
+  // cannot be opened as a directory.
+  bool
+  preopen(std::filesystem::path const &HostPath, std::string_view GuestPath);
+
+  FileTable &getFileTable();
+};
+
+// Binds Instance to Context before it runs, as the host data of the instance.
+// WASI functions called from an unbound instance throw std::logic_error.
+void bind(WebAssemblyInstance &Instance, std::shared_ptr<WASIContext> Context);
+
 // clang-format off
 void proc_exit(__sable_instance_t *, std::int32_t);
 
-inline std::int32_t fd_prestart_get(__sable_instance_t *, std::int32_t, std::int32_t) { return ERRNO_BADF; }
-inline std::int32_t fd_prestat_dir_name(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t) { return ERRNO_BADF; }
-inline std::int32_t path_open(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int64_t, std::int64_t, std::int32_t, std::int32_t) { return ERRNO_BADF; }
+std::int32_t fd_prestat_get(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t fd_prestat_dir_name(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_open(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int64_t, std::int64_t, std::int32_t, std::int32_t);
+std::int32_t path_filestat_get(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_create_directory(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_remove_directory(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_unlink_file(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_rename(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
 std::int32_t fd_seek(__sable_instance_t *, std::int32_t, std::int64_t, std::int32_t, std::int32_t);
+std::int32_t fd_tell(__sable_instance_t *, std::int32_t, std::int32_t);
 std::int32_t fd_close(__sable_instance_t*, std::int32_t);
+std::int32_t fd_sync(__sable_instance_t *, std::int32_t);
+std::int32_t fd_datasync(__sable_instance_t *, std::int32_t);
 std::int32_t fd_fdstat_get(__sable_instance_t *, std::int32_t, std::int32_t);
-inline std::int32_t fd_fdstat_set_flags(__sable_instance_t *, std::int32_t, std::int32_t) { return ERRNO_BADF; }
-inline std::int32_t fd_read(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t) { return ERRNO_BADF; }
+std::int32_t fd_fdstat_set_flags(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t fd_filestat_get(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t fd_filestat_set_size(__sable_instance_t *, std::int32_t, std::int64_t);
+std::int32_t fd_readdir(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int64_t, std::int32_t);
+// reads and writes go straight between the file and the linear memory
+std::int32_t fd_read(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t fd_pread(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int64_t, std::int32_t);
 std::int32_t fd_write(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t fd_pwrite(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int64_t, std::int32_t);
+std::int32_t fd_renumber(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t fd_advise(__sable_instance_t *, std::int32_t, std::int64_t, std::int64_t, std::int32_t);
+std::int32_t fd_allocate(__sable_instance_t *, std::int32_t, std::int64_t, std::int64_t);
+std::int32_t fd_fdstat_set_rights(__sable_instance_t *, std::int32_t, std::int64_t, std::int64_t);
+std::int32_t fd_filestat_set_times(__sable_instance_t *, std::int32_t, std::int64_t, std::int64_t, std::int32_t);
+std::int32_t path_filestat_set_times(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int64_t, std::int64_t, std::int32_t);
+std::int32_t path_readlink(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_symlink(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
+std::int32_t path_link(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t, std::int32_t);
 std::int32_t args_sizes_get(__sable_instance_t *, std::int32_t, std::int32_t);
 std::int32_t args_get(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t environ_sizes_get(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t environ_get(__sable_instance_t *, std::int32_t, std::int32_t);
+std::int32_t sched_yield(__sable_instance_t *);
 
 std::int32_t random_get(__sable_instance_t *, std::int32_t, std::int32_t);
 std::int32_t clock_time_get(__sable_instance_t *, std::int32_t, std::int64_t, std::int32_t);
 
-std::int32_t poll_oneoff(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t) { return ERRNO_INVAL; }
+// wasi-threads, runs the export wasi_thread_start(tid, StartArg) of a new
+// instance bound to the imports and the WASI context of the caller on a
+// thread the caller joins
+std::int32_t thread_spawn(__sable_instance_t *, std::int32_t);
+
+inline std::int32_t poll_oneoff(__sable_instance_t *, std::int32_t, std::int32_t, std::int32_t, std::int32_t) { return ERRNO_INVAL; }
 // clang-format on
 } // namespace runtime::wasi
 
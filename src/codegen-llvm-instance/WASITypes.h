@@ -93,6 +93,88 @@ using wasi_fd_t = std::uint32_t;
 using wasi_filetype_t = std::uint8_t;
 using wasi_fdflags_t = std::uint16_t;
 using wasi_rights_t = std::uint64_t;
+using wasi_filesize_t = std::uint64_t;
+using wasi_filedelta_t = std::int64_t;
+using wasi_dircookie_t = std::uint64_t;
+using wasi_device_t = std::uint64_t;
+using wasi_inode_t = std::uint64_t;
+using wasi_linkcount_t = std::uint64_t;
+using wasi_whence_t = std::uint8_t;
+using wasi_oflags_t = std::uint16_t;
+using wasi_lookupflags_t = std::uint32_t;
+using wasi_fstflags_t = std::uint16_t;
+using wasi_advice_t = std::uint8_t;
+
+// clang-format off
+constexpr wasi_filetype_t FILETYPE_UNKNOWN          = 0;
+constexpr wasi_filetype_t FILETYPE_BLOCK_DEVICE     = 1;
+constexpr wasi_filetype_t FILETYPE_CHARACTER_DEVICE = 2;
+constexpr wasi_filetype_t FILETYPE_DIRECTORY        = 3;
+constexpr wasi_filetype_t FILETYPE_REGULAR_FILE     = 4;
+constexpr wasi_filetype_t FILETYPE_SOCKET_DGRAM     = 5;
+constexpr wasi_filetype_t FILETYPE_SOCKET_STREAM    = 6;
+constexpr wasi_filetype_t FILETYPE_SYMBOLIC_LINK    = 7;
+
+constexpr wasi_fdflags_t FDFLAGS_APPEND   = 1 << 0;
+constexpr wasi_fdflags_t FDFLAGS_DSYNC    = 1 << 1;
+constexpr wasi_fdflags_t FDFLAGS_NONBLOCK = 1 << 2;
+constexpr wasi_fdflags_t FDFLAGS_RSYNC    = 1 << 3;
+constexpr wasi_fdflags_t FDFLAGS_SYNC     = 1 << 4;
+
+constexpr wasi_oflags_t OFLAGS_CREAT     = 1 << 0;
+constexpr wasi_oflags_t OFLAGS_DIRECTORY = 1 << 1;
+constexpr wasi_oflags_t OFLAGS_EXCL      = 1 << 2;
+constexpr wasi_oflags_t OFLAGS_TRUNC     = 1 << 3;
+
+constexpr wasi_lookupflags_t LOOKUPFLAGS_SYMLINK_FOLLOW = 1 << 0;
+
+constexpr wasi_fstflags_t FSTFLAGS_ATIM     = 1 << 0;
+constexpr wasi_fstflags_t FSTFLAGS_ATIM_NOW = 1 << 1;
+constexpr wasi_fstflags_t FSTFLAGS_MTIM     = 1 << 2;
+constexpr wasi_fstflags_t FSTFLAGS_MTIM_NOW = 1 << 3;
+
+constexpr wasi_advice_t ADVICE_NORMAL     = 0;
+constexpr wasi_advice_t ADVICE_SEQUENTIAL = 1;
+constexpr wasi_advice_t ADVICE_RANDOM     = 2;
+constexpr wasi_advice_t ADVICE_WILLNEED   = 3;
+constexpr wasi_advice_t ADVICE_DONTNEED   = 4;
+constexpr wasi_advice_t ADVICE_NOREUSE    = 5;
+
+constexpr wasi_whence_t WHENCE_SET = 0;
+constexpr wasi_whence_t WHENCE_CUR = 1;
+constexpr wasi_whence_t WHENCE_END = 2;
+
+constexpr wasi_rights_t RIGHTS_FD_DATASYNC             = 1 << 0;
+constexpr wasi_rights_t RIGHTS_FD_READ                 = 1 << 1;
+constexpr wasi_rights_t RIGHTS_FD_SEEK                 = 1 << 2;
+constexpr wasi_rights_t RIGHTS_FD_FDSTAT_SET_FLAGS     = 1 << 3;
+constexpr wasi_rights_t RIGHTS_FD_SYNC                 = 1 << 4;
+constexpr wasi_rights_t RIGHTS_FD_TELL                 = 1 << 5;
+constexpr wasi_rights_t RIGHTS_FD_WRITE                = 1 << 6;
+constexpr wasi_rights_t RIGHTS_FD_ADVISE               = 1 << 7;
+constexpr wasi_rights_t RIGHTS_FD_ALLOCATE             = 1 << 8;
+constexpr wasi_rights_t RIGHTS_PATH_CREATE_DIRECTORY   = 1 << 9;
+constexpr wasi_rights_t RIGHTS_PATH_CREATE_FILE        = 1 << 10;
+constexpr wasi_rights_t RIGHTS_PATH_LINK_SOURCE        = 1 << 11;
+constexpr wasi_rights_t RIGHTS_PATH_LINK_TARGET        = 1 << 12;
+constexpr wasi_rights_t RIGHTS_PATH_OPEN               = 1 << 13;
+constexpr wasi_rights_t RIGHTS_FD_READDIR              = 1 << 14;
+constexpr wasi_rights_t RIGHTS_PATH_READLINK           = 1 << 15;
+constexpr wasi_rights_t RIGHTS_PATH_RENAME_SOURCE      = 1 << 16;
+constexpr wasi_rights_t RIGHTS_PATH_RENAME_TARGET      = 1 << 17;
+constexpr wasi_rights_t RIGHTS_PATH_FILESTAT_GET       = 1 << 18;
+constexpr wasi_rights_t RIGHTS_PATH_FILESTAT_SET_SIZE  = 1 << 19;
+constexpr wasi_rights_t RIGHTS_PATH_FILESTAT_SET_TIMES = 1 << 20;
+constexpr wasi_rights_t RIGHTS_FD_FILESTAT_GET         = 1 << 21;
+constexpr wasi_rights_t RIGHTS_FD_FILESTAT_SET_SIZE    = 1 << 22;
+constexpr wasi_rights_t RIGHTS_FD_FILESTAT_SET_TIMES   = 1 << 23;
+constexpr wasi_rights_t RIGHTS_PATH_SYMLINK            = 1 << 24;
+constexpr wasi_rights_t RIGHTS_PATH_REMOVE_DIRECTORY   = 1 << 25;
+constexpr wasi_rights_t RIGHTS_PATH_UNLINK_FILE        = 1 << 26;
+constexpr wasi_rights_t RIGHTS_ALL                     = (1 << 30) - 1;
+
+constexpr std::uint8_t PREOPENTYPE_DIR = 0;
+// clang-format on
 
 struct wasi_fdstat_t {
   wasi_filetype_t fs_filetype;
@@ -115,6 +197,40 @@ static_assert(offsetof(wasi_ciovec_t, buf) == 0);
 static_assert(offsetof(wasi_ciovec_t, buf_len) == 4);
 
 using wasi_timestamp_t = std::uint64_t;
+
+struct wasi_prestat_t {
+  std::uint8_t tag;
+  wasi_size_t pr_name_len;
+};
+static_assert(sizeof(wasi_prestat_t) == 8);
+static_assert(offsetof(wasi_prestat_t, tag) == 0);
+static_assert(offsetof(wasi_prestat_t, pr_name_len) == 4);
+
+struct wasi_filestat_t {
+  wasi_device_t dev;
+  wasi_inode_t ino;
+  wasi_filetype_t filetype;
+  wasi_linkcount_t nlink;
+  wasi_filesize_t size;
+  wasi_timestamp_t atim;
+  wasi_timestamp_t mtim;
+  wasi_timestamp_t ctim;
+};
+static_assert(sizeof(wasi_filestat_t) == 64);
+static_assert(offsetof(wasi_filestat_t, filetype) == 16);
+static_assert(offsetof(wasi_filestat_t, nlink) == 24);
+static_assert(offsetof(wasi_filestat_t, ctim) == 56);
+
+// followed by d_namlen bytes of name in fd_readdir buffers
+struct wasi_dirent_t {
+  wasi_dircookie_t d_next;
+  wasi_inode_t d_ino;
+  std::uint32_t d_namlen;
+  wasi_filetype_t d_type;
+};
+static_assert(sizeof(wasi_dirent_t) == 24);
+static_assert(offsetof(wasi_dirent_t, d_namlen) == 16);
+static_assert(offsetof(wasi_dirent_t, d_type) == 20);
 using wasi_clockid_t = std::uint32_t;
 // clang-format off
 constexpr wasi_clockid_t CLOCKID_REALTIME           = 0;
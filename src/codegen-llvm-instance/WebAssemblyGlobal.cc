@@ -9,6 +9,10 @@ WebAssemblyGlobal::WebAssemblyGlobal(bytecode::ValueType ValueType_)
   std::memset(&Storage, 0, sizeof(decltype(Storage)));
 }
 
+void WebAssemblyGlobal::reset() {
+  std::memset(&Storage, 0, sizeof(decltype(Storage)));
+}
+
 bytecode::ValueType const &WebAssemblyGlobal::getValueType() const {
   return ValueType;
 }
@@ -1,16 +1,32 @@
 #include "WebAssemblyInstance.h"
 
 #include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <range/v3/algorithm/contains.hpp>
 #include <range/v3/view/subrange.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 #define INSTANCE_ENTITY_START_OFFSET 4
 
 void __sable_unreachable() { throw runtime::exceptions::Unreachable(); }
 
+void __sable_data_trap(std::size_t Offset, std::size_t Size) {
+  throw runtime::exceptions::DataSegmentAccessOutOfBound(Offset, Size);
+}
+
 namespace runtime {
 namespace detail {
 template <>
@@ -85,23 +101,63 @@ std::string toSignature(bytecode::FunctionType const &Type) {
     Result.push_back(toSignature(ValueType));
   return Result;
 }
+
+namespace {
+struct SignatureRegistry {
+  std::shared_mutex Mutex;
+  std::deque<std::string> Signatures{std::string()};
+  std::unordered_map<std::string_view, std::uint32_t> SignatureIDs{
+      {std::string_view(Signatures.front()), 0}};
+};
+
+SignatureRegistry &getSignatureRegistry() {
+  static SignatureRegistry Registry;
+  return Registry;
+}
+} // namespace
+
+std::uint32_t toSignatureID(std::string_view Signature) {
+  auto &Registry = getSignatureRegistry();
+  {
+    std::shared_lock<std::shared_mutex> Lock(Registry.Mutex);
+    auto SearchIter = Registry.SignatureIDs.find(Signature);
+    if (SearchIter != Registry.SignatureIDs.end())
+      return std::get<1>(*SearchIter);
+  }
+  std::unique_lock<std::shared_mutex> Lock(Registry.Mutex);
+  auto SearchIter = Registry.SignatureIDs.find(Signature);
+  if (SearchIter != Registry.SignatureIDs.end())
+    return std::get<1>(*SearchIter);
+  auto SignatureID = static_cast<std::uint32_t>(Registry.Signatures.size());
+  Registry.Signatures.emplace_back(Signature);
+  Registry.SignatureIDs.emplace(Registry.Signatures.back(), SignatureID);
+  return SignatureID;
+}
+
+std::string_view fromSignatureID(std::uint32_t SignatureID) {
+  auto &Registry = getSignatureRegistry();
+  std::shared_lock<std::shared_mutex> Lock(Registry.Mutex);
+  assert(SignatureID < Registry.Signatures.size());
+  return Registry.Signatures[SignatureID];
+}
 } // namespace detail
 
-struct WebAssemblyInstance::ImportDescriptor {
+struct WebAssemblyModule::ImportDescriptor {
   std::uint32_t Index;
   char const *ModuleName;
   char const *EntityName;
 };
 
-struct WebAssemblyInstance::ExportDescriptor {
+struct WebAssemblyModule::ExportDescriptor {
   std::uint32_t Index;
   char const *Name;
 };
 
-struct WebAssemblyInstance::MemoryMetadata {
+struct WebAssemblyModule::MemoryMetadata {
   struct MemorySignature {
-    std::uint32_t Min;
-    std::uint32_t Max;
+    std::uint64_t Min;
+    std::uint64_t Max;
+    std::uint32_t Flags;
   };
   std::uint32_t Size, ISize, ESize;
   MemorySignature const *Signatures;
@@ -109,7 +165,7 @@ struct WebAssemblyInstance::MemoryMetadata {
   ExportDescriptor const *Exports;
 };
 
-struct WebAssemblyInstance::TableMetadata {
+struct WebAssemblyModule::TableMetadata {
   struct TableSignature {
     std::uint32_t Min;
     std::uint32_t Max;
@@ -120,160 +176,573 @@ struct WebAssemblyInstance::TableMetadata {
   ExportDescriptor const *Exports;
 };
 
-struct WebAssemblyInstance::GlobalMetadata {
+struct WebAssemblyModule::GlobalMetadata {
   std::uint32_t Size, ISize, ESize;
   char const *Signatures;
   ImportDescriptor const *Imports;
   ExportDescriptor const *Exports;
 };
 
-struct WebAssemblyInstance::FunctionMetadata {
+// Signatures expected by call_indirect, the shared object reserves a slot for
+// the ID of each of them which is filled in once loaded
+struct WebAssemblyModule::SignatureMetadata {
+  std::uint32_t Size;
+  char const *const *Signatures;
+  std::uint32_t *SignatureIDs;
+};
+
+struct WebAssemblyModule::ImageMetadata {
+  struct ImageDescriptor {
+    std::uint32_t Index;
+    std::uint64_t Offset;
+    std::uint64_t Size;
+    std::byte const *Content;
+  };
+  std::uint32_t Size;
+  ImageDescriptor const *Images;
+};
+
+struct WebAssemblyModule::FunctionMetadata {
   std::uint32_t Size, ISize, ESize;
   char const *const *Signatures;
   ImportDescriptor const *Imports;
   ExportDescriptor const *Exports;
 };
 
-WebAssemblyInstanceBuilder::WebAssemblyInstanceBuilder(
-    std::filesystem::path const &Path) {
-  Instance = std::unique_ptr<WebAssemblyInstance>(new WebAssemblyInstance());
+struct WebAssemblyModule::DataMetadata {
+  std::uint32_t Size;
+  std::uint64_t const *Sizes;
+};
+
+namespace {
+// anonymous file of Size bytes, reads as zero until written
+int createImageFile(std::size_t Size) {
+  auto FileDescriptor = memfd_create("sable-memory-image", MFD_CLOEXEC);
+  if (FileDescriptor == -1) return -1;
+  if (ftruncate(FileDescriptor, Size) == 0) return FileDescriptor;
+  close(FileDescriptor);
+  return -1;
+}
+
+bool writeImageFile(
+    int FileDescriptor, std::span<std::byte const> Content,
+    std::size_t Offset) {
+  std::size_t NumWritten = 0;
+  while (NumWritten < Content.size()) {
+    auto Result = pwrite(
+        FileDescriptor, std::addressof(Content[NumWritten]),
+        Content.size() - NumWritten, Offset + NumWritten);
+    if ((Result == -1) && (errno == EINTR)) continue;
+    if (Result <= 0) return false;
+    NumWritten = NumWritten + Result;
+  }
+  return true;
+}
+
+// identifies the content of an image file, unlike file descriptors IDs are
+// never reused
+std::uint64_t createImageID() {
+  static std::atomic<std::uint64_t> NextImageID = 1;
+  return NextImageID.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace
+
+WebAssemblyModule::~WebAssemblyModule() noexcept {
+  for (auto const &Image : MemoryImages)
+    if (Image.FileDescriptor != -1) close(Image.FileDescriptor);
+  if (DLHandler == nullptr) return;
+  WebAssemblyMemory::unregisterModuleCode(DLHandler);
+  dlclose(DLHandler);
+}
+
+std::shared_ptr<WebAssemblyModule>
+WebAssemblyModule::load(std::filesystem::path const &Path) {
+  auto Module = std::shared_ptr<WebAssemblyModule>(new WebAssemblyModule());
   auto AbsolutPath = std::filesystem::absolute(Path);
-  Instance->DLHandler = dlopen(AbsolutPath.c_str(), RTLD_NOW | RTLD_LOCAL);
-  if (Instance->DLHandler == nullptr)
+  Module->DLHandler = dlopen(AbsolutPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (Module->DLHandler == nullptr)
     throw exceptions::MalformedInstanceLibrary(dlerror());
+  WebAssemblyMemory::registerModuleCode(Module->DLHandler);
   // clang-format off
-  auto *MemoryMetadata = reinterpret_cast
-    <WebAssemblyInstance::MemoryMetadata *>
-    (dlsym(Instance->DLHandler, "__sable_memory_metadata"));
-  if (MemoryMetadata == nullptr)
+  Module->Memories = reinterpret_cast<MemoryMetadata *>
+    (dlsym(Module->DLHandler, "__sable_memory_metadata"));
+  if (Module->Memories == nullptr)
+    throw exceptions::MalformedInstanceLibrary(dlerror());
+  Module->Tables = reinterpret_cast<TableMetadata *>
+    (dlsym(Module->DLHandler, "__sable_table_metadata"));
+  if (Module->Tables == nullptr)
+    throw exceptions::MalformedInstanceLibrary(dlerror());
+  Module->Globals = reinterpret_cast<GlobalMetadata *>
+    (dlsym(Module->DLHandler, "__sable_global_metadata"));
+  if (Module->Globals == nullptr)
+    throw exceptions::MalformedInstanceLibrary(dlerror());
+  Module->Functions = reinterpret_cast<FunctionMetadata *>
+    (dlsym(Module->DLHandler, "__sable_function_metadata"));
+  if (Module->Functions == nullptr)
+    throw exceptions::MalformedInstanceLibrary(dlerror());
+  Module->DataSegments = reinterpret_cast<DataMetadata *>
+    (dlsym(Module->DLHandler, "__sable_data_metadata"));
+  if (Module->DataSegments == nullptr)
     throw exceptions::MalformedInstanceLibrary(dlerror());
-  auto *TableMetadata = reinterpret_cast
-    <WebAssemblyInstance::TableMetadata *>
-    (dlsym(Instance->DLHandler, "__sable_table_metadata"));
-  if (TableMetadata == nullptr)
+  auto *Signatures = reinterpret_cast<SignatureMetadata *>
+    (dlsym(Module->DLHandler, "__sable_signature_metadata"));
+  if (Signatures == nullptr)
     throw exceptions::MalformedInstanceLibrary(dlerror());
-  auto *GlobalMetadata = reinterpret_cast
-    <WebAssemblyInstance::GlobalMetadata *>
-    (dlsym(Instance->DLHandler, "__sable_global_metadata"));
-  if (GlobalMetadata == nullptr)
+  auto *Images = reinterpret_cast<ImageMetadata *>
+    (dlsym(Module->DLHandler, "__sable_memory_image_metadata"));
+  if (Images == nullptr)
     throw exceptions::MalformedInstanceLibrary(dlerror());
-  auto *FunctionMetadata = reinterpret_cast
-    <WebAssemblyInstance::FunctionMetadata *>
-    (dlsym(Instance->DLHandler, "__sable_function_metadata"));
-  if (FunctionMetadata == nullptr)
+  Module->MemoryInitializer = reinterpret_cast<InitializerFnTy>
+    (dlsym(Module->DLHandler, "__sable_initialize_memory"));
+  if (Module->MemoryInitializer == nullptr)
+    throw exceptions::MalformedInstanceLibrary(dlerror());
+  Module->Initializer = reinterpret_cast<InitializerFnTy>
+    (dlsym(Module->DLHandler, "__sable_initialize"));
+  if (Module->Initializer == nullptr)
     throw exceptions::MalformedInstanceLibrary(dlerror());
   // clang-format on
 
-  auto MemoryOffset = INSTANCE_ENTITY_START_OFFSET;
-  auto TableOffset = MemoryOffset + MemoryMetadata->Size;
-  auto GlobalOffset = TableOffset + TableMetadata->Size;
-  auto FunctionOffset = GlobalOffset + GlobalMetadata->Size;
-  auto Size = FunctionOffset + FunctionMetadata->Size * 2;
+  // IDs are process-wide, concurrent loads of the same library store the
+  // same values
+  for (std::size_t I = 0; I < Signatures->Size; ++I) {
+    auto SignatureID = detail::toSignatureID(Signatures->Signatures[I]);
+    std::atomic_ref<std::uint32_t> Slot(Signatures->SignatureIDs[I]);
+    Slot.store(SignatureID, std::memory_order_relaxed);
+  }
+
+  // the image files are shared by all instances, a library that cannot get
+  // one falls back to copying the content
+  auto PageSize = WebAssemblyMemory::getWebAssemblyPageSize();
+  Module->MemoryImages.resize(Module->Memories->Size);
+  for (std::size_t I = 0; I < Images->Size; ++I) {
+    auto const &Descriptor = Images->Images[I];
+    auto &Image = Module->MemoryImages[Descriptor.Index];
+    Image.Offset = Descriptor.Offset;
+    Image.Size = (Descriptor.Size + PageSize - 1) / PageSize * PageSize;
+    Image.Content = std::span(Descriptor.Content, Descriptor.Size);
+    Image.FileDescriptor = createImageFile(Image.Size);
+    Image.ImageID = createImageID();
+    if (Image.FileDescriptor == -1) continue;
+    if (writeImageFile(Image.FileDescriptor, Image.Content, 0)) continue;
+    close(Image.FileDescriptor);
+    Image.FileDescriptor = -1;
+  }
 
-  Instance->Storage = new void *[Size + 1];
-  std::fill(Instance->Storage, Instance->Storage + Size + 1, nullptr);
-  Instance->Storage[0] = Instance.get();
-  Instance->Storage = std::addressof(Instance->Storage[1]);
+  Module->StorageSize = INSTANCE_ENTITY_START_OFFSET +
+                        Module->Memories->Size * 2 + Module->Tables->Size +
+                        Module->Globals->Size + Module->Functions->Size * 2 +
+                        Module->DataSegments->Size;
 
-  Instance->Storage[0] = MemoryMetadata;
-  Instance->Storage[1] = TableMetadata;
-  Instance->Storage[2] = GlobalMetadata;
-  Instance->Storage[3] = FunctionMetadata;
+  return Module;
+}
+
+WebAssemblyImportResolver::WebAssemblyImportResolver(
+    std::shared_ptr<WebAssemblyModule> Module_)
+    : Module(std::move(Module_)) {
+  assert(Module != nullptr);
+  ContextPtrs.resize(Module->Functions->ISize, nullptr);
+  FunctionPtrs.resize(Module->Functions->ISize, nullptr);
+}
+
+std::size_t WebAssemblyImportResolver::resolve(
+    std::string_view ModuleName, std::span<HostFunction const> Namespace) {
+  auto const &Functions = *Module->Functions;
+  auto Imports = WebAssemblyModule::findImports(
+      std::span(Functions.Imports, Functions.ISize), ModuleName);
+  std::vector<HostFunction const *> Candidates;
+  Candidates.reserve(Namespace.size());
+  for (auto const &Function : Namespace)
+    Candidates.push_back(std::addressof(Function));
+  std::ranges::stable_sort(Candidates, {}, &HostFunction::EntityName);
+
+  // imports within ModuleName are sorted by entity name as well, both sides
+  // are walked once
+  std::size_t NumBound = 0;
+  auto CandidateIter = Candidates.begin();
+  for (auto const &Import : Imports) {
+    std::string_view EntityName(Import.EntityName);
+    while ((CandidateIter != Candidates.end()) &&
+           ((*CandidateIter)->EntityName < EntityName))
+      ++CandidateIter;
+    for (auto Iter = CandidateIter; Iter != Candidates.end(); ++Iter) {
+      auto const &Candidate = **Iter;
+      if (Candidate.EntityName != EntityName) break;
+      if (Candidate.Signature != Functions.Signatures[Import.Index]) continue;
+      ContextPtrs[Import.Index] = Candidate.ContextPtr;
+      FunctionPtrs[Import.Index] = Candidate.FunctionPtr;
+      NumBound = NumBound + 1;
+      break;
+    }
+  }
+  return NumBound;
+}
+
+bool WebAssemblyImportResolver::isResolved() const {
+  return std::ranges::none_of(
+      FunctionPtrs, [](auto *FunctionPtr) { return FunctionPtr == nullptr; });
+}
+
+WebAssemblyInstanceBuilder::WebAssemblyInstanceBuilder(
+    std::filesystem::path const &Path)
+    : WebAssemblyInstanceBuilder(WebAssemblyModule::load(Path)) {}
+
+WebAssemblyMemory *WebAssemblyModule::createMemory(
+    std::size_t Index, MemoryPagePolicy PagePolicy,
+    MemoryCommitPolicy CommitPolicy) const {
+  assert((Memories->ISize <= Index) && (Index < Memories->Size));
+  auto Min = Memories->Signatures[Index].Min;
+  auto Max = Memories->Signatures[Index].Max;
+  auto Flags = Memories->Signatures[Index].Flags;
+  auto Reservation = static_cast<MemoryReservationKind>(Flags & 0x3);
+  auto IsShared = (Flags & 0x4) != 0;
+  auto IsMemory64 = (Flags & 0x8) != 0;
+  return new WebAssemblyMemory(
+      Min, MemoryOptions{
+               .MaxNumPage = Max,
+               .Reservation = Reservation,
+               .PagePolicy = PagePolicy,
+               .CommitPolicy = CommitPolicy,
+               .IsShared = IsShared,
+               .IsMemory64 = IsMemory64});
+}
+
+std::span<WebAssemblyModule::ImportDescriptor const>
+WebAssemblyModule::findImports(
+    std::span<ImportDescriptor const> Imports, std::string_view ModuleName) {
+  auto Projection = [](ImportDescriptor const &Import) {
+    return std::string_view(Import.ModuleName);
+  };
+  auto Range =
+      std::ranges::equal_range(Imports, ModuleName, {}, Projection);
+  return std::span(Range.begin(), Range.end());
+}
+
+std::span<WebAssemblyModule::ImportDescriptor const>
+WebAssemblyModule::findImports(
+    std::span<ImportDescriptor const> Imports, std::string_view ModuleName,
+    std::string_view EntityName) {
+  auto Projection = [](ImportDescriptor const &Import) {
+    return std::make_pair(
+        std::string_view(Import.ModuleName),
+        std::string_view(Import.EntityName));
+  };
+  auto Key = std::make_pair(ModuleName, EntityName);
+  auto Range = std::ranges::equal_range(Imports, Key, {}, Projection);
+  return std::span(Range.begin(), Range.end());
+}
+
+WebAssemblyModule::ExportDescriptor const *WebAssemblyModule::findExport(
+    std::span<ExportDescriptor const> Exports, std::string_view Name) {
+  auto Projection = [](ExportDescriptor const &Export) {
+    return std::string_view(Export.Name);
+  };
+  auto SearchIter = std::ranges::lower_bound(Exports, Name, {}, Projection);
+  if ((SearchIter == Exports.end()) || (SearchIter->Name != Name))
+    return nullptr;
+  return std::addressof(*SearchIter);
+}
+
+std::unique_ptr<WebAssemblyMemory> WebAssemblyModule::createImportMemory(
+    std::string_view ModuleName, std::string_view EntityName,
+    MemoryPagePolicy PagePolicy, MemoryCommitPolicy CommitPolicy) const {
+  auto Imports = std::span(Memories->Imports, Memories->ISize);
+  for (auto const &Import : findImports(Imports, ModuleName, EntityName)) {
+    auto Index = Import.Index;
+    auto Min = Memories->Signatures[Index].Min;
+    auto Max = Memories->Signatures[Index].Max;
+    auto Flags = Memories->Signatures[Index].Flags;
+    auto Reservation = static_cast<MemoryReservationKind>(Flags & 0x3);
+    auto IsShared = (Flags & 0x4) != 0;
+    auto IsMemory64 = (Flags & 0x8) != 0;
+    return std::make_unique<WebAssemblyMemory>(
+        Min, MemoryOptions{
+                 .MaxNumPage = Max,
+                 .Reservation = Reservation,
+                 .PagePolicy = PagePolicy,
+                 .CommitPolicy = CommitPolicy,
+                 .IsShared = IsShared,
+                 .IsMemory64 = IsMemory64});
+  }
+  return nullptr;
+}
+
+std::optional<ExportIndex<WebAssemblyMemory>>
+WebAssemblyModule::findExportedMemory(std::string_view Name) const {
+  auto Exports = std::span(Memories->Exports, Memories->ESize);
+  auto const *Export = findExport(Exports, Name);
+  if (Export == nullptr) return std::nullopt;
+  return ExportIndex<WebAssemblyMemory>(Export->Index);
+}
+
+std::optional<ExportIndex<WebAssemblyTable>>
+WebAssemblyModule::findExportedTable(std::string_view Name) const {
+  auto Exports = std::span(Tables->Exports, Tables->ESize);
+  auto const *Export = findExport(Exports, Name);
+  if (Export == nullptr) return std::nullopt;
+  return ExportIndex<WebAssemblyTable>(Export->Index);
+}
+
+std::optional<ExportIndex<WebAssemblyGlobal>>
+WebAssemblyModule::findExportedGlobal(std::string_view Name) const {
+  auto Exports = std::span(Globals->Exports, Globals->ESize);
+  auto const *Export = findExport(Exports, Name);
+  if (Export == nullptr) return std::nullopt;
+  return ExportIndex<WebAssemblyGlobal>(Export->Index);
+}
+
+std::optional<ExportIndex<WebAssemblyCallee>>
+WebAssemblyModule::findExportedFunction(std::string_view Name) const {
+  auto Exports = std::span(Functions->Exports, Functions->ESize);
+  auto const *Export = findExport(Exports, Name);
+  if (Export == nullptr) return std::nullopt;
+  return ExportIndex<WebAssemblyCallee>(Export->Index);
+}
+
+WebAssemblyTable *WebAssemblyModule::createTable(std::size_t Index) const {
+  assert((Tables->ISize <= Index) && (Index < Tables->Size));
+  auto Min = Tables->Signatures[Index].Min;
+  auto Max = Tables->Signatures[Index].Max;
+  return new WebAssemblyTable(Min, Max);
+}
+
+WebAssemblyGlobal *WebAssemblyModule::createGlobal(std::size_t Index) const {
+  assert((Globals->ISize <= Index) && (Index < Globals->Size));
+  auto TypeChar = Globals->Signatures[Index];
+  auto GlobalValueType = detail::fromSignature<bytecode::ValueType>(TypeChar);
+  return new WebAssemblyGlobal(GlobalValueType);
+}
+
+void WebAssemblyModule::initializeMemory(
+    std::size_t Index, WebAssemblyMemory &Memory) const {
+  auto const &Image = MemoryImages[Index];
+  if (Image.Content.empty()) return;
+  if ((Image.FileDescriptor != -1) && Memory.canMapImage()) {
+    Memory.mapImage(
+        Image.FileDescriptor, Image.ImageID, Image.Offset, Image.Size);
+    return;
+  }
+  auto *Dest = std::addressof(Memory[Image.Offset]);
+  std::memcpy(Dest, Image.Content.data(), Image.Content.size());
+}
+
+WebAssemblyInstancePool::WebAssemblyInstancePool(
+    std::shared_ptr<WebAssemblyModule> Module_, std::size_t NumSlots,
+    MemoryPagePolicy PagePolicy, MemoryCommitPolicy CommitPolicy)
+    : Module(std::move(Module_)) {
+  assert(Module != nullptr);
+  Slots.resize(NumSlots);
+  FreeSlots.reserve(NumSlots);
+  for (auto &Slot : Slots) {
+    auto Size = Module->StorageSize;
+    Slot.Storage = new void *[Size + 1];
+    std::fill(Slot.Storage, Slot.Storage + Size + 1, nullptr);
+    auto const &Memories = *Module->Memories;
+    for (std::size_t I = Memories.ISize; I < Memories.Size; ++I)
+      Slot.Memories.push_back(
+          Module->createMemory(I, PagePolicy, CommitPolicy));
+    auto const &Tables = *Module->Tables;
+    for (std::size_t I = Tables.ISize; I < Tables.Size; ++I)
+      Slot.Tables.push_back(Module->createTable(I));
+    auto const &Globals = *Module->Globals;
+    for (std::size_t I = Globals.ISize; I < Globals.Size; ++I)
+      Slot.Globals.push_back(Module->createGlobal(I));
+    FreeSlots.push_back(std::addressof(Slot));
+  }
+}
+
+WebAssemblyInstancePool::~WebAssemblyInstancePool() noexcept {
+  assert(FreeSlots.size() == Slots.size());
+  for (auto &Slot : Slots) {
+    for (auto *Memory : Slot.Memories) delete Memory;
+    for (auto *Table : Slot.Tables) delete Table;
+    for (auto *Global : Slot.Globals) delete Global;
+    delete[] Slot.Storage;
+  }
+}
+
+WebAssemblyInstancePool::InstanceSlot *WebAssemblyInstancePool::acquire() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (FreeSlots.empty()) return nullptr;
+  auto *Slot = FreeSlots.back();
+  FreeSlots.pop_back();
+  return Slot;
+}
+
+void WebAssemblyInstancePool::release(InstanceSlot &Slot) {
+  auto const &Memories = *Module->Memories;
+  for (std::size_t I = Memories.ISize; I < Memories.Size; ++I) {
+    auto *Memory = Slot.Memories[I - Memories.ISize];
+    Memory->reset(Memories.Signatures[I].Min);
+  }
+  for (auto *Table : Slot.Tables) Table->reset();
+  for (auto *Global : Slot.Globals) Global->reset();
+  auto Size = Module->StorageSize;
+  std::fill(Slot.Storage, Slot.Storage + Size + 1, nullptr);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  FreeSlots.push_back(std::addressof(Slot));
+}
+
+WebAssemblyModule &WebAssemblyInstancePool::getModule() { return *Module; }
+
+std::size_t WebAssemblyInstancePool::getNumSlots() const {
+  return Slots.size();
+}
+
+std::size_t WebAssemblyInstancePool::getNumFreeSlots() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return FreeSlots.size();
+}
+
+void WebAssemblyInstanceBuilder::setup(
+    std::shared_ptr<WebAssemblyModule> Module, void **Storage) {
+  Instance->Storage = std::addressof(Storage[1]);
+  Storage[0] = Instance.get();
+  Instance->Storage[0] = Module->Memories;
+  Instance->Storage[1] = Module->Tables;
+  Instance->Storage[2] = Module->Globals;
+  Instance->Storage[3] = Module->Functions;
+  Instance->Module = std::move(Module);
+}
+
+WebAssemblyInstanceBuilder::WebAssemblyInstanceBuilder(
+    std::shared_ptr<WebAssemblyModule> Module) {
+  assert(Module != nullptr);
+  Instance = std::unique_ptr<WebAssemblyInstance>(new WebAssemblyInstance());
+  auto Size = Module->StorageSize;
+  auto *Storage = new void *[Size + 1];
+  std::fill(Storage, Storage + Size + 1, nullptr);
+  setup(std::move(Module), Storage);
+}
+
+WebAssemblyInstanceBuilder::WebAssemblyInstanceBuilder(
+    WebAssemblyInstancePool &Pool) {
+  Instance = std::unique_ptr<WebAssemblyInstance>(new WebAssemblyInstance());
+  auto *Slot = Pool.acquire();
+  if (Slot == nullptr) throw exceptions::InstancePoolExhausted();
+  Instance->Pool = std::addressof(Pool);
+  Instance->Slot = Slot;
+  setup(Pool.Module, Slot->Storage);
+}
+
+WebAssemblyInstanceBuilder::WebAssemblyInstanceBuilder(
+    WebAssemblyInstance &Parent)
+    : WebAssemblyInstanceBuilder(Parent.Module) {
+  Instance->HostData = Parent.HostData;
+  auto const &MemoryMetadata = Instance->getMemoryMetadata();
+  for (std::size_t I = 0; I < MemoryMetadata.ISize; ++I) {
+    auto *Memory = WebAssemblyMemory::fromInstancePtr(Parent.getMemory(I));
+    Memory->addUseSite(Instance->getMemory(I), Instance->getMemorySize(I));
+  }
+  for (std::size_t I = 0; I < Instance->getTableMetadata().ISize; ++I)
+    Instance->getTable(I) = Parent.getTable(I);
+  for (std::size_t I = 0; I < Instance->getGlobalMetadata().ISize; ++I)
+    Instance->getGlobal(I) = Parent.getGlobal(I);
+  for (std::size_t I = 0; I < Instance->getFunctionMetadata().ISize; ++I) {
+    Instance->getContextPtr(I) = Parent.getContextPtr(I);
+    Instance->getFunctionPtr(I) = Parent.getFunctionPtr(I);
+  }
 }
 
 bool WebAssemblyInstanceBuilder::tryImport(
     std::string_view ModuleName, std::string_view EntityName,
     WebAssemblyMemory &Memory) {
   auto const &MemoryMetadata = Instance->getMemoryMetadata();
-  for (std::size_t I = 0; I < MemoryMetadata.ISize; ++I) {
-    if ((MemoryMetadata.Imports[I].ModuleName != ModuleName) ||
-        (MemoryMetadata.Imports[I].EntityName != EntityName))
-      continue;
-    auto Index = MemoryMetadata.Imports[I].Index;
+  auto Imports = std::span(MemoryMetadata.Imports, MemoryMetadata.ISize);
+  auto IsBound = false;
+  for (auto const &Import :
+       WebAssemblyModule::findImports(Imports, ModuleName, EntityName)) {
+    auto Index = Import.Index;
     auto Min = MemoryMetadata.Signatures[Index].Min;
     auto Max = MemoryMetadata.Signatures[Index].Max;
     if (!(Memory.getSize() >= Min)) continue;
     if (!(Memory.getMaxSize() <= Max)) continue;
-    Memory.addUseSite(*Instance);
-    auto *InstancePtr = Memory.asInstancePtr();
-    Instance->getMemory(Index) = InstancePtr;
-    return true;
+    auto Flags = MemoryMetadata.Signatures[Index].Flags;
+    auto Reservation = static_cast<MemoryReservationKind>(Flags & 0x3);
+    if ((Reservation == MemoryReservationKind::GuardPage) &&
+        (Memory.getReservationKind() != MemoryReservationKind::GuardPage))
+      continue;
+    if (((Flags & 0x4) != 0) != Memory.isShared()) continue;
+    if (((Flags & 0x8) != 0) != Memory.isMemory64()) continue;
+    Memory.addUseSite(
+        Instance->getMemory(Index), Instance->getMemorySize(Index));
+    IsBound = true;
   }
-  return false;
+  return IsBound;
 }
 
 bool WebAssemblyInstanceBuilder::tryImport(
     std::string_view ModuleName, std::string_view EntityName,
     WebAssemblyTable &Table) {
   auto const &TableMetadata = Instance->getTableMetadata();
-  for (std::size_t I = 0; I < TableMetadata.ISize; ++I) {
-    if ((TableMetadata.Imports[I].ModuleName != ModuleName) ||
-        (TableMetadata.Imports[I].EntityName != EntityName))
-      continue;
-    auto Index = TableMetadata.Imports[I].Index;
+  auto Imports = std::span(TableMetadata.Imports, TableMetadata.ISize);
+  auto IsBound = false;
+  for (auto const &Import :
+       WebAssemblyModule::findImports(Imports, ModuleName, EntityName)) {
+    auto Index = Import.Index;
     auto Min = TableMetadata.Signatures[Index].Min;
     auto Max = TableMetadata.Signatures[Index].Min;
     if (!(Table.getSize() >= Min)) continue;
     if (!(Table.getMaxSize() <= Max)) continue;
     auto *InstancePtr = Table.asInstancePtr();
     Instance->getTable(Index) = InstancePtr;
-    return true;
+    IsBound = true;
   }
-  return false;
+  return IsBound;
 }
 
 bool WebAssemblyInstanceBuilder::tryImport(
     std::string_view ModuleName, std::string_view EntityName,
     WebAssemblyGlobal &Global) {
   auto const &GlobalMetadata = Instance->getGlobalMetadata();
-  for (std::size_t I = 0; I < GlobalMetadata.ISize; ++I) {
-    if ((GlobalMetadata.Imports[I].ModuleName != ModuleName) ||
-        (GlobalMetadata.Imports[I].EntityName != EntityName))
-      continue;
-    auto Index = GlobalMetadata.Imports[I].Index;
+  auto Imports = std::span(GlobalMetadata.Imports, GlobalMetadata.ISize);
+  auto IsBound = false;
+  for (auto const &Import :
+       WebAssemblyModule::findImports(Imports, ModuleName, EntityName)) {
+    auto Index = Import.Index;
     auto ExpectTypeChar = std::toupper(GlobalMetadata.Signatures[Index]);
     auto ActualTypeChar = detail::toSignature(Global.getValueType());
     if (ExpectTypeChar != ActualTypeChar) continue;
     auto *InstancePtr = Global.asInstancePtr();
     Instance->getGlobal(Index) = InstancePtr;
-    return true;
+    IsBound = true;
   }
-  return false;
+  return IsBound;
 }
 
 bool WebAssemblyInstanceBuilder::tryImport(
     std::string_view ModuleName, std::string_view EntityName,
     WebAssemblyCallee Callee) {
   auto const &FunctionMetadata = Instance->getFunctionMetadata();
-  for (std::size_t I = 0; I < FunctionMetadata.ISize; ++I) {
-    if ((FunctionMetadata.Imports[I].ModuleName != ModuleName) ||
-        (FunctionMetadata.Imports[I].EntityName != EntityName))
-      continue;
-    auto Index = FunctionMetadata.Imports[I].Index;
-    if (FunctionMetadata.Signatures[Index] != Callee.getSignature()) continue;
+  auto Imports = std::span(FunctionMetadata.Imports, FunctionMetadata.ISize);
+  auto IsBound = false;
+  for (auto const &Import :
+       WebAssemblyModule::findImports(Imports, ModuleName, EntityName)) {
+    auto Index = Import.Index;
+    std::string_view Signature(Callee.getSignature());
+    if (FunctionMetadata.Signatures[Index] != Signature) continue;
     Instance->getContextPtr(Index) = Callee.getContextPtr();
     Instance->getFunctionPtr(Index) = Callee.getFunctionPtr();
-    return true;
+    IsBound = true;
   }
-  return false;
+  return IsBound;
 }
 
 bool WebAssemblyInstanceBuilder::tryImport(
     std::string_view ModuleName, std::string_view EntityName,
     std::string_view Signature, std::intptr_t Function) {
   auto const &FunctionMetadata = Instance->getFunctionMetadata();
-  for (std::size_t I = 0; I < FunctionMetadata.ISize; ++I) {
-    if ((FunctionMetadata.Imports[I].ModuleName != ModuleName) ||
-        (FunctionMetadata.Imports[I].EntityName != EntityName))
-      continue;
-    auto Index = FunctionMetadata.Imports[I].Index;
+  auto Imports = std::span(FunctionMetadata.Imports, FunctionMetadata.ISize);
+  auto IsBound = false;
+  for (auto const &Import :
+       WebAssemblyModule::findImports(Imports, ModuleName, EntityName)) {
+    auto Index = Import.Index;
     if (FunctionMetadata.Signatures[Index] != Signature) continue;
     auto *CastedPtr = reinterpret_cast<__sable_function_t *>(Function);
     Instance->getContextPtr(Index) = nullptr;
     Instance->getFunctionPtr(Index) = CastedPtr;
-    return true;
+    IsBound = true;
   }
-  return false;
+  return IsBound;
 }
 
 WebAssemblyInstanceBuilder &WebAssemblyInstanceBuilder::import(
@@ -316,43 +785,54 @@ WebAssemblyInstanceBuilder &WebAssemblyInstanceBuilder::import(
   return *this;
 }
 
+WebAssemblyInstanceBuilder &
+WebAssemblyInstanceBuilder::import(WebAssemblyImportResolver const &Resolver) {
+  if (Resolver.Module != Instance->Module)
+    throw std::invalid_argument("import resolver of another module");
+  for (std::size_t I = 0; I < Resolver.FunctionPtrs.size(); ++I) {
+    if (Resolver.FunctionPtrs[I] == nullptr) continue;
+    Instance->getContextPtr(I) = Resolver.ContextPtrs[I];
+    Instance->getFunctionPtr(I) = Resolver.FunctionPtrs[I];
+  }
+  return *this;
+}
+
 std::unique_ptr<WebAssemblyInstance> WebAssemblyInstanceBuilder::Build() {
+  auto *Slot = Instance->Slot;
+  auto const &Module = *Instance->Module;
+
   auto MemoryDefFirst = Instance->getMemoryMetadata().ISize;
   auto MemoryDefLast = Instance->getMemoryMetadata().Size;
   for (std::size_t I = MemoryDefFirst; I < MemoryDefLast; ++I) {
-    auto Min = Instance->getMemoryMetadata().Signatures[I].Min;
-    auto Max = Instance->getMemoryMetadata().Signatures[I].Max;
-    auto *Memory = new WebAssemblyMemory(Min, Max);
-    Memory->addUseSite(*Instance);
-    Instance->getMemory(I) = Memory->asInstancePtr();
+    auto *Memory = (Slot != nullptr)
+                       ? Slot->Memories[I - MemoryDefFirst]
+                       : Module.createMemory(I, PagePolicy, CommitPolicy);
+    if (Snapshot != nullptr) {
+      Snapshot->restore(I - MemoryDefFirst, *Memory);
+    } else {
+      Module.initializeMemory(I, *Memory);
+    }
+    Memory->addUseSite(Instance->getMemory(I), Instance->getMemorySize(I));
   }
 
   auto TableDefStart = Instance->getTableMetadata().ISize;
   auto TableDefLast = Instance->getTableMetadata().Size;
   for (std::size_t I = TableDefStart; I < TableDefLast; ++I) {
-    auto Min = Instance->getTableMetadata().Signatures[I].Min;
-    auto Max = Instance->getTableMetadata().Signatures[I].Max;
-    auto *Table = new WebAssemblyTable(Min, Max);
+    auto *Table = (Slot != nullptr) ? Slot->Tables[I - TableDefStart]
+                                    : Module.createTable(I);
     Instance->getTable(I) = Table->asInstancePtr();
   }
 
   auto GlobalDefFirst = Instance->getGlobalMetadata().ISize;
   auto GlobalDefEnd = Instance->getGlobalMetadata().Size;
   for (std::size_t I = GlobalDefFirst; I < GlobalDefEnd; ++I) {
-    auto TypeChar = Instance->getGlobalMetadata().Signatures[I];
-    auto GlobalValueType = detail::fromSignature<bytecode::ValueType>(TypeChar);
-    auto *Global = new WebAssemblyGlobal(GlobalValueType);
+    auto *Global = (Slot != nullptr) ? Slot->Globals[I - GlobalDefFirst]
+                                     : Module.createGlobal(I);
     Instance->getGlobal(I) = Global->asInstancePtr();
   }
 
-  using SableInitializeFnTy = void (*)(void *);
-  // clang-format off
-  auto *Initializer = reinterpret_cast<SableInitializeFnTy>
-    (dlsym(Instance->DLHandler, "__sable_initialize"));
-  if (Initializer == nullptr)
-    throw exceptions::MalformedInstanceLibrary(dlerror());
-  // clang-format on
-  Initializer(Instance->Storage);
+  if (Snapshot == nullptr) Module.MemoryInitializer(Instance->Storage);
+  Module.Initializer(Instance->Storage);
 
   for (std::size_t I = 0; I < Instance->getMemoryMetadata().Size; ++I)
     if (Instance->getMemory(I) == nullptr)
@@ -367,91 +847,340 @@ std::unique_ptr<WebAssemblyInstance> WebAssemblyInstanceBuilder::Build() {
     if (Instance->getFunctionPtr(I) == nullptr)
       throw std::runtime_error("incomplete instance (missing function)");
 
-  auto const &MemoryMetadata = Instance->getMemoryMetadata();
-  auto const &TableMetadata = Instance->getTableMetadata();
-  auto const &GlobalMetadata = Instance->getGlobalMetadata();
-  auto const &FunctionMetadata = Instance->getFunctionMetadata();
+  if (Snapshot != nullptr) Snapshot->restore(*Instance);
+  return std::move(Instance);
+}
 
-  Instance->ExportedMemories.reserve(MemoryMetadata.ESize);
-  for (std::size_t I = 0; I < MemoryMetadata.ESize; ++I) {
-    std::string_view Name(MemoryMetadata.Exports[I].Name);
-    auto *InstancePtr = Instance->getMemory(MemoryMetadata.Exports[I].Index);
-    Instance->ExportedMemories.emplace(Name, InstancePtr);
+WebAssemblyInstanceBuilder &WebAssemblyInstanceBuilder::restore(
+    std::shared_ptr<WebAssemblySnapshot const> Snapshot_) {
+  assert(Snapshot_ != nullptr);
+  if (Snapshot_->Module != Instance->Module)
+    throw std::invalid_argument("snapshot of another module");
+  Snapshot = std::move(Snapshot_);
+  return *this;
+}
+
+WebAssemblyInstanceBuilder &
+WebAssemblyInstanceBuilder::setMemoryPagePolicy(MemoryPagePolicy PagePolicy_) {
+  PagePolicy = PagePolicy_;
+  return *this;
+}
+
+WebAssemblyInstanceBuilder &WebAssemblyInstanceBuilder::setMemoryCommitPolicy(
+    MemoryCommitPolicy CommitPolicy_) {
+  CommitPolicy = CommitPolicy_;
+  return *this;
+}
+
+namespace {
+constexpr std::array<char, 8> SnapshotMagic{
+    'S', 'A', 'B', 'L', 'E', 'S', 'N', 'P'};
+constexpr std::uint32_t SnapshotVersion = 3;
+
+template <typename T> void writeValue(std::ostream &Output, T const &Value) {
+  auto *Ptr = reinterpret_cast<char const *>(std::addressof(Value));
+  Output.write(Ptr, sizeof(T));
+}
+
+template <typename T> T readValue(std::istream &Input) {
+  T Value;
+  Input.read(reinterpret_cast<char *>(std::addressof(Value)), sizeof(T));
+  if (!Input) throw exceptions::MalformedSnapshot("unexpected end of file");
+  return Value;
+}
+} // namespace
+
+WebAssemblySnapshot::~WebAssemblySnapshot() noexcept {
+  for (auto const &Memory : Memories)
+    if (Memory.FileDescriptor != -1) close(Memory.FileDescriptor);
+}
+
+WebAssemblyModule &WebAssemblySnapshot::getModule() { return *Module; }
+
+void WebAssemblySnapshot::restore(
+    std::size_t Index, WebAssemblyMemory &Memory) const {
+  auto const &Snapshot = Memories[Index];
+  Memory.restore(Snapshot.NumPage, Snapshot.FileDescriptor, Snapshot.ImageID);
+}
+
+void WebAssemblySnapshot::restore(WebAssemblyInstance &Instance) const {
+  auto TableDefFirst = Instance.getTableMetadata().ISize;
+  for (std::size_t I = 0; I < Tables.size(); ++I) {
+    auto *TablePtr = Instance.getTable(TableDefFirst + I);
+    auto &Table = *WebAssemblyTable::fromInstancePtr(TablePtr);
+    for (std::uint32_t J = 0; J < Tables[I].size(); ++J) {
+      auto FunctionIndex = Tables[I][J];
+      if (FunctionIndex == NullEntry) {
+        Table.set(J, nullptr, nullptr, std::string_view());
+        continue;
+      }
+      auto *ContextPtr = Instance.getContextPtr(FunctionIndex);
+      auto *FunctionPtr = Instance.getFunctionPtr(FunctionIndex);
+      auto *Signature = Instance.getSignature(FunctionIndex);
+      Table.set(J, ContextPtr, FunctionPtr, Signature);
+    }
   }
 
-  Instance->ExportedTables.reserve(TableMetadata.ESize);
-  for (std::size_t I = 0; I < TableMetadata.ESize; ++I) {
-    std::string_view Name(TableMetadata.Exports[I].Name);
-    auto *InstancePtr = Instance->getTable(TableMetadata.Exports[I].Index);
-    Instance->ExportedTables.emplace(Name, InstancePtr);
+  auto GlobalDefFirst = Instance.getGlobalMetadata().ISize;
+  for (std::size_t I = 0; I < Globals.size(); ++I) {
+    auto *GlobalPtr = Instance.getGlobal(GlobalDefFirst + I);
+    auto &Global = *WebAssemblyGlobal::fromInstancePtr(GlobalPtr);
+    static_assert(sizeof(Global.Storage) == sizeof(std::uint64_t));
+    std::memcpy(&Global.Storage, &Globals[I], sizeof(std::uint64_t));
   }
 
-  Instance->ExportedGlobals.reserve(GlobalMetadata.ESize);
-  for (std::size_t I = 0; I < GlobalMetadata.ESize; ++I) {
-    std::string_view Name(GlobalMetadata.Exports[I].Name);
-    auto *InstancePtr = Instance->getGlobal(GlobalMetadata.Exports[I].Index);
-    Instance->ExportedGlobals.emplace(Name, InstancePtr);
+  for (std::size_t I = 0; I < DataSizes.size(); ++I)
+    Instance.getDataSize(I) = DataSizes[I];
+}
+
+std::shared_ptr<WebAssemblySnapshot>
+WebAssemblySnapshot::capture(WebAssemblyInstance &Instance) {
+  // data segments of imported memories would not be applied on restore
+  if (Instance.getMemoryMetadata().ISize != 0)
+    throw std::invalid_argument("cannot snapshot imported memories");
+  auto Snapshot =
+      std::shared_ptr<WebAssemblySnapshot>(new WebAssemblySnapshot());
+  Snapshot->Module = Instance.Module;
+
+  auto PageSize = WebAssemblyMemory::getWebAssemblyPageSize();
+  auto const &Memories = Instance.getMemoryMetadata();
+  for (std::size_t I = Memories.ISize; I < Memories.Size; ++I) {
+    auto &Memory = *WebAssemblyMemory::fromInstancePtr(Instance.getMemory(I));
+    auto &MemorySnapshot = Snapshot->Memories.emplace_back();
+    MemorySnapshot.NumPage = Memory.getSize();
+    MemorySnapshot.FileDescriptor = createImageFile(Memory.getSizeInBytes());
+    if (MemorySnapshot.FileDescriptor == -1) throw std::bad_alloc();
+    MemorySnapshot.ImageID = createImageID();
+    // scanning only populated pages keeps untouched ones unallocated
+    for (auto J : Memory.getPopulatedPages()) {
+      auto Offset = std::size_t(J) * PageSize;
+      auto Page = std::span<std::byte const>(Memory.data() + Offset, PageSize);
+      auto IsZero = std::all_of(Page.begin(), Page.end(), [](std::byte Byte) {
+        return Byte == std::byte(0);
+      });
+      if (IsZero) continue;
+      if (!writeImageFile(MemorySnapshot.FileDescriptor, Page, Offset))
+        throw std::bad_alloc();
+      // at most 2^32 pages, a page index always fits
+      MemorySnapshot.DataPages.push_back(static_cast<std::uint32_t>(J));
+    }
+  }
+
+  using FunctionKey = std::pair<__sable_instance_t *, __sable_function_t *>;
+  std::map<FunctionKey, std::uint32_t> FunctionIndices;
+  for (std::uint32_t I = 0; I < Instance.getFunctionMetadata().Size; ++I) {
+    auto *ContextPtr = Instance.getContextPtr(I);
+    auto *FunctionPtr = Instance.getFunctionPtr(I);
+    FunctionIndices.emplace(FunctionKey(ContextPtr, FunctionPtr), I);
+  }
+  auto const &Tables = Instance.getTableMetadata();
+  for (std::size_t I = Tables.ISize; I < Tables.Size; ++I) {
+    auto &Table = *WebAssemblyTable::fromInstancePtr(Instance.getTable(I));
+    auto &TableSnapshot = Snapshot->Tables.emplace_back();
+    TableSnapshot.reserve(Table.getSize());
+    for (std::uint32_t J = 0; J < Table.getSize(); ++J) {
+      auto const &Entry = Table.Storage[J];
+      if (Entry.FunctionPtr == nullptr) {
+        TableSnapshot.push_back(NullEntry);
+        continue;
+      }
+      auto Key = FunctionKey(Entry.ContextPtr, Entry.FunctionPtr);
+      auto SearchIter = FunctionIndices.find(Key);
+      if (SearchIter == FunctionIndices.end())
+        throw std::invalid_argument("cannot snapshot foreign table entry");
+      TableSnapshot.push_back(std::get<1>(*SearchIter));
+    }
   }
 
-  Instance->ExportedFunctions.reserve(FunctionMetadata.ESize);
-  for (std::size_t I = 0; I < FunctionMetadata.ESize; ++I) {
-    auto Index = FunctionMetadata.Exports[I].Index;
-    std::string_view Name(FunctionMetadata.Exports[I].Name);
-    auto *ContextPtr = Instance->getContextPtr(Index);
-    auto *FunctionPtr = Instance->getFunctionPtr(Index);
-    auto *Signature = FunctionMetadata.Signatures[Index];
-    WebAssemblyInstance::FunctionEntry Entry{
-        .ContextPtr = ContextPtr,
-        .FunctionPtr = FunctionPtr,
-        .Signature = Signature};
-    Instance->ExportedFunctions.emplace(Name, Entry);
+  auto const &Globals = Instance.getGlobalMetadata();
+  for (std::size_t I = Globals.ISize; I < Globals.Size; ++I) {
+    auto &Global = *WebAssemblyGlobal::fromInstancePtr(Instance.getGlobal(I));
+    std::uint64_t Value = 0;
+    std::memcpy(&Value, &Global.Storage, sizeof(std::uint64_t));
+    Snapshot->Globals.push_back(Value);
   }
 
-  return std::move(Instance);
+  auto NumDataSegments = Instance.Module->DataSegments->Size;
+  for (std::size_t I = 0; I < NumDataSegments; ++I)
+    Snapshot->DataSizes.push_back(Instance.getDataSize(I));
+  return Snapshot;
 }
 
-WebAssemblyInstance::MemoryMetadata const &
+void WebAssemblySnapshot::save(std::filesystem::path const &Path) const {
+  std::ofstream Output(Path, std::ios::binary | std::ios::trunc);
+  if (!Output) throw std::runtime_error("cannot open snapshot file");
+  Output.write(SnapshotMagic.data(), SnapshotMagic.size());
+  writeValue(Output, SnapshotVersion);
+
+  auto PageSize = WebAssemblyMemory::getWebAssemblyPageSize();
+  std::vector<char> Buffer(PageSize);
+  writeValue(Output, static_cast<std::uint32_t>(Memories.size()));
+  for (auto const &Memory : Memories) {
+    writeValue(Output, Memory.NumPage);
+    writeValue(Output, static_cast<std::uint32_t>(Memory.DataPages.size()));
+    for (auto PageIndex : Memory.DataPages) {
+      auto NumRead = pread(
+          Memory.FileDescriptor, Buffer.data(), PageSize,
+          std::size_t(PageIndex) * PageSize);
+      if (NumRead != static_cast<ssize_t>(PageSize))
+        throw std::runtime_error("cannot read memory snapshot");
+      writeValue(Output, PageIndex);
+      Output.write(Buffer.data(), PageSize);
+    }
+  }
+
+  writeValue(Output, static_cast<std::uint32_t>(Tables.size()));
+  for (auto const &Table : Tables) {
+    writeValue(Output, static_cast<std::uint32_t>(Table.size()));
+    for (auto FunctionIndex : Table) writeValue(Output, FunctionIndex);
+  }
+
+  writeValue(Output, static_cast<std::uint32_t>(Globals.size()));
+  for (auto Global : Globals) writeValue(Output, Global);
+
+  writeValue(Output, static_cast<std::uint32_t>(DataSizes.size()));
+  for (auto DataSize : DataSizes) writeValue(Output, DataSize);
+  if (!Output) throw std::runtime_error("cannot write snapshot file");
+}
+
+std::shared_ptr<WebAssemblySnapshot> WebAssemblySnapshot::load(
+    std::shared_ptr<WebAssemblyModule> Module,
+    std::filesystem::path const &Path) {
+  assert(Module != nullptr);
+  std::ifstream Input(Path, std::ios::binary);
+  if (!Input) throw std::runtime_error("cannot open snapshot file");
+  auto Magic = readValue<std::array<char, 8>>(Input);
+  if (Magic != SnapshotMagic)
+    throw exceptions::MalformedSnapshot("not a snapshot file");
+  if (readValue<std::uint32_t>(Input) != SnapshotVersion)
+    throw exceptions::MalformedSnapshot("unsupported snapshot version");
+
+  auto Snapshot =
+      std::shared_ptr<WebAssemblySnapshot>(new WebAssemblySnapshot());
+  Snapshot->Module = Module;
+
+  auto const &Memories = *Module->Memories;
+  auto PageSize = WebAssemblyMemory::getWebAssemblyPageSize();
+  std::vector<std::byte> Buffer(PageSize);
+  if (readValue<std::uint32_t>(Input) != Memories.Size - Memories.ISize)
+    throw exceptions::MalformedSnapshot("memory count mismatch");
+  Snapshot->Memories.resize(Memories.Size - Memories.ISize);
+  for (std::size_t I = 0; I < Snapshot->Memories.size(); ++I) {
+    auto &Memory = Snapshot->Memories[I];
+    auto const &Signature = Memories.Signatures[Memories.ISize + I];
+    Memory.NumPage = readValue<std::uint64_t>(Input);
+    if ((Memory.NumPage < Signature.Min) || (Memory.NumPage > Signature.Max))
+      throw exceptions::MalformedSnapshot("memory size mismatch");
+    Memory.FileDescriptor = createImageFile(Memory.NumPage * PageSize);
+    if (Memory.FileDescriptor == -1) throw std::bad_alloc();
+    Memory.ImageID = createImageID();
+    auto NumDataPages = readValue<std::uint32_t>(Input);
+    for (std::uint32_t J = 0; J < NumDataPages; ++J) {
+      auto PageIndex = readValue<std::uint32_t>(Input);
+      if (PageIndex >= Memory.NumPage)
+        throw exceptions::MalformedSnapshot("memory page out of bound");
+      Input.read(reinterpret_cast<char *>(Buffer.data()), PageSize);
+      if (!Input) throw exceptions::MalformedSnapshot("unexpected end of file");
+      auto Offset = std::size_t(PageIndex) * PageSize;
+      if (!writeImageFile(Memory.FileDescriptor, Buffer, Offset))
+        throw std::bad_alloc();
+      Memory.DataPages.push_back(PageIndex);
+    }
+  }
+
+  auto const &Tables = *Module->Tables;
+  auto NumFunctions = Module->Functions->Size;
+  if (readValue<std::uint32_t>(Input) != Tables.Size - Tables.ISize)
+    throw exceptions::MalformedSnapshot("table count mismatch");
+  Snapshot->Tables.resize(Tables.Size - Tables.ISize);
+  for (std::size_t I = 0; I < Snapshot->Tables.size(); ++I) {
+    auto &Table = Snapshot->Tables[I];
+    auto NumEntries = readValue<std::uint32_t>(Input);
+    if (NumEntries != Tables.Signatures[Tables.ISize + I].Min)
+      throw exceptions::MalformedSnapshot("table size mismatch");
+    Table.resize(NumEntries);
+    for (auto &FunctionIndex : Table) {
+      FunctionIndex = readValue<std::uint32_t>(Input);
+      if ((FunctionIndex != NullEntry) && (FunctionIndex >= NumFunctions))
+        throw exceptions::MalformedSnapshot("table entry out of bound");
+    }
+  }
+
+  auto const &Globals = *Module->Globals;
+  if (readValue<std::uint32_t>(Input) != Globals.Size - Globals.ISize)
+    throw exceptions::MalformedSnapshot("global count mismatch");
+  Snapshot->Globals.resize(Globals.Size - Globals.ISize);
+  for (auto &Global : Snapshot->Globals)
+    Global = readValue<std::uint64_t>(Input);
+
+  // a dropped segment stays dropped, a live one keeps its full length
+  auto const &DataSegments = *Module->DataSegments;
+  if (readValue<std::uint32_t>(Input) != DataSegments.Size)
+    throw exceptions::MalformedSnapshot("data segment count mismatch");
+  Snapshot->DataSizes.resize(DataSegments.Size);
+  for (std::size_t I = 0; I < Snapshot->DataSizes.size(); ++I) {
+    auto DataSize = readValue<std::uint64_t>(Input);
+    if ((DataSize != 0) && (DataSize != DataSegments.Sizes[I]))
+      throw exceptions::MalformedSnapshot("data segment size mismatch");
+    Snapshot->DataSizes[I] = DataSize;
+  }
+
+  return Snapshot;
+}
+
+WebAssemblyModule::MemoryMetadata const &
 WebAssemblyInstance::getMemoryMetadata() const {
-  return *reinterpret_cast<MemoryMetadata *>(Storage[0]);
+  return *reinterpret_cast<WebAssemblyModule::MemoryMetadata *>(
+      Storage[0]);
 }
 
-WebAssemblyInstance::TableMetadata const &
+WebAssemblyModule::TableMetadata const &
 WebAssemblyInstance::getTableMetadata() const {
-  return *reinterpret_cast<TableMetadata *>(Storage[1]);
+  return *reinterpret_cast<WebAssemblyModule::TableMetadata *>(
+      Storage[1]);
 }
 
-WebAssemblyInstance::GlobalMetadata const &
+WebAssemblyModule::GlobalMetadata const &
 WebAssemblyInstance::getGlobalMetadata() const {
-  return *reinterpret_cast<GlobalMetadata *>(Storage[2]);
+  return *reinterpret_cast<WebAssemblyModule::GlobalMetadata *>(
+      Storage[2]);
 }
 
-WebAssemblyInstance::FunctionMetadata const &
+WebAssemblyModule::FunctionMetadata const &
 WebAssemblyInstance::getFunctionMetadata() const {
-  return *reinterpret_cast<FunctionMetadata *>(Storage[3]);
+  return *reinterpret_cast<WebAssemblyModule::FunctionMetadata *>(
+      Storage[3]);
 }
 
 __sable_memory_t *&WebAssemblyInstance::getMemory(std::size_t Index) {
   assert(Index < getMemoryMetadata().Size);
-  auto Offset = INSTANCE_ENTITY_START_OFFSET + Index;
+  auto Offset = INSTANCE_ENTITY_START_OFFSET + Index * 2;
   return reinterpret_cast<__sable_memory_t *&>(Storage[Offset]);
 }
 
+std::size_t &WebAssemblyInstance::getMemorySize(std::size_t Index) {
+  assert(Index < getMemoryMetadata().Size);
+  auto Offset = INSTANCE_ENTITY_START_OFFSET + Index * 2 + 1;
+  return reinterpret_cast<std::size_t &>(Storage[Offset]);
+}
+
 __sable_table_t *&WebAssemblyInstance::getTable(std::size_t Index) {
   assert(Index < getTableMetadata().Size);
-  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size + Index;
+  auto Offset =
+      INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size * 2 + Index;
   return reinterpret_cast<__sable_table_t *&>(Storage[Offset]);
 }
 
 __sable_global_t *&WebAssemblyInstance::getGlobal(std::size_t Index) {
   assert(Index < getGlobalMetadata().Size);
-  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size +
+  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size * 2 +
                 getTableMetadata().Size + Index;
   return reinterpret_cast<__sable_global_t *&>(Storage[Offset]);
 }
 
 __sable_instance_t *&WebAssemblyInstance::getContextPtr(std::size_t Index) {
   assert(Index < getFunctionMetadata().Size);
-  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size +
+  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size * 2 +
                 getTableMetadata().Size + getGlobalMetadata().Size;
   Offset = Offset + Index * 2;
   return reinterpret_cast<__sable_instance_t *&>(Storage[Offset]);
@@ -459,44 +1188,39 @@ __sable_instance_t *&WebAssemblyInstance::getContextPtr(std::size_t Index) {
 
 __sable_function_t *&WebAssemblyInstance::getFunctionPtr(std::size_t Index) {
   assert(Index < getFunctionMetadata().Size);
-  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size +
+  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size * 2 +
                 getTableMetadata().Size + getGlobalMetadata().Size;
   Index = Offset + Index * 2 + 1;
   return reinterpret_cast<__sable_function_t *&>(Storage[Index]);
 }
 
+std::size_t &WebAssemblyInstance::getDataSize(std::size_t Index) {
+  assert(Index < Module->DataSegments->Size);
+  auto Offset = INSTANCE_ENTITY_START_OFFSET + getMemoryMetadata().Size * 2 +
+                getTableMetadata().Size + getGlobalMetadata().Size +
+                getFunctionMetadata().Size * 2;
+  Offset = Offset + Index;
+  return reinterpret_cast<std::size_t &>(Storage[Offset]);
+}
+
 char const *WebAssemblyInstance::getSignature(std::size_t Index) const {
   assert(Index < getFunctionMetadata().Size);
   return getFunctionMetadata().Signatures[Index];
 }
 
-void WebAssemblyInstance::replace(
-    __sable_memory_t *Old, __sable_memory_t *New) {
-  auto HasReplaced = false;
-  for (std::size_t I = 0; I < getMemoryMetadata().Size; ++I)
-    if (getMemory(I) == Old) {
-      getMemory(I) = New;
-      HasReplaced = true;
-      break;
-    }
-  for (auto const &[Name, MemoryPtr] : ExportedMemories) {
-    if (MemoryPtr == Old) {
-      ExportedMemories[Name] = New;
-      HasReplaced = true;
-      break;
-    }
-  }
-  utility::ignore(HasReplaced);
-  assert(HasReplaced);
-}
-
 WebAssemblyInstance::~WebAssemblyInstance() noexcept {
-  auto *DLHandlerToFree = DLHandler;
+  for (auto &Thread : Threads) Thread.join();
   if (Storage != nullptr) {
     for (std::size_t I = 0; I < getMemoryMetadata().Size; ++I) {
       auto *MemoryPtr = getMemory(I);
       auto *Memory = WebAssemblyMemory::fromInstancePtr(MemoryPtr);
-      if (Memory != nullptr) Memory->removeUseSite(*this);
+      if (Memory != nullptr) Memory->removeUseSite(getMemory(I));
+    }
+
+    // pooled entities are reset and kept by the pool
+    if (Pool != nullptr) {
+      Pool->release(*Slot);
+      return;
     }
 
     auto MemoryDefFirst = getMemoryMetadata().ISize;
@@ -524,7 +1248,6 @@ WebAssemblyInstance::~WebAssemblyInstance() noexcept {
     }
     delete[] std::addressof(Storage[-1]);
   }
-  if (DLHandlerToFree != nullptr) dlclose(DLHandlerToFree);
 }
 
 WebAssemblyMemory &WebAssemblyInstance::getMemory(std::string_view Name) {
@@ -556,33 +1279,85 @@ WebAssemblyCallee WebAssemblyInstance::getFunction(std::string_view Name) {
 }
 
 WebAssemblyMemory *WebAssemblyInstance::tryGetMemory(std::string_view Name) {
-  auto SearchIter = ExportedMemories.find(Name);
-  if (SearchIter == ExportedMemories.end()) return nullptr;
-  return WebAssemblyMemory::fromInstancePtr(std::get<1>(*SearchIter));
+  auto Index = Module->findExportedMemory(Name);
+  if (!Index.has_value()) return nullptr;
+  return std::addressof(getMemory(*Index));
 }
 
 WebAssemblyTable *WebAssemblyInstance::tryGetTable(std::string_view Name) {
-  auto SearchIter = ExportedTables.find(Name);
-  if (SearchIter == ExportedTables.end()) return nullptr;
-  return WebAssemblyTable::fromInstancePtr(std::get<1>(*SearchIter));
+  auto Index = Module->findExportedTable(Name);
+  if (!Index.has_value()) return nullptr;
+  return std::addressof(getTable(*Index));
 }
 
 WebAssemblyGlobal *WebAssemblyInstance::tryGetGlobal(std::string_view Name) {
-  auto SearchIter = ExportedGlobals.find(Name);
-  if (SearchIter == ExportedGlobals.end()) return nullptr;
-  return WebAssemblyGlobal::fromInstancePtr(std::get<1>(*SearchIter));
+  auto Index = Module->findExportedGlobal(Name);
+  if (!Index.has_value()) return nullptr;
+  return std::addressof(getGlobal(*Index));
 }
 
 std::optional<WebAssemblyCallee>
 WebAssemblyInstance::tryGetFunction(std::string_view Name) {
-  auto SearchIter = ExportedFunctions.find(Name);
-  if (SearchIter == ExportedFunctions.end()) return std::nullopt;
-  auto *Signature = std::get<1>(*SearchIter).Signature;
-  auto *FunctionPtr = std::get<1>(*SearchIter).FunctionPtr;
-  auto *ContextPtr = std::get<1>(*SearchIter).ContextPtr;
+  auto Index = Module->findExportedFunction(Name);
+  if (!Index.has_value()) return std::nullopt;
+  return getFunction(*Index);
+}
+
+WebAssemblyMemory &
+WebAssemblyInstance::getMemory(ExportIndex<WebAssemblyMemory> Index) {
+  assert(Index.Index < getMemoryMetadata().Size);
+  return *WebAssemblyMemory::fromInstancePtr(getMemory(Index.Index));
+}
+
+WebAssemblyTable &
+WebAssemblyInstance::getTable(ExportIndex<WebAssemblyTable> Index) {
+  assert(Index.Index < getTableMetadata().Size);
+  return *WebAssemblyTable::fromInstancePtr(getTable(Index.Index));
+}
+
+WebAssemblyGlobal &
+WebAssemblyInstance::getGlobal(ExportIndex<WebAssemblyGlobal> Index) {
+  assert(Index.Index < getGlobalMetadata().Size);
+  return *WebAssemblyGlobal::fromInstancePtr(getGlobal(Index.Index));
+}
+
+WebAssemblyCallee
+WebAssemblyInstance::getFunction(ExportIndex<WebAssemblyCallee> Index) {
+  assert(Index.Index < getFunctionMetadata().Size);
+  auto *Signature = getSignature(Index.Index);
+  auto *FunctionPtr = getFunctionPtr(Index.Index);
+  auto *ContextPtr = getContextPtr(Index.Index);
   return WebAssemblyCallee(ContextPtr, FunctionPtr, Signature);
 }
 
+WebAssemblyModule &WebAssemblyInstance::getModule() { return *Module; }
+
+WebAssemblyModule const &WebAssemblyInstance::getModule() const {
+  return *Module;
+}
+
+void WebAssemblyInstance::addThread(std::thread Thread) {
+  Threads.push_back(std::move(Thread));
+}
+
+void WebAssemblyInstance::setHostData(std::shared_ptr<void> Data) {
+  HostData = std::move(Data);
+}
+
+std::shared_ptr<void> const &WebAssemblyInstance::getHostData() const {
+  return HostData;
+}
+
+std::shared_ptr<WebAssemblySnapshot> WebAssemblyInstance::snapshot() {
+  return WebAssemblySnapshot::capture(*this);
+}
+
+std::shared_ptr<WebAssemblySnapshot>
+WebAssemblyInstance::snapshot(std::string_view InitializerName) {
+  getFunction(InitializerName).invoke<void>();
+  return snapshot();
+}
+
 __sable_instance_t *WebAssemblyInstance::asInstancePtr() {
   return reinterpret_cast<__sable_instance_t *>(Storage);
 }
@@ -4,11 +4,20 @@
 #include "../bytecode/Type.h"
 #include "../utility/Commons.h"
 
+#include <array>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 extern "C" {
 struct __sable_memory_t;
@@ -21,13 +30,20 @@ struct __sable_instance_t;
 void __sable_unreachable();
 
 std::uint32_t __sable_memory_size(__sable_memory_t *);
-void __sable_memory_guard(__sable_memory_t *, std::uint32_t Offset);
+std::uint64_t __sable_memory_size64(__sable_memory_t *);
+void __sable_memory_guard(__sable_memory_t *, std::size_t Offset);
+[[noreturn]] void __sable_memory_trap(__sable_memory_t *, std::size_t Offset);
 std::uint32_t __sable_memory_grow(__sable_memory_t *, std::uint32_t Delta);
+std::uint64_t __sable_memory_grow64(__sable_memory_t *, std::uint64_t Delta);
+[[noreturn]] void __sable_memory_unaligned_trap(__sable_memory_t *, std::size_t Offset);
+std::uint32_t __sable_memory_wait32(__sable_memory_t *, std::size_t Offset, std::uint32_t Expect, std::int64_t Timeout);
+std::uint32_t __sable_memory_wait64(__sable_memory_t *, std::size_t Offset, std::uint64_t Expect, std::int64_t Timeout);
+std::uint32_t __sable_memory_notify(__sable_memory_t *, std::size_t Offset, std::uint32_t Count);
+
+[[noreturn]] void __sable_data_trap(std::size_t Offset, std::size_t Size);
 
 void __sable_table_guard(__sable_table_t *, std::uint32_t Index);
-void __sable_table_check(__sable_table_t *, std::uint32_t Index, char const *ExpectSignature);
-__sable_instance_t *__sable_table_context(__sable_table_t *, std::uint32_t Index);
-__sable_function_t *__sable_table_function(__sable_table_t *, std::uint32_t Index);
+void __sable_table_check(__sable_table_t *, std::uint32_t Index, std::uint32_t ExpectSignatureID);
 void __sable_table_set(__sable_table_t *, __sable_instance_t *, std::uint32_t Offset, std::uint32_t Count, std::uint32_t Indices[]);
 // clang-format on
 }
@@ -37,6 +53,10 @@ class WebAssemblyMemory;
 class WebAssemblyGlobal;
 class WebAssemblyTable;
 class WebAssemblyCallee;
+class WebAssemblyModule;
+class WebAssemblyImportResolver;
+class WebAssemblyInstancePool;
+class WebAssemblySnapshot;
 class WebAssemblyInstance;
 class WebAssemblyInstanceBuilder;
 
@@ -64,6 +84,55 @@ public:
   std::size_t getAttemptOffset() const { return AttemptOffset; }
 };
 
+class UnalignedAtomicAccess : public std::runtime_error {
+  WebAssemblyMemory const *Site;
+  std::size_t AttemptOffset;
+
+public:
+  UnalignedAtomicAccess(
+      WebAssemblyMemory const &Site_, std::size_t AttemptOffset_)
+      : std::runtime_error("WebAssembly unaligned atomic memory access"),
+        Site(std::addressof(Site_)), AttemptOffset(AttemptOffset_) {}
+  WebAssemblyMemory const &getSite() const { return *Site; }
+  std::size_t getAttemptOffset() const { return AttemptOffset; }
+};
+
+class UnsharedMemoryWait : public std::runtime_error {
+  WebAssemblyMemory const *Site;
+
+public:
+  UnsharedMemoryWait(WebAssemblyMemory const &Site_)
+      : std::runtime_error("WebAssembly atomic wait on an unshared memory"),
+        Site(std::addressof(Site_)) {}
+  WebAssemblyMemory const &getSite() const { return *Site; }
+};
+
+class DataSegmentAccessOutOfBound : public std::runtime_error {
+  std::size_t AttemptOffset;
+  std::size_t AttemptSize;
+
+public:
+  DataSegmentAccessOutOfBound(
+      std::size_t AttemptOffset_, std::size_t AttemptSize_)
+      : std::runtime_error("WebAssembly data segment access out of bound"),
+        AttemptOffset(AttemptOffset_), AttemptSize(AttemptSize_) {}
+  std::size_t getAttemptOffset() const { return AttemptOffset; }
+  std::size_t getAttemptSize() const { return AttemptSize; }
+};
+
+class UnreservableMemory : public std::runtime_error {
+  std::uint64_t MaxNumPage;
+
+public:
+  explicit UnreservableMemory(std::uint64_t MaxNumPage_)
+      : std::runtime_error(
+            "WebAssembly memory64 maximum exceeds the 64 GiB in place "
+            "reservation, the module must be compiled without "
+            "--codegen-guard-page or --codegen-reserve-memory"),
+        MaxNumPage(MaxNumPage_) {}
+  std::uint64_t getMaxNumPage() const { return MaxNumPage; }
+};
+
 class TableAccessOutOfBound : public std::runtime_error {
   WebAssemblyTable const *Site;
   std::uint32_t AttemptIndex;
@@ -110,6 +179,17 @@ public:
   bytecode::ValueType const &getAttemptType() const { return AttemptType; }
 };
 
+class InstancePoolExhausted : public std::runtime_error {
+public:
+  InstancePoolExhausted()
+      : std::runtime_error("no free slot in WebAssembly instance pool") {}
+};
+
+class MalformedSnapshot : public std::runtime_error {
+public:
+  MalformedSnapshot(char const *What) : std::runtime_error(What) {}
+};
+
 class BadTableEntry : public std::runtime_error {
   WebAssemblyTable const *Site;
   std::uint32_t AttemptIndex;
@@ -121,6 +201,19 @@ public:
   WebAssemblyTable const &getSite() const { return *Site; }
   std::uint32_t getAttemptIndex() const { return AttemptIndex; }
 };
+
+// a call of a batch failed, the results of the calls before Index are valid
+// and the original exception is nested
+class BatchInterrupted : public std::runtime_error,
+                         public std::nested_exception {
+  std::size_t Index;
+
+public:
+  BatchInterrupted(std::size_t Index_)
+      : std::runtime_error("WebAssembly batch invocation interrupted"),
+        Index(Index_) {}
+  std::size_t getIndex() const { return Index; }
+};
 } // namespace exceptions
 
 namespace detail {
@@ -148,6 +241,12 @@ char toSignature(bytecode::ValueType const &Type);
 char toSignature(bytecode::GlobalType const &Type);
 std::string toSignature(bytecode::FunctionType const &Type);
 
+// Process-wide signature interning, equal signatures always map to the same
+// ID hence type checks are plain integer comparisons. ID 0 is reserved for
+// the empty signature of null table entries.
+std::uint32_t toSignatureID(std::string_view Signature);
+std::string_view fromSignatureID(std::uint32_t SignatureID);
+
 template <typename T> constexpr char signature_();
 template <> constexpr char signature_<std::int32_t>() { return 'I'; }
 template <> constexpr char signature_<std::uint32_t>() { return 'I'; }
@@ -156,38 +255,206 @@ template <> constexpr char signature_<std::uint64_t>() { return 'J'; }
 template <> constexpr char signature_<float>() { return 'F'; }
 template <> constexpr char signature_<double>() { return 'D'; }
 
+// multi-value results are spelled as std::tuple<ResultTypes...>
+template <typename T> struct multi_value_result : std::false_type {
+  static constexpr auto Signature = [] {
+    if constexpr (std::is_same_v<T, void>) {
+      return std::array<char, 0>{};
+    } else {
+      return std::array<char, 1>{signature_<T>()};
+    }
+  }();
+};
+template <typename... ResultTypes>
+struct multi_value_result<std::tuple<ResultTypes...>> : std::true_type {
+  static_assert(sizeof...(ResultTypes) > 1);
+  static constexpr std::array<char, sizeof...(ResultTypes)> Signature{
+      signature_<ResultTypes>()...};
+};
+template <typename T>
+inline constexpr bool is_multi_value_result_v = multi_value_result<T>::value;
+
+// signatures of host types are spelled at compile time and null terminated,
+// checking them against a callee never allocates
 template <typename RetType, typename... ArgTypes>
-inline std::string signature() {
-  std::string TypeStr;
-  std::array<char, sizeof...(ArgTypes)> ParamTypes{signature_<ArgTypes>()...};
-  TypeStr.append(ParamTypes.begin(), ParamTypes.end());
-  TypeStr.push_back(':');
-  if constexpr (!std::is_same_v<RetType, void>) {
-    char ReturnType = signature_<RetType>();
-    TypeStr.push_back(ReturnType);
-  }
+inline constexpr auto signature_v = [] {
+  using ResultSignature = multi_value_result<RetType>;
+  constexpr auto NumResults = ResultSignature::Signature.size();
+  std::array<char, sizeof...(ArgTypes) + NumResults + 2> TypeStr{};
+  std::size_t Pos = 0;
+  ((TypeStr[Pos++] = signature_<ArgTypes>()), ...);
+  TypeStr[Pos++] = ':';
+  for (auto Result : ResultSignature::Signature) TypeStr[Pos++] = Result;
   return TypeStr;
+}();
+
+template <typename RetType, typename... ArgTypes>
+constexpr std::string_view signature() {
+  auto const &TypeStr = signature_v<RetType, ArgTypes...>;
+  return std::string_view(TypeStr.data(), TypeStr.size() - 1);
+}
+
+// Must agree with EntityLayout::ResultABI. Up to MaxNumRegisterResults scalar
+// results come back as integer registers, each holding the bits of a result,
+// more results are stored at their natural alignment through a trailing
+// pointer argument.
+inline constexpr std::size_t MaxNumRegisterResults = 2;
+struct RegisterResults {
+  std::uint64_t Members[MaxNumRegisterResults];
+};
+
+template <typename T> T decodeRegisterResult(std::uint64_t Encoded) {
+  if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+    return std::bit_cast<T>(static_cast<std::uint32_t>(Encoded));
+  } else {
+    return std::bit_cast<T>(Encoded);
+  }
+}
+
+template <typename... ResultTypes, typename... ArgTypes>
+std::tuple<ResultTypes...> invokeMultiValue(
+    std::tuple<ResultTypes...> *, __sable_instance_t *ContextPtr,
+    __sable_function_t *FunctionPtr, ArgTypes... Args) {
+  if constexpr (sizeof...(ResultTypes) <= MaxNumRegisterResults) {
+    using FunctionTy = RegisterResults (*)(__sable_instance_t *, ArgTypes...);
+    auto *CastedPtr = reinterpret_cast<FunctionTy>(FunctionPtr);
+    auto Encoded = CastedPtr(ContextPtr, Args...);
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      return std::tuple<ResultTypes...>(
+          decodeRegisterResult<ResultTypes>(Encoded.Members[Is])...);
+    }(std::index_sequence_for<ResultTypes...>());
+  } else {
+    using FunctionTy = void (*)(__sable_instance_t *, ArgTypes..., void *);
+    auto *CastedPtr = reinterpret_cast<FunctionTy>(FunctionPtr);
+    alignas(std::uint64_t) std::byte Buffer[sizeof...(ResultTypes) * 8];
+    CastedPtr(ContextPtr, Args..., Buffer);
+    std::tuple<ResultTypes...> Results;
+    std::size_t Offset = 0;
+    auto Load = [&]<typename T>(T &Result) {
+      Offset = (Offset + alignof(T) - 1) / alignof(T) * alignof(T);
+      std::memcpy(std::addressof(Result), Buffer + Offset, sizeof(T));
+      Offset = Offset + sizeof(T);
+    };
+    std::apply([&](auto &...Members) { (Load(Members), ...); }, Results);
+    return Results;
+  }
+}
+
+// callers are responsible for checking the signature of FunctionPtr
+template <typename RetType, typename... ArgTypes>
+RetType invokeUnchecked(
+    __sable_instance_t *ContextPtr, __sable_function_t *FunctionPtr,
+    ArgTypes... Args) {
+  if constexpr (is_multi_value_result_v<RetType>) {
+    return invokeMultiValue(
+        static_cast<RetType *>(nullptr), ContextPtr, FunctionPtr, Args...);
+  } else {
+    using FunctionTy = RetType (*)(__sable_instance_t *, ArgTypes...);
+    auto *CastedPtr = reinterpret_cast<FunctionTy>(FunctionPtr);
+    return CastedPtr(ContextPtr, Args...);
+  }
 }
 } // namespace detail
 
+// clang-format off
+enum class MemoryReservationKind : std::uint32_t {
+  Exact     = 0, // reserve exactly the current size, remap on grow
+  GuardPage = 1, // reserve the whole 32-bit space plus a trailing guard region
+  Reserved  = 2  // reserve the maximum size (capped), commit on grow
+};
+
+enum class MemoryPagePolicy : std::uint32_t {
+  Native              = 0, // native pages only
+  TransparentHugePage = 1, // huge page aligned data, madvise(MADV_HUGEPAGE)
+  HugeTLB             = 2  // hugetlbfs backed data, Reserved memories only
+};
+
+enum class MemoryCommitPolicy : std::uint32_t {
+  Accounted = 0, // exact reservations are charged to the overcommit limit
+  Lazy      = 1  // nothing is charged, pages are allocated on first touch
+};
+// clang-format on
+
+// Configuration of a memory instance besides its initial size, the defaults
+// describe an unshared 32-bit memory without maximum, exactly reserved.
+struct MemoryOptions {
+  std::uint64_t MaxNumPage = std::numeric_limits<std::uint64_t>::max();
+  MemoryReservationKind Reservation = MemoryReservationKind::Exact;
+  // HugeTLB falls back to TransparentHugePage for reservations other than
+  // Reserved, or if the hugetlbfs pool cannot hold the whole reservation
+  MemoryPagePolicy PagePolicy = MemoryPagePolicy::Native;
+  // in place reservations are never charged, whatever the commit policy
+  MemoryCommitPolicy CommitPolicy = MemoryCommitPolicy::Accounted;
+  // shared memories are never moved, Exact is promoted to Reserved
+  bool IsShared = false;
+  // 64-bit memories grow past 4 GiB, in place reservations hold at most
+  // 64 GiB and guard page ones take a 4 GiB guard region past that, a larger
+  // declared maximum throws UnreservableMemory
+  bool IsMemory64 = false;
+};
+
+// Residency is only sampled by getStats, hence the peak is the highest
+// ResidentBytes sampled since creation or the last pool reset. Pages touched
+// and released between two samples are never seen.
+struct MemoryStats {
+  std::size_t ReservedBytes;            // address space, metadata excluded
+  std::size_t CommittedBytes;           // accessible bytes
+  std::size_t ResidentBytes;            // pages touched and still resident
+  std::size_t SampledPeakResidentBytes; // highest ResidentBytes sampled
+};
+
 class WebAssemblyMemory {
   friend class WebAssemblyInstance;
   friend class WebAssemblyInstanceBuilder;
+  friend class WebAssemblyInstancePool;
+  friend class WebAssemblyModule;
+  friend class WebAssemblySnapshot;
   struct MemoryMetadata;
   std::byte *Memory;
 
   MemoryMetadata &getMetadata();
   MemoryMetadata const &getMetadata() const;
 
-  void addUseSite(WebAssemblyInstance &Instance);
-  void removeUseSite(WebAssemblyInstance &Instance);
-
-  static constexpr std::uint32_t NO_MAXIMUM =
-      std::numeric_limits<std::uint32_t>::max();
+  // instance storage slots of the memory and of its cached size, set when
+  // added and rewritten on grow, reservations other than Exact never move
+  // the memory
+  struct UseSite {
+    __sable_memory_t **MemorySlot;
+    std::size_t *SizeSlot;
+  };
+  void addUseSite(__sable_memory_t *&MemorySlot, std::size_t &SizeSlot);
+  void removeUseSite(__sable_memory_t *&MemorySlot);
+
+  // zero the memory, a mapped image is replaced by anonymous pages
+  void clear();
+  // zero the content and shrink back to NumPage
+  void reset(std::uint64_t NumPage);
+  // map a memory image copy-on-write at Offset, in place reservations only,
+  // the rest of the memory is zeroed, ImageID identifies the content of the
+  // file process-wide
+  void mapImage(
+      int FileDescriptor, std::uint64_t ImageID, std::size_t Offset,
+      std::size_t Size);
+  // grow to NumPage and take the content of the file, mapped if possible
+  void
+  restore(std::uint64_t NumPage, int FileDescriptor, std::uint64_t ImageID);
+  // images are mapped at WebAssembly page granularity
+  bool canMapImage() const;
+  std::size_t getResidentSize() const;
+  // indices of the pages that may hold non-zero bytes, found without faulting
+  // any page in
+  std::vector<std::uint64_t> getPopulatedPages() const;
+  // only faults raised by the code of a loaded module library are turned
+  // into traps, any other goes to the previously installed handler
+  static void registerModuleCode(void *DLHandler);
+  static void unregisterModuleCode(void *DLHandler);
+
+  static constexpr std::uint64_t NO_MAXIMUM =
+      std::numeric_limits<std::uint64_t>::max();
 
 public:
-  explicit WebAssemblyMemory(std::uint32_t NumPage);
-  WebAssemblyMemory(std::uint32_t NumPage, std::uint32_t MaxNumPage);
+  explicit WebAssemblyMemory(
+      std::uint64_t NumPage, MemoryOptions const &Options = MemoryOptions());
   WebAssemblyMemory(WebAssemblyMemory const &) = delete;
   WebAssemblyMemory(WebAssemblyMemory &&) noexcept = delete;
   WebAssemblyMemory &operator=(WebAssemblyMemory const &) = delete;
@@ -195,14 +462,31 @@ public:
   ~WebAssemblyMemory() noexcept;
 
   bool hasMaxSize() const;
-  std::uint32_t getMaxSize() const;
-  std::uint32_t getSize() const;
+  std::uint64_t getMaxSize() const;
+  std::uint64_t getSize() const;
   std::size_t getSizeInBytes() const;
+  // address space of in place reservations, trailing guard region included
+  std::size_t getReservedSize() const;
+  MemoryReservationKind getReservationKind() const;
+  MemoryPagePolicy getPagePolicy() const; // the policy actually in effect
+  MemoryCommitPolicy getCommitPolicy() const;
+  bool isShared() const;
+  bool isMemory64() const;
+  // samples the resident pages, which also updates the sampled peak
+  MemoryStats getStats();
 
   std::byte *data();
   std::byte const *data() const;
 
-  std::uint32_t grow(std::uint32_t DeltaNumPage);
+  std::uint64_t grow(std::uint64_t DeltaNumPage);
+
+  // memory.atomic.wait and memory.atomic.notify, a negative timeout waits
+  // forever, wait returns 0 (woken), 1 (not equal) or 2 (timed out)
+  std::uint32_t
+  wait(std::size_t Offset, std::uint32_t Expect, std::int64_t Timeout);
+  std::uint32_t
+  wait(std::size_t Offset, std::uint64_t Expect, std::int64_t Timeout);
+  std::uint32_t notify(std::size_t Offset, std::uint32_t Count);
 
   std::byte &operator[](std::size_t Offset);
   std::byte const &operator[](std::size_t Offset) const;
@@ -213,13 +497,17 @@ public:
 
   static std::size_t getWebAssemblyPageSize();
   static std::size_t getNativePageSize();
+  static std::size_t getGuardPageReservationSize();
+  static std::size_t getHugePageSize();
 
   __sable_memory_t *asInstancePtr();
   static WebAssemblyMemory *fromInstancePtr(__sable_memory_t *InstancePtr);
-  static std::uint32_t const GrowFailed;
+  static std::uint64_t const GrowFailed;
 };
 
 class WebAssemblyGlobal {
+  friend class WebAssemblyInstancePool;
+  friend class WebAssemblySnapshot;
   union {
     std::int32_t I32;
     std::int64_t I64;
@@ -228,6 +516,8 @@ class WebAssemblyGlobal {
   } Storage;
   bytecode::ValueType ValueType;
 
+  void reset();
+
 public:
   explicit WebAssemblyGlobal(bytecode::ValueType Type_);
   WebAssemblyGlobal(WebAssemblyGlobal const &) = delete;
@@ -251,30 +541,39 @@ public:
 };
 
 class WebAssemblyTable {
-  std::uint32_t Size;
-  std::uint32_t MaxSize;
-
   struct TableEntry {
     __sable_instance_t *ContextPtr;
     __sable_function_t *FunctionPtr;
-    std::string Signature;
+    std::uint32_t SignatureID;
   };
+
+  // Flat layout read by generated code for call_indirect, Entries and Size
+  // must stay the leading members:
+  //   struct { __sable_table_entry_t *Entries; std::uint32_t Size; }
+  //   struct __sable_table_entry_t {
+  //     __sable_instance_t *ContextPtr; // nullptr for host functions
+  //     __sable_function_t *FunctionPtr;
+  //     std::uint32_t SignatureID;      // 0 for null entries
+  //   }
+  TableEntry *Entries;
+  std::uint32_t Size;
+  std::uint32_t MaxSize;
   std::vector<TableEntry> Storage;
 
   // clang-format off
   friend void ::__sable_table_guard(__sable_table_t *, std::uint32_t);
-  friend void ::__sable_table_check(__sable_table_t *, std::uint32_t, char const *);
-  friend __sable_instance_t * ::__sable_table_context(__sable_table_t *, std::uint32_t);
-  friend __sable_function_t * ::__sable_table_function(__sable_table_t *, std::uint32_t);
+  friend void ::__sable_table_check(__sable_table_t *, std::uint32_t, std::uint32_t);
   friend void ::__sable_table_set(__sable_table_t *, __sable_instance_t *, std::uint32_t, std::uint32_t, std::uint32_t *);
   // clang-format on
 
+  friend class WebAssemblyInstancePool;
+  friend class WebAssemblySnapshot;
+
   void
   set(std::uint32_t, __sable_instance_t *ContextPtr,
       __sable_function_t *FunctionPtr, std::string_view Signature);
-  __sable_instance_t *getContextPtr(std::uint32_t) const;
-  __sable_function_t *getFunctionPtr(std::uint32_t) const;
   std::string_view getSignature(std::uint32_t) const;
+  void reset();
 
   static constexpr std::uint32_t NO_MAXIMUM =
       std::numeric_limits<std::uint32_t>::max();
@@ -301,6 +600,7 @@ public:
   void
   set(std::uint32_t Index,
       RetType (*FunctionPtr)(__sable_instance_t *, ArgTypes...)) {
+    static_assert(!detail::is_multi_value_result_v<RetType>);
     auto Signature = detail::signature<RetType, ArgTypes...>();
     auto *TypeErasedPtr = reinterpret_cast<__sable_function_t *>(FunctionPtr);
     set(Index, nullptr, TypeErasedPtr, Signature);
@@ -312,8 +612,244 @@ public:
   static WebAssemblyTable *fromInstancePtr(__sable_table_t *InstancePtr);
 };
 
+// Entity index of an export of a module, resolved once by name and valid for
+// all instances of the module, T is the kind of the exported entity
+template <typename T> class ExportIndex {
+  friend class WebAssemblyModule;
+  friend class WebAssemblyInstance;
+  std::uint32_t Index;
+  explicit ExportIndex(std::uint32_t Index_) : Index(Index_) {}
+
+public:
+  std::uint32_t getEntityIndex() const { return Index; }
+};
+
+// A loaded sable shared library. The library is opened and its metadata is
+// resolved once, any number of instances can then be built from it. Instances
+// share the ownership hence the library stays loaded as long as one is alive.
+class WebAssemblyModule {
+  friend class WebAssemblyInstance;
+  friend class WebAssemblyInstanceBuilder;
+  friend class WebAssemblyImportResolver;
+  friend class WebAssemblyInstancePool;
+  friend class WebAssemblySnapshot;
+  void *DLHandler = nullptr;
+
+  struct ImportDescriptor;
+  struct ExportDescriptor;
+  struct MemoryMetadata;    // __sable_memory_metadata_t
+  struct TableMetadata;     // __sable_table_metadata_t
+  struct GlobalMetadata;    // __sable_global_metadata_t
+  struct FunctionMetadata;  // __sable_function_metadata_t
+  struct SignatureMetadata; // __sable_signature_metadata_t
+  struct ImageMetadata;     // __sable_memory_image_metadata_t
+  struct DataMetadata;      // __sable_data_metadata_t
+
+  MemoryMetadata *Memories = nullptr;
+  TableMetadata *Tables = nullptr;
+  GlobalMetadata *Globals = nullptr;
+  FunctionMetadata *Functions = nullptr;
+  DataMetadata *DataSegments = nullptr;
+  using InitializerFnTy = void (*)(void *);
+  InitializerFnTy MemoryInitializer = nullptr;
+  InitializerFnTy Initializer = nullptr;
+  std::size_t StorageSize = 0; // number of slots of __sable_instance_t
+
+  // Initial content of the data segments of a defined memory, kept in an
+  // anonymous file so that instances share its clean pages
+  struct MemoryImage {
+    std::size_t Offset = 0;
+    std::size_t Size = 0; // rounded up to WebAssembly pages
+    std::span<std::byte const> Content;
+    int FileDescriptor = -1; // -1 if the content has to be copied
+    std::uint64_t ImageID = 0;
+  };
+  std::vector<MemoryImage> MemoryImages; // indexed by memory index
+
+  WebAssemblyModule() = default;
+
+  // create the Index-th defined entity with its declared limits
+  WebAssemblyMemory *createMemory(
+      std::size_t Index, MemoryPagePolicy PagePolicy,
+      MemoryCommitPolicy CommitPolicy) const;
+  WebAssemblyTable *createTable(std::size_t Index) const;
+  WebAssemblyGlobal *createGlobal(std::size_t Index) const;
+  void initializeMemory(std::size_t Index, WebAssemblyMemory &Memory) const;
+
+  // import descriptors are sorted by module name then entity name, hence the
+  // imports of a name form a contiguous range
+  static std::span<ImportDescriptor const> findImports(
+      std::span<ImportDescriptor const> Imports, std::string_view ModuleName);
+  static std::span<ImportDescriptor const> findImports(
+      std::span<ImportDescriptor const> Imports, std::string_view ModuleName,
+      std::string_view EntityName);
+  // export descriptors are sorted by name
+  static ExportDescriptor const *findExport(
+      std::span<ExportDescriptor const> Exports, std::string_view Name);
+
+public:
+  WebAssemblyModule(WebAssemblyModule const &) = delete;
+  WebAssemblyModule(WebAssemblyModule &&) noexcept = delete;
+  WebAssemblyModule &operator=(WebAssemblyModule const &) = delete;
+  WebAssemblyModule &operator=(WebAssemblyModule &&) noexcept = delete;
+  ~WebAssemblyModule() noexcept;
+
+  static std::shared_ptr<WebAssemblyModule>
+  load(std::filesystem::path const &Path);
+
+  // create a memory matching the memory import ModuleName.EntityName, with
+  // its minimum size and declared sharing, nullptr if there is no such import
+  std::unique_ptr<WebAssemblyMemory> createImportMemory(
+      std::string_view ModuleName, std::string_view EntityName,
+      MemoryPagePolicy PagePolicy = MemoryPagePolicy::Native,
+      MemoryCommitPolicy CommitPolicy = MemoryCommitPolicy::Accounted) const;
+
+  // exports are looked up in the metadata of the library, the index may be
+  // used on every instance of this module
+  std::optional<ExportIndex<WebAssemblyMemory>>
+  findExportedMemory(std::string_view Name) const;
+  std::optional<ExportIndex<WebAssemblyTable>>
+  findExportedTable(std::string_view Name) const;
+  std::optional<ExportIndex<WebAssemblyGlobal>>
+  findExportedGlobal(std::string_view Name) const;
+  std::optional<ExportIndex<WebAssemblyCallee>>
+  findExportedFunction(std::string_view Name) const;
+};
+
+// Function imports of a module resolved against whole host namespaces. Each
+// namespace is merged with the sorted imports of the module in one pass, the
+// resolution is then copied into every instance built with the resolver.
+class WebAssemblyImportResolver {
+  friend class WebAssemblyInstanceBuilder;
+  std::shared_ptr<WebAssemblyModule> Module;
+  // by function index, null function pointers for unresolved imports
+  std::vector<__sable_instance_t *> ContextPtrs;
+  std::vector<__sable_function_t *> FunctionPtrs;
+
+public:
+  struct HostFunction {
+    std::string_view EntityName;
+    std::string_view Signature;
+    __sable_instance_t *ContextPtr;
+    __sable_function_t *FunctionPtr;
+  };
+
+  template <typename RetType, typename... ArgTypes>
+  static HostFunction define(
+      std::string_view EntityName,
+      RetType (*FunctionPtr)(__sable_instance_t *, ArgTypes...)) {
+    static_assert(!detail::is_multi_value_result_v<RetType>);
+    auto Signature = detail::signature<RetType, ArgTypes...>();
+    auto *TypeErasedPtr = reinterpret_cast<__sable_function_t *>(FunctionPtr);
+    return HostFunction{EntityName, Signature, nullptr, TypeErasedPtr};
+  }
+
+  explicit WebAssemblyImportResolver(
+      std::shared_ptr<WebAssemblyModule> Module_);
+
+  // bind the imports from ModuleName to the functions of Namespace with the
+  // same name and signature, returns the number of imports bound
+  std::size_t
+  resolve(std::string_view ModuleName, std::span<HostFunction const> Namespace);
+  bool isResolved() const;
+};
+
+// Pre-allocated instance slots of a module. A slot keeps the instance storage
+// and the defined memories, tables and globals across instances. Released
+// slots are reset in place, memories drop their pages with madvise instead of
+// being unmapped, hence instantiation and teardown stay away from the kernel
+// mapping machinery unless a memory has grown or had an image mapped, whose
+// pages are replaced by anonymous ones. The pool must outlive the instances
+// built from it.
+class WebAssemblyInstancePool {
+  friend class WebAssemblyInstance;
+  friend class WebAssemblyInstanceBuilder;
+  struct InstanceSlot {
+    void **Storage; // __sable_instance_t, including the leading back pointer
+    std::vector<WebAssemblyMemory *> Memories;
+    std::vector<WebAssemblyTable *> Tables;
+    std::vector<WebAssemblyGlobal *> Globals;
+  };
+
+  std::shared_ptr<WebAssemblyModule> Module;
+  std::vector<InstanceSlot> Slots;
+  std::vector<InstanceSlot *> FreeSlots;
+  mutable std::mutex Mutex;
+
+  InstanceSlot *acquire();
+  void release(InstanceSlot &Slot);
+
+public:
+  WebAssemblyInstancePool(
+      std::shared_ptr<WebAssemblyModule> Module_, std::size_t NumSlots,
+      MemoryPagePolicy PagePolicy = MemoryPagePolicy::Native,
+      MemoryCommitPolicy CommitPolicy = MemoryCommitPolicy::Accounted);
+  WebAssemblyInstancePool(WebAssemblyInstancePool const &) = delete;
+  WebAssemblyInstancePool(WebAssemblyInstancePool &&) noexcept = delete;
+  WebAssemblyInstancePool &operator=(WebAssemblyInstancePool const &) = delete;
+  WebAssemblyInstancePool &
+  operator=(WebAssemblyInstancePool &&) noexcept = delete;
+  ~WebAssemblyInstancePool() noexcept;
+
+  WebAssemblyModule &getModule();
+  std::size_t getNumSlots() const;
+  std::size_t getNumFreeSlots() const;
+};
+
+// State of the defined memories, tables and globals of an instance, usually
+// captured once the guest initialization has run. Instances restored from a
+// snapshot skip the data segments and start from the captured state, memory
+// content is mapped copy-on-write for guard page reservations.
+// Table entries are kept as function indices, hence a snapshot only holds
+// functions reachable through the function index space of the module.
+class WebAssemblySnapshot {
+  friend class WebAssemblyInstance;
+  friend class WebAssemblyInstanceBuilder;
+  struct MemorySnapshot {
+    std::uint64_t NumPage = 0;
+    std::vector<std::uint32_t> DataPages; // pages that are not all zero
+    int FileDescriptor = -1;              // sparse file of NumPage pages
+    std::uint64_t ImageID = 0;
+  };
+
+  std::shared_ptr<WebAssemblyModule> Module;
+  std::vector<MemorySnapshot> Memories;           // defined memories only
+  std::vector<std::vector<std::uint32_t>> Tables; // defined tables only
+  std::vector<std::uint64_t> Globals;             // defined globals only
+  std::vector<std::uint64_t> DataSizes;           // zero once dropped
+
+  static constexpr std::uint32_t NullEntry =
+      std::numeric_limits<std::uint32_t>::max();
+
+  WebAssemblySnapshot() = default;
+
+  static std::shared_ptr<WebAssemblySnapshot>
+  capture(WebAssemblyInstance &Instance);
+  void restore(std::size_t Index, WebAssemblyMemory &Memory) const;
+  void restore(WebAssemblyInstance &Instance) const;
+
+public:
+  WebAssemblySnapshot(WebAssemblySnapshot const &) = delete;
+  WebAssemblySnapshot(WebAssemblySnapshot &&) noexcept = delete;
+  WebAssemblySnapshot &operator=(WebAssemblySnapshot const &) = delete;
+  WebAssemblySnapshot &operator=(WebAssemblySnapshot &&) noexcept = delete;
+  ~WebAssemblySnapshot() noexcept;
+
+  WebAssemblyModule &getModule();
+
+  void save(std::filesystem::path const &Path) const;
+  static std::shared_ptr<WebAssemblySnapshot> load(
+      std::shared_ptr<WebAssemblyModule> Module,
+      std::filesystem::path const &Path);
+};
+
 class WebAssemblyInstanceBuilder {
   std::unique_ptr<WebAssemblyInstance> Instance;
+  std::shared_ptr<WebAssemblySnapshot const> Snapshot;
+  MemoryPagePolicy PagePolicy = MemoryPagePolicy::Native;
+  MemoryCommitPolicy CommitPolicy = MemoryCommitPolicy::Accounted;
+
+  void setup(std::shared_ptr<WebAssemblyModule> Module, void **Storage);
 
   WebAssemblyInstanceBuilder &import(
       std::string_view ModuleName, std::string_view EntityName,
@@ -325,6 +861,13 @@ class WebAssemblyInstanceBuilder {
 
 public:
   explicit WebAssemblyInstanceBuilder(std::filesystem::path const &Path);
+  explicit WebAssemblyInstanceBuilder(
+      std::shared_ptr<WebAssemblyModule> Module);
+  // throws InstancePoolExhausted if every slot is in use
+  explicit WebAssemblyInstanceBuilder(WebAssemblyInstancePool &Pool);
+  // another instance of the module of Parent bound to the same imports and
+  // host data, as each thread of a threaded module runs its own instance
+  explicit WebAssemblyInstanceBuilder(WebAssemblyInstance &Parent);
   WebAssemblyInstanceBuilder(WebAssemblyInstanceBuilder const &) = delete;
   WebAssemblyInstanceBuilder(WebAssemblyInstanceBuilder &&) noexcept = delete;
   WebAssemblyInstanceBuilder &
@@ -345,11 +888,15 @@ public:
   WebAssemblyInstanceBuilder &import(
       std::string_view ModuleName, std::string_view EntityName,
       WebAssemblyCallee Callee);
+  // every function import bound by Resolver, which must be built from the
+  // module of this instance
+  WebAssemblyInstanceBuilder &import(WebAssemblyImportResolver const &Resolver);
 
   template <typename RetType, typename... ArgTypes>
   WebAssemblyInstanceBuilder &import(
       std::string_view ModuleName, std::string_view EntityName,
       RetType (*FunctionPtr)(__sable_instance_t *, ArgTypes...)) {
+    static_assert(!detail::is_multi_value_result_v<RetType>);
     auto Signature = detail::signature<RetType, ArgTypes...>();
     auto TypeErasedPtr = reinterpret_cast<std::intptr_t>(FunctionPtr);
     return import(ModuleName, EntityName, Signature, TypeErasedPtr);
@@ -372,54 +919,56 @@ public:
   bool tryImport(
       std::string_view ModuleName, std::string_view EntityName,
       RetType (*FunctionPtr)(__sable_instance_t *, ArgTypes...)) {
+    static_assert(!detail::is_multi_value_result_v<RetType>);
     auto Signature = detail::signature<RetType, ArgTypes...>();
     auto TypeErasedPtr = reinterpret_cast<std::intptr_t>(FunctionPtr);
     return tryImport(ModuleName, EntityName, Signature, TypeErasedPtr);
   }
 
+  // start from a snapshot taken on the same module instead of running the
+  // data segment initialization
+  WebAssemblyInstanceBuilder &
+  restore(std::shared_ptr<WebAssemblySnapshot const> Snapshot_);
+
+  // page and commit policies of the defined memories, pooled instances take
+  // the policies of their pool instead
+  WebAssemblyInstanceBuilder &setMemoryPagePolicy(MemoryPagePolicy PagePolicy_);
+  WebAssemblyInstanceBuilder &
+  setMemoryCommitPolicy(MemoryCommitPolicy CommitPolicy_);
+
   std::unique_ptr<WebAssemblyInstance> Build();
 };
 
 class WebAssemblyInstance {
   friend class WebAssemblyInstanceBuilder;
-  friend class WebAssemblyMemory;
+  friend class WebAssemblySnapshot;
   void **Storage = nullptr; // __sable_instance_t
-  void *DLHandler = nullptr;
-
-  // Exports:
-  struct FunctionEntry {
-    __sable_instance_t *ContextPtr;
-    __sable_function_t *FunctionPtr;
-    char const *Signature;
-  };
-  std::unordered_map<std::string_view, __sable_memory_t *> ExportedMemories;
-  std::unordered_map<std::string_view, __sable_table_t *> ExportedTables;
-  std::unordered_map<std::string_view, __sable_global_t *> ExportedGlobals;
-  std::unordered_map<std::string_view, FunctionEntry> ExportedFunctions;
-
-  struct ImportDescriptor;
-  struct ExportDescriptor;
-  struct MemoryMetadata;   // __sable_memory_metadata_t
-  struct TableMetadata;    // __sable_table_metadata_t
-  struct GlobalMetadata;   // __sable_global_metadata_t
-  struct FunctionMetadata; // __sable_function_metadata_t
-
-  MemoryMetadata const &getMemoryMetadata() const;
-  TableMetadata const &getTableMetadata() const;
-  GlobalMetadata const &getGlobalMetadata() const;
-  FunctionMetadata const &getFunctionMetadata() const;
+  std::shared_ptr<WebAssemblyModule> Module;
+  WebAssemblyInstancePool *Pool = nullptr;
+  WebAssemblyInstancePool::InstanceSlot *Slot = nullptr;
+  // threads running child instances bound to the imports of this one, only
+  // the thread running this instance adds to it
+  std::vector<std::thread> Threads;
+  // state of the embedder the host functions act on, child instances share
+  // the one of their parent
+  std::shared_ptr<void> HostData;
+
+  WebAssemblyModule::MemoryMetadata const &getMemoryMetadata() const;
+  WebAssemblyModule::TableMetadata const &getTableMetadata() const;
+  WebAssemblyModule::GlobalMetadata const &getGlobalMetadata() const;
+  WebAssemblyModule::FunctionMetadata const &getFunctionMetadata() const;
 
   __sable_memory_t *&getMemory(std::size_t Index);
+  std::size_t &getMemorySize(std::size_t Index);
   __sable_table_t *&getTable(std::size_t Index);
   __sable_global_t *&getGlobal(std::size_t Index);
   __sable_instance_t *&getContextPtr(std::size_t Index);
   __sable_function_t *&getFunctionPtr(std::size_t Index);
+  std::size_t &getDataSize(std::size_t Index);
   char const *getSignature(std::size_t Index) const;
 
   WebAssemblyInstance() = default;
 
-  void replace(__sable_memory_t *Old, __sable_memory_t *New);
-
   // clang-format off
   friend void ::__sable_table_set(__sable_table_t *, __sable_instance_t *, std::uint32_t, std::uint32_t, std::uint32_t *);
   // clang-format on
@@ -441,6 +990,30 @@ public:
   WebAssemblyGlobal *tryGetGlobal(std::string_view Name);
   std::optional<WebAssemblyCallee> tryGetFunction(std::string_view Name);
 
+  // Index must come from the module of this instance
+  WebAssemblyMemory &getMemory(ExportIndex<WebAssemblyMemory> Index);
+  WebAssemblyTable &getTable(ExportIndex<WebAssemblyTable> Index);
+  WebAssemblyGlobal &getGlobal(ExportIndex<WebAssemblyGlobal> Index);
+  WebAssemblyCallee getFunction(ExportIndex<WebAssemblyCallee> Index);
+
+  WebAssemblyModule &getModule();
+  WebAssemblyModule const &getModule() const;
+
+  // takes over a thread running a child instance, see
+  // WebAssemblyInstanceBuilder(WebAssemblyInstance &), the destructor joins
+  // it before the imports the child shares may go away
+  void addThread(std::thread Thread);
+
+  // set before the instance runs, e.g. the WASI context of wasi::bind
+  void setHostData(std::shared_ptr<void> Data);
+  std::shared_ptr<void> const &getHostData() const;
+
+  std::shared_ptr<WebAssemblySnapshot> snapshot();
+  // invoke the export InitializerName, a function without parameter and
+  // result, then snapshot the initialized state
+  std::shared_ptr<WebAssemblySnapshot>
+  snapshot(std::string_view InitializerName);
+
   __sable_instance_t *asInstancePtr();
   static WebAssemblyInstance *fromInstancePtr(__sable_instance_t *InstancePtr);
 };
@@ -463,14 +1036,79 @@ public:
   __sable_instance_t *getContextPtr() const { return ContextPtr; }
   char const *getSignature() const { return Signature; }
 
+  // multi-value functions are invoked as invoke<std::tuple<Results...>>
   template <typename RetType, typename... ArgTypes>
   RetType invoke(ArgTypes... Args) const { // use copy instead of forward
-    using FunctionTy = RetType (*)(__sable_instance_t *, ArgTypes...);
     if (detail::signature<RetType, ArgTypes...>() != Signature) {
       throw std::runtime_error("type mismatch");
     }
-    auto *CastedPtr = reinterpret_cast<FunctionTy>(FunctionPtr);
-    return CastedPtr(ContextPtr, Args...);
+    return detail::invokeUnchecked<RetType, ArgTypes...>(
+        ContextPtr, FunctionPtr, Args...);
+  }
+};
+
+// A callee resolved and type checked once, for instance
+//   TypedFunc<std::int32_t(std::int32_t)> Filter(Instance.getFunction("f"));
+// then every call is a direct call through the function pointer. Handles
+// remain valid as long as the instance providing the function is alive.
+template <typename FunctionType> class TypedFunc;
+template <typename RetType, typename... ArgTypes>
+class TypedFunc<RetType(ArgTypes...)> {
+  __sable_instance_t *ContextPtr = nullptr;
+  __sable_function_t *FunctionPtr = nullptr;
+
+public:
+  TypedFunc() = default;
+  explicit TypedFunc(WebAssemblyCallee const &Callee)
+      : ContextPtr(Callee.getContextPtr()),
+        FunctionPtr(Callee.getFunctionPtr()) {
+    if (getSignature() != Callee.getSignature()) {
+      throw std::runtime_error("type mismatch");
+    }
+  }
+
+  static constexpr std::string_view getSignature() {
+    return detail::signature<RetType, ArgTypes...>();
+  }
+  __sable_function_t *getFunctionPtr() const { return FunctionPtr; }
+  __sable_instance_t *getContextPtr() const { return ContextPtr; }
+  bool isNull() const { return FunctionPtr == nullptr; }
+
+  RetType invoke(ArgTypes... Args) const {
+    return detail::invokeUnchecked<RetType, ArgTypes...>(
+        ContextPtr, FunctionPtr, Args...);
+  }
+  RetType operator()(ArgTypes... Args) const { return invoke(Args...); }
+
+  using ArgumentTuple = std::tuple<ArgTypes...>;
+
+  // Invokes the function on every argument tuple of Args in a tight loop
+  // inside a single try region, the result of Args[I] is stored to
+  // Results[I]. Results may not be shorter than Args.
+  void invokeBatch(
+      std::span<ArgumentTuple const> Args, std::span<RetType> Results) const
+    requires(!std::is_void_v<RetType>)
+  {
+    if (Results.size() < Args.size())
+      throw std::invalid_argument("not enough result slots");
+    std::size_t Index = 0;
+    try {
+      for (; Index < Args.size(); ++Index)
+        Results[Index] = std::apply(*this, Args[Index]);
+    } catch (...) {
+      throw exceptions::BatchInterrupted(Index);
+    }
+  }
+
+  void invokeBatch(std::span<ArgumentTuple const> Args) const
+    requires(std::is_void_v<RetType>)
+  {
+    std::size_t Index = 0;
+    try {
+      for (; Index < Args.size(); ++Index) std::apply(*this, Args[Index]);
+    } catch (...) {
+      throw exceptions::BatchInterrupted(Index);
+    }
   }
 };
 } // namespace runtime
@@ -1,42 +1,469 @@
 #include "WebAssemblyInstance.h"
 
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <link.h>
+#include <signal.h>
 #include <sys/mman.h>
+#include <ucontext.h>
 #include <unistd.h>
 
 #include <range/v3/algorithm/find.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <forward_list>
 #include <limits>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 extern "C" {
 std::uint32_t __sable_memory_size(__sable_memory_t *Memory) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  return static_cast<std::uint32_t>(MemoryInstance->getSize());
+}
+
+std::uint64_t __sable_memory_size64(__sable_memory_t *Memory) {
   auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
   return MemoryInstance->getSize();
 }
 
-void __sable_memory_guard(__sable_memory_t *Memory, std::uint32_t Offset) {
+void __sable_memory_guard(__sable_memory_t *Memory, std::size_t Offset) {
   auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
   if (!(Offset <= MemoryInstance->getSizeInBytes()))
     throw runtime::exceptions::MemoryAccessOutOfBound(*MemoryInstance, Offset);
 }
 
+void __sable_memory_trap(__sable_memory_t *Memory, std::size_t Offset) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  throw runtime::exceptions::MemoryAccessOutOfBound(*MemoryInstance, Offset);
+}
+
 std::uint32_t
 __sable_memory_grow(__sable_memory_t *Memory, std::uint32_t Delta) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  // 32-bit memories never exceed 65536 pages, GrowFailed truncates to -1
+  return static_cast<std::uint32_t>(MemoryInstance->grow(Delta));
+}
+
+std::uint64_t
+__sable_memory_grow64(__sable_memory_t *Memory, std::uint64_t Delta) {
   auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
   return MemoryInstance->grow(Delta);
 }
+
+void __sable_memory_unaligned_trap(
+    __sable_memory_t *Memory, std::size_t Offset) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  throw runtime::exceptions::UnalignedAtomicAccess(*MemoryInstance, Offset);
+}
+
+std::uint32_t __sable_memory_wait32(
+    __sable_memory_t *Memory, std::size_t Offset, std::uint32_t Expect,
+    std::int64_t Timeout) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  return MemoryInstance->wait(Offset, Expect, Timeout);
+}
+
+std::uint32_t __sable_memory_wait64(
+    __sable_memory_t *Memory, std::size_t Offset, std::uint64_t Expect,
+    std::int64_t Timeout) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  return MemoryInstance->wait(Offset, Expect, Timeout);
+}
+
+std::uint32_t __sable_memory_notify(
+    __sable_memory_t *Memory, std::size_t Offset, std::uint32_t Count) {
+  auto *MemoryInstance = runtime::WebAssemblyMemory::fromInstancePtr(Memory);
+  return MemoryInstance->notify(Offset, Count);
+}
 }
 
 namespace runtime {
 struct WebAssemblyMemory::MemoryMetadata {
-  std::uint32_t Size;      // In Unit of WebAssembly Pages
-  std::uint32_t Max;       // In Unit of WebAssembly Pages
+  std::uint64_t Size;      // In Unit of WebAssembly Pages
+  std::uint64_t Max;       // In Unit of WebAssembly Pages
   std::size_t SizeInBytes; // In Unit of Bytes
-  std::forward_list<WebAssemblyInstance *> *UseSites;
+  std::size_t ReservedSize; // In Unit of Bytes, in place reservations only
+  std::forward_list<UseSite> *UseSites;
   WebAssemblyMemory *Instance;
+  MemoryReservationKind Reservation;
+  MemoryPagePolicy PagePolicy;
+  MemoryCommitPolicy CommitPolicy;
+  std::size_t SampledPeakResidentBytes;
+  std::uint64_t ImageID;   // 0 if no memory image is mapped
+  std::size_t ImageOffset; // In Unit of Bytes, range mapped from the image
+  std::size_t ImageSize;   // In Unit of Bytes, 0 if no memory image is mapped
+  bool IsShared;
+  bool IsMemory64;
+  std::mutex *Mutex;       // serializes grow and use site updates
+};
+
+namespace {
+/* Guard page memories are registered here so that the fault handler can map
+ * a faulting address back to its memory instance. The handler may run at any
+ * time, hence the registry is a fixed array of atomic slots instead of a
+ * locked container. Each guard page memory reserves at least 8 GiB of address
+ * space, which bounds the number of live guard page memories well below the
+ * limit.
+ */
+constexpr std::size_t MaxNumGuardPageMemories = 16384;
+std::array<std::atomic<WebAssemblyMemory *>, MaxNumGuardPageMemories>
+    GuardPageMemories;
+
+/* Executable segments of the loaded module libraries. Only a fault raised by
+ * generated code is a failed guarded access, any other fault is left to the
+ * previous handler. A slot is claimed by setting Begin and released by
+ * clearing End first, a slot in between covers no address.
+ */
+struct CodeRange {
+  std::atomic<std::uintptr_t> Begin;
+  std::atomic<std::uintptr_t> End;
+};
+constexpr std::size_t MaxNumCodeRanges = 4096;
+std::array<CodeRange, MaxNumCodeRanges> CodeRanges;
+
+using SegmentBounds = std::pair<std::uintptr_t, std::uintptr_t>;
+
+std::vector<SegmentBounds> getExecutableSegments(void *DLHandler) {
+  struct link_map *LinkMap = nullptr;
+  if (dlinfo(DLHandler, RTLD_DI_LINKMAP, &LinkMap) != 0) return {};
+  struct SearchContext {
+    ElfW(Addr) LoadAddress;
+    std::vector<SegmentBounds> Segments;
+  } Context{.LoadAddress = LinkMap->l_addr, .Segments = {}};
+  auto Visit = [](dl_phdr_info *Info, std::size_t, void *Data) {
+    auto &Context = *reinterpret_cast<SearchContext *>(Data);
+    if (Info->dlpi_addr != Context.LoadAddress) return 0;
+    for (ElfW(Half) I = 0; I < Info->dlpi_phnum; ++I) {
+      auto const &Header = Info->dlpi_phdr[I];
+      if ((Header.p_type != PT_LOAD) || !(Header.p_flags & PF_X)) continue;
+      auto Begin =
+          static_cast<std::uintptr_t>(Info->dlpi_addr + Header.p_vaddr);
+      Context.Segments.emplace_back(Begin, Begin + Header.p_memsz);
+    }
+    return 1;
+  };
+  dl_iterate_phdr(Visit, std::addressof(Context));
+  return std::move(Context.Segments);
+}
+
+bool isModuleCode(std::uintptr_t Address) {
+  for (auto const &Range : CodeRanges) {
+    auto Begin = Range.Begin.load(std::memory_order_acquire);
+    if (Begin == 0) continue;
+    auto End = Range.End.load(std::memory_order_acquire);
+    if ((Begin <= Address) && (Address < End)) return true;
+  }
+  return false;
+}
+
+std::uintptr_t getFaultingPC(void *SignalContext) {
+  auto *Context = reinterpret_cast<ucontext_t *>(SignalContext);
+#if defined(__x86_64__)
+  return static_cast<std::uintptr_t>(Context->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return Context->uc_mcontext.pc;
+#else
+#error "guard page memory is not supported on this architecture"
+#endif
+}
+
+struct sigaction PreviousSIGSEGVAction;
+struct sigaction PreviousSIGBUSAction;
+
+[[noreturn, gnu::noinline]]
+#if defined(__x86_64__)
+[[gnu::force_align_arg_pointer]]
+#endif
+void raiseMemoryAccessOutOfBound(
+    WebAssemblyMemory *Memory, std::uintptr_t Offset) {
+  throw exceptions::MemoryAccessOutOfBound(*Memory, Offset);
+}
+
+/* Redirects the faulting thread into raiseMemoryAccessOutOfBound as if the
+ * faulting instruction had called it. The fake return address points into the
+ * faulting instruction, so the unwinder picks up the unwind table row of the
+ * faulting instruction and unwinds through the generated code from there.
+ */
+void redirectToTrap(
+    void *SignalContext, WebAssemblyMemory *Memory, std::uintptr_t Offset) {
+  auto *Context = reinterpret_cast<ucontext_t *>(SignalContext);
+  auto TrapAddress = reinterpret_cast<std::uintptr_t>(
+      std::addressof(raiseMemoryAccessOutOfBound));
+#if defined(__x86_64__)
+  auto &Registers = Context->uc_mcontext.gregs;
+  auto StackPtr = static_cast<std::uintptr_t>(Registers[REG_RSP]);
+  StackPtr = StackPtr - sizeof(std::uintptr_t);
+  *reinterpret_cast<std::uintptr_t *>(StackPtr) = Registers[REG_RIP] + 1;
+  Registers[REG_RSP] = static_cast<greg_t>(StackPtr);
+  Registers[REG_RIP] = static_cast<greg_t>(TrapAddress);
+  Registers[REG_RDI] = reinterpret_cast<greg_t>(Memory);
+  Registers[REG_RSI] = static_cast<greg_t>(Offset);
+#elif defined(__aarch64__)
+  auto &Registers = Context->uc_mcontext;
+  Registers.regs[30] = Registers.pc + 1;
+  Registers.pc = TrapAddress;
+  Registers.regs[0] = reinterpret_cast<std::uintptr_t>(Memory);
+  Registers.regs[1] = Offset;
+#else
+#error "guard page memory is not supported on this architecture"
+#endif
+}
+
+void forwardSignal(int Signal, siginfo_t *Info, void *SignalContext) {
+  auto &Previous = (Signal == SIGSEGV) ? PreviousSIGSEGVAction
+                                       : PreviousSIGBUSAction;
+  if (Previous.sa_flags & SA_SIGINFO) {
+    Previous.sa_sigaction(Signal, Info, SignalContext);
+    return;
+  }
+  if ((Previous.sa_handler == SIG_DFL) || (Previous.sa_handler == SIG_IGN)) {
+    // restore the previous disposition, the faulting instruction re-executes
+    // on return and the fault is delivered to it
+    sigaction(Signal, &Previous, nullptr);
+    return;
+  }
+  Previous.sa_handler(Signal);
+}
+
+/* An access starting at the very end of a reservation may overrun it by up to
+ * the width of the widest access, and a split access may report a fault
+ * address in its tail. The tail of a reservation never overlaps the data of
+ * another memory, which is preceded by its accessible metadata page.
+ */
+constexpr std::size_t MaxAccessWidth = 16; // v128
+
+void handleMemoryFault(int Signal, siginfo_t *Info, void *SignalContext) {
+  if (!isModuleCode(getFaultingPC(SignalContext))) {
+    forwardSignal(Signal, Info, SignalContext);
+    return;
+  }
+  auto *FaultAddress = reinterpret_cast<std::byte *>(Info->si_addr);
+  for (auto &Slot : GuardPageMemories) {
+    auto *Memory = Slot.load(std::memory_order_acquire);
+    if (Memory == nullptr) continue;
+    auto *ReservationStart = Memory->data();
+    auto ReservationSize = Memory->getReservedSize() + MaxAccessWidth;
+    if (!(ReservationStart <= FaultAddress)) continue;
+    if (!(FaultAddress < ReservationStart + ReservationSize)) continue;
+    auto Offset = static_cast<std::uintptr_t>(FaultAddress - ReservationStart);
+    redirectToTrap(SignalContext, Memory, Offset);
+    return;
+  }
+  forwardSignal(Signal, Info, SignalContext);
+}
+
+void installMemoryFaultHandler() {
+  static std::once_flag Installed;
+  std::call_once(Installed, [] {
+    struct sigaction Action = {};
+    Action.sa_sigaction = handleMemoryFault;
+    Action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&Action.sa_mask);
+    sigaction(SIGSEGV, &Action, &PreviousSIGSEGVAction);
+    sigaction(SIGBUS, &Action, &PreviousSIGBUSAction);
+  });
+}
+
+void registerGuardPageMemory(WebAssemblyMemory &Memory) {
+  installMemoryFaultHandler();
+  for (auto &Slot : GuardPageMemories) {
+    WebAssemblyMemory *Expected = nullptr;
+    if (Slot.compare_exchange_strong(Expected, std::addressof(Memory)))
+      return;
+  }
+  throw std::bad_alloc();
+}
+
+void unregisterGuardPageMemory(WebAssemblyMemory &Memory) {
+  for (auto &Slot : GuardPageMemories) {
+    auto *Expected = std::addressof(Memory);
+    if (Slot.compare_exchange_strong(Expected, nullptr)) return;
+  }
+  utility::unreachable();
+}
+
+// a 32-bit index addresses at most 4 GiB
+constexpr std::size_t MaxNumWebAssemblyPage = 65536;
+// a 64-bit memory is kept within 2^48 bytes, any host address space is
+// smaller anyway, and in place reservations of it within 64 GiB. Compiled
+// code never reloads the base of an in place memory, hence one declaring a
+// larger maximum cannot fall back to Exact and is rejected.
+constexpr std::size_t MaxNumWebAssemblyPage64 = std::size_t(1) << 32;
+constexpr std::size_t MaxNumReservedPage64 = std::size_t(1) << 20;
+// trailing a 64-bit guard page memory, covers any guarded access width
+constexpr std::size_t GuardRegionSize = std::size_t(4) * 1024 * 1024 * 1024;
+
+std::size_t getMaxNumPage(bool IsMemory64) {
+  return IsMemory64 ? MaxNumWebAssemblyPage64 : MaxNumWebAssemblyPage;
+}
+
+// pages an in place reservation holds, guard regions excluded
+std::size_t getNumReservedPage(std::uint64_t MaxNumPage, bool IsMemory64) {
+  auto Limit = IsMemory64 ? MaxNumReservedPage64 : MaxNumWebAssemblyPage;
+  return std::min<std::uint64_t>(MaxNumPage, Limit);
+}
+
+std::size_t alignTo(std::size_t Size, std::size_t Alignment) {
+  return (Size + Alignment - 1) / Alignment * Alignment;
+}
+
+// hugetlbfs pages are committed as a whole
+std::size_t getCommitSize(MemoryPagePolicy PagePolicy, std::size_t Size) {
+  if (PagePolicy != MemoryPagePolicy::HugeTLB) return Size;
+  return alignTo(Size, WebAssemblyMemory::getHugePageSize());
+}
+
+// address space reserved for the content of an in place memory
+std::size_t getReservationSize(
+    MemoryReservationKind Reservation, MemoryPagePolicy PagePolicy,
+    std::uint64_t MaxNumPage, bool IsMemory64) {
+  auto NumPage = getNumReservedPage(MaxNumPage, IsMemory64);
+  auto Size = NumPage * WebAssemblyMemory::getWebAssemblyPageSize();
+  if (Reservation == MemoryReservationKind::GuardPage) {
+    if (!IsMemory64) return WebAssemblyMemory::getGuardPageReservationSize();
+    return Size + GuardRegionSize;
+  }
+  assert(Reservation == MemoryReservationKind::Reserved);
+  return getCommitSize(PagePolicy, Size);
+}
+
+// in place memories grow up to their reservation, guard regions excluded
+std::size_t getCommitLimit(std::uint64_t MaxNumPage, bool IsMemory64) {
+  auto NumPage = getNumReservedPage(MaxNumPage, IsMemory64);
+  return NumPage * WebAssemblyMemory::getWebAssemblyPageSize();
+}
+
+/* Maps the metadata page followed by DataSize bytes of data. Unless the page
+ * policy is Native, the data region starts on a huge page boundary, which
+ * keeps the metadata page exactly one native page below it: the mapping is
+ * over-reserved by one huge page and the unaligned head and tail are trimmed.
+ */
+std::byte *mapAligned(
+    std::size_t DataSize, int Permission, int Flag,
+    MemoryPagePolicy PagePolicy) {
+  auto NativePageSize = WebAssemblyMemory::getNativePageSize();
+  auto Alignment = (PagePolicy == MemoryPagePolicy::Native)
+                       ? NativePageSize
+                       : WebAssemblyMemory::getHugePageSize();
+  auto Padding = Alignment - NativePageSize;
+  auto AllocSize = NativePageSize + DataSize + Padding;
+  auto *MappedPages = mmap(NULL, AllocSize, Permission, Flag, -1, 0);
+  if (MappedPages == MAP_FAILED) return nullptr;
+  auto Address = reinterpret_cast<std::uintptr_t>(MappedPages);
+  auto DataAddress = alignTo(Address + NativePageSize, Alignment);
+  auto HeadSize = DataAddress - NativePageSize - Address;
+  auto TailSize = Padding - HeadSize;
+  if (HeadSize != 0) munmap(MappedPages, HeadSize);
+  if (TailSize != 0)
+    munmap(reinterpret_cast<void *>(DataAddress + DataSize), TailSize);
+  return reinterpret_cast<std::byte *>(DataAddress - NativePageSize);
+}
+
+/* Replaces the reserved data region by hugetlbfs pages. Pages are reserved
+ * for the whole region so that a short pool fails here instead of raising
+ * SIGBUS on first touch. On failure the region is reserved again with native
+ * pages, a failed MAP_FIXED may already have dropped the previous mapping.
+ */
+bool mapHugeTLB(std::byte *Data, std::size_t DataSize) {
+  auto Flag = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+  auto *MappedPages =
+      mmap(Data, DataSize, PROT_NONE, Flag | MAP_HUGETLB, -1, 0);
+  if (MappedPages != MAP_FAILED) return true;
+  MappedPages =
+      mmap(Data, DataSize, PROT_NONE, Flag | MAP_NORESERVE, -1, 0);
+  if (MappedPages == MAP_FAILED) throw std::bad_alloc();
+  return false;
+}
+
+/* Replaces the pages at Data by fresh anonymous ones, which drops a memory
+ * image mapped there: MADV_DONTNEED on private file pages reads the file back
+ * instead of zeros.
+ */
+void mapAnonymous(
+    std::byte *Data, std::size_t Size, MemoryPagePolicy PagePolicy) {
+  if (Size == 0) return;
+  auto Permission = PROT_READ | PROT_WRITE;
+  auto Flag = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE;
+  auto *MappedPages = mmap(Data, Size, Permission, Flag, -1, 0);
+  if (MappedPages == MAP_FAILED) throw std::bad_alloc();
+  if (PagePolicy == MemoryPagePolicy::TransparentHugePage)
+    madvise(Data, Size, MADV_HUGEPAGE);
+}
+
+/* Threads blocked in memory.atomic.wait park in a bucket selected by the
+ * address they wait on. The value is compared under the bucket lock, and
+ * notify takes the same lock, hence a notify issued after the store that the
+ * waiter is about to observe is never lost.
+ */
+struct Waiter {
+  std::byte const *Address = nullptr;
+  std::condition_variable Condition;
+  bool IsNotified = false;
 };
 
+struct ParkingBucket {
+  std::mutex Mutex;
+  std::list<Waiter *> Waiters;
+};
+
+constexpr std::size_t NumParkingBuckets = 256;
+std::array<ParkingBucket, NumParkingBuckets> ParkingBuckets;
+
+ParkingBucket &getParkingBucket(std::byte const *Address) {
+  auto Key = reinterpret_cast<std::uintptr_t>(Address) >> 2;
+  return ParkingBuckets[Key % NumParkingBuckets];
+}
+
+template <typename T>
+std::uint32_t waitOn(std::byte *Address, T Expect, std::int64_t Timeout) {
+  auto &Bucket = getParkingBucket(Address);
+  std::unique_lock<std::mutex> Lock(Bucket.Mutex);
+  std::atomic_ref<T> Value(*reinterpret_cast<T *>(Address));
+  if (Value.load() != Expect) return 1;
+  Waiter Self;
+  Self.Address = Address;
+  auto Position = Bucket.Waiters.insert(Bucket.Waiters.end(), &Self);
+  auto IsNotified = [&] { return Self.IsNotified; };
+  if (Timeout < 0) {
+    Self.Condition.wait(Lock, IsNotified);
+    return 0;
+  }
+  auto Duration = std::chrono::nanoseconds(Timeout);
+  if (Self.Condition.wait_for(Lock, Duration, IsNotified)) return 0;
+  Bucket.Waiters.erase(Position);
+  return 2;
+}
+
+std::uint32_t notifyOn(std::byte const *Address, std::uint32_t Count) {
+  auto &Bucket = getParkingBucket(Address);
+  std::lock_guard<std::mutex> Lock(Bucket.Mutex);
+  std::uint32_t NumWoken = 0;
+  auto Iter = Bucket.Waiters.begin();
+  while ((Iter != Bucket.Waiters.end()) && (NumWoken < Count)) {
+    auto *Parked = *Iter;
+    if (Parked->Address != Address) {
+      ++Iter;
+      continue;
+    }
+    Parked->IsNotified = true;
+    Parked->Condition.notify_one();
+    Iter = Bucket.Waiters.erase(Iter);
+    NumWoken = NumWoken + 1;
+  }
+  return NumWoken;
+}
+} // namespace
+
 WebAssemblyMemory::MemoryMetadata &WebAssemblyMemory::getMetadata() {
   auto *Ptr = std::addressof(Memory[-getNativePageSize()]);
   return *reinterpret_cast<MemoryMetadata *>(Ptr);
@@ -48,84 +475,416 @@ WebAssemblyMemory::getMetadata() const {
   return *reinterpret_cast<MemoryMetadata const *>(Ptr);
 }
 
-void WebAssemblyMemory::addUseSite(WebAssemblyInstance &Instance) {
-  getMetadata().UseSites->push_front(std::addressof(Instance));
+void WebAssemblyMemory::addUseSite(
+    __sable_memory_t *&MemorySlot, std::size_t &SizeSlot) {
+  UseSite Site{
+      .MemorySlot = std::addressof(MemorySlot),
+      .SizeSlot = std::addressof(SizeSlot)};
+  // the slots are published under the lock that grow holds, so a concurrent
+  // grow either sees the site or happens before it is initialized
+  std::lock_guard<std::mutex> Lock(*getMetadata().Mutex);
+  MemorySlot = asInstancePtr();
+  std::atomic_ref<std::size_t>(SizeSlot).store(
+      getMetadata().SizeInBytes, std::memory_order_release);
+  getMetadata().UseSites->push_front(Site);
 }
 
 namespace {
-template <typename Iterator, typename T>
-Iterator find_before(Iterator BeforeFist, Iterator Last, T const &Value) {
+template <typename Iterator, typename Predicate>
+Iterator find_before_if(Iterator BeforeFist, Iterator Last, Predicate Pred) {
   assert(BeforeFist != Last);
   auto Next = std::next(BeforeFist);
   if (Next == Last) return Last;
-  if (*Next == Value) return BeforeFist;
-  return find_before(Next, Last, Value);
+  if (Pred(*Next)) return BeforeFist;
+  return find_before_if(Next, Last, Pred);
 }
 } // namespace
 
-void WebAssemblyMemory::removeUseSite(WebAssemblyInstance &Instance) {
-  auto SearchIter = find_before(
+void WebAssemblyMemory::removeUseSite(__sable_memory_t *&MemorySlot) {
+  std::lock_guard<std::mutex> Lock(*getMetadata().Mutex);
+  auto SearchIter = find_before_if(
       getMetadata().UseSites->before_begin(), getMetadata().UseSites->end(),
-      std::addressof(Instance));
+      [&](UseSite const &Site) {
+        return Site.MemorySlot == std::addressof(MemorySlot);
+      });
   assert(SearchIter != getMetadata().UseSites->end());
   getMetadata().UseSites->erase_after(SearchIter);
 }
 
-WebAssemblyMemory::WebAssemblyMemory(std::uint32_t NumPage)
-    : WebAssemblyMemory(NumPage, NO_MAXIMUM) {}
-
 WebAssemblyMemory::WebAssemblyMemory(
-    std::uint32_t NumPage, std::uint32_t MaxNumPage)
+    std::uint64_t NumPage, MemoryOptions const &Options)
     : Memory(nullptr) {
+  auto [MaxNumPage, Reservation, PagePolicy, CommitPolicy, IsShared,
+        IsMemory64] = Options;
   assert(getWebAssemblyPageSize() >= getNativePageSize());
   assert(getWebAssemblyPageSize() % getNativePageSize() == 0);
   assert(sizeof(MemoryMetadata) < getNativePageSize());
   assert(NumPage <= MaxNumPage);
-  auto NumAllocPage =
-      (NumPage * getWebAssemblyPageSize() / getNativePageSize()) + 1;
-  auto AllocSize = NumAllocPage * getNativePageSize();
-  auto Permission = PROT_READ | PROT_WRITE;
+  if (NumPage > getMaxNumPage(IsMemory64)) throw std::bad_alloc();
+  // other threads access the memory without going through the use sites
+  if (IsShared && (Reservation == MemoryReservationKind::Exact))
+    Reservation = MemoryReservationKind::Reserved;
+  // without a declared maximum, growing past the reservation merely fails
+  auto HasMax = MaxNumPage != std::numeric_limits<std::uint64_t>::max();
+  if (IsMemory64 && HasMax && (MaxNumPage > MaxNumReservedPage64) &&
+      (Reservation != MemoryReservationKind::Exact))
+    throw exceptions::UnreservableMemory(MaxNumPage);
+  // committed huge pages past the size would stay accessible and defeat the
+  // guard region, and exact reservations remap on grow
+  if ((PagePolicy == MemoryPagePolicy::HugeTLB) &&
+      (Reservation != MemoryReservationKind::Reserved))
+    PagePolicy = MemoryPagePolicy::TransparentHugePage;
+  std::size_t SizeInBytes = NumPage * getWebAssemblyPageSize();
+  std::size_t ReservedSize = 0;
   auto Flag = MAP_PRIVATE | MAP_ANONYMOUS;
-  auto *MappedPages = mmap(NULL, AllocSize, Permission, Flag, -1, 0);
-  if (MappedPages == nullptr) throw std::bad_alloc();
-  Memory = &reinterpret_cast<std::byte *>(MappedPages)[getNativePageSize()];
+  std::byte *MappedPages = nullptr;
+  std::size_t DataSize = 0;
+  switch (Reservation) {
+  case MemoryReservationKind::Exact: {
+    DataSize = SizeInBytes;
+    if (CommitPolicy == MemoryCommitPolicy::Lazy) Flag = Flag | MAP_NORESERVE;
+    auto Permission = PROT_READ | PROT_WRITE;
+    MappedPages = mapAligned(DataSize, Permission, Flag, PagePolicy);
+    if (MappedPages == nullptr) throw std::bad_alloc();
+    break;
+  }
+  case MemoryReservationKind::GuardPage:
+  case MemoryReservationKind::Reserved: {
+    if (SizeInBytes > getCommitLimit(MaxNumPage, IsMemory64))
+      throw std::bad_alloc();
+    DataSize =
+        getReservationSize(Reservation, PagePolicy, MaxNumPage, IsMemory64);
+    ReservedSize = DataSize;
+    Flag = Flag | MAP_NORESERVE;
+    MappedPages = mapAligned(DataSize, PROT_NONE, Flag, PagePolicy);
+    if (MappedPages == nullptr) throw std::bad_alloc();
+    auto *Data = std::addressof(MappedPages[getNativePageSize()]);
+    if (PagePolicy == MemoryPagePolicy::HugeTLB)
+      if (!mapHugeTLB(Data, DataSize))
+        PagePolicy = MemoryPagePolicy::TransparentHugePage;
+    auto CommitSize = getCommitSize(PagePolicy, SizeInBytes);
+    auto Permission = PROT_READ | PROT_WRITE;
+    if ((mprotect(MappedPages, getNativePageSize(), Permission) != 0) ||
+        (mprotect(Data, CommitSize, Permission) != 0)) {
+      munmap(MappedPages, DataSize + getNativePageSize());
+      throw std::bad_alloc();
+    }
+    break;
+  }
+  default: utility::unreachable();
+  }
+  // khugepaged may still back the region with native pages, the advice is
+  // best effort and a kernel without THP support simply ignores it
+  if (PagePolicy == MemoryPagePolicy::TransparentHugePage)
+    madvise(MappedPages, DataSize + getNativePageSize(), MADV_HUGEPAGE);
+  Memory = std::addressof(MappedPages[getNativePageSize()]);
   getMetadata().Size = NumPage;
   getMetadata().Max = MaxNumPage;
-  getMetadata().SizeInBytes = getSize() * getWebAssemblyPageSize();
+  getMetadata().SizeInBytes = SizeInBytes;
+  getMetadata().ReservedSize = ReservedSize;
   getMetadata().Instance = this;
-  getMetadata().UseSites = new std::forward_list<WebAssemblyInstance *>();
+  getMetadata().UseSites = new std::forward_list<UseSite>();
+  getMetadata().Reservation = Reservation;
+  getMetadata().PagePolicy = PagePolicy;
+  getMetadata().CommitPolicy = CommitPolicy;
+  getMetadata().SampledPeakResidentBytes = 0;
+  getMetadata().ImageID = 0;
+  getMetadata().ImageOffset = 0;
+  getMetadata().ImageSize = 0;
+  getMetadata().IsShared = IsShared;
+  getMetadata().IsMemory64 = IsMemory64;
+  getMetadata().Mutex = new std::mutex();
+  if (Reservation == MemoryReservationKind::GuardPage)
+    registerGuardPageMemory(*this);
 }
 
 WebAssemblyMemory::~WebAssemblyMemory() noexcept {
   assert(getMetadata().UseSites->empty());
   delete getMetadata().UseSites;
+  delete getMetadata().Mutex;
   auto *MappedPages = std::addressof(Memory[-getNativePageSize()]);
   auto MappedSize = getMetadata().SizeInBytes + getNativePageSize();
+  if (getReservationKind() == MemoryReservationKind::GuardPage)
+    unregisterGuardPageMemory(*this);
+  if (getReservationKind() != MemoryReservationKind::Exact)
+    MappedSize = getReservedSize() + getNativePageSize();
   munmap(MappedPages, MappedSize);
 }
 
+void WebAssemblyMemory::clear() {
+  auto CommitSize = getCommitSize(getPagePolicy(), getSizeInBytes());
+  if (getMetadata().ImageID != 0) {
+    // a file image or a snapshot is mapped somewhere in the committed range,
+    // its pages must not survive into the next tenant
+    mapAnonymous(Memory, CommitSize, getPagePolicy());
+    getMetadata().ImageID = 0;
+    getMetadata().ImageOffset = 0;
+    getMetadata().ImageSize = 0;
+    return;
+  }
+  // pages stay mapped and read back as zero on next touch
+  if (madvise(Memory, CommitSize, MADV_DONTNEED) != 0) {
+    // older kernels reject MADV_DONTNEED on hugetlbfs pages
+    std::memset(Memory, 0, getSizeInBytes());
+  }
+}
+
+void WebAssemblyMemory::reset(std::uint64_t NumPage) {
+  assert(getMetadata().UseSites->empty());
+  auto SizeInBytes = std::size_t(NumPage) * getWebAssemblyPageSize();
+  assert(SizeInBytes <= getSizeInBytes());
+  clear();
+  if (SizeInBytes != getSizeInBytes()) {
+    auto CommitSize = getCommitSize(getPagePolicy(), getSizeInBytes());
+    auto NewCommitSize = getCommitSize(getPagePolicy(), SizeInBytes);
+    auto *ShrinkStart = std::addressof(Memory[NewCommitSize]);
+    auto ShrinkSize = CommitSize - NewCommitSize;
+    switch (getReservationKind()) {
+    case MemoryReservationKind::Exact: {
+      auto *MappedPages = &Memory[-getNativePageSize()];
+      auto MappedSize = getSizeInBytes() + getNativePageSize();
+      auto NewMappedSize = SizeInBytes + getNativePageSize();
+      // shrinking in place never moves the mapping
+      mremap(MappedPages, MappedSize, NewMappedSize, 0);
+      break;
+    }
+    case MemoryReservationKind::GuardPage:
+    case MemoryReservationKind::Reserved:
+      mprotect(ShrinkStart, ShrinkSize, PROT_NONE);
+      break;
+    default: utility::unreachable();
+    }
+  }
+  getMetadata().Size = NumPage;
+  getMetadata().SizeInBytes = SizeInBytes;
+  getMetadata().SampledPeakResidentBytes = 0;
+}
+
+void WebAssemblyMemory::mapImage(
+    int FileDescriptor, std::uint64_t ImageID, std::size_t Offset,
+    std::size_t Size) {
+  assert(canMapImage());
+  assert(ImageID != 0);
+  assert(Offset + Size <= getSizeInBytes());
+  // whatever the committed range held before, including another image, is
+  // dropped and only the image itself is left non-zero
+  clear();
+  auto *ImageStart = std::addressof(Memory[Offset]);
+  auto Permission = PROT_READ | PROT_WRITE;
+  auto Flag = MAP_PRIVATE | MAP_FIXED;
+  auto *MappedPages =
+      mmap(ImageStart, Size, Permission, Flag, FileDescriptor, 0);
+  if (MappedPages == MAP_FAILED) throw std::bad_alloc();
+  getMetadata().ImageID = ImageID;
+  getMetadata().ImageOffset = Offset;
+  getMetadata().ImageSize = Size;
+}
+
+void WebAssemblyMemory::restore(
+    std::uint64_t NumPage, int FileDescriptor, std::uint64_t ImageID) {
+  assert(getMetadata().UseSites->empty());
+  assert(getSize() <= NumPage);
+  if (grow(NumPage - getSize()) == GrowFailed) throw std::bad_alloc();
+  if (getSizeInBytes() == 0) return;
+  if (canMapImage()) {
+    mapImage(FileDescriptor, ImageID, 0, getSizeInBytes());
+    return;
+  }
+  // only the data extents of the sparse file are read, pages under holes are
+  // left zero without being touched
+  clear();
+  auto Size = static_cast<off_t>(getSizeInBytes());
+  off_t DataStart = 0;
+  while (DataStart < Size) {
+    DataStart = lseek(FileDescriptor, DataStart, SEEK_DATA);
+    if ((DataStart == -1) && (errno == ENXIO)) return;
+    auto DataEnd = lseek(FileDescriptor, DataStart, SEEK_HOLE);
+    if ((DataStart == -1) || (DataEnd == -1))
+      throw std::runtime_error("cannot restore memory");
+    DataEnd = std::min(DataEnd, Size);
+    while (DataStart < DataEnd) {
+      auto Result = pread(
+          FileDescriptor, std::addressof(Memory[DataStart]),
+          DataEnd - DataStart, DataStart);
+      if ((Result == -1) && (errno == EINTR)) continue;
+      if (Result <= 0) throw std::runtime_error("cannot restore memory");
+      DataStart = DataStart + Result;
+    }
+  }
+}
+
+bool WebAssemblyMemory::canMapImage() const {
+  if (getReservationKind() == MemoryReservationKind::Exact) return false;
+  return getPagePolicy() != MemoryPagePolicy::HugeTLB;
+}
+
+/* Counted with mincore over the committed size, hence clean pages of a
+ * memory image count as resident once any instance sharing the image has
+ * touched them.
+ */
+std::size_t WebAssemblyMemory::getResidentSize() const {
+  constexpr std::size_t ChunkNumPage = 4096;
+  std::array<unsigned char, ChunkNumPage> Residency;
+  auto ChunkSize = ChunkNumPage * getNativePageSize();
+  auto CommitSize = getCommitSize(getPagePolicy(), getSizeInBytes());
+  std::size_t NumResidentPage = 0;
+  for (std::size_t Offset = 0; Offset < CommitSize; Offset += ChunkSize) {
+    auto Length = std::min(ChunkSize, CommitSize - Offset);
+    auto *Start = const_cast<std::byte *>(std::addressof(Memory[Offset]));
+    if (mincore(Start, Length, Residency.data()) != 0)
+      throw std::runtime_error("cannot query resident pages");
+    auto NumPage = Length / getNativePageSize();
+    for (std::size_t I = 0; I < NumPage; ++I)
+      NumResidentPage = NumResidentPage + (Residency[I] & 0x1);
+  }
+  return NumResidentPage * getNativePageSize();
+}
+
+/* An anonymous page never written since it was mapped is neither present nor
+ * swapped out and reads as zero, /proc/self/pagemap tells so without faulting
+ * the page in. mincore cannot, it reports swapped out pages as non-resident.
+ * Pages of a mapped image read from the file instead, they are all reported,
+ * as well as every page when the pagemap is unavailable.
+ */
+std::vector<std::uint64_t> WebAssemblyMemory::getPopulatedPages() const {
+  constexpr std::uint64_t PresentOrSwapped = std::uint64_t(0x3) << 62;
+  auto PageMap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+  auto NumEntry = getWebAssemblyPageSize() / getNativePageSize();
+  auto FirstEntry =
+      reinterpret_cast<std::uintptr_t>(Memory) / getNativePageSize();
+  std::vector<std::uint64_t> Entries(NumEntry);
+  auto EntriesSize = NumEntry * sizeof(std::uint64_t);
+  auto ImageStart = getMetadata().ImageOffset;
+  auto ImageEnd = ImageStart + getMetadata().ImageSize;
+  std::vector<std::uint64_t> Pages;
+  for (std::uint64_t I = 0; I < getSize(); ++I) {
+    auto PageStart = std::size_t(I) * getWebAssemblyPageSize();
+    auto PageEnd = PageStart + getWebAssemblyPageSize();
+    auto IsImage = (PageStart < ImageEnd) && (ImageStart < PageEnd);
+    if (IsImage || (PageMap == -1)) {
+      Pages.push_back(I);
+      continue;
+    }
+    auto Offset = (FirstEntry + I * NumEntry) * sizeof(std::uint64_t);
+    auto NumRead = pread(PageMap, Entries.data(), EntriesSize, Offset);
+    auto IsPopulated =
+        (NumRead != static_cast<ssize_t>(EntriesSize)) ||
+        std::any_of(Entries.begin(), Entries.end(), [](std::uint64_t Entry) {
+          return (Entry & PresentOrSwapped) != 0;
+        });
+    if (IsPopulated) Pages.push_back(I);
+  }
+  if (PageMap != -1) close(PageMap);
+  return Pages;
+}
+
+void WebAssemblyMemory::registerModuleCode(void *DLHandler) {
+  for (auto const &[Begin, End] : getExecutableSegments(DLHandler)) {
+    auto IsRegistered = false;
+    for (auto &Range : CodeRanges) {
+      std::uintptr_t Expected = 0;
+      if (!Range.Begin.compare_exchange_strong(Expected, Begin)) continue;
+      Range.End.store(End, std::memory_order_release);
+      IsRegistered = true;
+      break;
+    }
+    if (!IsRegistered) throw std::bad_alloc();
+  }
+}
+
+void WebAssemblyMemory::unregisterModuleCode(void *DLHandler) {
+  for (auto const &[Begin, End] : getExecutableSegments(DLHandler)) {
+    for (auto &Range : CodeRanges) {
+      if (Range.Begin.load(std::memory_order_acquire) != Begin) continue;
+      auto Expected = End;
+      if (!Range.End.compare_exchange_strong(Expected, 0)) continue;
+      Range.Begin.store(0, std::memory_order_release);
+      break;
+    }
+  }
+}
+
 bool WebAssemblyMemory::hasMaxSize() const {
   return getMetadata().Max == NO_MAXIMUM;
 }
 
-std::uint32_t WebAssemblyMemory::getMaxSize() const {
+std::uint64_t WebAssemblyMemory::getMaxSize() const {
   return getMetadata().Max;
 }
 
-std::uint32_t WebAssemblyMemory::getSize() const { return getMetadata().Size; }
+std::uint64_t WebAssemblyMemory::getSize() const { return getMetadata().Size; }
 
 std::size_t WebAssemblyMemory::getSizeInBytes() const {
   return getMetadata().SizeInBytes;
 }
 
+std::size_t WebAssemblyMemory::getReservedSize() const {
+  return getMetadata().ReservedSize;
+}
+
+MemoryReservationKind WebAssemblyMemory::getReservationKind() const {
+  return getMetadata().Reservation;
+}
+
+MemoryPagePolicy WebAssemblyMemory::getPagePolicy() const {
+  return getMetadata().PagePolicy;
+}
+
+MemoryCommitPolicy WebAssemblyMemory::getCommitPolicy() const {
+  return getMetadata().CommitPolicy;
+}
+
+bool WebAssemblyMemory::isShared() const { return getMetadata().IsShared; }
+
+bool WebAssemblyMemory::isMemory64() const {
+  return getMetadata().IsMemory64;
+}
+
+MemoryStats WebAssemblyMemory::getStats() {
+  MemoryStats Stats;
+  Stats.ReservedBytes = getSizeInBytes();
+  if (getReservationKind() != MemoryReservationKind::Exact)
+    Stats.ReservedBytes = getReservedSize();
+  Stats.CommittedBytes = getCommitSize(getPagePolicy(), getSizeInBytes());
+  Stats.ResidentBytes = getResidentSize();
+  auto &PeakBytes = getMetadata().SampledPeakResidentBytes;
+  PeakBytes = std::max(PeakBytes, Stats.ResidentBytes);
+  Stats.SampledPeakResidentBytes = PeakBytes;
+  return Stats;
+}
+
 std::byte *WebAssemblyMemory::data() { return Memory; }
 
 std::byte const *WebAssemblyMemory::data() const { return Memory; }
 
-std::uint32_t WebAssemblyMemory::grow(std::uint32_t DeltaNumPage) {
-  auto *OldInstancePtr = asInstancePtr();
+std::uint64_t WebAssemblyMemory::grow(std::uint64_t DeltaNumPage) {
+  std::lock_guard<std::mutex> Lock(*getMetadata().Mutex);
   auto OldSize = getSize();
-  if (getMetadata().Size + DeltaNumPage > getMetadata().Max) return GrowFailed;
+  // a 64-bit delta may wrap around, compare against the headroom instead
+  if (DeltaNumPage > getMetadata().Max - OldSize) return GrowFailed;
+  if (DeltaNumPage > getMaxNumPage(isMemory64()) - OldSize) return GrowFailed;
+  if (getReservationKind() != MemoryReservationKind::Exact) {
+    // the reservation already covers the maximum size, grow in place and
+    // only refresh the cached sizes
+    auto NewSizeInBytes =
+        getSizeInBytes() + std::size_t(DeltaNumPage) * getWebAssemblyPageSize();
+    auto CommitLimit = getCommitLimit(getMaxSize(), isMemory64());
+    if (NewSizeInBytes > CommitLimit) return GrowFailed;
+    auto OldCommitSize = getCommitSize(getPagePolicy(), getSizeInBytes());
+    auto NewCommitSize = getCommitSize(getPagePolicy(), NewSizeInBytes);
+    auto *CommitStart = std::addressof(Memory[OldCommitSize]);
+    auto CommitSize = NewCommitSize - OldCommitSize;
+    auto Permission = PROT_READ | PROT_WRITE;
+    if (mprotect(CommitStart, CommitSize, Permission) != 0) return GrowFailed;
+    getMetadata().Size = getMetadata().Size + DeltaNumPage;
+    getMetadata().SizeInBytes = NewSizeInBytes;
+    // instances on other threads load the size of a shared memory while it
+    // grows, the release pairs with their acquire load
+    for (auto const &UseSite : *getMetadata().UseSites)
+      std::atomic_ref<std::size_t>(*UseSite.SizeSlot)
+          .store(NewSizeInBytes, std::memory_order_release);
+    return OldSize;
+  }
   auto *MappedPages = &Memory[-getNativePageSize()];
   auto MappedSize = getMetadata().SizeInBytes + getNativePageSize();
   auto NewMappedSize = MappedSize + DeltaNumPage * getWebAssemblyPageSize();
@@ -135,12 +894,44 @@ std::uint32_t WebAssemblyMemory::grow(std::uint32_t DeltaNumPage) {
   Memory = &reinterpret_cast<std::byte *>(RemappedPages)[getNativePageSize()];
   getMetadata().Size = getMetadata().Size + DeltaNumPage;
   getMetadata().SizeInBytes = getSize() * getWebAssemblyPageSize();
-  auto *NewInstancePtr = asInstancePtr();
-  for (auto *UseSite : *getMetadata().UseSites)
-    UseSite->replace(OldInstancePtr, NewInstancePtr);
+  for (auto const &UseSite : *getMetadata().UseSites) {
+    *UseSite.MemorySlot = asInstancePtr();
+    *UseSite.SizeSlot = getSizeInBytes();
+  }
   return OldSize;
 }
 
+namespace {
+template <typename T>
+std::uint32_t waitOnMemory(
+    WebAssemblyMemory &Memory, std::size_t Offset, T Expect,
+    std::int64_t Timeout) {
+  if (!Memory.isShared()) throw exceptions::UnsharedMemoryWait(Memory);
+  if (Offset + sizeof(T) > Memory.getSizeInBytes())
+    throw exceptions::MemoryAccessOutOfBound(Memory, Offset);
+  return waitOn(std::addressof(Memory[Offset]), Expect, Timeout);
+}
+} // namespace
+
+std::uint32_t WebAssemblyMemory::wait(
+    std::size_t Offset, std::uint32_t Expect, std::int64_t Timeout) {
+  return waitOnMemory(*this, Offset, Expect, Timeout);
+}
+
+std::uint32_t WebAssemblyMemory::wait(
+    std::size_t Offset, std::uint64_t Expect, std::int64_t Timeout) {
+  return waitOnMemory(*this, Offset, Expect, Timeout);
+}
+
+std::uint32_t
+WebAssemblyMemory::notify(std::size_t Offset, std::uint32_t Count) {
+  if (Offset + sizeof(std::uint32_t) > getSizeInBytes())
+    throw exceptions::MemoryAccessOutOfBound(*this, Offset);
+  // nobody can wait on an unshared memory
+  if (!isShared()) return 0;
+  return notifyOn(std::addressof(Memory[Offset]), Count);
+}
+
 __sable_memory_t *WebAssemblyMemory::asInstancePtr() {
   return reinterpret_cast<__sable_memory_t *>(data()); // NOLINT
 }
@@ -153,6 +944,17 @@ std::size_t WebAssemblyMemory::getNativePageSize() {
   return sysconf(_SC_PAGESIZE);
 }
 
+std::size_t WebAssemblyMemory::getGuardPageReservationSize() {
+  // 4 GiB addressable by a 32-bit index plus 4 GiB trailing guard region
+  // covering any static offset that can be added to it, the widest access at
+  // the largest address overruns it by a few bytes, see handleMemoryFault
+  return std::size_t(8) * 1024 * 1024 * 1024;
+}
+
+std::size_t WebAssemblyMemory::getHugePageSize() {
+  return 2 * 1024 * 1024; /* 2 MiB */
+}
+
 std::byte &WebAssemblyMemory::operator[](std::size_t Offset) {
   return data()[Offset];
 }
@@ -198,6 +1000,6 @@ WebAssemblyMemory::fromInstancePtr(__sable_memory_t *InstancePtr) {
   return Metadata->Instance;
 }
 
-std::uint32_t const WebAssemblyMemory::GrowFailed =
-    static_cast<std::uint32_t>(-1);
+std::uint64_t const WebAssemblyMemory::GrowFailed =
+    static_cast<std::uint64_t>(-1);
 } // namespace runtime
@@ -7,11 +7,12 @@ void __sable_table_guard(__sable_table_t *TablePtr, std::uint32_t Index) {
 }
 
 void __sable_table_check(
-    __sable_table_t *TablePtr, std::uint32_t Index, char const *Signature) {
+    __sable_table_t *TablePtr, std::uint32_t Index, std::uint32_t SignatureID) {
   auto *Table = runtime::WebAssemblyTable::fromInstancePtr(TablePtr);
   if (Table->isNull(Index))
     throw runtime::exceptions::BadTableEntry(*Table, Index);
-  if (Table->getSignature(Index) != Signature) {
+  if (Table->Storage[Index].SignatureID != SignatureID) {
+    auto Signature = runtime::detail::fromSignatureID(SignatureID);
     auto ExpectType = runtime::detail::fromSignature<bytecode::FunctionType>(
         Table->getSignature(Index));
     auto ActualType =
@@ -21,18 +22,6 @@ void __sable_table_check(
   }
 }
 
-__sable_instance_t *
-__sable_table_context(__sable_table_t *TablePtr, std::uint32_t Index) {
-  auto *Table = runtime::WebAssemblyTable::fromInstancePtr(TablePtr);
-  return Table->getContextPtr(Index);
-}
-
-__sable_function_t *
-__sable_table_function(__sable_table_t *TablePtr, std::uint32_t Index) {
-  auto *Table = runtime::WebAssemblyTable::fromInstancePtr(TablePtr);
-  return Table->getFunctionPtr(Index);
-}
-
 void __sable_table_set(
     __sable_table_t *TablePtr, __sable_instance_t *InstancePtr,
     std::uint32_t Offset, std::uint32_t Count, std::uint32_t Indices[]) {
@@ -55,24 +44,19 @@ void WebAssemblyTable::set(
   TableEntry Entry{
       .ContextPtr = ContextPtr,
       .FunctionPtr = FunctionPtr,
-      .Signature = std::string(Signature)};
+      .SignatureID = detail::toSignatureID(Signature)};
   Storage[Index] = Entry;
 }
 
-__sable_instance_t *WebAssemblyTable::getContextPtr(std::uint32_t Index) const {
-  assert(Index < Storage.size());
-  return Storage[Index].ContextPtr;
-}
-
-__sable_function_t *
-WebAssemblyTable::getFunctionPtr(std::uint32_t Index) const {
+std::string_view WebAssemblyTable::getSignature(std::uint32_t Index) const {
   assert(Index < Storage.size());
-  return Storage[Index].FunctionPtr;
+  return detail::fromSignatureID(Storage[Index].SignatureID);
 }
 
-std::string_view WebAssemblyTable::getSignature(std::uint32_t Index) const {
-  assert(Index < Storage.size());
-  return Storage[Index].Signature;
+void WebAssemblyTable::reset() {
+  TableEntry DefaultEntry{
+      .ContextPtr = nullptr, .FunctionPtr = nullptr, .SignatureID = 0};
+  std::fill(Storage.begin(), Storage.end(), DefaultEntry);
 }
 
 WebAssemblyTable::WebAssemblyTable(std::uint32_t NumEntries)
@@ -80,12 +64,11 @@ WebAssemblyTable::WebAssemblyTable(std::uint32_t NumEntries)
 
 WebAssemblyTable::WebAssemblyTable(
     std::uint32_t NumEntries, std::uint32_t MaxNumEntries)
-    : Size(NumEntries), MaxSize(MaxNumEntries), Storage() {
+    : Entries(nullptr), Size(NumEntries), MaxSize(MaxNumEntries), Storage() {
   TableEntry DefaultEntry{
-      .ContextPtr = nullptr,
-      .FunctionPtr = nullptr,
-      .Signature = std::string()};
+      .ContextPtr = nullptr, .FunctionPtr = nullptr, .SignatureID = 0};
   Storage.resize(NumEntries, DefaultEntry);
+  Entries = Storage.data();
 }
 
 std::uint32_t WebAssemblyTable::getSize() const { return Size; }
@@ -102,7 +85,7 @@ bool WebAssemblyTable::isNull(std::uint32_t Index) const {
 
 bytecode::FunctionType WebAssemblyTable::getType(std::uint32_t Index) const {
   if (isNull(Index)) throw exceptions::BadTableEntry(*this, Index);
-  auto const &Signature = Storage[Index].Signature;
+  auto Signature = getSignature(Index);
   return detail::fromSignature<bytecode::FunctionType>(Signature);
 }
 
@@ -110,7 +93,8 @@ WebAssemblyCallee WebAssemblyTable::get(std::uint32_t Index) const {
   if (isNull(Index)) throw exceptions::BadTableEntry(*this, Index);
   auto *ContextPtr = Storage[Index].ContextPtr;
   auto *FunctionPtr = Storage[Index].FunctionPtr;
-  auto *Signature = Storage[Index].Signature.c_str();
+  // interned signatures are null terminated and never freed
+  auto *Signature = getSignature(Index).data();
   return WebAssemblyCallee(ContextPtr, FunctionPtr, Signature);
 }
 
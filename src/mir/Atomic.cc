@@ -0,0 +1,330 @@
+#include "Atomic.h"
+#include "Module.h"
+
+namespace mir::instructions {
+Atomic::Atomic(
+    AtomicKind Kind_, Memory *LinearMemory_, Instruction *Address_,
+    unsigned Width_)
+    : Instruction(InstructionKind::Atomic), Kind(Kind_), LinearMemory(),
+      Address(), Width(Width_) {
+  setLinearMemory(LinearMemory_);
+  setAddress(Address_);
+}
+
+Atomic::~Atomic() noexcept {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (Address != nullptr) Address->remove_use(this);
+}
+
+AtomicKind Atomic::getAtomicKind() const { return Kind; }
+bool Atomic::isAtomicLoad() const { return Kind == AtomicKind::AtomicLoad; }
+bool Atomic::isAtomicStore() const { return Kind == AtomicKind::AtomicStore; }
+bool Atomic::isAtomicRMW() const { return Kind == AtomicKind::AtomicRMW; }
+
+bool Atomic::isAtomicCmpxchg() const {
+  return Kind == AtomicKind::AtomicCmpxchg;
+}
+
+bool Atomic::isAtomicWait() const { return Kind == AtomicKind::AtomicWait; }
+bool Atomic::isAtomicNotify() const { return Kind == AtomicKind::AtomicNotify; }
+
+Memory *Atomic::getLinearMemory() const { return LinearMemory; }
+void Atomic::setLinearMemory(Memory *LinearMemory_) {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (LinearMemory_ != nullptr) LinearMemory_->add_use(this);
+  LinearMemory = LinearMemory_;
+}
+
+Instruction *Atomic::getAddress() const { return Address; }
+void Atomic::setAddress(Instruction *Address_) {
+  if (Address != nullptr) Address->remove_use(this);
+  if (Address_ != nullptr) Address_->add_use(this);
+  Address = Address_;
+}
+
+unsigned Atomic::getWidth() const { return Width; }
+void Atomic::setWidth(unsigned Width_) { Width = Width_; }
+
+void Atomic::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  if (getLinearMemory() == Old) setLinearMemory(dyn_cast<Memory>(New));
+  if (getAddress() == Old) setAddress(dyn_cast<Instruction>(New));
+}
+
+bool Atomic::classof(Instruction const *Inst) {
+  return Inst->getInstructionKind() == InstructionKind::Atomic;
+}
+
+bool Atomic::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return Atomic::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+} // namespace mir::instructions
+
+namespace mir::instructions::atomic {
+AtomicLoad::AtomicLoad(
+    Memory *LinearMemory_, bytecode::ValueType Type_, Instruction *Address_,
+    unsigned Width_)
+    : Atomic(AtomicKind::AtomicLoad, LinearMemory_, Address_, Width_),
+      Type(Type_) {}
+AtomicLoad::~AtomicLoad() noexcept = default;
+
+bytecode::ValueType const &AtomicLoad::getType() const { return Type; }
+void AtomicLoad::setType(bytecode::ValueType const &Type_) { Type = Type_; }
+
+bool AtomicLoad::classof(Atomic const *Inst) { return Inst->isAtomicLoad(); }
+
+bool AtomicLoad::classof(Instruction const *Inst) {
+  if (Atomic::classof(Inst))
+    return AtomicLoad::classof(dyn_cast<Atomic>(Inst));
+  return false;
+}
+
+bool AtomicLoad::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicLoad::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+AtomicStore::AtomicStore(
+    Memory *LinearMemory_, Instruction *Address_, Instruction *Operand_,
+    unsigned Width_)
+    : Atomic(AtomicKind::AtomicStore, LinearMemory_, Address_, Width_),
+      Operand() {
+  setOperand(Operand_);
+}
+
+AtomicStore::~AtomicStore() noexcept {
+  if (Operand != nullptr) Operand->remove_use(this);
+}
+
+Instruction *AtomicStore::getOperand() const { return Operand; }
+void AtomicStore::setOperand(Instruction *Operand_) {
+  if (Operand != nullptr) Operand->remove_use(this);
+  if (Operand_ != nullptr) Operand_->add_use(this);
+  Operand = Operand_;
+}
+
+void AtomicStore::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  Atomic::replace(Old, New);
+  if (getOperand() == Old) setOperand(dyn_cast<Instruction>(New));
+}
+
+bool AtomicStore::classof(Atomic const *Inst) { return Inst->isAtomicStore(); }
+
+bool AtomicStore::classof(Instruction const *Inst) {
+  if (Atomic::classof(Inst))
+    return AtomicStore::classof(dyn_cast<Atomic>(Inst));
+  return false;
+}
+
+bool AtomicStore::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicStore::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+AtomicRMW::AtomicRMW(
+    AtomicRMWOperator Operator_, Memory *LinearMemory_,
+    bytecode::ValueType Type_, Instruction *Address_, Instruction *Operand_,
+    unsigned Width_)
+    : Atomic(AtomicKind::AtomicRMW, LinearMemory_, Address_, Width_),
+      Operator(Operator_), Type(Type_), Operand() {
+  setOperand(Operand_);
+}
+
+AtomicRMW::~AtomicRMW() noexcept {
+  if (Operand != nullptr) Operand->remove_use(this);
+}
+
+AtomicRMWOperator AtomicRMW::getOperator() const { return Operator; }
+void AtomicRMW::setOperator(AtomicRMWOperator Operator_) {
+  Operator = Operator_;
+}
+
+bytecode::ValueType const &AtomicRMW::getType() const { return Type; }
+void AtomicRMW::setType(bytecode::ValueType const &Type_) { Type = Type_; }
+
+Instruction *AtomicRMW::getOperand() const { return Operand; }
+void AtomicRMW::setOperand(Instruction *Operand_) {
+  if (Operand != nullptr) Operand->remove_use(this);
+  if (Operand_ != nullptr) Operand_->add_use(this);
+  Operand = Operand_;
+}
+
+void AtomicRMW::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  Atomic::replace(Old, New);
+  if (getOperand() == Old) setOperand(dyn_cast<Instruction>(New));
+}
+
+bool AtomicRMW::classof(Atomic const *Inst) { return Inst->isAtomicRMW(); }
+
+bool AtomicRMW::classof(Instruction const *Inst) {
+  if (Atomic::classof(Inst))
+    return AtomicRMW::classof(dyn_cast<Atomic>(Inst));
+  return false;
+}
+
+bool AtomicRMW::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicRMW::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+AtomicCmpxchg::AtomicCmpxchg(
+    Memory *LinearMemory_, bytecode::ValueType Type_, Instruction *Address_,
+    Instruction *Expected_, Instruction *Replacement_, unsigned Width_)
+    : Atomic(AtomicKind::AtomicCmpxchg, LinearMemory_, Address_, Width_),
+      Type(Type_), Expected(), Replacement() {
+  setExpected(Expected_);
+  setReplacement(Replacement_);
+}
+
+AtomicCmpxchg::~AtomicCmpxchg() noexcept {
+  if (Expected != nullptr) Expected->remove_use(this);
+  if (Replacement != nullptr) Replacement->remove_use(this);
+}
+
+bytecode::ValueType const &AtomicCmpxchg::getType() const { return Type; }
+void AtomicCmpxchg::setType(bytecode::ValueType const &Type_) { Type = Type_; }
+
+Instruction *AtomicCmpxchg::getExpected() const { return Expected; }
+void AtomicCmpxchg::setExpected(Instruction *Expected_) {
+  if (Expected != nullptr) Expected->remove_use(this);
+  if (Expected_ != nullptr) Expected_->add_use(this);
+  Expected = Expected_;
+}
+
+Instruction *AtomicCmpxchg::getReplacement() const { return Replacement; }
+void AtomicCmpxchg::setReplacement(Instruction *Replacement_) {
+  if (Replacement != nullptr) Replacement->remove_use(this);
+  if (Replacement_ != nullptr) Replacement_->add_use(this);
+  Replacement = Replacement_;
+}
+
+void AtomicCmpxchg::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  Atomic::replace(Old, New);
+  if (getExpected() == Old) setExpected(dyn_cast<Instruction>(New));
+  if (getReplacement() == Old) setReplacement(dyn_cast<Instruction>(New));
+}
+
+bool AtomicCmpxchg::classof(Atomic const *Inst) {
+  return Inst->isAtomicCmpxchg();
+}
+
+bool AtomicCmpxchg::classof(Instruction const *Inst) {
+  if (Atomic::classof(Inst))
+    return AtomicCmpxchg::classof(dyn_cast<Atomic>(Inst));
+  return false;
+}
+
+bool AtomicCmpxchg::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicCmpxchg::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+AtomicWait::AtomicWait(
+    Memory *LinearMemory_, Instruction *Address_, Instruction *Expected_,
+    Instruction *Timeout_, unsigned Width_)
+    : Atomic(AtomicKind::AtomicWait, LinearMemory_, Address_, Width_),
+      Expected(), Timeout() {
+  setExpected(Expected_);
+  setTimeout(Timeout_);
+}
+
+AtomicWait::~AtomicWait() noexcept {
+  if (Expected != nullptr) Expected->remove_use(this);
+  if (Timeout != nullptr) Timeout->remove_use(this);
+}
+
+Instruction *AtomicWait::getExpected() const { return Expected; }
+void AtomicWait::setExpected(Instruction *Expected_) {
+  if (Expected != nullptr) Expected->remove_use(this);
+  if (Expected_ != nullptr) Expected_->add_use(this);
+  Expected = Expected_;
+}
+
+Instruction *AtomicWait::getTimeout() const { return Timeout; }
+void AtomicWait::setTimeout(Instruction *Timeout_) {
+  if (Timeout != nullptr) Timeout->remove_use(this);
+  if (Timeout_ != nullptr) Timeout_->add_use(this);
+  Timeout = Timeout_;
+}
+
+void AtomicWait::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  Atomic::replace(Old, New);
+  if (getExpected() == Old) setExpected(dyn_cast<Instruction>(New));
+  if (getTimeout() == Old) setTimeout(dyn_cast<Instruction>(New));
+}
+
+bool AtomicWait::classof(Atomic const *Inst) { return Inst->isAtomicWait(); }
+
+bool AtomicWait::classof(Instruction const *Inst) {
+  if (Atomic::classof(Inst))
+    return AtomicWait::classof(dyn_cast<Atomic>(Inst));
+  return false;
+}
+
+bool AtomicWait::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicWait::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+AtomicNotify::AtomicNotify(
+    Memory *LinearMemory_, Instruction *Address_, Instruction *Count_)
+    : Atomic(AtomicKind::AtomicNotify, LinearMemory_, Address_, 32), Count() {
+  setCount(Count_);
+}
+
+AtomicNotify::~AtomicNotify() noexcept {
+  if (Count != nullptr) Count->remove_use(this);
+}
+
+Instruction *AtomicNotify::getCount() const { return Count; }
+void AtomicNotify::setCount(Instruction *Count_) {
+  if (Count != nullptr) Count->remove_use(this);
+  if (Count_ != nullptr) Count_->add_use(this);
+  Count = Count_;
+}
+
+void AtomicNotify::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  Atomic::replace(Old, New);
+  if (getCount() == Old) setCount(dyn_cast<Instruction>(New));
+}
+
+bool AtomicNotify::classof(Atomic const *Inst) {
+  return Inst->isAtomicNotify();
+}
+
+bool AtomicNotify::classof(Instruction const *Inst) {
+  if (Atomic::classof(Inst))
+    return AtomicNotify::classof(dyn_cast<Atomic>(Inst));
+  return false;
+}
+
+bool AtomicNotify::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicNotify::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+} // namespace mir::instructions::atomic
+
+namespace fmt {
+using namespace mir::instructions::atomic;
+char const *
+formatter<AtomicRMWOperator>::toString(AtomicRMWOperator const &Operator) {
+  // clang-format off
+  switch (Operator) {
+  case AtomicRMWOperator::Add : return "add" ;
+  case AtomicRMWOperator::Sub : return "sub" ;
+  case AtomicRMWOperator::And : return "and" ;
+  case AtomicRMWOperator::Or  : return "or"  ;
+  case AtomicRMWOperator::Xor : return "xor" ;
+  case AtomicRMWOperator::Xchg: return "xchg";
+  default: utility::unreachable();
+  }
+  // clang-format on
+}
+} // namespace fmt
\ No newline at end of file
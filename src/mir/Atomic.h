@@ -0,0 +1,248 @@
+#ifndef SABLE_INCLUDE_GUARD_MIR_ATOMIC
+#define SABLE_INCLUDE_GUARD_MIR_ATOMIC
+
+#include "Instruction.h"
+
+#include <fmt/format.h>
+
+namespace mir::instructions {
+enum class AtomicKind {
+  AtomicLoad,
+  AtomicStore,
+  AtomicRMW,
+  AtomicCmpxchg,
+  AtomicWait,
+  AtomicNotify
+};
+
+// Sequentially consistent accesses to a (shared) linear memory. Width is the
+// access width in bits, narrow accesses zero extend their results.
+class Atomic : public Instruction {
+  AtomicKind Kind;
+  Memory *LinearMemory;
+  Instruction *Address;
+  unsigned Width;
+
+public:
+  Atomic(
+      AtomicKind Kind_, Memory *LinearMemory_, Instruction *Address_,
+      unsigned Width_);
+  Atomic(Atomic const &) = delete;
+  Atomic(Atomic &&) noexcept = delete;
+  Atomic &operator=(Atomic const &) = delete;
+  Atomic &operator=(Atomic &&) noexcept = delete;
+  ~Atomic() noexcept override;
+
+  AtomicKind getAtomicKind() const;
+  bool isAtomicLoad() const;
+  bool isAtomicStore() const;
+  bool isAtomicRMW() const;
+  bool isAtomicCmpxchg() const;
+  bool isAtomicWait() const;
+  bool isAtomicNotify() const;
+
+  Memory *getLinearMemory() const;
+  void setLinearMemory(Memory *LinearMemory_);
+  Instruction *getAddress() const;
+  void setAddress(Instruction *Address_);
+  unsigned getWidth() const;
+  void setWidth(unsigned Width_);
+
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+SABLE_DEFINE_IS_A(Atomic)
+SABLE_DEFINE_DYN_CAST(Atomic)
+
+namespace atomic {
+class AtomicLoad : public Atomic {
+  bytecode::ValueType Type;
+
+public:
+  AtomicLoad(
+      Memory *LinearMemory_, bytecode::ValueType Type_, Instruction *Address_,
+      unsigned Width_);
+  AtomicLoad(AtomicLoad const &) = delete;
+  AtomicLoad(AtomicLoad &&) noexcept = delete;
+  AtomicLoad &operator=(AtomicLoad const &) = delete;
+  AtomicLoad &operator=(AtomicLoad &&) noexcept = delete;
+  ~AtomicLoad() noexcept override;
+
+  bytecode::ValueType const &getType() const;
+  void setType(bytecode::ValueType const &Type_);
+
+  static bool classof(Atomic const *Inst);
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+class AtomicStore : public Atomic {
+  Instruction *Operand;
+
+public:
+  AtomicStore(
+      Memory *LinearMemory_, Instruction *Address_, Instruction *Operand_,
+      unsigned Width_);
+  AtomicStore(AtomicStore const &) = delete;
+  AtomicStore(AtomicStore &&) noexcept = delete;
+  AtomicStore &operator=(AtomicStore const &) = delete;
+  AtomicStore &operator=(AtomicStore &&) noexcept = delete;
+  ~AtomicStore() noexcept override;
+
+  Instruction *getOperand() const;
+  void setOperand(Instruction *Operand_);
+
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Atomic const *Inst);
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+enum class AtomicRMWOperator : std::uint8_t { Add, Sub, And, Or, Xor, Xchg };
+class AtomicRMW : public Atomic {
+  AtomicRMWOperator Operator;
+  bytecode::ValueType Type;
+  Instruction *Operand;
+
+public:
+  AtomicRMW(
+      AtomicRMWOperator Operator_, Memory *LinearMemory_,
+      bytecode::ValueType Type_, Instruction *Address_, Instruction *Operand_,
+      unsigned Width_);
+  AtomicRMW(AtomicRMW const &) = delete;
+  AtomicRMW(AtomicRMW &&) noexcept = delete;
+  AtomicRMW &operator=(AtomicRMW const &) = delete;
+  AtomicRMW &operator=(AtomicRMW &&) noexcept = delete;
+  ~AtomicRMW() noexcept override;
+
+  AtomicRMWOperator getOperator() const;
+  void setOperator(AtomicRMWOperator Operator_);
+  bytecode::ValueType const &getType() const;
+  void setType(bytecode::ValueType const &Type_);
+  Instruction *getOperand() const;
+  void setOperand(Instruction *Operand_);
+
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Atomic const *Inst);
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+class AtomicCmpxchg : public Atomic {
+  bytecode::ValueType Type;
+  Instruction *Expected;
+  Instruction *Replacement;
+
+public:
+  AtomicCmpxchg(
+      Memory *LinearMemory_, bytecode::ValueType Type_, Instruction *Address_,
+      Instruction *Expected_, Instruction *Replacement_, unsigned Width_);
+  AtomicCmpxchg(AtomicCmpxchg const &) = delete;
+  AtomicCmpxchg(AtomicCmpxchg &&) noexcept = delete;
+  AtomicCmpxchg &operator=(AtomicCmpxchg const &) = delete;
+  AtomicCmpxchg &operator=(AtomicCmpxchg &&) noexcept = delete;
+  ~AtomicCmpxchg() noexcept override;
+
+  bytecode::ValueType const &getType() const;
+  void setType(bytecode::ValueType const &Type_);
+  Instruction *getExpected() const;
+  void setExpected(Instruction *Expected_);
+  Instruction *getReplacement() const;
+  void setReplacement(Instruction *Replacement_);
+
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Atomic const *Inst);
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+// memory.atomic.wait32 and memory.atomic.wait64, Width selects the flavour
+class AtomicWait : public Atomic {
+  Instruction *Expected;
+  Instruction *Timeout;
+
+public:
+  AtomicWait(
+      Memory *LinearMemory_, Instruction *Address_, Instruction *Expected_,
+      Instruction *Timeout_, unsigned Width_);
+  AtomicWait(AtomicWait const &) = delete;
+  AtomicWait(AtomicWait &&) noexcept = delete;
+  AtomicWait &operator=(AtomicWait const &) = delete;
+  AtomicWait &operator=(AtomicWait &&) noexcept = delete;
+  ~AtomicWait() noexcept override;
+
+  Instruction *getExpected() const;
+  void setExpected(Instruction *Expected_);
+  Instruction *getTimeout() const;
+  void setTimeout(Instruction *Timeout_);
+
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Atomic const *Inst);
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+class AtomicNotify : public Atomic {
+  Instruction *Count;
+
+public:
+  AtomicNotify(
+      Memory *LinearMemory_, Instruction *Address_, Instruction *Count_);
+  AtomicNotify(AtomicNotify const &) = delete;
+  AtomicNotify(AtomicNotify &&) noexcept = delete;
+  AtomicNotify &operator=(AtomicNotify const &) = delete;
+  AtomicNotify &operator=(AtomicNotify &&) noexcept = delete;
+  ~AtomicNotify() noexcept override;
+
+  Instruction *getCount() const;
+  void setCount(Instruction *Count_);
+
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Atomic const *Inst);
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+} // namespace atomic
+
+template <typename Derived, typename RetType = void, bool Const = true>
+class AtomicVisitorBase {
+  Derived &derived() { return static_cast<Derived &>(*this); }
+  template <typename T> using Ptr = std::conditional_t<Const, T const *, T *>;
+  template <typename T> RetType castAndCall(Ptr<Atomic> Inst) {
+    return derived()(dyn_cast<T>(Inst));
+  }
+
+public:
+  RetType visit(Ptr<Atomic> Inst) {
+    using namespace atomic;
+    using AKind = AtomicKind;
+    // clang-format off
+    switch (Inst->getAtomicKind()) {
+    case AKind::AtomicLoad   : return castAndCall<AtomicLoad>(Inst);
+    case AKind::AtomicStore  : return castAndCall<AtomicStore>(Inst);
+    case AKind::AtomicRMW    : return castAndCall<AtomicRMW>(Inst);
+    case AKind::AtomicCmpxchg: return castAndCall<AtomicCmpxchg>(Inst);
+    case AKind::AtomicWait   : return castAndCall<AtomicWait>(Inst);
+    case AKind::AtomicNotify : return castAndCall<AtomicNotify>(Inst);
+    default: utility::unreachable();
+    }
+    // clang-format on
+  }
+};
+} // namespace mir::instructions
+
+namespace fmt {
+template <> struct formatter<mir::instructions::atomic::AtomicRMWOperator> {
+  using AtomicRMWOperator = mir::instructions::atomic::AtomicRMWOperator;
+  char const *toString(AtomicRMWOperator const &Operator);
+  template <typename CTX> auto parse(CTX &&C) { return C.begin(); }
+  template <typename CTX>
+  auto format(AtomicRMWOperator const &Operator, CTX &&C) {
+    return fmt::format_to(C.out(), toString(Operator));
+  }
+};
+} // namespace fmt
+
+#endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "BasicBlock.h"
+#include "Atomic.h"
 #include "Binary.h"
 #include "Branch.h"
 #include "Cast.h"
@@ -50,8 +51,8 @@ void BasicBlock::splice(
 }
 
 void BasicBlock::splice(iterator Pos, pointer InstPtr) {
-  InstPtr->Parent = this;
   auto &BasicBlock = *InstPtr->getParent();
+  InstPtr->Parent = this;
   Instructions.splice(Pos, BasicBlock.Instructions, InstPtr);
 }
 
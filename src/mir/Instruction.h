@@ -18,6 +18,7 @@ class Function;
 class Global;
 class Table;
 class Memory;
+class Data;
 
 class BasicBlock;
 class Local;
@@ -130,9 +131,15 @@ enum class InstructionKind : std::uint8_t {
   MemoryGuard,
   MemorySize,
   MemoryGrow,
+  MemoryInit,
+  DataDrop,
+  MemoryCopy,
+  MemoryFill,
   VectorSplat,
   VectorExtract,
   VectorInsert,
+  Atomic,
+  AtomicFence,
 
   SIMD128ShuffleByte,
   SIMD128Narrow,
@@ -172,6 +179,7 @@ SABLE_DEFINE_DYN_CAST(Instruction)
 namespace mir::instructions {
 class Branch;             // See Branch.h
 class Compare;            // See Compare.h
+class Atomic;             // See Atomic.h
 class Unary;              // See Unary.h
 class Binary;             // See Binary.h
 class VectorSplat;        // See Vector.h
@@ -212,9 +220,11 @@ public:
 };
 
 //////////////////////////////////// Call //////////////////////////////////////
+// A tail call is immediately followed by a Return of its result
 class Call : public Instruction {
   Function *Target;
   std::vector<Instruction *> Arguments;
+  bool TailCall = false;
 
 public:
   Call(Function *Target_, std::span<Instruction *const> Arguments_);
@@ -230,17 +240,21 @@ public:
   Instruction *getArgument(std::size_t Index) const;
   void setArguments(std::span<Instruction *const> Arguments_);
   void setArgument(std::size_t Index, Instruction *Argument);
+  bool isTailCall() const;
+  void setTailCall(bool TailCall_);
   void replace(ASTNode const *Old, ASTNode *New) noexcept override;
   static bool classof(Instruction const *Inst);
   static bool classof(ASTNode const *Node);
 };
 
 /////////////////////////////// CallIndirect ///////////////////////////////////
+// A tail call is immediately followed by a Return of its result
 class CallIndirect : public Instruction {
   Table *IndirectTable;
   Instruction *Operand;
   bytecode::FunctionType ExpectType;
   std::vector<Instruction *> Arguments;
+  bool TailCall = false;
 
 public:
   CallIndirect(
@@ -263,6 +277,8 @@ public:
   Instruction *getArgument(std::size_t Index) const;
   void setArguments(std::span<Instruction *const> Arguments_);
   void setArgument(std::size_t Index, Instruction *Argument);
+  bool isTailCall() const;
+  void setTailCall(bool TailCall_);
   void replace(ASTNode const *Old, ASTNode *New) noexcept override;
   static bool classof(Instruction const *Inst);
   static bool classof(ASTNode const *Node);
@@ -507,6 +523,15 @@ public:
   static bool classof(ASTNode const *Node);
 };
 
+/////////////////////////////// AtomicFence ////////////////////////////////////
+class AtomicFence : public Instruction {
+public:
+  AtomicFence();
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
 /////////////////////////////// MemorySize /////////////////////////////////////
 class MemorySize : public Instruction {
   Memory *LinearMemory;
@@ -525,6 +550,121 @@ public:
   static bool classof(ASTNode const *Node);
 };
 
+/////////////////////////////// MemoryInit /////////////////////////////////////
+// copies Size bytes at Offset of a data segment to Destination
+class MemoryInit : public Instruction {
+  Memory *LinearMemory;
+  Data *Segment;
+  Instruction *Destination;
+  Instruction *Offset;
+  Instruction *Size;
+
+public:
+  MemoryInit(
+      Memory *LinearMemory_, Data *Segment_, Instruction *Destination_,
+      Instruction *Offset_, Instruction *Size_);
+  MemoryInit(MemoryInit const &) = delete;
+  MemoryInit(MemoryInit &&) noexcept = delete;
+  MemoryInit &operator=(MemoryInit const &) = delete;
+  MemoryInit &operator=(MemoryInit &&) noexcept = delete;
+  ~MemoryInit() noexcept override;
+  Memory *getLinearMemory() const;
+  void setLinearMemory(Memory *LinearMemory_);
+  Data *getSegment() const;
+  void setSegment(Data *Segment_);
+  Instruction *getDestination() const;
+  void setDestination(Instruction *Destination_);
+  Instruction *getOffset() const;
+  void setOffset(Instruction *Offset_);
+  Instruction *getSize() const;
+  void setSize(Instruction *Size_);
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+//////////////////////////////// DataDrop //////////////////////////////////////
+class DataDrop : public Instruction {
+  Data *Segment;
+
+public:
+  explicit DataDrop(Data *Segment_);
+  DataDrop(DataDrop const &) = delete;
+  DataDrop(DataDrop &&) noexcept = delete;
+  DataDrop &operator=(DataDrop const &) = delete;
+  DataDrop &operator=(DataDrop &&) noexcept = delete;
+  ~DataDrop() noexcept override;
+  Data *getSegment() const;
+  void setSegment(Data *Segment_);
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+/////////////////////////////// MemoryCopy /////////////////////////////////////
+// LinearMemory is the destination memory, Source and Destination may overlap
+// if both sides are the same memory
+class MemoryCopy : public Instruction {
+  Memory *LinearMemory;
+  Memory *SourceMemory;
+  Instruction *Destination;
+  Instruction *Source;
+  Instruction *Size;
+
+public:
+  MemoryCopy(
+      Memory *LinearMemory_, Memory *SourceMemory_, Instruction *Destination_,
+      Instruction *Source_, Instruction *Size_);
+  MemoryCopy(MemoryCopy const &) = delete;
+  MemoryCopy(MemoryCopy &&) noexcept = delete;
+  MemoryCopy &operator=(MemoryCopy const &) = delete;
+  MemoryCopy &operator=(MemoryCopy &&) noexcept = delete;
+  ~MemoryCopy() noexcept override;
+  Memory *getLinearMemory() const;
+  void setLinearMemory(Memory *LinearMemory_);
+  Memory *getSourceMemory() const;
+  void setSourceMemory(Memory *SourceMemory_);
+  Instruction *getDestination() const;
+  void setDestination(Instruction *Destination_);
+  Instruction *getSource() const;
+  void setSource(Instruction *Source_);
+  Instruction *getSize() const;
+  void setSize(Instruction *Size_);
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
+/////////////////////////////// MemoryFill /////////////////////////////////////
+// only the lowest byte of Value is stored
+class MemoryFill : public Instruction {
+  Memory *LinearMemory;
+  Instruction *Destination;
+  Instruction *Value;
+  Instruction *Size;
+
+public:
+  MemoryFill(
+      Memory *LinearMemory_, Instruction *Destination_, Instruction *Value_,
+      Instruction *Size_);
+  MemoryFill(MemoryFill const &) = delete;
+  MemoryFill(MemoryFill &&) noexcept = delete;
+  MemoryFill &operator=(MemoryFill const &) = delete;
+  MemoryFill &operator=(MemoryFill &&) noexcept = delete;
+  ~MemoryFill() noexcept override;
+  Memory *getLinearMemory() const;
+  void setLinearMemory(Memory *LinearMemory_);
+  Instruction *getDestination() const;
+  void setDestination(Instruction *Destination_);
+  Instruction *getValue() const;
+  void setValue(Instruction *Value_);
+  Instruction *getSize() const;
+  void setSize(Instruction *Size_);
+  void replace(ASTNode const *Old, ASTNode *New) noexcept override;
+  static bool classof(Instruction const *Inst);
+  static bool classof(ASTNode const *Node);
+};
+
 ///////////////////////////////// Packed ///////////////////////////////////////
 class Pack : public Instruction {
   std::vector<Instruction *> Arguments;
@@ -629,6 +769,10 @@ public:
     case IKind::MemoryGuard  : return castAndCall<MemoryGuard>(Inst);
     case IKind::MemoryGrow   : return castAndCall<MemoryGrow>(Inst);
     case IKind::MemorySize   : return castAndCall<MemorySize>(Inst);
+    case IKind::MemoryInit   : return castAndCall<MemoryInit>(Inst);
+    case IKind::DataDrop     : return castAndCall<DataDrop>(Inst);
+    case IKind::MemoryCopy   : return castAndCall<MemoryCopy>(Inst);
+    case IKind::MemoryFill   : return castAndCall<MemoryFill>(Inst);
     case IKind::Cast         : return castAndCall<Cast>(Inst);
     case IKind::Pack         : return castAndCall<Pack>(Inst);
     case IKind::Unpack       : return castAndCall<Unpack>(Inst);
@@ -636,6 +780,8 @@ public:
     case IKind::VectorSplat  : return castAndCall<VectorSplat>(Inst);
     case IKind::VectorExtract: return castAndCall<VectorExtract>(Inst);
     case IKind::VectorInsert : return castAndCall<VectorInsert>(Inst);
+    case IKind::Atomic       : return castAndCall<Atomic>(Inst);
+    case IKind::AtomicFence  : return castAndCall<AtomicFence>(Inst);
     case IKind::SIMD128ShuffleByte: 
       return castAndCall<SIMD128ShuffleByte>(Inst);
     default: utility::unreachable();
@@ -104,6 +104,9 @@ void Call::setArgument(std::size_t Index, Instruction *Argument) {
   Arguments[Index] = Argument;
 }
 
+bool Call::isTailCall() const { return TailCall; }
+void Call::setTailCall(bool TailCall_) { TailCall = TailCall_; }
+
 void Call::replace(ASTNode const *Old, ASTNode *New) noexcept {
   if (getTarget() == Old) setTarget(dyn_cast<Function>(New));
   for (std::size_t I = 0; I < getNumArguments(); ++I)
@@ -187,6 +190,9 @@ void CallIndirect::setArgument(std::size_t Index, Instruction *Argument) {
   Arguments[Index] = Argument;
 }
 
+bool CallIndirect::isTailCall() const { return TailCall; }
+void CallIndirect::setTailCall(bool TailCall_) { TailCall = TailCall_; }
+
 void CallIndirect::replace(ASTNode const *Old, ASTNode *New) noexcept {
   if (getIndirectTable() == Old) setIndirectTable(dyn_cast<Table>(New));
   if (getOperand() == Old) setOperand(dyn_cast<Instruction>(New));
@@ -654,6 +660,23 @@ bool MemoryGrow::classof(ASTNode const *Node) {
   return false;
 }
 
+/////////////////////////////// AtomicFence ////////////////////////////////////
+AtomicFence::AtomicFence() : Instruction(IKind::AtomicFence) {}
+
+void AtomicFence::replace(ASTNode const *, ASTNode *) noexcept {
+  utility::unreachable();
+}
+
+bool AtomicFence::classof(Instruction const *Inst) {
+  return Inst->getInstructionKind() == IKind::AtomicFence;
+}
+
+bool AtomicFence::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return AtomicFence::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
 /////////////////////////////// MemorySize /////////////////////////////////////
 MemorySize::MemorySize(Memory *LinearMemory_)
     : Instruction(InstructionKind::MemorySize), LinearMemory() {
@@ -686,6 +709,252 @@ bool MemorySize::classof(ASTNode const *Node) {
   return false;
 }
 
+////////////////////////////////// MemoryInit //////////////////////////////////
+MemoryInit::MemoryInit(
+    Memory *LinearMemory_, Data *Segment_, Instruction *Destination_,
+    Instruction *Offset_, Instruction *Size_)
+    : Instruction(IKind::MemoryInit), LinearMemory(), Segment(), Destination(),
+      Offset(), Size() {
+  setLinearMemory(LinearMemory_);
+  setSegment(Segment_);
+  setDestination(Destination_);
+  setOffset(Offset_);
+  setSize(Size_);
+}
+
+MemoryInit::~MemoryInit() noexcept {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (Segment != nullptr) Segment->remove_use(this);
+  if (Destination != nullptr) Destination->remove_use(this);
+  if (Offset != nullptr) Offset->remove_use(this);
+  if (Size != nullptr) Size->remove_use(this);
+}
+
+Memory *MemoryInit::getLinearMemory() const { return LinearMemory; }
+Data *MemoryInit::getSegment() const { return Segment; }
+Instruction *MemoryInit::getDestination() const { return Destination; }
+Instruction *MemoryInit::getOffset() const { return Offset; }
+Instruction *MemoryInit::getSize() const { return Size; }
+
+void MemoryInit::setLinearMemory(Memory *LinearMemory_) {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (LinearMemory_ != nullptr) LinearMemory_->add_use(this);
+  LinearMemory = LinearMemory_;
+}
+
+void MemoryInit::setSegment(Data *Segment_) {
+  if (Segment != nullptr) Segment->remove_use(this);
+  if (Segment_ != nullptr) Segment_->add_use(this);
+  Segment = Segment_;
+}
+
+void MemoryInit::setDestination(Instruction *Destination_) {
+  if (Destination != nullptr) Destination->remove_use(this);
+  if (Destination_ != nullptr) Destination_->add_use(this);
+  Destination = Destination_;
+}
+
+void MemoryInit::setOffset(Instruction *Offset_) {
+  if (Offset != nullptr) Offset->remove_use(this);
+  if (Offset_ != nullptr) Offset_->add_use(this);
+  Offset = Offset_;
+}
+
+void MemoryInit::setSize(Instruction *Size_) {
+  if (Size != nullptr) Size->remove_use(this);
+  if (Size_ != nullptr) Size_->add_use(this);
+  Size = Size_;
+}
+
+void MemoryInit::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  if (getLinearMemory() == Old) setLinearMemory(dyn_cast<Memory>(New));
+  if (getSegment() == Old) setSegment(dyn_cast<Data>(New));
+  if (getDestination() == Old) setDestination(dyn_cast<Instruction>(New));
+  if (getOffset() == Old) setOffset(dyn_cast<Instruction>(New));
+  if (getSize() == Old) setSize(dyn_cast<Instruction>(New));
+}
+
+bool MemoryInit::classof(Instruction const *Inst) {
+  return Inst->getInstructionKind() == IKind::MemoryInit;
+}
+
+bool MemoryInit::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return MemoryInit::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+/////////////////////////////////// DataDrop ///////////////////////////////////
+DataDrop::DataDrop(Data *Segment_) : Instruction(IKind::DataDrop), Segment() {
+  setSegment(Segment_);
+}
+
+DataDrop::~DataDrop() noexcept {
+  if (Segment != nullptr) Segment->remove_use(this);
+}
+
+Data *DataDrop::getSegment() const { return Segment; }
+
+void DataDrop::setSegment(Data *Segment_) {
+  if (Segment != nullptr) Segment->remove_use(this);
+  if (Segment_ != nullptr) Segment_->add_use(this);
+  Segment = Segment_;
+}
+
+void DataDrop::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  if (getSegment() == Old) setSegment(dyn_cast<Data>(New));
+}
+
+bool DataDrop::classof(Instruction const *Inst) {
+  return Inst->getInstructionKind() == IKind::DataDrop;
+}
+
+bool DataDrop::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return DataDrop::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+////////////////////////////////// MemoryCopy //////////////////////////////////
+MemoryCopy::MemoryCopy(
+    Memory *LinearMemory_, Memory *SourceMemory_, Instruction *Destination_,
+    Instruction *Source_, Instruction *Size_)
+    : Instruction(IKind::MemoryCopy), LinearMemory(), SourceMemory(),
+      Destination(), Source(), Size() {
+  setLinearMemory(LinearMemory_);
+  setSourceMemory(SourceMemory_);
+  setDestination(Destination_);
+  setSource(Source_);
+  setSize(Size_);
+}
+
+MemoryCopy::~MemoryCopy() noexcept {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (SourceMemory != nullptr) SourceMemory->remove_use(this);
+  if (Destination != nullptr) Destination->remove_use(this);
+  if (Source != nullptr) Source->remove_use(this);
+  if (Size != nullptr) Size->remove_use(this);
+}
+
+Memory *MemoryCopy::getLinearMemory() const { return LinearMemory; }
+Memory *MemoryCopy::getSourceMemory() const { return SourceMemory; }
+Instruction *MemoryCopy::getDestination() const { return Destination; }
+Instruction *MemoryCopy::getSource() const { return Source; }
+Instruction *MemoryCopy::getSize() const { return Size; }
+
+void MemoryCopy::setLinearMemory(Memory *LinearMemory_) {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (LinearMemory_ != nullptr) LinearMemory_->add_use(this);
+  LinearMemory = LinearMemory_;
+}
+
+void MemoryCopy::setSourceMemory(Memory *SourceMemory_) {
+  if (SourceMemory != nullptr) SourceMemory->remove_use(this);
+  if (SourceMemory_ != nullptr) SourceMemory_->add_use(this);
+  SourceMemory = SourceMemory_;
+}
+
+void MemoryCopy::setDestination(Instruction *Destination_) {
+  if (Destination != nullptr) Destination->remove_use(this);
+  if (Destination_ != nullptr) Destination_->add_use(this);
+  Destination = Destination_;
+}
+
+void MemoryCopy::setSource(Instruction *Source_) {
+  if (Source != nullptr) Source->remove_use(this);
+  if (Source_ != nullptr) Source_->add_use(this);
+  Source = Source_;
+}
+
+void MemoryCopy::setSize(Instruction *Size_) {
+  if (Size != nullptr) Size->remove_use(this);
+  if (Size_ != nullptr) Size_->add_use(this);
+  Size = Size_;
+}
+
+void MemoryCopy::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  if (getLinearMemory() == Old) setLinearMemory(dyn_cast<Memory>(New));
+  if (getSourceMemory() == Old) setSourceMemory(dyn_cast<Memory>(New));
+  if (getDestination() == Old) setDestination(dyn_cast<Instruction>(New));
+  if (getSource() == Old) setSource(dyn_cast<Instruction>(New));
+  if (getSize() == Old) setSize(dyn_cast<Instruction>(New));
+}
+
+bool MemoryCopy::classof(Instruction const *Inst) {
+  return Inst->getInstructionKind() == IKind::MemoryCopy;
+}
+
+bool MemoryCopy::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return MemoryCopy::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
+////////////////////////////////// MemoryFill //////////////////////////////////
+MemoryFill::MemoryFill(
+    Memory *LinearMemory_, Instruction *Destination_, Instruction *Value_,
+    Instruction *Size_)
+    : Instruction(IKind::MemoryFill), LinearMemory(), Destination(), Value(),
+      Size() {
+  setLinearMemory(LinearMemory_);
+  setDestination(Destination_);
+  setValue(Value_);
+  setSize(Size_);
+}
+
+MemoryFill::~MemoryFill() noexcept {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (Destination != nullptr) Destination->remove_use(this);
+  if (Value != nullptr) Value->remove_use(this);
+  if (Size != nullptr) Size->remove_use(this);
+}
+
+Memory *MemoryFill::getLinearMemory() const { return LinearMemory; }
+Instruction *MemoryFill::getDestination() const { return Destination; }
+Instruction *MemoryFill::getValue() const { return Value; }
+Instruction *MemoryFill::getSize() const { return Size; }
+
+void MemoryFill::setLinearMemory(Memory *LinearMemory_) {
+  if (LinearMemory != nullptr) LinearMemory->remove_use(this);
+  if (LinearMemory_ != nullptr) LinearMemory_->add_use(this);
+  LinearMemory = LinearMemory_;
+}
+
+void MemoryFill::setDestination(Instruction *Destination_) {
+  if (Destination != nullptr) Destination->remove_use(this);
+  if (Destination_ != nullptr) Destination_->add_use(this);
+  Destination = Destination_;
+}
+
+void MemoryFill::setValue(Instruction *Value_) {
+  if (Value != nullptr) Value->remove_use(this);
+  if (Value_ != nullptr) Value_->add_use(this);
+  Value = Value_;
+}
+
+void MemoryFill::setSize(Instruction *Size_) {
+  if (Size != nullptr) Size->remove_use(this);
+  if (Size_ != nullptr) Size_->add_use(this);
+  Size = Size_;
+}
+
+void MemoryFill::replace(ASTNode const *Old, ASTNode *New) noexcept {
+  if (getLinearMemory() == Old) setLinearMemory(dyn_cast<Memory>(New));
+  if (getDestination() == Old) setDestination(dyn_cast<Instruction>(New));
+  if (getValue() == Old) setValue(dyn_cast<Instruction>(New));
+  if (getSize() == Old) setSize(dyn_cast<Instruction>(New));
+}
+
+bool MemoryFill::classof(Instruction const *Inst) {
+  return Inst->getInstructionKind() == IKind::MemoryFill;
+}
+
+bool MemoryFill::classof(ASTNode const *Node) {
+  if (Instruction::classof(Node))
+    return MemoryFill::classof(dyn_cast<Instruction>(Node));
+  return false;
+}
+
 ////////////////////////////////// Pack ////////////////////////////////////////
 Pack::Pack(std::span<Instruction *const> Arguments_)
     : Instruction(IKind::Pack) {
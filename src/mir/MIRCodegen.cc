@@ -1,4 +1,5 @@
 #include "MIRCodegen.h"
+#include "Atomic.h"
 #include "Binary.h"
 #include "Branch.h"
 #include "Cast.h"
@@ -12,6 +13,8 @@
 #include <range/v3/view/enumerate.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include <limits>
+
 namespace mir::bytecode_codegen {
 using namespace bytecode::valuetypes;
 namespace minsts = mir::instructions;
@@ -97,11 +100,18 @@ EntityLayout::EntityLayout(bytecode::Module const &BModule, Module &MModule)
     Functions.push_back(MFunction);
   }
   for (auto const &BDataSegment : BModuleView.module().Data) {
+    if (BDataSegment.Mode == bytecode::entities::DataMode::Passive) {
+      auto *MDataSegment = MModule.BuildDataSegment(nullptr);
+      MDataSegment->setContent(BDataSegment.Initializer);
+      DataSegments.push_back(MDataSegment);
+      continue;
+    }
     auto Offset = solveInitializerExpr(BDataSegment.Offset);
     auto *Target = this->operator[](BDataSegment.Memory);
     auto *MDataSegment = MModule.BuildDataSegment(std::move(Offset));
     MDataSegment->setContent(BDataSegment.Initializer);
     Target->addInitializer(MDataSegment);
+    DataSegments.push_back(MDataSegment);
   }
   for (auto const &BElementSegment : BModuleView.module().Elements) {
     auto Offset = solveInitializerExpr(BElementSegment.Offset);
@@ -136,21 +146,15 @@ Global *EntityLayout::operator[](bytecode::GlobalIDX Index) const {
   return detail::getFromContainer(Globals, Index);
 }
 
+Data *EntityLayout::operator[](bytecode::DataIDX Index) const {
+  return detail::getFromContainer(DataSegments, Index);
+}
+
 bytecode::FunctionType const *
 EntityLayout::operator[](bytecode::TypeIDX Index) const {
   return BModuleView[Index];
 }
 
-Memory *EntityLayout::getImplicitMemory() const {
-  assert(!Memories.empty());
-  return Memories.front();
-}
-
-Table *EntityLayout::getImplicitTable() const {
-  assert(!Tables.empty());
-  return Tables.front();
-}
-
 ////////////////////////// FunctionTranslationTask /////////////////////////////
 namespace {
 namespace detail {
@@ -174,6 +178,8 @@ bool isTerminatingInstruction(bytecode::Instruction const *Inst) {
   switch (Inst->getOpcode()) {
   case bytecode::Opcode::Unreachable:
   case bytecode::Opcode::Return:
+  case bytecode::Opcode::ReturnCall:
+  case bytecode::Opcode::ReturnCallIndirect:
   case bytecode::Opcode::Br:
   case bytecode::Opcode::BrTable: return true;
   default: return false;
@@ -239,6 +245,7 @@ public:
   Memory *operator[](bytecode::MemIDX Index) const { return E[Index]; }
   Table *operator[](bytecode::TableIDX Index) const { return E[Index]; }
   Global *operator[](bytecode::GlobalIDX Index) const { return E[Index]; }
+  Data *operator[](bytecode::DataIDX Index) const { return E[Index]; }
   bytecode::FunctionType const *operator[](bytecode::TypeIDX Index) const {
     return E[Index];
   }
@@ -261,9 +268,6 @@ public:
   }
   void pop() { Labels.pop_back(); }
   bool empty() const { return Labels.empty(); }
-
-  Memory *getImplicitMemory() const { return E.getImplicitMemory(); }
-  Table *getImplicitTable() const { return E.getImplicitTable(); }
 };
 
 class FunctionTranslationTask::TranslationVisitor :
@@ -291,6 +295,53 @@ class FunctionTranslationTask::TranslationVisitor :
     utility::unreachable();
   }
 
+  /* Returns the effective address Address + Offset of a Width bits access,
+   * guarded against the memory size.
+   * The index itself is guarded with the offset folded into the guard size,
+   * which lowers to a single compare of the index when a guard region covers
+   * the rest of the access. 32-bit indices are zero extended and the sum is
+   * taken in 64 bits, so it never wraps around as wasm requires. The sum is
+   * only guarded when the offset does not fit in the guard size, a 64-bit
+   * index is then known to be below the memory size, at most 2^48 bytes, and
+   * offsets past that always trap.
+   */
+  Instruction *buildGuardedAddress(
+      Memory *Mem, Instruction *Address, std::uint64_t Offset,
+      unsigned Width) {
+    auto IsMemory64 = Mem->getType().isMemory64();
+    constexpr std::uint64_t MaxMemory64Offset = std::uint64_t(1) << 48;
+    auto MaxFoldedOffset =
+        (std::numeric_limits<std::uint32_t>::max() - Width) / 8;
+    if (Offset <= MaxFoldedOffset) {
+      auto GuardSize = static_cast<std::uint32_t>(Offset * 8 + Width);
+      CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(
+          Mem, Address, GuardSize);
+      if (Offset == 0) return Address;
+    }
+    auto *Index = Address;
+    if (!IsMemory64)
+      Index = CurrentBasicBlock->BuildInst<minsts::Cast>(
+          minsts::CastOpcode::I64ExtendI32U, Address);
+    auto *OffsetConstant = CurrentBasicBlock->BuildInst<minsts::Constant>(
+        static_cast<std::int64_t>(Offset));
+    auto *EffectiveAddress =
+        CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(
+            minsts::binary::IntBinaryOperator::Add, Index, OffsetConstant);
+    if (Offset <= MaxFoldedOffset) return EffectiveAddress;
+    if (!IsMemory64) {
+      CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(
+          Mem, EffectiveAddress, Width);
+    } else if (Offset < MaxMemory64Offset) {
+      CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(Mem, Address, Width);
+      CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(
+          Mem, EffectiveAddress, Width);
+    } else {
+      CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(
+          Mem, OffsetConstant, Width);
+    }
+    return EffectiveAddress;
+  }
+
 public:
   TranslationVisitor(
       TranslationContext &Context_, BasicBlock *CurrentBasicBlock_,
@@ -521,7 +572,7 @@ public:
 
   void operator()(binsts::CallIndirect const *Inst) {
     auto const *Type = Context[Inst->Type];
-    auto *Table = Context.getImplicitTable();
+    auto *Table = Context[Inst->Table];
     auto *Operand = values().pop();
     auto NumArguments = Type->getParamTypes().size();
     auto Arguments =
@@ -540,6 +591,45 @@ public:
     }
   }
 
+  // The callee results are the results of the enclosing function, return
+  // them right away instead of merging them into the exit block so that the
+  // call stays in tail position.
+  void
+  buildTailReturn(Instruction *Result, bytecode::FunctionType const &Type) {
+    if (Type.isVoidResult()) {
+      CurrentBasicBlock->BuildInst<minsts::Return>();
+    } else {
+      CurrentBasicBlock->BuildInst<minsts::Return>(Result);
+    }
+    values().clear();
+  }
+
+  void operator()(binsts::ReturnCall const *Inst) {
+    auto *Target = Context[Inst->Target];
+    auto NumArguments = Target->getType().getParamTypes().size();
+    auto Arguments =
+        ranges::to<std::vector<Instruction *>>(values().peek(NumArguments));
+    values().pop(NumArguments);
+    auto *Result =
+        CurrentBasicBlock->BuildInst<minsts::Call>(Target, Arguments);
+    Result->setTailCall(true);
+    buildTailReturn(Result, Target->getType());
+  }
+
+  void operator()(binsts::ReturnCallIndirect const *Inst) {
+    auto const *Type = Context[Inst->Type];
+    auto *Table = Context[Inst->Table];
+    auto *Operand = values().pop();
+    auto NumArguments = Type->getParamTypes().size();
+    auto Arguments =
+        ranges::to<std::vector<Instruction *>>(values().peek(NumArguments));
+    values().pop(NumArguments);
+    auto *Result = CurrentBasicBlock->BuildInst<minsts::CallIndirect>(
+        Table, Operand, *Type, Arguments);
+    Result->setTailCall(true);
+    buildTailReturn(Result, *Type);
+  }
+
   void operator()(binsts::Drop const *) { utility::ignore(values().pop()); }
 
   void operator()(binsts::Select const *) {
@@ -586,16 +676,9 @@ public:
   void operator()(BYTECODE_INST const *Inst) {                                 \
     auto LoadType = LOAD_TYPE;                                                 \
     auto LoadWidth = LOAD_WIDTH;                                               \
-    auto *Mem = Context.getImplicitMemory();                                   \
+    auto *Mem = Context[Inst->Memory];                                         \
     auto *Address = values().pop();                                            \
-    if (Inst->Offset != 0) {                                                   \
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(           \
-          static_cast<std::int32_t>(Inst->Offset));                            \
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(       \
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);            \
-    }                                                                          \
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(                         \
-        Mem, Address, LoadWidth);                                              \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, LoadWidth);      \
     auto *Result = CurrentBasicBlock->BuildInst<minsts::Load>(                 \
         Mem, LoadType, Address, LoadWidth);                                    \
     values().push(Result);                                                     \
@@ -615,16 +698,9 @@ public:
 
 #define LOAD_SIGN_EXTEND(BYTECODE_INST, LOAD_TYPE, LOAD_WIDTH, LOAD_EXTEND_OP) \
   void operator()(BYTECODE_INST const *Inst) {                                 \
-    auto *Mem = Context.getImplicitMemory();                                   \
+    auto *Mem = Context[Inst->Memory];                                         \
     auto *Address = values().pop();                                            \
-    if (Inst->Offset != 0) {                                                   \
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(           \
-          static_cast<std::int32_t>(Inst->Offset));                            \
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(       \
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);            \
-    }                                                                          \
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(                         \
-        Mem, Address, LOAD_WIDTH);                                             \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, LOAD_WIDTH);     \
     auto *Result = CurrentBasicBlock->BuildInst<minsts::Load>(                 \
         Mem, LOAD_TYPE, Address, LOAD_WIDTH);                                  \
     auto *ExtendedResult = CurrentBasicBlock->BuildInst<minsts::Cast>(         \
@@ -643,17 +719,10 @@ public:
 #define STORE(BYTECODE_INST, STORE_WIDTH)                                      \
   void operator()(BYTECODE_INST const *Inst) {                                 \
     auto StoreWidth = STORE_WIDTH;                                             \
-    auto *Mem = Context.getImplicitMemory();                                   \
+    auto *Mem = Context[Inst->Memory];                                         \
     auto *Operand = values().pop();                                            \
     auto *Address = values().pop();                                            \
-    if (Inst->Offset != 0) {                                                   \
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(           \
-          static_cast<std::int32_t>(Inst->Offset));                            \
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(       \
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);            \
-    }                                                                          \
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(                         \
-        Mem, Address, StoreWidth);                                             \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, StoreWidth);     \
     CurrentBasicBlock->BuildInst<minsts::Store>(                               \
         Mem, Address, Operand, StoreWidth);                                    \
   }
@@ -670,20 +739,202 @@ public:
   // clang-format on
 #undef STORE
 
-  void operator()(binsts::MemorySize const *) {
-    auto *Mem = Context.getImplicitMemory();
+  void operator()(binsts::MemorySize const *Inst) {
+    auto *Mem = Context[Inst->Memory];
     auto *Result = CurrentBasicBlock->BuildInst<minsts::MemorySize>(Mem);
     values().push(Result);
   }
 
-  void operator()(binsts::MemoryGrow const *) {
+  void operator()(binsts::MemoryGrow const *Inst) {
     auto *Operand = values().pop();
-    auto *Mem = Context.getImplicitMemory();
+    auto *Mem = Context[Inst->Memory];
     auto *Result =
         CurrentBasicBlock->BuildInst<minsts::MemoryGrow>(Mem, Operand);
     values().push(Result);
   }
 
+#define ATOMIC_LOAD(BYTECODE_INST, LOAD_TYPE, LOAD_WIDTH)                      \
+  void operator()(BYTECODE_INST const *Inst) {                                 \
+    auto *Mem = Context[Inst->Memory];                                         \
+    auto *Address = values().pop();                                            \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, LOAD_WIDTH);     \
+    auto *Result = CurrentBasicBlock->BuildInst<minsts::atomic::AtomicLoad>(   \
+        Mem, LOAD_TYPE, Address, LOAD_WIDTH);                                  \
+    values().push(Result);                                                     \
+  }
+  // clang-format off
+  ATOMIC_LOAD(binsts::I32AtomicLoad       , I32, 32)
+  ATOMIC_LOAD(binsts::I64AtomicLoad       , I64, 64)
+  ATOMIC_LOAD(binsts::I32AtomicLoad8U     , I32, 8 )
+  ATOMIC_LOAD(binsts::I32AtomicLoad16U    , I32, 16)
+  ATOMIC_LOAD(binsts::I64AtomicLoad8U     , I64, 8 )
+  ATOMIC_LOAD(binsts::I64AtomicLoad16U    , I64, 16)
+  ATOMIC_LOAD(binsts::I64AtomicLoad32U    , I64, 32)
+  // clang-format on
+#undef ATOMIC_LOAD
+
+#define ATOMIC_STORE(BYTECODE_INST, STORE_WIDTH)                               \
+  void operator()(BYTECODE_INST const *Inst) {                                 \
+    auto *Mem = Context[Inst->Memory];                                         \
+    auto *Operand = values().pop();                                            \
+    auto *Address = values().pop();                                            \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, STORE_WIDTH);    \
+    CurrentBasicBlock->BuildInst<minsts::atomic::AtomicStore>(                 \
+        Mem, Address, Operand, STORE_WIDTH);                                   \
+  }
+  // clang-format off
+  ATOMIC_STORE(binsts::I32AtomicStore      , 32)
+  ATOMIC_STORE(binsts::I64AtomicStore      , 64)
+  ATOMIC_STORE(binsts::I32AtomicStore8     , 8 )
+  ATOMIC_STORE(binsts::I32AtomicStore16    , 16)
+  ATOMIC_STORE(binsts::I64AtomicStore8     , 8 )
+  ATOMIC_STORE(binsts::I64AtomicStore16    , 16)
+  ATOMIC_STORE(binsts::I64AtomicStore32    , 32)
+  // clang-format on
+#undef ATOMIC_STORE
+
+#define ATOMIC_RMW(BYTECODE_INST, RMW_OP, RMW_TYPE, RMW_WIDTH)                 \
+  void operator()(BYTECODE_INST const *Inst) {                                 \
+    auto *Mem = Context[Inst->Memory];                                         \
+    auto *Operand = values().pop();                                            \
+    auto *Address = values().pop();                                            \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, RMW_WIDTH);      \
+    auto *Result = CurrentBasicBlock->BuildInst<minsts::atomic::AtomicRMW>(    \
+        minsts::atomic::AtomicRMWOperator::RMW_OP, Mem, RMW_TYPE, Address,     \
+        Operand, RMW_WIDTH);                                                   \
+    values().push(Result);                                                     \
+  }
+  // clang-format off
+  ATOMIC_RMW(binsts::I32AtomicRmwAdd     , Add , I32, 32)
+  ATOMIC_RMW(binsts::I64AtomicRmwAdd     , Add , I64, 64)
+  ATOMIC_RMW(binsts::I32AtomicRmw8AddU   , Add , I32, 8 )
+  ATOMIC_RMW(binsts::I32AtomicRmw16AddU  , Add , I32, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw8AddU   , Add , I64, 8 )
+  ATOMIC_RMW(binsts::I64AtomicRmw16AddU  , Add , I64, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw32AddU  , Add , I64, 32)
+  ATOMIC_RMW(binsts::I32AtomicRmwSub     , Sub , I32, 32)
+  ATOMIC_RMW(binsts::I64AtomicRmwSub     , Sub , I64, 64)
+  ATOMIC_RMW(binsts::I32AtomicRmw8SubU   , Sub , I32, 8 )
+  ATOMIC_RMW(binsts::I32AtomicRmw16SubU  , Sub , I32, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw8SubU   , Sub , I64, 8 )
+  ATOMIC_RMW(binsts::I64AtomicRmw16SubU  , Sub , I64, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw32SubU  , Sub , I64, 32)
+  ATOMIC_RMW(binsts::I32AtomicRmwAnd     , And , I32, 32)
+  ATOMIC_RMW(binsts::I64AtomicRmwAnd     , And , I64, 64)
+  ATOMIC_RMW(binsts::I32AtomicRmw8AndU   , And , I32, 8 )
+  ATOMIC_RMW(binsts::I32AtomicRmw16AndU  , And , I32, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw8AndU   , And , I64, 8 )
+  ATOMIC_RMW(binsts::I64AtomicRmw16AndU  , And , I64, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw32AndU  , And , I64, 32)
+  ATOMIC_RMW(binsts::I32AtomicRmwOr      , Or  , I32, 32)
+  ATOMIC_RMW(binsts::I64AtomicRmwOr      , Or  , I64, 64)
+  ATOMIC_RMW(binsts::I32AtomicRmw8OrU    , Or  , I32, 8 )
+  ATOMIC_RMW(binsts::I32AtomicRmw16OrU   , Or  , I32, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw8OrU    , Or  , I64, 8 )
+  ATOMIC_RMW(binsts::I64AtomicRmw16OrU   , Or  , I64, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw32OrU   , Or  , I64, 32)
+  ATOMIC_RMW(binsts::I32AtomicRmwXor     , Xor , I32, 32)
+  ATOMIC_RMW(binsts::I64AtomicRmwXor     , Xor , I64, 64)
+  ATOMIC_RMW(binsts::I32AtomicRmw8XorU   , Xor , I32, 8 )
+  ATOMIC_RMW(binsts::I32AtomicRmw16XorU  , Xor , I32, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw8XorU   , Xor , I64, 8 )
+  ATOMIC_RMW(binsts::I64AtomicRmw16XorU  , Xor , I64, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw32XorU  , Xor , I64, 32)
+  ATOMIC_RMW(binsts::I32AtomicRmwXchg    , Xchg, I32, 32)
+  ATOMIC_RMW(binsts::I64AtomicRmwXchg    , Xchg, I64, 64)
+  ATOMIC_RMW(binsts::I32AtomicRmw8XchgU  , Xchg, I32, 8 )
+  ATOMIC_RMW(binsts::I32AtomicRmw16XchgU , Xchg, I32, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw8XchgU  , Xchg, I64, 8 )
+  ATOMIC_RMW(binsts::I64AtomicRmw16XchgU , Xchg, I64, 16)
+  ATOMIC_RMW(binsts::I64AtomicRmw32XchgU , Xchg, I64, 32)
+  // clang-format on
+#undef ATOMIC_RMW
+
+#define ATOMIC_CMPXCHG(BYTECODE_INST, CMPXCHG_TYPE, CMPXCHG_WIDTH)            \
+  void operator()(BYTECODE_INST const *Inst) {                                 \
+    auto *Mem = Context[Inst->Memory];                                         \
+    auto *Replacement = values().pop();                                        \
+    auto *Expected = values().pop();                                           \
+    auto *Address = values().pop();                                            \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, CMPXCHG_WIDTH);  \
+    auto *Result = CurrentBasicBlock->BuildInst<minsts::atomic::AtomicCmpxchg>(\
+        Mem, CMPXCHG_TYPE, Address, Expected, Replacement, CMPXCHG_WIDTH);     \
+    values().push(Result);                                                     \
+  }
+  // clang-format off
+  ATOMIC_CMPXCHG(binsts::I32AtomicRmwCmpxchg , I32, 32)
+  ATOMIC_CMPXCHG(binsts::I64AtomicRmwCmpxchg , I64, 64)
+  ATOMIC_CMPXCHG(binsts::I32AtomicRmw8CmpxchgU, I32, 8 )
+  ATOMIC_CMPXCHG(binsts::I32AtomicRmw16CmpxchgU, I32, 16)
+  ATOMIC_CMPXCHG(binsts::I64AtomicRmw8CmpxchgU, I64, 8 )
+  ATOMIC_CMPXCHG(binsts::I64AtomicRmw16CmpxchgU, I64, 16)
+  ATOMIC_CMPXCHG(binsts::I64AtomicRmw32CmpxchgU, I64, 32)
+  // clang-format on
+#undef ATOMIC_CMPXCHG
+
+#define ATOMIC_WAIT(BYTECODE_INST, WAIT_WIDTH)                                 \
+  void operator()(BYTECODE_INST const *Inst) {                                 \
+    auto *Mem = Context[Inst->Memory];                                         \
+    auto *Timeout = values().pop();                                            \
+    auto *Expected = values().pop();                                           \
+    auto *Address = values().pop();                                            \
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, WAIT_WIDTH);     \
+    auto *Result = CurrentBasicBlock->BuildInst<minsts::atomic::AtomicWait>(   \
+        Mem, Address, Expected, Timeout, WAIT_WIDTH);                          \
+    values().push(Result);                                                     \
+  }
+  ATOMIC_WAIT(binsts::MemoryAtomicWait32, 32)
+  ATOMIC_WAIT(binsts::MemoryAtomicWait64, 64)
+#undef ATOMIC_WAIT
+
+  void operator()(binsts::MemoryAtomicNotify const *Inst) {
+    auto *Mem = Context[Inst->Memory];
+    auto *Count = values().pop();
+    auto *Address = values().pop();
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, 32);
+    auto *Result = CurrentBasicBlock->BuildInst<minsts::atomic::AtomicNotify>(
+        Mem, Address, Count);
+    values().push(Result);
+  }
+
+  void operator()(binsts::AtomicFence const *) {
+    CurrentBasicBlock->BuildInst<minsts::AtomicFence>();
+  }
+
+  void operator()(binsts::MemoryInit const *Inst) {
+    auto *Mem = Context[Inst->Memory];
+    auto *Segment = Context[Inst->Segment];
+    auto *Size = values().pop();
+    auto *Offset = values().pop();
+    auto *Destination = values().pop();
+    CurrentBasicBlock->BuildInst<minsts::MemoryInit>(
+        Mem, Segment, Destination, Offset, Size);
+  }
+
+  void operator()(binsts::DataDrop const *Inst) {
+    auto *Segment = Context[Inst->Segment];
+    CurrentBasicBlock->BuildInst<minsts::DataDrop>(Segment);
+  }
+
+  void operator()(binsts::MemoryCopy const *Inst) {
+    auto *DestinationMem = Context[Inst->Destination];
+    auto *SourceMem = Context[Inst->Source];
+    auto *Size = values().pop();
+    auto *Source = values().pop();
+    auto *Destination = values().pop();
+    CurrentBasicBlock->BuildInst<minsts::MemoryCopy>(
+        DestinationMem, SourceMem, Destination, Source, Size);
+  }
+
+  void operator()(binsts::MemoryFill const *Inst) {
+    auto *Mem = Context[Inst->Memory];
+    auto *Size = values().pop();
+    auto *Value = values().pop();
+    auto *Destination = values().pop();
+    CurrentBasicBlock->BuildInst<minsts::MemoryFill>(
+        Mem, Destination, Value, Size);
+  }
+
 #define CONSTANT(BYTECODE_INST, VALUE_TYPE)                                    \
   void operator()(BYTECODE_INST const *Inst) {                                 \
     auto Value = static_cast<VALUE_TYPE>(Inst->Value);                         \
@@ -1426,44 +1677,26 @@ public:
   // clang-format on
 
   void operator()(binsts::V128Store const *Inst) {
-    auto *Mem = Context.getImplicitMemory();
+    auto *Mem = Context[Inst->Memory];
     auto *Operand = values().pop();
     auto *Address = values().pop();
-    if (Inst->Offset != 0) {
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(
-          static_cast<std::int32_t>(Inst->Offset));
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);
-    }
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(Mem, Address, 128);
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, 128);
     CurrentBasicBlock->BuildInst<minsts::Store>(Mem, Address, Operand, 128);
   }
 
   void operator()(binsts::V128Load const *Inst) {
-    auto *Mem = Context.getImplicitMemory();
+    auto *Mem = Context[Inst->Memory];
     auto *Address = values().pop();
-    if (Inst->Offset != 0) {
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(
-          static_cast<std::int32_t>(Inst->Offset));
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);
-    }
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(Mem, Address, 128);
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, 128);
     auto *Result = CurrentBasicBlock->BuildInst<minsts::Load>(
         Mem, bytecode::ValueTypeKind::V128, Address, 128);
     values().push(Result);
   }
 
   void operator()(binsts::V128Load64Splat const *Inst) {
-    auto *Mem = Context.getImplicitMemory();
+    auto *Mem = Context[Inst->Memory];
     auto *Address = values().pop();
-    if (Inst->Offset != 0) {
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(
-          static_cast<std::int32_t>(Inst->Offset));
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);
-    }
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(Mem, Address, 64);
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, 64);
     mir::Instruction *Result = CurrentBasicBlock->BuildInst<minsts::Load>(
         Mem, bytecode::ValueTypeKind::I64, Address, 64);
     Result =
@@ -1473,15 +1706,9 @@ public:
   }
 
   void operator()(binsts::V128Load32Splat const *Inst) {
-    auto *Mem = Context.getImplicitMemory();
+    auto *Mem = Context[Inst->Memory];
     auto *Address = values().pop();
-    if (Inst->Offset != 0) {
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(
-          static_cast<std::int32_t>(Inst->Offset));
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);
-    }
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(Mem, Address, 32);
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, 32);
     mir::Instruction *Result = CurrentBasicBlock->BuildInst<minsts::Load>(
         Mem, bytecode::ValueTypeKind::I32, Address, 32);
     Result =
@@ -1491,15 +1718,9 @@ public:
   }
 
   void operator()(binsts::V128Load32x2S const * Inst) {
-    auto *Mem = Context.getImplicitMemory();
+    auto *Mem = Context[Inst->Memory];
     auto *Address = values().pop();
-    if (Inst->Offset != 0) {
-      auto *Offset = CurrentBasicBlock->BuildInst<minsts::Constant>(
-          static_cast<std::int32_t>(Inst->Offset));
-      Address = CurrentBasicBlock->BuildInst<minsts::binary::IntBinary>(
-          minsts::binary::IntBinaryOperator::Add, Address, Offset);
-    }
-    CurrentBasicBlock->BuildInst<minsts::MemoryGuard>(Mem, Address, 64);
+    Address = buildGuardedAddress(Mem, Address, Inst->Offset, 64);
     mir::Instruction *Result = CurrentBasicBlock->BuildInst<minsts::Load>(
         Mem, bytecode::ValueTypeKind::V128, Address, 64);
     Result =
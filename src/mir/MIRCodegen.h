@@ -33,11 +33,9 @@ public:
   Memory *operator[](bytecode::MemIDX Index) const;
   Table *operator[](bytecode::TableIDX Index) const;
   Global *operator[](bytecode::GlobalIDX Index) const;
+  Data *operator[](bytecode::DataIDX Index) const;
   bytecode::FunctionType const *operator[](bytecode::TypeIDX Index) const;
 
-  Memory *getImplicitMemory() const;
-  Table *getImplicitTable() const;
-
   // clang-format off
   auto functions() const
   { return ranges::views::zip(BModuleView.functions(), Functions); }
@@ -1,6 +1,7 @@
 #ifndef SABLE_INCLUDE_GUARD_MIR_PRINTER
 #define SABLE_INCLUDE_GUARD_MIR_PRINTER
 
+#include "Atomic.h"
 #include "BasicBlock.h"
 #include "Binary.h"
 #include "Branch.h"
@@ -39,6 +40,8 @@ public:
   Iterator write(Iterator Out, Global const &Global_) const;
   template <std::output_iterator<char> Iterator>
   Iterator write(Iterator Out, Function const &Function_) const;
+  template <std::output_iterator<char> Iterator>
+  Iterator write(Iterator Out, Data const &Data_) const;
 
   template <std::output_iterator<char> Iterator>
   Iterator write(Iterator Out, Memory const *MemoryPtr) const;
@@ -48,6 +51,8 @@ public:
   Iterator write(Iterator Out, Global const *GlobalPtr) const;
   template <std::output_iterator<char> Iterator>
   Iterator write(Iterator Out, Function const *FunctionPtr) const;
+  template <std::output_iterator<char> Iterator>
+  Iterator write(Iterator Out, Data const *DataPtr) const;
 };
 
 class LocalNameWriter {
@@ -120,6 +125,8 @@ public:
   MIRIteratorWriter &operator<<
   (instructions::compare::SIMD128FPCompareOperator Op)
   { Out = fmt::format_to(Out, "{}", Op); return *this; }
+  MIRIteratorWriter &operator<<(instructions::atomic::AtomicRMWOperator Op)
+  { Out = fmt::format_to(Out, "{}", Op); return *this; }
   MIRIteratorWriter &operator<<(SIMD128IntLaneInfo const &LaneInfo)
   { Out = fmt::format_to(Out, "{}", LaneInfo); return *this; }
   MIRIteratorWriter &operator<<(SIMD128FPLaneInfo const &LaneInfo)
@@ -158,10 +165,12 @@ public:
   MIRIteratorWriter &operator<<(Table const &X) { return forwardE(X); }
   MIRIteratorWriter &operator<<(Global const &X) { return forwardE(X); }
   MIRIteratorWriter &operator<<(Function const &X) { return forwardE(X); }
+  MIRIteratorWriter &operator<<(Data const &X) { return forwardE(X); }
   MIRIteratorWriter &operator<<(Memory const *X) { return forwardE(X); }
   MIRIteratorWriter &operator<<(Table const *X) { return forwardE(X); }
   MIRIteratorWriter &operator<<(Global const *X) { return forwardE(X); }
   MIRIteratorWriter &operator<<(Function const *X) { return forwardE(X); }
+  MIRIteratorWriter &operator<<(Data const *X) { return forwardE(X); }
 
   MIRIteratorWriter &operator<<(Local const &X) { return forwardL(X); }
   MIRIteratorWriter &operator<<(BasicBlock const &X) { return forwardL(X); }
@@ -35,6 +35,7 @@ inline EntityNameWriter::EntityNameWriter(Module const &Module_) {
   prepareEntities(Module_.getTables().asView());
   prepareEntities(Module_.getGlobals().asView());
   prepareEntities(Module_.getFunctions().asView());
+  prepareEntities(Module_.getData().asView());
 }
 
 template <std::output_iterator<char> Iterator>
@@ -83,6 +84,17 @@ EntityNameWriter::write(Iterator Out, Function const *FunctionPtr) const {
   return write(Out, *FunctionPtr);
 }
 
+template <std::output_iterator<char> Iterator>
+Iterator EntityNameWriter::write(Iterator Out, Data const &Data_) const {
+  return write(Out, "%data:{}", Data_);
+}
+
+template <std::output_iterator<char> Iterator>
+Iterator EntityNameWriter::write(Iterator Out, Data const *DataPtr) const {
+  if (DataPtr == nullptr) { return fmt::format_to(Out, "{}", NULL_STR); }
+  return write(Out, *DataPtr);
+}
+
 inline char const *const LocalNameWriter::NULL_STR = "null";
 
 template <std::output_iterator<char> Iterator>
@@ -118,9 +130,13 @@ inline bool isVoidReturnInst(Instruction const &Inst) {
   case InstructionKind::LocalSet:
   case InstructionKind::GlobalSet:
   case InstructionKind::MemoryGuard:
+  case InstructionKind::AtomicFence:
   case InstructionKind::Branch: return true;
-  default: return false;
+  default: break;
   }
+  if (is_a<instructions::atomic::AtomicStore>(std::addressof(Inst)))
+    return true;
+  return false;
 }
 } // namespace detail
 
@@ -292,6 +308,7 @@ class WriterInstructionVisitor :
     public InstVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
     public mir::instructions::BranchVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
     public mir::instructions::CompareVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
+    public mir::instructions::AtomicVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
     public mir::instructions::UnaryVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
     public mir::instructions::BinaryVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
     public mir::instructions::VectorSplatVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>,
@@ -348,6 +365,7 @@ public:
   Iterator operator()(instructions::Call const *Inst) {
     if ((Inst->getTarget() != nullptr) &&
         (Inst->getTarget()->getType().isVoidResult())) {
+      if (Inst->isTailCall()) Writer << "tail ";
       Writer << "call " << Inst->getTarget() << '(';
       char const *Separator = "";
       for (auto const *Argument : Inst->getArguments()) {
@@ -356,7 +374,9 @@ public:
       }
       Writer << ')';
     } else {
-      Writer << Inst << " = call " << Inst->getTarget() << '(';
+      Writer << Inst << " = ";
+      if (Inst->isTailCall()) Writer << "tail ";
+      Writer << "call " << Inst->getTarget() << '(';
       char const *Separator = "";
       for (auto const *Argument : Inst->getArguments()) {
         Writer << Separator << Argument;
@@ -369,6 +389,7 @@ public:
 
   Iterator operator()(instructions::CallIndirect const *Inst) {
     if (Inst->getExpectType().isVoidResult()) {
+      if (Inst->isTailCall()) Writer << "tail ";
       Writer << "call.indirect " << Inst->getIndirectTable() << ' '
              << Inst->getOperand() << " (";
       char const *Separator = "";
@@ -378,7 +399,9 @@ public:
       }
       Writer << ')';
     } else {
-      Writer << Inst << " = call.indirect " << Inst->getIndirectTable() << ' '
+      Writer << Inst << " = ";
+      if (Inst->isTailCall()) Writer << "tail ";
+      Writer << "call.indirect " << Inst->getIndirectTable() << ' '
              << Inst->getOperand() << " (";
       char const *Separator = "";
       for (auto const *Argument : Inst->getArguments()) {
@@ -612,6 +635,119 @@ public:
     return Writer.iterator();
   }
 
+  Iterator operator()(instructions::MemoryInit const *Inst) {
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Segment = Inst->getSegment();
+    auto const *Destination = Inst->getDestination();
+    auto const *Offset = Inst->getOffset();
+    auto const *Size = Inst->getSize();
+    Writer << "memory.init " << Memory << ' ' << Segment << ' ' << Destination
+           << ' ' << Offset << ' ' << Size;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::DataDrop const *Inst) {
+    Writer << "data.drop " << Inst->getSegment();
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::MemoryCopy const *Inst) {
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *SourceMemory = Inst->getSourceMemory();
+    auto const *Destination = Inst->getDestination();
+    auto const *Source = Inst->getSource();
+    auto const *Size = Inst->getSize();
+    Writer << "memory.copy " << Memory << ' ' << SourceMemory << ' '
+           << Destination << ' ' << Source << ' ' << Size;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::MemoryFill const *Inst) {
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Destination = Inst->getDestination();
+    auto const *Value = Inst->getValue();
+    auto const *Size = Inst->getSize();
+    Writer << "memory.fill " << Memory << ' ' << Destination << ' ' << Value
+           << ' ' << Size;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::atomic::AtomicLoad const *Inst) {
+    auto Width = Inst->getWidth();
+    auto Type = Inst->getType();
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Address = Inst->getAddress();
+    Writer << Inst << " = atomic.load." << Width << ' ' << Type << ' '
+           << Memory << ' ' << Address;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::atomic::AtomicStore const *Inst) {
+    auto Width = Inst->getWidth();
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Address = Inst->getAddress();
+    auto const *Operand = Inst->getOperand();
+    Writer << "atomic.store." << Width << ' ' << Memory << ' ' << Address
+           << ' ' << Operand;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::atomic::AtomicRMW const *Inst) {
+    auto Operator = Inst->getOperator();
+    auto Width = Inst->getWidth();
+    auto Type = Inst->getType();
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Address = Inst->getAddress();
+    auto const *Operand = Inst->getOperand();
+    Writer << Inst << " = atomic.rmw." << Operator << '.' << Width << ' '
+           << Type << ' ' << Memory << ' ' << Address << ' ' << Operand;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::atomic::AtomicCmpxchg const *Inst) {
+    auto Width = Inst->getWidth();
+    auto Type = Inst->getType();
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Address = Inst->getAddress();
+    auto const *Expected = Inst->getExpected();
+    auto const *Replacement = Inst->getReplacement();
+    Writer << Inst << " = atomic.cmpxchg." << Width << ' ' << Type << ' '
+           << Memory << ' ' << Address << ' ' << Expected << ' '
+           << Replacement;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::atomic::AtomicWait const *Inst) {
+    auto Width = Inst->getWidth();
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Address = Inst->getAddress();
+    auto const *Expected = Inst->getExpected();
+    auto const *Timeout = Inst->getTimeout();
+    Writer << Inst << " = atomic.wait." << Width << ' ' << Memory << ' '
+           << Address << ' ' << Expected << ' ' << Timeout;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::atomic::AtomicNotify const *Inst) {
+    auto const *Memory = Inst->getLinearMemory();
+    auto const *Address = Inst->getAddress();
+    auto const *Count = Inst->getCount();
+    Writer << Inst << " = atomic.notify " << Memory << ' ' << Address << ' '
+           << Count;
+    return Writer.iterator();
+  }
+
+  Iterator operator()(instructions::Atomic const *Inst) {
+    using namespace mir::instructions;
+    using AtomicVisitor =
+        AtomicVisitorBase<WriterInstructionVisitor<Iterator>, Iterator>;
+    return AtomicVisitor::visit(Inst);
+  }
+
+  Iterator operator()(instructions::AtomicFence const *) {
+    return (Writer << "atomic.fence").iterator();
+  }
+
   Iterator operator()(instructions::Cast const *Inst) {
     auto CastOpcode = Inst->getCastOpcode();
     auto const *Operand = Inst->getOperand();
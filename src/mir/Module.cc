@@ -15,6 +15,7 @@ Data::Data(std::unique_ptr<InitializerExpr> Offset_)
 InitializerExpr *Data::getOffset() const { return Offset.get(); }
 void Data::setOffset(std::unique_ptr<InitializerExpr> Offset_)
 { Offset = std::move(Offset_); }
+bool Data::isPassive() const { return Offset == nullptr; }
 std::size_t Data::getSize() const { return Content.size(); }
 
 std::span<const std::byte> Data::getContent() const { return Content; }
@@ -25,8 +25,10 @@ class Data : public ASTNode, public llvm::ilist_node_with_parent<Data, Module> {
 public:
   explicit Data(std::unique_ptr<InitializerExpr> Offset_);
 
+  // passive segments have no offset and are only copied by memory.init
   InitializerExpr *getOffset() const;
   void setOffset(std::unique_ptr<InitializerExpr> Offset_);
+  bool isPassive() const;
 
   std::span<std::byte const> getContent() const;
   void setContent(std::span<std::byte const> Content_);
@@ -0,0 +1,155 @@
+#include "Devirtualization.h"
+
+#include "../Branch.h"
+#include "../Compare.h"
+
+#include <range/v3/algorithm/contains.hpp>
+#include <range/v3/view/enumerate.hpp>
+
+namespace mir::passes {
+namespace minsts = mir::instructions;
+
+namespace {
+// tables larger than this are not materialized at compile time
+constexpr std::uint32_t MaxNumStaticTableEntries = 1U << 16;
+
+mir::BasicBlock *buildBasicBlockAfter(mir::BasicBlock &Pos) {
+  auto &Function = *Pos.getParent();
+  auto NextIter = std::next(Pos.getIterator());
+  if (NextIter == Function.getBasicBlocks().end())
+    return Function.BuildBasicBlock();
+  return Function.BuildBasicBlockAt(std::addressof(*NextIter));
+}
+} // namespace
+
+void DevirtualizationPass::analyzeTables() {
+  for (auto const &Table : Module->getTables().asView()) {
+    if (Table.isImported() || Table.isExported()) continue;
+    if (Table.getType().getMin() > MaxNumStaticTableEntries) continue;
+    std::vector<mir::Function *> Content(Table.getType().getMin(), nullptr);
+    auto IsStatic = true;
+    for (auto const *ElementSegment : Table.getInitializers()) {
+      auto const *Offset = ElementSegment->getOffset();
+      if (!is_a<initializer::Constant>(Offset)) {
+        IsStatic = false;
+        break;
+      }
+      auto Base = static_cast<std::uint32_t>(
+          dyn_cast<initializer::Constant>(Offset)->asI32());
+      // out of bound segments fail the instantiation, nothing to optimize
+      if (std::uint64_t(Base) + ElementSegment->getSize() > Content.size()) {
+        IsStatic = false;
+        break;
+      }
+      for (auto const &[Index, Function] :
+           ranges::views::enumerate(ElementSegment->getContent()))
+        Content[Base + Index] = Function;
+    }
+    if (!IsStatic) continue;
+    TableContents.emplace(std::addressof(Table), std::move(Content));
+  }
+}
+
+bool DevirtualizationPass::devirtualize(minsts::CallIndirect &CallIndirect) {
+  auto const &ExpectType = CallIndirect.getExpectType();
+  // phi nodes cannot carry aggregates
+  if (ExpectType.isMultiValueResult()) return false;
+  // the candidate calls would no longer be in tail position
+  if (CallIndirect.isTailCall()) return false;
+  auto SearchIter = TableContents.find(CallIndirect.getIndirectTable());
+  if (SearchIter == TableContents.end()) return false;
+  auto const &Content = std::get<1>(*SearchIter);
+
+  std::vector<std::pair<std::uint32_t, mir::Function *>> CandidateIndices;
+  std::vector<mir::Function *> Candidates;
+  for (auto const &[Index, Function] : ranges::views::enumerate(Content)) {
+    if ((Function == nullptr) || (Function->getType() != ExpectType)) continue;
+    CandidateIndices.emplace_back(Index, Function);
+    if (!ranges::contains(Candidates, Function)) Candidates.push_back(Function);
+  }
+  // no candidate at all always traps, keep the precise runtime error
+  if (Candidates.empty() || (Candidates.size() > MaxNumCandidates))
+    return false;
+  auto MaxIndex = std::get<0>(CandidateIndices.back());
+  if ((CandidateIndices.size() > 1) && (MaxIndex >= MaxSwitchSize))
+    return false;
+
+  auto &BasicBlock = *CallIndirect.getParent();
+  auto &Function = *BasicBlock.getParent();
+  auto *ContinueBB = buildBasicBlockAfter(BasicBlock);
+  auto SplitPos = std::next(CallIndirect.getIterator());
+  ContinueBB->splice(ContinueBB->end(), BasicBlock, SplitPos, BasicBlock.end());
+  for (auto *Successor : ContinueBB->getOutwardFlow())
+    for (auto &Instruction : *Successor) {
+      if (!is_a<minsts::Phi>(Instruction)) continue;
+      Instruction.replace(std::addressof(BasicBlock), ContinueBB);
+    }
+
+  std::vector<std::pair<mir::Instruction *, mir::BasicBlock *>> Results;
+  std::unordered_map<mir::Function *, mir::BasicBlock *> CandidateBBs;
+  for (auto *Candidate : Candidates) {
+    auto *CandidateBB = Function.BuildBasicBlockAt(ContinueBB);
+    auto *Call = CandidateBB->BuildInst<minsts::Call>(
+        Candidate, CallIndirect.getArguments());
+    CandidateBB->BuildInst<minsts::branch::Unconditional>(ContinueBB);
+    CandidateBBs.emplace(Candidate, CandidateBB);
+    Results.emplace_back(Call, CandidateBB);
+  }
+
+  auto *FallbackBB = Function.BuildBasicBlockAt(ContinueBB);
+  auto *Operand = CallIndirect.getOperand();
+  FallbackBB->splice(FallbackBB->end(), std::addressof(CallIndirect));
+  FallbackBB->BuildInst<minsts::branch::Unconditional>(ContinueBB);
+
+  if (CandidateIndices.size() == 1) {
+    auto [Index, Candidate] = CandidateIndices.front();
+    auto *IndexConstant = BasicBlock.BuildInst<minsts::Constant>(
+        static_cast<std::int32_t>(Index));
+    auto *IsCandidate = BasicBlock.BuildInst<minsts::compare::IntCompare>(
+        minsts::compare::IntCompareOperator::Eq, Operand, IndexConstant);
+    BasicBlock.BuildInst<minsts::branch::Conditional>(
+        IsCandidate, CandidateBBs.at(Candidate), FallbackBB);
+  } else {
+    std::vector<mir::BasicBlock *> Targets(MaxIndex + 1, FallbackBB);
+    for (auto const &[Index, Candidate] : CandidateIndices)
+      Targets[Index] = CandidateBBs.at(Candidate);
+    BasicBlock.BuildInst<minsts::branch::Switch>(Operand, FallbackBB, Targets);
+  }
+
+  if (ExpectType.isSingleValueResult()) {
+    auto *Phi = new minsts::Phi(ExpectType.getResultTypes()[0]);
+    ContinueBB->push_front(Phi);
+    CallIndirect.replaceAllUseWith(Phi);
+    Results.emplace_back(std::addressof(CallIndirect), FallbackBB);
+    for (auto const &[Value, Path] : Results) Phi->addCandidate(Value, Path);
+  }
+  return true;
+}
+
+void DevirtualizationPass::prepare(mir::Module &Module_) {
+  Module = std::addressof(Module_);
+  TableContents.clear();
+  NumDevirtualized = 0;
+}
+
+PassStatus DevirtualizationPass::run() {
+  analyzeTables();
+  if (TableContents.empty()) return PassStatus::Converged;
+  std::vector<minsts::CallIndirect *> CallSites;
+  for (auto &Function : Module->getFunctions().asView())
+    for (auto &BasicBlock : Function.getBasicBlocks().asView())
+      for (auto &Instruction : BasicBlock) {
+        if (!is_a<minsts::CallIndirect>(Instruction)) continue;
+        CallSites.push_back(dyn_cast<minsts::CallIndirect>(&Instruction));
+      }
+  for (auto *CallIndirect : CallSites)
+    if (devirtualize(*CallIndirect)) NumDevirtualized = NumDevirtualized + 1;
+  return PassStatus::Converged;
+}
+
+void DevirtualizationPass::finalize() { TableContents.clear(); }
+
+DevirtualizationPass::AnalysisResult DevirtualizationPass::getResult() const {
+  return NumDevirtualized;
+}
+} // namespace mir::passes
@@ -0,0 +1,49 @@
+#ifndef SABLE_INCLUDE_GUARD_MIR_PASSES_DEVIRTUALIZATION
+#define SABLE_INCLUDE_GUARD_MIR_PASSES_DEVIRTUALIZATION
+
+#include "../Function.h"
+#include "../Module.h"
+#include "Pass.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace mir::passes {
+
+// Rewrites call_indirect through immutable tables into direct calls.
+// A table is immutable if it is neither imported nor exported and all its
+// element segments have constant offsets, hence its content after
+// instantiation is known at compile time. For each call_indirect the entries
+// matching the expected signature form the candidate set:
+// 1. a single candidate index becomes a compare and a direct call
+// 2. a few candidate functions become a switch over direct calls
+// Any other index falls back to the original call_indirect, which reports the
+// same trap as before.
+class DevirtualizationPass {
+  mir::Module *Module;
+  std::unordered_map<mir::Table const *, std::vector<mir::Function *>>
+      TableContents;
+  std::size_t NumDevirtualized = 0;
+
+  void analyzeTables();
+  bool devirtualize(mir::instructions::CallIndirect &CallIndirect);
+
+public:
+  static constexpr std::size_t MaxNumCandidates = 4;
+  static constexpr std::size_t MaxSwitchSize = 1024;
+
+  void prepare(mir::Module &Module_);
+  PassStatus run();
+  void finalize();
+
+  using AnalysisResult = std::size_t; // number of devirtualized call sites
+  AnalysisResult getResult() const;
+
+  static constexpr bool isConstantPass() { return false; }
+  static constexpr bool isSingleRunPass() { return true; }
+};
+
+static_assert(module_pass<DevirtualizationPass>);
+} // namespace mir::passes
+
+#endif
@@ -0,0 +1,309 @@
+#include "GuardElimination.h"
+
+#include "../Binary.h"
+#include "../Cast.h"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mir::passes {
+namespace minsts = mir::instructions;
+
+namespace {
+using GuardKey = std::pair<mir::Memory const *, mir::Instruction const *>;
+using GuardFacts = std::map<GuardKey, std::uint32_t>;
+
+GuardKey getGuardKey(minsts::MemoryGuard const &Guard) {
+  return std::make_pair(Guard.getLinearMemory(), Guard.getAddress());
+}
+
+bool isTrappingIntBinary(Instruction const &Inst) {
+  if (!is_a<minsts::binary::IntBinary>(Inst)) return false;
+  using IntBinaryOperator = minsts::binary::IntBinaryOperator;
+  switch (dyn_cast<minsts::binary::IntBinary>(Inst).getOperator()) {
+  case IntBinaryOperator::DivS:
+  case IntBinaryOperator::DivU:
+  case IntBinaryOperator::RemS:
+  case IntBinaryOperator::RemU: return true;
+  default: return false;
+  }
+}
+
+bool isTrappingCast(Instruction const &Inst) {
+  using CastOpcode = minsts::CastOpcode;
+  switch (dyn_cast<minsts::Cast>(Inst).getCastOpcode()) {
+  case CastOpcode::I32TruncF32S:
+  case CastOpcode::I32TruncF32U:
+  case CastOpcode::I32TruncF64S:
+  case CastOpcode::I32TruncF64U:
+  case CastOpcode::I64TruncF32S:
+  case CastOpcode::I64TruncF32U:
+  case CastOpcode::I64TruncF64S:
+  case CastOpcode::I64TruncF64U: return true;
+  default: return false;
+  }
+}
+
+// Instructions that neither trap (other than through their memory guards)
+// nor have effects observable after a trap. A guard may be moved across them.
+bool isUnobservable(Instruction const &Inst) {
+  switch (Inst.getInstructionKind()) {
+  case InstructionKind::Select:
+  case InstructionKind::LocalGet:
+  case InstructionKind::LocalSet:
+  case InstructionKind::GlobalGet:
+  case InstructionKind::Constant:
+  case InstructionKind::Compare:
+  case InstructionKind::Unary:
+  case InstructionKind::Load:
+  case InstructionKind::Pack:
+  case InstructionKind::Unpack:
+  case InstructionKind::Phi:
+  case InstructionKind::MemoryGuard:
+  case InstructionKind::MemorySize:
+  case InstructionKind::VectorSplat:
+  case InstructionKind::VectorExtract:
+  case InstructionKind::VectorInsert:
+  case InstructionKind::SIMD128ShuffleByte:
+  case InstructionKind::SIMD128Narrow: return true;
+  case InstructionKind::Binary: return !isTrappingIntBinary(Inst);
+  case InstructionKind::Cast: return !isTrappingCast(Inst);
+  default: return false;
+  }
+}
+
+bool isWrittenIn(
+    mir::Local const &Local,
+    std::unordered_set<mir::BasicBlock const *> const &BasicBlocks) {
+  for (auto const *Node : Local.getUsedSites()) {
+    if (!is_a<minsts::LocalSet>(Node)) continue;
+    auto const *Parent = dyn_cast<minsts::LocalSet>(Node)->getParent();
+    if (BasicBlocks.contains(Parent)) return true;
+  }
+  return false;
+}
+
+} // namespace
+
+/* Merges local.get of the same local without local.set in between, so that
+ * guards on the same local share their base. Memory offsets are already kept
+ * on the guard by the code generation, an address computed by the program as
+ * Base + Constant is never split since the i32 add wraps around.
+ */
+void GuardEliminationPass::canonicalizeGuards(mir::BasicBlock &BasicBlock) {
+  std::unordered_map<mir::Local const *, minsts::LocalGet *> AvailableGets;
+  for (auto Iter = BasicBlock.begin(); Iter != BasicBlock.end();) {
+    auto &Instruction = *Iter++;
+    if (is_a<minsts::LocalSet>(Instruction)) {
+      auto &LocalSet = dyn_cast<minsts::LocalSet>(Instruction);
+      AvailableGets.erase(LocalSet.getTarget());
+      continue;
+    }
+    if (is_a<minsts::LocalGet>(Instruction)) {
+      auto &LocalGet = dyn_cast<minsts::LocalGet>(Instruction);
+      auto [SearchIter, Inserted] = AvailableGets.emplace(
+          LocalGet.getTarget(), std::addressof(LocalGet));
+      if (Inserted) continue;
+      LocalGet.replaceAllUseWith(std::get<1>(*SearchIter));
+      LocalGet.eraseFromParent();
+      continue;
+    }
+  }
+}
+
+/* Within a basic block a guard covered by an earlier guard on the same base is
+ * dropped. If the later guard is wider, the earlier one is widened instead,
+ * provided that the instructions in between are unobservable after a trap.
+ */
+void GuardEliminationPass::mergeGuards(mir::BasicBlock &BasicBlock) {
+  GuardFacts CoveredGuards;
+  std::map<GuardKey, minsts::MemoryGuard *> WidenableGuards;
+  for (auto Iter = BasicBlock.begin(); Iter != BasicBlock.end();) {
+    auto &Instruction = *Iter++;
+    if (!isUnobservable(Instruction)) {
+      // earlier guards can no longer be widened across this instruction
+      WidenableGuards.clear();
+      continue;
+    }
+    if (!is_a<minsts::MemoryGuard>(Instruction)) continue;
+    auto &Guard = dyn_cast<minsts::MemoryGuard>(Instruction);
+    auto Key = getGuardKey(Guard);
+    auto &CoveredSize = CoveredGuards[Key];
+    if (Guard.getGuardSize() <= CoveredSize) {
+      Guard.eraseFromParent();
+      NumEliminated = NumEliminated + 1;
+      continue;
+    }
+    CoveredSize = Guard.getGuardSize();
+    auto SearchIter = WidenableGuards.find(Key);
+    if (SearchIter == WidenableGuards.end()) {
+      WidenableGuards.emplace(Key, std::addressof(Guard));
+      continue;
+    }
+    std::get<1>(*SearchIter)->setGuardSize(Guard.getGuardSize());
+    Guard.eraseFromParent();
+    NumEliminated = NumEliminated + 1;
+  }
+}
+
+/* Hoists guards on loop invariant bases from the top of a loop header into
+ * the preheader. Only the prefix of the header that is unobservable after a
+ * trap is considered, so the guard fires at the same point as before the first
+ * iteration. Local reads of locals never written in the loop, constants and
+ * non-trapping integer arithmetic on them are hoisted along, every read of
+ * such a local in the loop is replaced with the hoisted one.
+ */
+void GuardEliminationPass::hoistGuards(mir::BasicBlock &Header) {
+  std::vector<mir::BasicBlock *> Latches;
+  for (auto *Predecessor : Header.getInwardFlow())
+    if (Dominator->dominate(Header, *Predecessor))
+      Latches.push_back(Predecessor);
+  if (Latches.empty()) return;
+
+  std::unordered_set<mir::BasicBlock const *> LoopBody;
+  LoopBody.insert(std::addressof(Header));
+  while (!Latches.empty()) {
+    auto *BasicBlock = Latches.back();
+    Latches.pop_back();
+    if (!LoopBody.insert(BasicBlock).second) continue;
+    for (auto *Predecessor : BasicBlock->getInwardFlow())
+      Latches.push_back(Predecessor);
+  }
+
+  mir::BasicBlock *Preheader = nullptr;
+  for (auto *Predecessor : Header.getInwardFlow()) {
+    if (LoopBody.contains(Predecessor)) continue;
+    if (Preheader != nullptr) return;
+    Preheader = Predecessor;
+  }
+  if (Preheader == nullptr) return;
+  if (Preheader->getOutwardFlow().size() != 1) return;
+
+  auto isInvariant = [&](mir::Instruction const *Inst) {
+    return !LoopBody.contains(Inst->getParent());
+  };
+  auto isHoistable = [&](mir::Instruction const &Inst) {
+    switch (Inst.getInstructionKind()) {
+    case InstructionKind::Constant: return true;
+    case InstructionKind::LocalGet: {
+      auto const &LocalGet = dyn_cast<minsts::LocalGet>(Inst);
+      return !isWrittenIn(*LocalGet.getTarget(), LoopBody);
+    }
+    case InstructionKind::Binary: {
+      if (!is_a<minsts::binary::IntBinary>(Inst)) return false;
+      if (isTrappingIntBinary(Inst)) return false;
+      auto const &Binary = dyn_cast<minsts::Binary>(Inst);
+      return isInvariant(Binary.getLHS()) && isInvariant(Binary.getRHS());
+    }
+    default: return false;
+    }
+  };
+  auto hoist = [&](mir::Instruction &Inst) {
+    auto InsertPos = std::prev(Preheader->end());
+    Preheader->splice(InsertPos, std::addressof(Inst));
+  };
+
+  for (auto Iter = Header.begin(); Iter != Header.end();) {
+    auto &Instruction = *Iter++;
+    if (is_a<minsts::MemoryGuard>(Instruction)) {
+      auto &Guard = dyn_cast<minsts::MemoryGuard>(Instruction);
+      if (isInvariant(Guard.getAddress())) {
+        hoist(Guard);
+        NumHoisted = NumHoisted + 1;
+      }
+      continue;
+    }
+    if (isHoistable(Instruction)) {
+      hoist(Instruction);
+      if (!is_a<minsts::LocalGet>(Instruction)) continue;
+      auto &LocalGet = dyn_cast<minsts::LocalGet>(Instruction);
+      std::vector<minsts::LocalGet *> LoopLocalGets;
+      for (auto *Node : LocalGet.getTarget()->getUsedSites()) {
+        if (!is_a<minsts::LocalGet>(Node)) continue;
+        auto *OtherLocalGet = dyn_cast<minsts::LocalGet>(Node);
+        if (!LoopBody.contains(OtherLocalGet->getParent())) continue;
+        LoopLocalGets.push_back(OtherLocalGet);
+      }
+      for (auto *OtherLocalGet : LoopLocalGets) {
+        if ((Iter != Header.end()) && (OtherLocalGet == std::addressof(*Iter)))
+          ++Iter;
+        OtherLocalGet->replaceAllUseWith(std::addressof(LocalGet));
+        OtherLocalGet->eraseFromParent();
+      }
+      continue;
+    }
+    if (!isUnobservable(Instruction)) break;
+  }
+}
+
+/* A guard is redundant if a guard on the same base with at least the same size
+ * is executed in a strictly dominating basic block.
+ */
+void GuardEliminationPass::eliminateDominatedGuards() {
+  std::unordered_map<mir::BasicBlock const *, GuardFacts> BlockFacts;
+  for (auto const &BasicBlock : Function->getBasicBlocks().asView()) {
+    auto &Facts = BlockFacts[std::addressof(BasicBlock)];
+    for (auto const &Instruction : BasicBlock) {
+      if (!is_a<minsts::MemoryGuard>(Instruction)) continue;
+      auto const &Guard = dyn_cast<minsts::MemoryGuard>(Instruction);
+      auto &GuardSize = Facts[getGuardKey(Guard)];
+      GuardSize = std::max(GuardSize, Guard.getGuardSize());
+    }
+  }
+
+  for (auto &BasicBlock : Function->getBasicBlocks().asView()) {
+    auto Dominators = Dominator->getDom(BasicBlock);
+    for (auto Iter = BasicBlock.begin(); Iter != BasicBlock.end();) {
+      auto &Instruction = *Iter++;
+      if (!is_a<minsts::MemoryGuard>(Instruction)) continue;
+      auto &Guard = dyn_cast<minsts::MemoryGuard>(Instruction);
+      auto Key = getGuardKey(Guard);
+      auto IsRedundant = false;
+      for (auto const *DominatorBB : Dominators) {
+        if (DominatorBB == std::addressof(BasicBlock)) continue;
+        auto const &Facts = BlockFacts[DominatorBB];
+        auto SearchIter = Facts.find(Key);
+        if (SearchIter == Facts.end()) continue;
+        if (std::get<1>(*SearchIter) < Guard.getGuardSize()) continue;
+        IsRedundant = true;
+        break;
+      }
+      if (!IsRedundant) continue;
+      Guard.eraseFromParent();
+      NumEliminated = NumEliminated + 1;
+    }
+  }
+}
+
+void GuardEliminationPass::prepare(mir::Function &Function_) {
+  Function = std::addressof(Function_);
+  SimpleFunctionPassDriver<DominatorPass> DominatorPassDriver;
+  Dominator.emplace(DominatorPassDriver(Function_));
+  NumEliminated = 0;
+  NumHoisted = 0;
+}
+
+PassStatus GuardEliminationPass::run() {
+  for (auto &BasicBlock : Function->getBasicBlocks().asView()) {
+    canonicalizeGuards(BasicBlock);
+    mergeGuards(BasicBlock);
+  }
+  for (auto &BasicBlock : Function->getBasicBlocks().asView())
+    hoistGuards(BasicBlock);
+  eliminateDominatedGuards();
+  return PassStatus::Converged;
+}
+
+void GuardEliminationPass::finalize() { Dominator.reset(); }
+
+bool GuardEliminationPass::isSkipped(mir::Function const &Function_) const {
+  return Function_.isDeclaration();
+}
+
+GuardEliminationPass::AnalysisResult GuardEliminationPass::getResult() const {
+  return GuardEliminationStats{
+      .NumEliminated = NumEliminated, .NumHoisted = NumHoisted};
+}
+
+} // namespace mir::passes
@@ -0,0 +1,53 @@
+#ifndef SABLE_INCLUDE_GUARD_MIR_PASSES_GUARD_ELIMINATION
+#define SABLE_INCLUDE_GUARD_MIR_PASSES_GUARD_ELIMINATION
+
+#include "../Function.h"
+#include "Dominator.h"
+#include "Pass.h"
+
+#include <optional>
+
+namespace mir::passes {
+
+// Reduces the number of MemoryGuard executed at runtime
+// 1. local.get of the same local are merged so that guards share their base,
+//    memory offsets are already folded into the guard size by the codegen
+// 2. guards on the same base within a basic block are merged, the earlier one
+//    is widened if nothing observable happens in between
+// 3. loop invariant guards at the top of a loop header are hoisted into the
+//    loop preheader
+// 4. guards dominated by a wider guard on the same base are removed, linear
+//    memories never shrink hence a passed guard stays valid
+class GuardEliminationPass {
+  mir::Function *Function;
+  std::optional<DominatorPassResult> Dominator;
+  std::size_t NumEliminated = 0;
+  std::size_t NumHoisted = 0;
+
+  void canonicalizeGuards(mir::BasicBlock &BasicBlock);
+  void mergeGuards(mir::BasicBlock &BasicBlock);
+  void hoistGuards(mir::BasicBlock &Header);
+  void eliminateDominatedGuards();
+
+public:
+  void prepare(mir::Function &Function_);
+  PassStatus run();
+  void finalize();
+
+  bool isSkipped(mir::Function const &Function_) const;
+
+  struct GuardEliminationStats {
+    std::size_t NumEliminated;
+    std::size_t NumHoisted;
+  };
+  using AnalysisResult = GuardEliminationStats;
+  AnalysisResult getResult() const;
+
+  static constexpr bool isConstantPass() { return false; }
+  static constexpr bool isSingleRunPass() { return true; }
+};
+
+static_assert(function_pass<GuardEliminationPass>);
+} // namespace mir::passes
+
+#endif
@@ -1,4 +1,5 @@
 #include "TypeInfer.h"
+#include "../Atomic.h"
 #include "../Binary.h"
 #include "../Branch.h"
 #include "../Cast.h"
@@ -43,7 +44,8 @@ class TypeInferVisitor :
     public minsts::UnaryVisitorBase<TypeInferVisitor, Type>,
     public minsts::BinaryVisitorBase<TypeInferVisitor, Type>,
     public minsts::VectorExtractVisitorBase<TypeInferVisitor, Type>,
-    public minsts::CompareVisitorBase<TypeInferVisitor, Type> {
+    public minsts::CompareVisitorBase<TypeInferVisitor, Type>,
+    public minsts::AtomicVisitorBase<TypeInferVisitor, Type> {
   TypeInferPassResult::TypeMap &Types;
 
   Type const &getType(mir::Instruction const *Instruction) const {
@@ -206,16 +208,53 @@ public:
   Type operator()(minsts::Store const *) { return Type::BuildUnit(); }
   Type operator()(minsts::MemoryGuard const *) { return Type::BuildUnit(); }
 
-  Type operator()(minsts::MemoryGrow const *) {
+  Type operator()(minsts::MemoryGrow const *Inst) {
+    auto const &MemoryType = Inst->getLinearMemory()->getType();
+    return Type::BuildPrimitive(MemoryType.getIndexType());
+  }
+
+  Type operator()(minsts::MemorySize const *Inst) {
+    auto const &MemoryType = Inst->getLinearMemory()->getType();
+    return Type::BuildPrimitive(MemoryType.getIndexType());
+  }
+
+  Type operator()(minsts::MemoryInit const *) { return Type::BuildUnit(); }
+  Type operator()(minsts::DataDrop const *) { return Type::BuildUnit(); }
+  Type operator()(minsts::MemoryCopy const *) { return Type::BuildUnit(); }
+  Type operator()(minsts::MemoryFill const *) { return Type::BuildUnit(); }
+
+  Type operator()(minsts::atomic::AtomicLoad const *Inst) {
+    return Type::BuildPrimitive(Inst->getType());
+  }
+
+  Type operator()(minsts::atomic::AtomicStore const *) {
+    return Type::BuildUnit();
+  }
+
+  Type operator()(minsts::atomic::AtomicRMW const *Inst) {
+    return Type::BuildPrimitive(Inst->getType());
+  }
+
+  Type operator()(minsts::atomic::AtomicCmpxchg const *Inst) {
+    return Type::BuildPrimitive(Inst->getType());
+  }
+
+  Type operator()(minsts::atomic::AtomicWait const *) {
     using namespace bytecode::valuetypes;
     return Type::BuildPrimitive(I32);
   }
 
-  Type operator()(minsts::MemorySize const *) {
+  Type operator()(minsts::atomic::AtomicNotify const *) {
     using namespace bytecode::valuetypes;
     return Type::BuildPrimitive(I32);
   }
 
+  Type operator()(minsts::Atomic const *Inst) {
+    return AtomicVisitorBase::visit(Inst);
+  }
+
+  Type operator()(minsts::AtomicFence const *) { return Type::BuildUnit(); }
+
   Type operator()(minsts::Cast const *Inst) {
     if (getType(Inst->getOperand()) != Inst->getCastFromType())
       return Type::BuildBottom();
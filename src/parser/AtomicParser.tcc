@@ -0,0 +1,109 @@
+#ifndef SABLE_INCLUDE_GUARD_PARSER_ATOMIC_PARSER
+#define SABLE_INCLUDE_GUARD_PARSER_ATOMIC_PARSER
+
+#include "Delegate.h"
+#include "Reader.h"
+
+namespace parser {
+struct AtomicParserBase {
+  static constexpr std::byte Prefix = std::byte(0xfe);
+};
+
+template <delegate DelegateType> struct AtomicParser : AtomicParserBase {
+  DelegateType &Delegate;
+
+  explicit AtomicParser(DelegateType &Delegate_) : Delegate(Delegate_) {}
+
+  template <reader ReaderBase> void operator()(WASMReader<ReaderBase> &Reader) {
+    auto AtomicOpcode = Reader.read();
+    switch (static_cast<unsigned>(AtomicOpcode)) {
+#define SABLE_ATOMIC_MEMORY_INSTRUCTION(Opcode, Name)                          \
+  case Opcode: {                                                               \
+    auto [Align, Offset, Memory] = Reader.readMemArg();                        \
+    Delegate.onInst##Name(Align, Offset, Memory);                              \
+    break;                                                                     \
+  }
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x00, MemoryAtomicNotify)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x01, MemoryAtomicWait32)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x02, MemoryAtomicWait64)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x10, I32AtomicLoad)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x11, I64AtomicLoad)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x12, I32AtomicLoad8U)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x13, I32AtomicLoad16U)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x14, I64AtomicLoad8U)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x15, I64AtomicLoad16U)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x16, I64AtomicLoad32U)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x17, I32AtomicStore)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x18, I64AtomicStore)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x19, I32AtomicStore8)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x1a, I32AtomicStore16)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x1b, I64AtomicStore8)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x1c, I64AtomicStore16)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x1d, I64AtomicStore32)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x1e, I32AtomicRmwAdd)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x1f, I64AtomicRmwAdd)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x20, I32AtomicRmw8AddU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x21, I32AtomicRmw16AddU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x22, I64AtomicRmw8AddU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x23, I64AtomicRmw16AddU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x24, I64AtomicRmw32AddU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x25, I32AtomicRmwSub)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x26, I64AtomicRmwSub)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x27, I32AtomicRmw8SubU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x28, I32AtomicRmw16SubU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x29, I64AtomicRmw8SubU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x2a, I64AtomicRmw16SubU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x2b, I64AtomicRmw32SubU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x2c, I32AtomicRmwAnd)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x2d, I64AtomicRmwAnd)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x2e, I32AtomicRmw8AndU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x2f, I32AtomicRmw16AndU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x30, I64AtomicRmw8AndU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x31, I64AtomicRmw16AndU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x32, I64AtomicRmw32AndU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x33, I32AtomicRmwOr)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x34, I64AtomicRmwOr)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x35, I32AtomicRmw8OrU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x36, I32AtomicRmw16OrU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x37, I64AtomicRmw8OrU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x38, I64AtomicRmw16OrU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x39, I64AtomicRmw32OrU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x3a, I32AtomicRmwXor)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x3b, I64AtomicRmwXor)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x3c, I32AtomicRmw8XorU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x3d, I32AtomicRmw16XorU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x3e, I64AtomicRmw8XorU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x3f, I64AtomicRmw16XorU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x40, I64AtomicRmw32XorU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x41, I32AtomicRmwXchg)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x42, I64AtomicRmwXchg)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x43, I32AtomicRmw8XchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x44, I32AtomicRmw16XchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x45, I64AtomicRmw8XchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x46, I64AtomicRmw16XchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x47, I64AtomicRmw32XchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x48, I32AtomicRmwCmpxchg)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x49, I64AtomicRmwCmpxchg)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x4a, I32AtomicRmw8CmpxchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x4b, I32AtomicRmw16CmpxchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x4c, I64AtomicRmw8CmpxchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x4d, I64AtomicRmw16CmpxchgU)
+      SABLE_ATOMIC_MEMORY_INSTRUCTION(0x4e, I64AtomicRmw32CmpxchgU)
+#undef SABLE_ATOMIC_MEMORY_INSTRUCTION
+    case 0x03: {
+      auto Reserved = Reader.read();
+      if (Reserved != std::byte(0x00))
+        throw ParserError(fmt::format(
+            "atomic.fence expects a zero byte, but 0x{:02x} found", Reserved));
+      Delegate.onInstAtomicFence();
+      break;
+    }
+    default:
+      throw ParserError(fmt::format(
+          "unknown atomic instruction 0xfe 0x{:02x}", AtomicOpcode));
+    }
+  }
+};
+} // namespace parser
+
+#endif
\ No newline at end of file
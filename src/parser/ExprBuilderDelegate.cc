@@ -83,7 +83,14 @@ EVENT(onInstBrTable)
 }
 EVENT(onInstReturn)() { addInst<Return>(); }
 EVENT(onInstCall)(bytecode::FuncIDX IDX) { addInst<Call>(IDX); }
-EVENT(onInstCallIndirect)(bytecode::TypeIDX IDX) { addInst<CallIndirect>(IDX); }
+EVENT(onInstCallIndirect)(bytecode::TypeIDX IDX, bytecode::TableIDX Table) {
+  addInst<CallIndirect>(IDX, Table);
+}
+EVENT(onInstReturnCall)(bytecode::FuncIDX IDX) { addInst<ReturnCall>(IDX); }
+EVENT(onInstReturnCallIndirect)(
+    bytecode::TypeIDX IDX, bytecode::TableIDX Table) {
+  addInst<ReturnCallIndirect>(IDX, Table);
+}
 
 EVENT(onInstDrop)() { addInst<Drop>(); }
 EVENT(onInstSelect)() { addInst<Select>(); }
@@ -102,8 +109,9 @@ GLOBAL_EVENT(onInstGlobalSet, GlobalSet)
 #undef GLOBAL_EVENT
 
 #define MEMORY_EVENT(Name, InstName)                                           \
-  EVENT(Name)(std::uint32_t Align, std::uint32_t Offset) {                     \
-    addInst<InstName>(Align, Offset);                                          \
+  EVENT(Name)(                                                                 \
+      std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) {    \
+    addInst<InstName>(Align, Offset, Memory);                                  \
   }
 // clang-format off
 MEMORY_EVENT(onInstI32Load   , I32Load   )
@@ -131,8 +139,84 @@ MEMORY_EVENT(onInstI64Store16, I64Store16)
 MEMORY_EVENT(onInstI64Store32, I64Store32)
 // clang-format on
 #undef MEMORY_EVENT
-EVENT(onInstMemorySize)() { addInst<MemorySize>(); }
-EVENT(onInstMemoryGrow)() { addInst<MemoryGrow>(); }
+EVENT(onInstMemorySize)(bytecode::MemIDX IDX) { addInst<MemorySize>(IDX); }
+EVENT(onInstMemoryGrow)(bytecode::MemIDX IDX) { addInst<MemoryGrow>(IDX); }
+
+#define ATOMIC_EVENT(Name, InstName)                                           \
+  EVENT(Name)(                                                                 \
+      std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) {    \
+    addInst<InstName>(Align, Offset, Memory);                                  \
+  }
+// clang-format off
+ATOMIC_EVENT(onInstMemoryAtomicNotify  , MemoryAtomicNotify  )
+ATOMIC_EVENT(onInstMemoryAtomicWait32  , MemoryAtomicWait32  )
+ATOMIC_EVENT(onInstMemoryAtomicWait64  , MemoryAtomicWait64  )
+ATOMIC_EVENT(onInstI32AtomicLoad       , I32AtomicLoad       )
+ATOMIC_EVENT(onInstI64AtomicLoad       , I64AtomicLoad       )
+ATOMIC_EVENT(onInstI32AtomicLoad8U     , I32AtomicLoad8U     )
+ATOMIC_EVENT(onInstI32AtomicLoad16U    , I32AtomicLoad16U    )
+ATOMIC_EVENT(onInstI64AtomicLoad8U     , I64AtomicLoad8U     )
+ATOMIC_EVENT(onInstI64AtomicLoad16U    , I64AtomicLoad16U    )
+ATOMIC_EVENT(onInstI64AtomicLoad32U    , I64AtomicLoad32U    )
+ATOMIC_EVENT(onInstI32AtomicStore      , I32AtomicStore      )
+ATOMIC_EVENT(onInstI64AtomicStore      , I64AtomicStore      )
+ATOMIC_EVENT(onInstI32AtomicStore8     , I32AtomicStore8     )
+ATOMIC_EVENT(onInstI32AtomicStore16    , I32AtomicStore16    )
+ATOMIC_EVENT(onInstI64AtomicStore8     , I64AtomicStore8     )
+ATOMIC_EVENT(onInstI64AtomicStore16    , I64AtomicStore16    )
+ATOMIC_EVENT(onInstI64AtomicStore32    , I64AtomicStore32    )
+ATOMIC_EVENT(onInstI32AtomicRmwAdd     , I32AtomicRmwAdd     )
+ATOMIC_EVENT(onInstI64AtomicRmwAdd     , I64AtomicRmwAdd     )
+ATOMIC_EVENT(onInstI32AtomicRmw8AddU   , I32AtomicRmw8AddU   )
+ATOMIC_EVENT(onInstI32AtomicRmw16AddU  , I32AtomicRmw16AddU  )
+ATOMIC_EVENT(onInstI64AtomicRmw8AddU   , I64AtomicRmw8AddU   )
+ATOMIC_EVENT(onInstI64AtomicRmw16AddU  , I64AtomicRmw16AddU  )
+ATOMIC_EVENT(onInstI64AtomicRmw32AddU  , I64AtomicRmw32AddU  )
+ATOMIC_EVENT(onInstI32AtomicRmwSub     , I32AtomicRmwSub     )
+ATOMIC_EVENT(onInstI64AtomicRmwSub     , I64AtomicRmwSub     )
+ATOMIC_EVENT(onInstI32AtomicRmw8SubU   , I32AtomicRmw8SubU   )
+ATOMIC_EVENT(onInstI32AtomicRmw16SubU  , I32AtomicRmw16SubU  )
+ATOMIC_EVENT(onInstI64AtomicRmw8SubU   , I64AtomicRmw8SubU   )
+ATOMIC_EVENT(onInstI64AtomicRmw16SubU  , I64AtomicRmw16SubU  )
+ATOMIC_EVENT(onInstI64AtomicRmw32SubU  , I64AtomicRmw32SubU  )
+ATOMIC_EVENT(onInstI32AtomicRmwAnd     , I32AtomicRmwAnd     )
+ATOMIC_EVENT(onInstI64AtomicRmwAnd     , I64AtomicRmwAnd     )
+ATOMIC_EVENT(onInstI32AtomicRmw8AndU   , I32AtomicRmw8AndU   )
+ATOMIC_EVENT(onInstI32AtomicRmw16AndU  , I32AtomicRmw16AndU  )
+ATOMIC_EVENT(onInstI64AtomicRmw8AndU   , I64AtomicRmw8AndU   )
+ATOMIC_EVENT(onInstI64AtomicRmw16AndU  , I64AtomicRmw16AndU  )
+ATOMIC_EVENT(onInstI64AtomicRmw32AndU  , I64AtomicRmw32AndU  )
+ATOMIC_EVENT(onInstI32AtomicRmwOr      , I32AtomicRmwOr      )
+ATOMIC_EVENT(onInstI64AtomicRmwOr      , I64AtomicRmwOr      )
+ATOMIC_EVENT(onInstI32AtomicRmw8OrU    , I32AtomicRmw8OrU    )
+ATOMIC_EVENT(onInstI32AtomicRmw16OrU   , I32AtomicRmw16OrU   )
+ATOMIC_EVENT(onInstI64AtomicRmw8OrU    , I64AtomicRmw8OrU    )
+ATOMIC_EVENT(onInstI64AtomicRmw16OrU   , I64AtomicRmw16OrU   )
+ATOMIC_EVENT(onInstI64AtomicRmw32OrU   , I64AtomicRmw32OrU   )
+ATOMIC_EVENT(onInstI32AtomicRmwXor     , I32AtomicRmwXor     )
+ATOMIC_EVENT(onInstI64AtomicRmwXor     , I64AtomicRmwXor     )
+ATOMIC_EVENT(onInstI32AtomicRmw8XorU   , I32AtomicRmw8XorU   )
+ATOMIC_EVENT(onInstI32AtomicRmw16XorU  , I32AtomicRmw16XorU  )
+ATOMIC_EVENT(onInstI64AtomicRmw8XorU   , I64AtomicRmw8XorU   )
+ATOMIC_EVENT(onInstI64AtomicRmw16XorU  , I64AtomicRmw16XorU  )
+ATOMIC_EVENT(onInstI64AtomicRmw32XorU  , I64AtomicRmw32XorU  )
+ATOMIC_EVENT(onInstI32AtomicRmwXchg    , I32AtomicRmwXchg    )
+ATOMIC_EVENT(onInstI64AtomicRmwXchg    , I64AtomicRmwXchg    )
+ATOMIC_EVENT(onInstI32AtomicRmw8XchgU  , I32AtomicRmw8XchgU  )
+ATOMIC_EVENT(onInstI32AtomicRmw16XchgU , I32AtomicRmw16XchgU )
+ATOMIC_EVENT(onInstI64AtomicRmw8XchgU  , I64AtomicRmw8XchgU  )
+ATOMIC_EVENT(onInstI64AtomicRmw16XchgU , I64AtomicRmw16XchgU )
+ATOMIC_EVENT(onInstI64AtomicRmw32XchgU , I64AtomicRmw32XchgU )
+ATOMIC_EVENT(onInstI32AtomicRmwCmpxchg , I32AtomicRmwCmpxchg )
+ATOMIC_EVENT(onInstI64AtomicRmwCmpxchg , I64AtomicRmwCmpxchg )
+ATOMIC_EVENT(onInstI32AtomicRmw8CmpxchgU, I32AtomicRmw8CmpxchgU)
+ATOMIC_EVENT(onInstI32AtomicRmw16CmpxchgU, I32AtomicRmw16CmpxchgU)
+ATOMIC_EVENT(onInstI64AtomicRmw8CmpxchgU, I64AtomicRmw8CmpxchgU)
+ATOMIC_EVENT(onInstI64AtomicRmw16CmpxchgU, I64AtomicRmw16CmpxchgU)
+ATOMIC_EVENT(onInstI64AtomicRmw32CmpxchgU, I64AtomicRmw32CmpxchgU)
+// clang-format on
+#undef ATOMIC_EVENT
+EVENT(onInstAtomicFence)() { addInst<AtomicFence>(); }
 
 EVENT(onInstI32Const)(std::int32_t N) { addInst<I32Const>(N); }
 EVENT(onInstI64Const)(std::int64_t N) { addInst<I64Const>(N); }
@@ -287,28 +371,38 @@ EVENT(onInstI64TruncSatF32U  )() { addInst<I64TruncSatF32U  >(); }
 EVENT(onInstI64TruncSatF64S  )() { addInst<I64TruncSatF64S  >(); }
 EVENT(onInstI64TruncSatF64U  )() { addInst<I64TruncSatF64U  >(); }
 
-EVENT(onInstV128Load         )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load       >(Align, Offset);         }
-EVENT(onInstV128Load8x8S     )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load8x8S   >(Align, Offset);         }
-EVENT(onInstV128Load8x8U     )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load8x8U   >(Align, Offset);         }
-EVENT(onInstV128Load16x4S    )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load16x4S  >(Align, Offset);         }
-EVENT(onInstV128Load16x4U    )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load16x4U  >(Align, Offset);         }
-EVENT(onInstV128Load32x2S    )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load32x2S  >(Align, Offset);         }
-EVENT(onInstV128Load32x2U    )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load32x2U  >(Align, Offset);         }
-EVENT(onInstV128Load8Splat   )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load8Splat >(Align, Offset);         }
-EVENT(onInstV128Load16Splat  )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load16Splat>(Align, Offset);         }
-EVENT(onInstV128Load32Splat  )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load32Splat>(Align, Offset);         }
-EVENT(onInstV128Load64Splat  )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load64Splat>(Align, Offset);         }
-EVENT(onInstV128Load32Zero   )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load32Zero >(Align, Offset);         }
-EVENT(onInstV128Load64Zero   )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Load64Zero >(Align, Offset);         }
-EVENT(onInstV128Load8Lane    )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Load8Lane  >(Align, Offset, LaneID); }
-EVENT(onInstV128Load16Lane   )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Load16Lane >(Align, Offset, LaneID); }
-EVENT(onInstV128Load32Lane   )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Load32Lane >(Align, Offset, LaneID); }
-EVENT(onInstV128Load64Lane   )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Load64Lane >(Align, Offset, LaneID); }
-EVENT(onInstV128Store        )(std::uint32_t Align, std::uint32_t Offset) { addInst<V128Store      >(Align, Offset);         }
-EVENT(onInstV128Store8Lane   )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Store8Lane >(Align, Offset, LaneID); }
-EVENT(onInstV128Store16Lane  )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Store16Lane>(Align, Offset, LaneID); }
-EVENT(onInstV128Store32Lane  )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Store32Lane>(Align, Offset, LaneID); }
-EVENT(onInstV128Store64Lane  )(std::uint32_t Align, std::uint32_t Offset, bytecode::SIMDLaneID LaneID) { addInst<V128Store64Lane>(Align, Offset, LaneID); }
+EVENT(onInstMemoryInit)(bytecode::DataIDX IDX, bytecode::MemIDX Memory) {
+  addInst<MemoryInit>(IDX, Memory);
+}
+EVENT(onInstDataDrop  )(bytecode::DataIDX IDX) { addInst<DataDrop  >(IDX); }
+EVENT(onInstMemoryCopy)(
+    bytecode::MemIDX Destination, bytecode::MemIDX Source) {
+  addInst<MemoryCopy>(Destination, Source);
+}
+EVENT(onInstMemoryFill)(bytecode::MemIDX IDX) { addInst<MemoryFill>(IDX); }
+
+EVENT(onInstV128Load         )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load       >(Align, Offset, Memory);         }
+EVENT(onInstV128Load8x8S     )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load8x8S   >(Align, Offset, Memory);         }
+EVENT(onInstV128Load8x8U     )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load8x8U   >(Align, Offset, Memory);         }
+EVENT(onInstV128Load16x4S    )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load16x4S  >(Align, Offset, Memory);         }
+EVENT(onInstV128Load16x4U    )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load16x4U  >(Align, Offset, Memory);         }
+EVENT(onInstV128Load32x2S    )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load32x2S  >(Align, Offset, Memory);         }
+EVENT(onInstV128Load32x2U    )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load32x2U  >(Align, Offset, Memory);         }
+EVENT(onInstV128Load8Splat   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load8Splat >(Align, Offset, Memory);         }
+EVENT(onInstV128Load16Splat  )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load16Splat>(Align, Offset, Memory);         }
+EVENT(onInstV128Load32Splat  )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load32Splat>(Align, Offset, Memory);         }
+EVENT(onInstV128Load64Splat  )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load64Splat>(Align, Offset, Memory);         }
+EVENT(onInstV128Load32Zero   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load32Zero >(Align, Offset, Memory);         }
+EVENT(onInstV128Load64Zero   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Load64Zero >(Align, Offset, Memory);         }
+EVENT(onInstV128Load8Lane    )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Load8Lane  >(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Load16Lane   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Load16Lane >(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Load32Lane   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Load32Lane >(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Load64Lane   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Load64Lane >(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Store        )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory) { addInst<V128Store      >(Align, Offset, Memory);         }
+EVENT(onInstV128Store8Lane   )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Store8Lane >(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Store16Lane  )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Store16Lane>(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Store32Lane  )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Store32Lane>(Align, Offset, Memory, LaneID); }
+EVENT(onInstV128Store64Lane  )(std::uint32_t Align, std::uint64_t Offset, bytecode::MemIDX Memory, bytecode::SIMDLaneID LaneID) { addInst<V128Store64Lane>(Align, Offset, Memory, LaneID); }
 
 EVENT(onInstV128Const        )(bytecode::V128Value Value             ) { addInst<V128Const>(Value);      }
 EVENT(onInstI8x16Shuffle     )(bytecode::SIMDLaneIDVector<16> Indices) { addInst<I8x16Shuffle>(Indices); }
@@ -106,10 +106,23 @@ public:
     utility::ignore(Index);
     using VectorT = std::vector<std::byte>;
     Module.Data.push_back(bytecode::entities::Data{
+        .Mode = bytecode::entities::DataMode::Active,
         .Memory = Memory,
         .Offset = std::move(this->getExpression()),
         .Initializer = ranges::to<VectorT>(C)});
   }
+  template <ranges::input_range T>
+  void onPassiveDataSectionEntry(SizeType Index, T &&C) {
+    utility::ignore(Index);
+    using VectorT = std::vector<std::byte>;
+    Module.Data.push_back(bytecode::entities::Data{
+        .Mode = bytecode::entities::DataMode::Passive,
+        .Memory = bytecode::MemIDX(0),
+        .Offset = {},
+        .Initializer = ranges::to<VectorT>(C)});
+  }
+
+  void onDataCountSectionEntry(SizeType Count) { Module.DataCount = Count; }
 };
 } // namespace parser
 
@@ -2,6 +2,7 @@
 #define SABLE_INCLUDE_GUARD_PARSER_PARSER
 
 #include "../utility/Commons.h"
+#include "AtomicParser.tcc"
 #include "Delegate.h"
 #include "Reader.h"
 #include "SIMD128Parser.tcc"
@@ -77,6 +78,7 @@ public:
   void parseElementSection();
   void parseCodeSection();
   void parseDataSection();
+  void parseDataCountSection();
 
   void parseCustomSection(std::size_t Size);
 
@@ -236,14 +238,29 @@ void Parser<ReaderImpl, DelegateImpl>::parseDataSection() {
   auto NumEntries = Reader.readULEB128Int32();
   Delegate.enterDataSection(NumEntries);
   for (decltype(NumEntries) I = 0; I < NumEntries; ++I) {
-    auto MemoryIndex = Reader.readMemIDX();
-    parseExpression();
+    auto Flags = Reader.readULEB128Int32();
+    if (Flags > 0x02)
+      throw ParserError(
+          fmt::format("unknown data segment flags 0x{:02x}", Flags));
+    auto MemoryIndex = bytecode::MemIDX(0);
+    if (Flags == 0x02) MemoryIndex = Reader.readMemIDX();
+    if (Flags != 0x01) parseExpression();
     auto NumBytes = Reader.readULEB128Int32();
     auto Bytes = Reader.read(NumBytes);
-    Delegate.onDataSectionEntry(I, MemoryIndex, Bytes);
+    if (Flags == 0x01) {
+      Delegate.onPassiveDataSectionEntry(I, Bytes);
+    } else {
+      Delegate.onDataSectionEntry(I, MemoryIndex, Bytes);
+    }
   }
 }
 
+template <reader ReaderImpl, delegate DelegateImpl>
+void Parser<ReaderImpl, DelegateImpl>::parseDataCountSection() {
+  auto Count = Reader.readULEB128Int32();
+  Delegate.onDataCountSectionEntry(Count);
+}
+
 template <reader ReaderImpl, delegate DelegateImpl>
 void Parser<ReaderImpl, DelegateImpl>::parseCustomSection(std::size_t Size) {
   auto EnterNumBytesConsumed = Reader.getNumBytesConsumed();
@@ -267,14 +284,21 @@ void Parser<ReaderImpl, DelegateImpl>::parseCustomSection(std::size_t Size) {
 
 namespace detail {
 struct WASMSectionOrderPolicy {
-  unsigned PreviousSectionNumber = 0;
+  unsigned PreviousSectionOrder = 0;
+  // data count section (0x0c) sits between element and code section
+  static unsigned getSectionOrder(std::byte SectionMagicNumber) {
+    auto SectionNumber = static_cast<unsigned>(SectionMagicNumber);
+    if (SectionNumber == 0x0c) return 2 * 0x09 + 1;
+    return 2 * SectionNumber;
+  }
   void check(std::byte SectionMagicNumber) {
     using namespace utility::literals;
     /* custom section can appear any where */
     if (SectionMagicNumber == 0x00_byte) return;
-    if (static_cast<unsigned>(SectionMagicNumber) <= PreviousSectionNumber)
+    auto SectionOrder = getSectionOrder(SectionMagicNumber);
+    if (SectionOrder <= PreviousSectionOrder)
       throw ParserError("invalid section ordering");
-    PreviousSectionNumber = static_cast<unsigned>(SectionMagicNumber);
+    PreviousSectionOrder = SectionOrder;
   }
 };
 } // namespace detail
@@ -302,6 +326,7 @@ void Parser<ReaderImpl, DelegateImpl>::parse() {
     case 0x09: parseElementSection(); break;
     case 0x0a: parseCodeSection(); break;
     case 0x0b: parseDataSection(); break;
+    case 0x0c: parseDataCountSection(); break;
     default:
       throw ParserError(fmt::format(
           "unknown section magic number 0x{:02x}", SectionMagicNumber));
@@ -382,10 +407,17 @@ void Parser<ReaderImpl, DelegateImpl>::parseInstruction() {
   }
   case 0x0f: Delegate.onInstReturn(); break;
   case 0x10: Delegate.onInstCall(Reader.readFuncIDX()); break;
-  case 0x11:
-    Delegate.onInstCallIndirect(Reader.readTypeIDX());
-    utility::ignore(Reader.read());
+  case 0x11: {
+    auto Type = Reader.readTypeIDX();
+    Delegate.onInstCallIndirect(Type, Reader.readTableIDX());
+    break;
+  }
+  case 0x12: Delegate.onInstReturnCall(Reader.readFuncIDX()); break;
+  case 0x13: {
+    auto Type = Reader.readTypeIDX();
+    Delegate.onInstReturnCallIndirect(Type, Reader.readTableIDX());
     break;
+  }
 
   case 0x1a: Delegate.onInstDrop(); break;
   case 0x1b: Delegate.onInstSelect(); break;
@@ -404,9 +436,8 @@ void Parser<ReaderImpl, DelegateImpl>::parseInstruction() {
 
 #define SABLE_MEMORY_INSTRUCTION(Opcode, Name)                                 \
   case Opcode: {                                                               \
-    auto Align = Reader.readULEB128Int32();                                    \
-    auto Offset = Reader.readULEB128Int32();                                   \
-    Delegate.onInst##Name(Align, Offset);                                      \
+    auto [Align, Offset, Memory] = Reader.readMemArg();                        \
+    Delegate.onInst##Name(Align, Offset, Memory);                              \
     break;                                                                     \
   }
     SABLE_MEMORY_INSTRUCTION(0x28, I32Load)
@@ -433,16 +464,8 @@ void Parser<ReaderImpl, DelegateImpl>::parseInstruction() {
     SABLE_MEMORY_INSTRUCTION(0x3d, I64Store16)
     SABLE_MEMORY_INSTRUCTION(0x3e, I64Store32)
 #undef SABLE_MEMORY_INSTRUCTION
-  case 0x3f: {
-    utility::ignore(Reader.read());
-    Delegate.onInstMemorySize();
-    break;
-  }
-  case 0x40: {
-    utility::ignore(Reader.read());
-    Delegate.onInstMemoryGrow();
-    break;
-  }
+  case 0x3f: Delegate.onInstMemorySize(Reader.readMemIDX()); break;
+  case 0x40: Delegate.onInstMemoryGrow(Reader.readMemIDX()); break;
 
   case 0x41: Delegate.onInstI32Const(Reader.readSLEB128Int32()); break;
   case 0x42: Delegate.onInstI64Const(Reader.readSLEB128Int64()); break;
@@ -629,6 +652,12 @@ void Parser<ReaderImpl, DelegateImpl>::parseInstruction() {
     break;
   }
 
+  case static_cast<unsigned>(AtomicParserBase::Prefix): {
+    AtomicParser ExtensionParser(Delegate);
+    ExtensionParser(Reader);
+    break;
+  }
+
   default:
     throw ParserError(
         fmt::format("unknown instruction opcode 0x{:02x}", OpcodeByte));
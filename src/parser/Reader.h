@@ -15,6 +15,7 @@
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 
 namespace parser {
 struct ParserError : std::runtime_error {
@@ -107,6 +108,8 @@ public:
   bytecode::ExportDescriptor readExportDescriptor();
 
   bytecode::BlockResultType  readBlockResultType();
+  // alignment, offset and the memory accessed
+  std::tuple<std::uint32_t, std::uint64_t, bytecode::MemIDX> readMemArg();
 
   bytecode::TypeIDX readTypeIDX()
   { return static_cast<bytecode::TypeIDX  >(readULEB128Int32()); }
@@ -122,6 +125,8 @@ public:
   { return static_cast<bytecode::LocalIDX >(readULEB128Int32()); }
   bytecode::LabelIDX readLabelIDX()
   { return static_cast<bytecode::LabelIDX >(readULEB128Int32()); }
+  bytecode::DataIDX readDataIDX()
+  { return static_cast<bytecode::DataIDX  >(readULEB128Int32()); }
   // clang-format on
 };
 
@@ -229,6 +234,7 @@ bytecode::FunctionType WASMReader<ReaderImpl>::readFunctionType() {
 
 template <reader ReaderImpl>
 bytecode::MemoryType WASMReader<ReaderImpl>::readMemoryType() {
+  // bit 0: maximum present, bit 1: shared, bit 2: 64-bit index type
   auto MagicNumber = read();
   switch (static_cast<unsigned>(MagicNumber)) {
   case 0x00: {
@@ -240,10 +246,26 @@ bytecode::MemoryType WASMReader<ReaderImpl>::readMemoryType() {
     auto Max = readULEB128Int32();
     return bytecode::MemoryType(Min, Max);
   }
+  case 0x03: {
+    auto Min = readULEB128Int32();
+    auto Max = readULEB128Int32();
+    return bytecode::MemoryType(Min, Max, true);
+  }
+  case 0x04: {
+    auto Min = readULEB128Int64();
+    return bytecode::MemoryType(Min, std::nullopt, false, true);
+  }
+  case 0x05:
+  case 0x07: {
+    auto Min = readULEB128Int64();
+    auto Max = readULEB128Int64();
+    auto Shared = (static_cast<unsigned>(MagicNumber) & 0x02U) != 0;
+    return bytecode::MemoryType(Min, Max, Shared, true);
+  }
   default:
     throw ParserError(fmt::format(
-        "mismatched memory type magic number, expecting 0x00 or 0x01, but "
-        "0x{:02x} found",
+        "mismatched memory type magic number, expecting 0x00, 0x01, 0x03, "
+        "0x04, 0x05 or 0x07, but 0x{:02x} found",
         MagicNumber));
   }
 }
@@ -336,6 +358,20 @@ bytecode::BlockResultType WASMReader<ReaderImpl>::readBlockResultType() {
         "function index in block type beyonds maximum possible value");
   return static_cast<bytecode::TypeIDX>(Index);
 }
+
+template <reader ReaderImpl>
+std::tuple<std::uint32_t, std::uint64_t, bytecode::MemIDX>
+WASMReader<ReaderImpl>::readMemArg() {
+  // multi-memory flags an explicit memory index with bit 6 of the alignment
+  auto Align = readULEB128Int32();
+  auto Memory = bytecode::MemIDX(0);
+  if ((Align & 0x40) != 0) {
+    Align = Align & ~std::uint32_t(0x40);
+    Memory = readMemIDX();
+  }
+  auto Offset = readULEB128Int64();
+  return std::make_tuple(Align, Offset, Memory);
+}
 } // namespace parser
 
 #endif
@@ -19,9 +19,8 @@ template <delegate DelegateType> struct SIMDParser : SIMDParserBase {
     switch (static_cast<unsigned>(SIMDOpcode)) {
 #define SABLE_MEMORY_INSTRUCTION(Opcode, Name)                                 \
   case Opcode: {                                                               \
-    auto Align = Reader.readULEB128Int32();                                    \
-    auto Offset = Reader.readULEB128Int32();                                   \
-    Delegate.onInst##Name(Align, Offset);                                      \
+    auto [Align, Offset, Memory] = Reader.readMemArg();                        \
+    Delegate.onInst##Name(Align, Offset, Memory);                              \
     break;                                                                     \
   }
       SABLE_MEMORY_INSTRUCTION(0x00, V128Load)
@@ -236,15 +235,13 @@ template <delegate DelegateType> struct SIMDParser : SIMDParserBase {
     case 0xfa: Delegate.onInstF32x4ConvertI32x4S(); break;
     case 0xfb: Delegate.onInstF32x4ConvertI32x4U(); break;
     case 0x5c: {
-      auto Align = Reader.readULEB128Int32();
-      auto Offset = Reader.readULEB128Int32();
-      Delegate.onInstV128Load32Zero(Align, Offset);
+      auto [Align, Offset, Memory] = Reader.readMemArg();
+      Delegate.onInstV128Load32Zero(Align, Offset, Memory);
       break;
     }
     case 0x5d: {
-      auto Align = Reader.readULEB128Int32();
-      auto Offset = Reader.readULEB128Int32();
-      Delegate.onInstV128Load64Zero(Align, Offset);
+      auto [Align, Offset, Memory] = Reader.readMemArg();
+      Delegate.onInstV128Load64Zero(Align, Offset, Memory);
       break;
     }
     case 0x9c: Delegate.onInstI16x8ExtMulLowI8x16S(); break;
@@ -263,10 +260,9 @@ template <delegate DelegateType> struct SIMDParser : SIMDParserBase {
     case 0x53: Delegate.onInstV128AnyTrue(); break;
 #define SABLE_LOAD_STORE_LANE_INSTRUCTION(Opcode, Name)                        \
   case Opcode: {                                                               \
-    auto Align = Reader.readULEB128Int32();                                    \
-    auto Offset = Reader.readULEB128Int32();                                   \
+    auto [Align, Offset, Memory] = Reader.readMemArg();                        \
     auto LaneIndex = static_cast<bytecode::SIMDLaneID>(Reader.read());         \
-    Delegate.onInst##Name(Align, Offset, LaneIndex);                           \
+    Delegate.onInst##Name(Align, Offset, Memory, LaneIndex);                   \
     break;                                                                     \
   }
       SABLE_LOAD_STORE_LANE_INSTRUCTION(0x54, V128Load8Lane)
@@ -27,6 +27,19 @@ struct SaturationArithmeticParser : SaturationArithmeticParserBase {
     case 0x05: Delegate.onInstI64TruncSatF32U(); break;
     case 0x06: Delegate.onInstI64TruncSatF64S(); break;
     case 0x07: Delegate.onInstI64TruncSatF64U(); break;
+    /* bulk memory operations share the 0xfc prefix */
+    case 0x08: {
+      auto Segment = Reader.readDataIDX();
+      Delegate.onInstMemoryInit(Segment, Reader.readMemIDX());
+      break;
+    }
+    case 0x09: Delegate.onInstDataDrop(Reader.readDataIDX()); break;
+    case 0x0a: {
+      auto Destination = Reader.readMemIDX();
+      Delegate.onInstMemoryCopy(Destination, Reader.readMemIDX());
+      break;
+    }
+    case 0x0b: Delegate.onInstMemoryFill(Reader.readMemIDX()); break;
     default:
       throw ParserError(fmt::format(
           "unknown saturation arithmetic instruction 0xfc 0x{:02x}", Opcode));
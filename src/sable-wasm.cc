@@ -3,6 +3,8 @@
 #include "mir/MIRCodegen.h"
 #include "mir/MIRPrinter.h"
 #include "mir/Module.h"
+#include "mir/passes/Devirtualization.h"
+#include "mir/passes/GuardElimination.h"
 #include "parser/ByteArrayReader.h"
 #include "parser/ModuleBuilderDelegate.h"
 #include "parser/Parser.h"
@@ -94,7 +96,11 @@ codegen::llvm_instance::TranslationOptions getMIRToLLVMCodegenOptions() {
       ArgOptions["unsafe"].as<bool>(),
     .AssumeMemRWAligned =
       ArgOptions["codegen-rw-aligned"].as<bool>()  ||
-      ArgOptions["unsafe"].as<bool>()};
+      ArgOptions["unsafe"].as<bool>(),
+    .UseMemGuardPage =
+      ArgOptions["codegen-guard-page"].as<bool>(),
+    .ReserveMemory =
+      ArgOptions["codegen-reserve-memory"].as<bool>()};
   // clang-format on
   return TOptions;
 }
@@ -167,6 +173,17 @@ void process(
       BytecodeModule, MIRModule, Name);
   BytecodeToMIRTranslationTask.perform();
 
+  if (ArgOptions["opt"].as<bool>()) {
+    mir::passes::SimpleModulePassDriver<mir::passes::DevirtualizationPass>
+        Devirtualization;
+    Devirtualization(MIRModule);
+    using GuardEliminationDriver =
+        mir::passes::SimpleForEachFunctionPassDriver<
+            mir::passes::GuardEliminationPass>;
+    GuardEliminationDriver GuardElimination;
+    GuardElimination(MIRModule);
+  }
+
   if (ArgOptions["emit-mir"].as<bool>() || ArgOptions["debug"].as<bool>()) {
     auto MIRFilePath = Out;
     MIRFilePath.replace_extension(".mir");
@@ -240,6 +257,10 @@ int main(int argc, char const *argv[]) {
    cxxopts::value<bool>()->default_value("false"))
   ("codegen-rw-aligned"   , "assume linear memory access is always aligned"    ,
    cxxopts::value<bool>()->default_value("false"))
+  ("codegen-guard-page"   , "trap linear memory out of bound with guard pages" ,
+   cxxopts::value<bool>()->default_value("false"))
+  ("codegen-reserve-memory", "reserve maximum memory size, grow in place"      ,
+   cxxopts::value<bool>()->default_value("false"))
   ;
   // clang-format on
 
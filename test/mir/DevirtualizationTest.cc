@@ -0,0 +1,94 @@
+#include "TestUtil.h"
+
+#include "mir/Branch.h"
+#include "mir/passes/Devirtualization.h"
+
+#include <string_view>
+
+namespace {
+namespace minsts = mir::instructions;
+
+std::size_t runDevirtualization(mir::Module &Module) {
+  mir::passes::SimpleModulePassDriver<mir::passes::DevirtualizationPass>
+      Devirtualization;
+  return Devirtualization(Module);
+}
+
+mir::Instruction &getTerminator(mir::Module &Module, std::string_view Name) {
+  return mir::test::getFunction(Module, Name).getEntryBasicBlock().back();
+}
+} // namespace
+
+// call_indirect through a table whose content is known calls the candidates
+// directly and falls back to itself on any other index, see
+// devirtualization.wat for the functions checked.
+int main(int argc, char const *argv[]) {
+  using namespace mir::test;
+  auto ModulePath = getModulePath(argc, argv);
+  auto Module = load(ModulePath);
+  expect(runDevirtualization(*Module) == 2, "both call sites devirtualized");
+  auto *One = std::addressof(getFunction(*Module, "one"));
+  auto *Two = std::addressof(getFunction(*Module, "two"));
+  auto *Zero = std::addressof(getFunction(*Module, "zero"));
+
+  {
+    auto &Function = getFunction(*Module, "single");
+    auto Calls = collect<minsts::Call>(Function);
+    auto Fallbacks = collect<minsts::CallIndirect>(Function);
+    expect(Calls.size() == 1, "single candidate called directly");
+    expect(Calls[0]->getTarget() == Zero, "candidate called");
+    expect(Fallbacks.size() == 1, "call_indirect kept as the fallback");
+    auto &Terminator = getTerminator(*Module, "single");
+    expect(is_a<minsts::branch::Conditional>(Terminator), "index compared");
+    auto &Branch = dyn_cast<minsts::branch::Conditional>(Terminator);
+    expect(Branch.getTrue() == Calls[0]->getParent(), "direct call on a hit");
+    expect(
+        Branch.getFalse() == Fallbacks[0]->getParent(),
+        "call_indirect on a miss");
+  }
+
+  {
+    auto &Function = getFunction(*Module, "switch");
+    auto Calls = collect<minsts::Call>(Function);
+    auto Fallbacks = collect<minsts::CallIndirect>(Function);
+    expect(Calls.size() == 2, "one direct call per candidate function");
+    expect(Calls[0]->getTarget() != Calls[1]->getTarget(), "calls differ");
+    for (auto *Call : Calls)
+      expect(
+          (Call->getTarget() == One) || (Call->getTarget() == Two),
+          "candidate called");
+    expect(Fallbacks.size() == 1, "call_indirect kept as the fallback");
+    auto &Terminator = getTerminator(*Module, "switch");
+    expect(is_a<minsts::branch::Switch>(Terminator), "dispatch on the index");
+    auto &Branch = dyn_cast<minsts::branch::Switch>(Terminator);
+    auto *FallbackBB = Fallbacks[0]->getParent();
+    expect(Branch.getDefaultTarget() == FallbackBB, "index past the table");
+    expect(Branch.getNumTargets() == 4, "one target per table entry");
+    expect(Branch.getTarget(0) == Branch.getTarget(3), "$one at 0 and 3");
+    expect(Branch.getTarget(0) != FallbackBB, "$one called directly");
+    expect(Branch.getTarget(2) != FallbackBB, "$two called directly");
+    expect(Branch.getTarget(0) != Branch.getTarget(2), "$two called directly");
+    expect(Branch.getTarget(1) == FallbackBB, "entry of another type");
+  }
+
+  // the content of an imported or exported table may change at runtime
+  for (auto IsImported : {true, false}) {
+    auto SharedModule = load(ModulePath);
+    for (auto &Table : SharedModule->getTables().asView()) {
+      if (IsImported) {
+        Table.setImport("env", "table");
+      } else {
+        Table.setExport("table");
+      }
+    }
+    expect(runDevirtualization(*SharedModule) == 0, "table left alone");
+    for (std::string_view Name : {"single", "switch"}) {
+      auto &Function = getFunction(*SharedModule, Name);
+      expect(collect<minsts::Call>(Function).empty(), "no direct call");
+      expect(
+          collect<minsts::CallIndirect>(Function).size() == 1,
+          "call_indirect kept");
+    }
+  }
+  return 0;
+}
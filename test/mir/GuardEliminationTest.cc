@@ -0,0 +1,88 @@
+#include "TestUtil.h"
+
+#include "mir/passes/GuardElimination.h"
+
+#include <string_view>
+#include <vector>
+
+namespace {
+namespace minsts = mir::instructions;
+
+struct GuardEliminationResult {
+  std::vector<minsts::MemoryGuard *> Guards;
+  mir::passes::GuardEliminationPass::AnalysisResult Stats;
+  bool IsHoisted;
+};
+
+GuardEliminationResult
+runGuardElimination(mir::Module &Module, std::string_view Name) {
+  using namespace mir::passes;
+  auto &Function = mir::test::getFunction(Module, Name);
+  SimpleFunctionPassDriver<GuardEliminationPass> GuardElimination;
+  auto Stats = GuardElimination(Function);
+  auto Guards = mir::test::collect<minsts::MemoryGuard>(Function);
+  auto const *EntryBB = std::addressof(Function.getEntryBasicBlock());
+  auto IsHoisted = !Guards.empty() && (Guards.front()->getParent() == EntryBB);
+  return GuardEliminationResult{
+      .Guards = std::move(Guards), .Stats = Stats, .IsHoisted = IsHoisted};
+}
+} // namespace
+
+// A guard may only be dropped or merged into another one if that guard is on
+// the same base, at least as wide and executed before it on every path. A
+// guard must not be moved across an instruction whose effects are observable
+// after the trap, see guard-elimination.wat for the functions checked.
+int main(int argc, char const *argv[]) {
+  using namespace mir::test;
+  auto Module = load(getModulePath(argc, argv));
+  auto Run = [&](std::string_view Name) {
+    return runGuardElimination(*Module, Name);
+  };
+
+  auto Covered = Run("covered");
+  expect(Covered.Guards.size() == 1, "covered guard dropped");
+  expect(Covered.Guards[0]->getGuardSize() == 32, "covering guard kept");
+  expect(Covered.Stats.NumEliminated == 1, "covered guard counted");
+
+  auto Widened = Run("widened");
+  expect(Widened.Guards.size() == 1, "guards merged");
+  expect(Widened.Guards[0]->getGuardSize() == 32, "earlier guard widened");
+
+  for (std::string_view Name : {"call_between", "grow_between"}) {
+    auto Result = Run(Name);
+    expect(Result.Guards.size() == 2, "guard not widened across effects");
+    expect(Result.Guards[0]->getGuardSize() == 8, "earlier guard unchanged");
+    expect(Result.Stats.NumEliminated == 0, "no guard eliminated");
+  }
+
+  auto CoveredAcrossGrow = Run("covered_across_grow");
+  expect(CoveredAcrossGrow.Guards.size() == 1, "passed guard stays valid");
+
+  expect(Run("rebased").Guards.size() == 2, "guards on different bases kept");
+
+  auto Dominated = Run("dominated");
+  expect(Dominated.Guards.size() == 1, "dominated guard removed");
+  expect(Dominated.Guards[0]->getGuardSize() == 32, "dominating guard kept");
+  expect(Dominated.Stats.NumEliminated == 1, "dominated guard counted");
+
+  expect(Run("dominated_narrower").Guards.size() == 2, "wider guard kept");
+  expect(Run("siblings").Guards.size() == 2, "guards not dominated kept");
+
+  auto Hoisted = Run("hoisted");
+  expect(Hoisted.Stats.NumHoisted == 1, "invariant guard hoisted");
+  expect(Hoisted.IsHoisted, "guard moved to the preheader");
+
+  auto HoistedCovers = Run("hoisted_covers");
+  expect(HoistedCovers.Stats.NumHoisted == 1, "invariant guard hoisted");
+  expect(HoistedCovers.Stats.NumEliminated == 1, "guard in the loop removed");
+  expect(HoistedCovers.Guards.size() == 1, "only the hoisted guard is left");
+  expect(HoistedCovers.IsHoisted, "guard moved to the preheader");
+
+  for (std::string_view Name : {"call_in_loop", "grow_in_loop"}) {
+    auto Result = Run(Name);
+    expect(Result.Stats.NumHoisted == 0, "guard not hoisted across effects");
+    expect(Result.Guards.size() == 1, "guard kept in the loop");
+    expect(!Result.IsHoisted, "guard kept in the loop");
+  }
+  return 0;
+}
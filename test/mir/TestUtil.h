@@ -0,0 +1,61 @@
+#ifndef SABLE_INCLUDE_GUARD_TEST_MIR_TEST_UTIL
+#define SABLE_INCLUDE_GUARD_TEST_MIR_TEST_UTIL
+
+#include "../runtime/TestUtil.h"
+
+#include "bytecode/Validation.h"
+#include "mir/MIRCodegen.h"
+#include "mir/Module.h"
+#include "parser/ByteArrayReader.h"
+#include "parser/ModuleBuilderDelegate.h"
+#include "parser/Parser.h"
+#include "utility/Commons.h"
+
+#include <mio/mmap.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// The MIR tests translate a test module next to them into MIR and inspect the
+// result of running a pass on it.
+namespace mir::test {
+using runtime::test::expect;
+using runtime::test::getModulePath;
+
+inline std::unique_ptr<mir::Module> load(std::filesystem::path const &Path) {
+  mio::basic_mmap_source<std::byte> Source(Path.c_str());
+  parser::ByteArrayReader Reader(Source);
+  parser::ModuleBuilderDelegate ModuleBuilderDelegate;
+  parser::Parser BytecodeParser(Reader, ModuleBuilderDelegate);
+  BytecodeParser.parse();
+  auto &BytecodeModule = ModuleBuilderDelegate.getModule();
+  expect(
+      bytecode::validation::validate(BytecodeModule) == nullptr,
+      "test module validates");
+  auto Module = std::make_unique<mir::Module>();
+  mir::bytecode_codegen::ModuleTranslationTask Task(BytecodeModule, *Module);
+  Task.perform();
+  return Module;
+}
+
+inline mir::Function &
+getFunction(mir::Module &Module, std::string_view ExportName) {
+  for (auto &Function : Module.getFunctions().asView())
+    if (Function.isExported() && (Function.getExportName() == ExportName))
+      return Function;
+  expect(false, "test function exported");
+  utility::unreachable();
+}
+
+template <ast_node T> std::vector<T *> collect(mir::Function &Function) {
+  std::vector<T *> Result;
+  for (auto &BasicBlock : Function.getBasicBlocks().asView())
+    for (auto &Instruction : BasicBlock)
+      if (is_a<T>(Instruction)) Result.push_back(dyn_cast<T>(&Instruction));
+  return Result;
+}
+} // namespace mir::test
+
+#endif
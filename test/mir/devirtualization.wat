@@ -0,0 +1,20 @@
+;; Source of devirtualization.wasm, the module devirtualization-test runs the
+;; devirtualization pass on. Its table is neither imported nor exported, the
+;; test imports or exports it to check that such tables are left alone.
+(module
+  (type $unary (func (param i32) (result i32)))
+  (type $nullary (func (result i32)))
+  (table 4 funcref)
+  (elem (i32.const 0) $one $zero $two $one)
+  (func $one (export "one") (type $unary)
+    (i32.add (local.get 0) (i32.const 1)))
+  (func $two (export "two") (type $unary)
+    (i32.add (local.get 0) (i32.const 2)))
+  (func $zero (export "zero") (type $nullary)
+    (i32.const 0))
+  ;; $zero at 1 is the only entry of the type
+  (func (export "single") (type $unary)
+    (call_indirect (type $nullary) (local.get 0)))
+  ;; $one at 0 and 3 and $two at 2 have the type
+  (func (export "switch") (type $unary)
+    (call_indirect (type $unary) (local.get 0) (local.get 0))))
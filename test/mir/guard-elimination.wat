@@ -0,0 +1,96 @@
+;; Source of guard-elimination.wasm, the module guard-elimination-test runs the
+;; guard elimination pass on. Every function accesses the memory through its
+;; first parameter, the second one is a branch condition or a loop counter.
+(module
+  (type $sink (func (param i32)))
+  (memory 1)
+  (func $nop)
+  ;; the later guard is covered by the earlier one on the same base
+  (func (export "covered") (param i32 i32)
+    (drop (i32.load (local.get 0)))
+    (drop (i32.load8_u (local.get 0))))
+  ;; the earlier guard is widened to cover the later one
+  (func (export "widened") (param i32 i32)
+    (drop (i32.load8_u (local.get 0)))
+    (drop (i32.load (local.get 0))))
+  ;; a widened guard would trap before the call had its effects
+  (func (export "call_between") (param i32 i32)
+    (drop (i32.load8_u (local.get 0)))
+    (call $nop)
+    (drop (i32.load (local.get 0))))
+  ;; and before memory.grow, after which the later access may be in bounds
+  (func (export "grow_between") (param i32 i32)
+    (drop (i32.load8_u (local.get 0)))
+    (drop (memory.grow (i32.const 1)))
+    (drop (i32.load (local.get 0))))
+  ;; memories never shrink, a passed guard stays valid across memory.grow
+  (func (export "covered_across_grow") (param i32 i32)
+    (drop (i32.load (local.get 0)))
+    (drop (memory.grow (i32.const 1)))
+    (drop (i32.load8_u (local.get 0))))
+  ;; the base is written in between
+  (func (export "rebased") (param i32 i32)
+    (drop (i32.load (local.get 0)))
+    (local.set 0 (local.get 1))
+    (drop (i32.load8_u (local.get 0))))
+  ;; the guard in the branch is dominated and covered by the one before it
+  (func (export "dominated") (param i32 i32)
+    (drop (i32.load (local.get 0)))
+    local.get 0
+    local.get 1
+    if (type $sink)
+      i32.load8_u
+      drop
+    else
+      drop
+    end)
+  ;; dominated but not covered
+  (func (export "dominated_narrower") (param i32 i32)
+    (drop (i32.load8_u (local.get 0)))
+    local.get 0
+    local.get 1
+    if (type $sink)
+      i32.load
+      drop
+    else
+      drop
+    end)
+  ;; covered but not dominated
+  (func (export "siblings") (param i32 i32)
+    local.get 0
+    local.get 1
+    if (type $sink)
+      i32.load
+      drop
+    else
+      i32.load8_u
+      drop
+    end)
+  ;; the guard on the loop invariant base is hoisted into the preheader
+  (func (export "hoisted") (param i32 i32)
+    loop
+      (drop (i32.load (local.get 0)))
+      (br_if 0 (local.tee 1 (i32.sub (local.get 1) (i32.const 1))))
+    end)
+  ;; the hoisted guard also covers the guard in the branch of the loop body
+  (func (export "hoisted_covers") (param i32 i32)
+    loop
+      (drop (i32.load (local.get 0)))
+      (if (local.get 1)
+        (then (drop (i32.load8_u (local.get 0)))))
+      (br_if 0 (local.tee 1 (i32.sub (local.get 1) (i32.const 1))))
+    end)
+  ;; a hoisted guard would trap before the call had its effects
+  (func (export "call_in_loop") (param i32 i32)
+    loop
+      (call $nop)
+      (drop (i32.load (local.get 0)))
+      (br_if 0 (local.tee 1 (i32.sub (local.get 1) (i32.const 1))))
+    end)
+  ;; and before memory.grow
+  (func (export "grow_in_loop") (param i32 i32)
+    loop
+      (drop (memory.grow (i32.const 1)))
+      (drop (i32.load (local.get 0)))
+      (br_if 0 (local.tee 1 (i32.sub (local.get 1) (i32.const 1))))
+    end))
@@ -0,0 +1,34 @@
+#include "TestUtil.h"
+
+#include "codegen-llvm-instance/WebAssemblyInstance.h"
+
+#include <cstdint>
+
+// An i32.add on the address wraps around while the static offset of a memory
+// access does not, the two must not be confused when guards are optimized.
+int main(int argc, char const *argv[]) {
+  using namespace runtime;
+  using namespace runtime::test;
+  auto Instance =
+      WebAssemblyInstanceBuilder(getModulePath(argc, argv)).Build();
+  auto LoadWrapped = Instance->getFunction("load_wrapped");
+  auto LoadOffset = Instance->getFunction("load_offset");
+  auto Load = [](WebAssemblyCallee const &Callee, std::uint32_t Address) {
+    return Callee.invoke<std::int32_t>(static_cast<std::int32_t>(Address));
+  };
+  using OutOfBound = exceptions::MemoryAccessOutOfBound;
+
+  // 0xfffffff0 + 0x20 wraps around to 0x10, where the data segment is
+  expect(Load(LoadWrapped, 0xfffffff0) == 0x6c626173, "wrapped load");
+  expect(Load(LoadWrapped, 0) == 0, "wrapped load in bound");
+
+  expect(
+      isThrown<OutOfBound>([&] { Load(LoadOffset, 0xfffffff0); }),
+      "static offset past 4 GiB traps");
+  // the last word of the single page is 0xfffc + 4 bytes
+  expect(Load(LoadOffset, 0xfffc - 0x20) == 0, "static offset in bound");
+  expect(
+      isThrown<OutOfBound>([&] { Load(LoadOffset, 0xfffd - 0x20); }),
+      "static offset past the memory size traps");
+  return 0;
+}
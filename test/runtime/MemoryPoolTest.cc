@@ -0,0 +1,57 @@
+#include "TestUtil.h"
+
+#include "codegen-llvm-instance/WebAssemblyInstance.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+bool isZero(
+    runtime::WebAssemblyMemory const &Memory, std::size_t First,
+    std::size_t Last) {
+  auto *Data = Memory.data();
+  return std::all_of(Data + First, Data + Last, [](std::byte Byte) {
+    return Byte == std::byte(0);
+  });
+}
+} // namespace
+
+// A pooled slot restored from a snapshot and released must not hand the
+// snapshot content over to the next instance built without it.
+int main(int argc, char const *argv[]) {
+  using namespace runtime;
+  using namespace runtime::test;
+  auto Module = WebAssemblyModule::load(getModulePath(argc, argv));
+  auto PageSize = WebAssemblyMemory::getWebAssemblyPageSize();
+  WebAssemblyInstancePool Pool(Module, 1);
+
+  std::shared_ptr<WebAssemblySnapshot> Snapshot;
+  {
+    auto Instance = WebAssemblyInstanceBuilder(Pool).Build();
+    auto &Memory = Instance->getMemory("memory");
+    expect(Memory.grow(1) == 1, "memory grows to two pages");
+    std::memset(Memory.data(), 0x5a, Memory.getSizeInBytes());
+    Snapshot = Instance->snapshot();
+  }
+
+  {
+    auto Builder = WebAssemblyInstanceBuilder(Pool);
+    auto Instance = Builder.restore(Snapshot).Build();
+    auto &Memory = Instance->getMemory("memory");
+    expect(Memory.getSizeInBytes() == 2 * PageSize, "snapshot size restored");
+    expect(Memory[0] == std::byte(0x5a), "snapshot content restored");
+    expect(Memory[PageSize] == std::byte(0x5a), "snapshot content restored");
+    Memory[1] = std::byte(0x33);
+  }
+
+  auto Instance = WebAssemblyInstanceBuilder(Pool).Build();
+  auto &Memory = Instance->getMemory("memory");
+  expect(Memory.getSizeInBytes() == PageSize, "memory shrinks to its minimum");
+  expect(std::memcmp(&Memory[16], "sable", 5) == 0, "data segment applied");
+  expect(isZero(Memory, 0, 16), "no content leaks from the snapshot");
+  expect(isZero(Memory, 21, PageSize), "no content leaks from the snapshot");
+  // committed again over the page the snapshot held
+  expect(Memory.grow(1) == 1, "memory grows to two pages");
+  expect(isZero(Memory, PageSize, 2 * PageSize), "no content leaks on grow");
+  return 0;
+}
@@ -0,0 +1,34 @@
+#ifndef SABLE_INCLUDE_GUARD_TEST_RUNTIME_TEST_UTIL
+#define SABLE_INCLUDE_GUARD_TEST_RUNTIME_TEST_UTIL
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+
+// Every runtime test is a plain executable taking the compiled runtime-test
+// module as its only argument, it exits with 1 on the first failed check.
+namespace runtime::test {
+inline void expect(bool Condition, std::string_view Message) {
+  if (Condition) return;
+  fmt::print(stderr, "FAILED: {}\n", Message);
+  std::exit(1);
+}
+
+template <typename ExceptionType, typename BodyType>
+bool isThrown(BodyType const &Body) {
+  try {
+    Body();
+  } catch (ExceptionType const &) { return true; }
+  return false;
+}
+
+inline std::filesystem::path getModulePath(int argc, char const *argv[]) {
+  if (argc == 2) return argv[1];
+  fmt::print(stderr, "usage: {} <test module>\n", argv[0]);
+  std::exit(1);
+}
+} // namespace runtime::test
+
+#endif
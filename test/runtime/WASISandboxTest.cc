@@ -0,0 +1,176 @@
+#include "TestUtil.h"
+
+#include "codegen-llvm-instance/WASI.h"
+#include "codegen-llvm-instance/WebAssemblyInstance.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace {
+// guest addresses of the path arguments and of the results
+constexpr std::int32_t PathAddress = 1024;
+constexpr std::int32_t OtherPathAddress = 2048;
+constexpr std::int32_t ResultAddress = 3072;
+
+std::int32_t
+putPath(runtime::WebAssemblyMemory &Memory, std::int32_t Address,
+        std::string_view Path) {
+  std::memcpy(std::addressof(Memory[Address]), Path.data(), Path.size());
+  return static_cast<std::int32_t>(Path.size());
+}
+} // namespace
+
+// Guest paths must stay beneath their preopened directory, even through
+// symbolic links planted in it that point outside.
+int main(int argc, char const *argv[]) {
+  using namespace runtime;
+  using namespace runtime::test;
+  namespace fs = std::filesystem;
+  auto ModulePath = getModulePath(argc, argv);
+
+  auto Template = (fs::temp_directory_path() / "sable-wasi-XXXXXX").string();
+  expect(mkdtemp(Template.data()) != nullptr, "temporary directory created");
+  auto Base = fs::path(Template);
+  auto Root = Base / "root";
+  auto Outside = Base / "outside";
+  fs::create_directory(Root);
+  fs::create_directory(Outside);
+  std::ofstream(Outside / "secret") << "secret";
+  fs::create_directory_symlink("../outside", Root / "escape");
+  fs::create_directory_symlink(Outside, Root / "absolute");
+  fs::create_directory(Root / "inside");
+  fs::create_directory_symlink("inside", Root / "alias");
+
+  auto Context = std::make_shared<wasi::WASIContext>();
+  expect(Context->preopen(Root, "/sandbox"), "directory preopened");
+  // stdio takes 0 to 2, the first preopened directory follows
+  constexpr std::int32_t DirFD = 3;
+
+  auto Module = WebAssemblyModule::load(ModulePath);
+  auto Instance = WebAssemblyInstanceBuilder(Module).Build();
+  wasi::bind(*Instance, Context);
+  auto &Memory = Instance->getMemory("memory");
+  auto *InstancePtr = Instance->asInstancePtr();
+
+  auto Open = [&](std::string_view Path, std::int32_t OpenFlags) {
+    auto Length = putPath(Memory, PathAddress, Path);
+    auto Rights = static_cast<std::int64_t>(
+        wasi::RIGHTS_FD_READ | wasi::RIGHTS_FD_WRITE);
+    return wasi::path_open(
+        InstancePtr, DirFD, wasi::LOOKUPFLAGS_SYMLINK_FOLLOW, PathAddress,
+        Length, OpenFlags, Rights, Rights, 0, ResultAddress);
+  };
+  auto Stat = [&](std::string_view Path, std::int32_t LookupFlags) {
+    auto Length = putPath(Memory, PathAddress, Path);
+    return wasi::path_filestat_get(
+        InstancePtr, DirFD, LookupFlags, PathAddress, Length, ResultAddress);
+  };
+
+  // symbolic links staying beneath the directory still resolve
+  expect(Open("alias/file", wasi::OFLAGS_CREAT) == wasi::ERRNO_SUCCESS,
+         "file created through a symbolic link inside the directory");
+  expect(fs::exists(Root / "inside" / "file"), "file created inside");
+
+  // a descriptor only allows the operations of its rights
+  auto FileLength = putPath(Memory, PathAddress, "inside/file");
+  auto ReadOnly = static_cast<std::int64_t>(wasi::RIGHTS_FD_READ);
+  expect(wasi::path_open(
+             InstancePtr, DirFD, 0, PathAddress, FileLength, 0, ReadOnly,
+             ReadOnly, 0, ResultAddress) == wasi::ERRNO_SUCCESS,
+         "read only file opened");
+  std::int32_t FileFD = 0;
+  std::memcpy(&FileFD, std::addressof(Memory[ResultAddress]), sizeof(FileFD));
+  expect(wasi::fd_write(InstancePtr, FileFD, OtherPathAddress, 0,
+                        ResultAddress) == wasi::ERRNO_NOTCAPABLE,
+         "write without the right");
+  expect(wasi::fd_seek(InstancePtr, FileFD, 1, wasi::WHENCE_SET,
+                       ResultAddress) == wasi::ERRNO_NOTCAPABLE,
+         "seek without the right");
+  expect(wasi::fd_read(InstancePtr, FileFD, OtherPathAddress, 0,
+                       ResultAddress) == wasi::ERRNO_SUCCESS,
+         "read with the right");
+  expect(wasi::fd_close(InstancePtr, FileFD) == wasi::ERRNO_SUCCESS,
+         "read only file closed");
+
+  for (std::string_view Link : {"escape", "absolute"}) {
+    auto Secret = fmt::format("{}/secret", Link);
+    auto Created = fmt::format("{}/created", Link);
+
+    expect(Open(Secret, 0) != wasi::ERRNO_SUCCESS, "open escapes");
+    expect(Open(Created, wasi::OFLAGS_CREAT) != wasi::ERRNO_SUCCESS,
+           "open with create escapes");
+    expect(!fs::exists(Outside / "created"), "file created outside");
+
+    auto Length = putPath(Memory, PathAddress, Created);
+    expect(wasi::path_create_directory(
+               InstancePtr, DirFD, PathAddress, Length) != wasi::ERRNO_SUCCESS,
+           "path_create_directory escapes");
+    expect(!fs::exists(Outside / "created"), "directory created outside");
+
+    Length = putPath(Memory, PathAddress, Secret);
+    expect(wasi::path_unlink_file(InstancePtr, DirFD, PathAddress, Length) !=
+               wasi::ERRNO_SUCCESS,
+           "path_unlink_file escapes");
+    expect(wasi::path_remove_directory(
+               InstancePtr, DirFD, PathAddress, Length) != wasi::ERRNO_SUCCESS,
+           "path_remove_directory escapes");
+    expect(fs::exists(Outside / "secret"), "file removed outside");
+
+    auto OtherLength = putPath(Memory, OtherPathAddress, "stolen");
+    expect(wasi::path_rename(
+               InstancePtr, DirFD, PathAddress, Length, DirFD,
+               OtherPathAddress, OtherLength) != wasi::ERRNO_SUCCESS,
+           "path_rename escapes");
+    expect(fs::exists(Outside / "secret"), "file renamed from outside");
+    expect(!fs::exists(Root / "stolen"), "file renamed from outside");
+
+    OtherLength = putPath(Memory, OtherPathAddress, "linked");
+    expect(wasi::path_link(
+               InstancePtr, DirFD, wasi::LOOKUPFLAGS_SYMLINK_FOLLOW,
+               PathAddress, Length, DirFD, OtherPathAddress,
+               OtherLength) != wasi::ERRNO_SUCCESS,
+           "path_link escapes");
+    expect(!fs::exists(Root / "linked"), "file linked from outside");
+
+    expect(Stat(Secret, 0) != wasi::ERRNO_SUCCESS, "filestat escapes");
+    expect(Stat(Link, wasi::LOOKUPFLAGS_SYMLINK_FOLLOW) != wasi::ERRNO_SUCCESS,
+           "filestat follows the link outside");
+    expect(Stat(Link, 0) == wasi::ERRNO_SUCCESS, "filestat of the link");
+    wasi::wasi_filestat_t Result{};
+    std::memcpy(&Result, std::addressof(Memory[ResultAddress]), sizeof(Result));
+    expect(Result.filetype == wasi::FILETYPE_SYMBOLIC_LINK,
+           "filestat of the link itself");
+  }
+
+  // symbolic links are read as is but never created pointing outside
+  auto LinkLength = putPath(Memory, PathAddress, "alias");
+  expect(wasi::path_readlink(
+             InstancePtr, DirFD, PathAddress, LinkLength, OtherPathAddress,
+             64, ResultAddress) == wasi::ERRNO_SUCCESS,
+         "path_readlink of the link");
+  auto const *Target = reinterpret_cast<char const *>(
+      std::addressof(Memory[OtherPathAddress]));
+  expect(std::string_view(Target, 6) == "inside", "link content read");
+  auto TargetLength = putPath(Memory, OtherPathAddress, "../outside");
+  LinkLength = putPath(Memory, PathAddress, "planted");
+  expect(wasi::path_symlink(
+             InstancePtr, OtherPathAddress, TargetLength, DirFD, PathAddress,
+             LinkLength) == wasi::ERRNO_NOTCAPABLE,
+         "path_symlink pointing outside");
+  expect(!fs::is_symlink(Root / "planted"), "link planted pointing outside");
+
+  // another program keeps its own descriptors, without the preopen
+  auto Other = WebAssemblyInstanceBuilder(Module).Build();
+  wasi::bind(*Other, std::make_shared<wasi::WASIContext>());
+  expect(wasi::fd_prestat_get(Other->asInstancePtr(), DirFD, ResultAddress) ==
+             wasi::ERRNO_BADF,
+         "preopen seen by another context");
+
+  fs::remove_all(Base);
+  return 0;
+}
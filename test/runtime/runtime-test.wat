@@ -0,0 +1,11 @@
+;; Source of runtime-test.wasm, the module the runtime tests instantiate.
+(module
+  (memory (export "memory") 1 4)
+  (data (i32.const 16) "sable")
+  ;; the address computation wraps around, the effective address is X + 32
+  ;; modulo 2^32
+  (func (export "load_wrapped") (param i32) (result i32)
+    (i32.load (i32.add (local.get 0) (i32.const 32))))
+  ;; the static offset does not wrap, X + 32 may exceed 4 GiB and trap
+  (func (export "load_offset") (param i32) (result i32)
+    (i32.load offset=32 (local.get 0))))